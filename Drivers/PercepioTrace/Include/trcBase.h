@@ -441,20 +441,24 @@ extern RecorderDataType* RecorderDataPtr;
 
 uint16_t prvTraceGetDTS(uint16_t param_maxDTS);
 
-void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint8_t* plength);
+void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint16_t* phash, uint8_t* plength);
 
 traceLabel prvTraceCreateSymbolTableEntry(const char* name,
                                           uint8_t crc6,
+                                          uint16_t hash,
                                           uint8_t len,
                                           traceLabel channel);
 
 traceLabel prvTraceLookupSymbolTableEntry(const char* name,
                                           uint8_t crc6,
+                                          uint16_t hash,
                                           uint8_t len,
                                           traceLabel channel);
 
 traceLabel prvTraceOpenSymbol(const char* name, traceLabel userEventChannel);
 
+traceLabel prvTraceOpenSymbolCached(const char* name, traceLabel userEventChannel);
+
 void prvTraceUpdateCounters(void);
 
 void prvCheckDataToBeOverwrittenForMultiEntryEvents(uint8_t nEntries);
@@ -120,6 +120,40 @@
 #error "SYMBOL_TABLE_SIZE may not be zero!"
 #endif
 
+/*******************************************************************************
+ * SYMBOL_INDEX_SIZE << EST
+ *
+ * Macro which should be defined as zero (0) or a power of two.
+ *
+ * Number of slots of a hash index over the symbol table, kept in RAM only
+ * (4 bytes per slot). With the index, looking up a User Event label or
+ * format string takes usually one string compare instead of walking the
+ * chain of all entries with the same 6-bit checksum. The index is filled up
+ * to 3/4, additional entries are found through the chains. Use 0 to disable.
+ ******************************************************************************/
+#define SYMBOL_INDEX_SIZE 64
+
+#if (SYMBOL_INDEX_SIZE & (SYMBOL_INDEX_SIZE - 1)) != 0
+#error "SYMBOL_INDEX_SIZE must be zero or a power of two!"
+#endif
+
+/*******************************************************************************
+ * SYMBOL_CACHE_SIZE << EST
+ *
+ * Macro which should be defined as zero (0) or a power of two.
+ *
+ * Number of entries of a cache mapping the address of a label or format
+ * string, as passed to xTraceOpenLabel or vTracePrintF, to its symbol table
+ * entry (8 bytes per entry with 32-bit pointers). A repeated call from the
+ * same place then only needs to confirm the string, without hashing it or
+ * searching the symbol table. Use 0 to disable.
+ ******************************************************************************/
+#define SYMBOL_CACHE_SIZE 8
+
+#if (SYMBOL_CACHE_SIZE & (SYMBOL_CACHE_SIZE - 1)) != 0
+#error "SYMBOL_CACHE_SIZE must be zero or a power of two!"
+#endif
+
 /*******************************************************************************
  * USE_SEPARATE_USER_EVENT_BUFFER
  *
@@ -498,6 +532,28 @@
 #define STOP_AFTER_N_EVENTS -1
 #endif
 
+/******************************************************************************
+ * TRACE_STREAMING << EST
+ *
+ * Macro which should be defined as either zero (0) or one (1).
+ * Default is 0.
+ *
+ * If one (1), the events are streamed to a sink function while recording,
+ * see trcStreaming.h. A low priority task copies the new events from the ring
+ * buffer every TRACE_STREAM_PERIOD_MS into pages of TRACE_STREAM_PAGE_SIZE
+ * bytes. EVENT_BUFFER_SIZE needs to hold the events recorded within a period,
+ * otherwise events get dropped. Requires TRACE_STORE_MODE_RING_BUFFER.
+ *****************************************************************************/
+%if defined(Streaming) & %Streaming='yes'
+#define TRACE_STREAMING 1
+#define TRACE_STREAM_PAGE_SIZE %StreamPageSize
+#define TRACE_STREAM_PERIOD_MS %StreamPeriodMs
+#define TRACE_STREAM_TASK_PRIORITY %StreamTaskPriority
+#define TRACE_STREAM_TASK_STACK_SIZE %StreamTaskStackSize
+%else
+#define TRACE_STREAMING 0
+%endif
+
 /******************************************************************************
  * USE_IMPLICIT_IFE_RULES
  *
@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * Tracealyzer v2.6.0 Recorder Library
+ * << EST: streaming extension, not part of the Percepio distribution
+ *
+ * trcStreaming.h
+ *
+ * Streaming of the recorded events to a sink (file, USB CDC, radio, ...)
+ * while the recorder is running, for captures longer than EVENT_BUFFER_SIZE.
+ *
+ * The recorder keeps writing to the ring buffer in RecorderData. A low
+ * priority task copies the new events into pages of TRACE_STREAM_PAGE_SIZE
+ * bytes and passes each page to the sink function. Two pages are used
+ * alternately. A sink writing synchronously returns when it is done with the
+ * page. A sink queuing the page for an asynchronous transfer (DMA, USB)
+ * returns TRACE_STREAM_SINK_PENDING instead, and calls vTraceStreamBlockDone
+ * when the transfer is complete: until then, the page is not written again.
+ *
+ * If the task cannot keep up and the recorder overwrites events not streamed
+ * yet, these events are counted as dropped and the next page is marked with
+ * TRACE_STREAM_FLAG_DISCONTINUITY, instead of losing the whole trace.
+ *
+ * Stream format: a sequence of blocks, each a TraceStreamBlockHeader followed
+ * by 'size' data bytes, all in the byte order of the target:
+ * - TRACE_STREAM_BLOCK_EVENTS: 4-byte event records as in
+ *   RecorderData.eventData, continuing the records of the previous block.
+ * - TRACE_STREAM_BLOCK_RECORDER_DATA: the complete RecorderData structure,
+ *   written by vTraceStreamStop(). It provides the object and symbol tables
+ *   needed to decode the events. For Tracealyzer, the streamed events are
+ *   put into its event buffer (adjusting maxEvents, nextFreeIndex and
+ *   numEvents).
+ ******************************************************************************/
+
+#ifndef TRCSTREAMING_H
+#define TRCSTREAMING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "trcKernelPort.h"
+
+#if (USE_TRACEALYZER_RECORDER == 1) && (TRACE_STREAMING == 1)
+
+#define TRACE_STREAM_MAGIC                 0x54525353UL /* 'TRSS' */
+
+#define TRACE_STREAM_BLOCK_EVENTS          1
+#define TRACE_STREAM_BLOCK_RECORDER_DATA   2
+
+/* Events have been dropped before the first record of the block */
+#define TRACE_STREAM_FLAG_DISCONTINUITY    0x0001
+
+typedef struct
+{
+    uint32_t magic;         /* TRACE_STREAM_MAGIC */
+    uint16_t type;          /* TRACE_STREAM_BLOCK_EVENTS or TRACE_STREAM_BLOCK_RECORDER_DATA */
+    uint16_t flags;         /* TRACE_STREAM_FLAG_xxx */
+    uint32_t sequence;      /* Block counter, starting with 0 */
+    uint32_t droppedEvents; /* Number of event records dropped so far */
+    uint32_t size;          /* Number of data bytes following the header */
+} TraceStreamBlockHeader;
+
+/* Returned by a sink which still uses the data, see vTraceStreamBlockDone */
+#define TRACE_STREAM_SINK_PENDING          1
+
+/*******************************************************************************
+ * TraceStreamSink
+ *
+ * Writes size bytes to the stream (e.g. f_write() to a FatFs file, or sending
+ * on the USB CDC or RNet link). Returns 0 on success, or
+ * TRACE_STREAM_SINK_PENDING if the data is still in use and will be released
+ * with vTraceStreamBlockDone. If a write fails (any other value), the block
+ * is counted as dropped.
+ ******************************************************************************/
+typedef int (*TraceStreamSink)(const uint8_t* data, uint32_t size);
+
+/*******************************************************************************
+ * vTraceStreamSetSink
+ *
+ * Sets the sink function, must be called before vTraceStreamStart.
+ ******************************************************************************/
+void vTraceStreamSetSink(TraceStreamSink sink);
+
+/*******************************************************************************
+ * uiTraceStreamStart
+ *
+ * Creates the streaming task (on the first call) and starts draining the
+ * event buffer. The recorder itself is started with uiTraceStart as usual.
+ * After vTraceStreamStop, a new stream starts with block sequence 0 and no
+ * dropped events. Returns 1 on success, 0 if no sink is set or the task could not be created.
+ ******************************************************************************/
+uint32_t uiTraceStreamStart(void);
+
+/*******************************************************************************
+ * vTraceStreamStop
+ *
+ * Stops the recorder, streams the remaining events followed by the
+ * RecorderData block and stops streaming. Must be called from a task, as it
+ * waits for the streaming task.
+ ******************************************************************************/
+void vTraceStreamStop(void);
+
+/*******************************************************************************
+ * vTraceStreamBlockDone
+ *
+ * Releases the data passed to the sink, for a sink which returned
+ * TRACE_STREAM_SINK_PENDING. Can be called from an interrupt (e.g. the end of
+ * a DMA transfer). The streaming task does not reuse a page before it is
+ * released, and vTraceStreamStop waits for all data to be released.
+ ******************************************************************************/
+void vTraceStreamBlockDone(const uint8_t* data);
+
+/*******************************************************************************
+ * uiTraceStreamGetDropped
+ *
+ * Returns the number of event records which could not be streamed.
+ ******************************************************************************/
+uint32_t uiTraceStreamGetDropped(void);
+
+/*******************************************************************************
+ * vTraceStreamSetMemory, xTraceStreamMemorySink, uiTraceStreamGetMemoryUsed
+ *
+ * Sink writing the stream into a memory buffer, e.g. an external RAM, to be
+ * saved or sent after the capture. Writes failing because the buffer is full
+ * are counted as dropped.
+ *
+ * Example:
+ *     vTraceStreamSetMemory(buffer, sizeof(buffer));
+ *     vTraceStreamSetSink(xTraceStreamMemorySink);
+ *     uiTraceStreamStart();
+ *     ...
+ *     vTraceStreamStop();
+ *     save(buffer, uiTraceStreamGetMemoryUsed());
+ ******************************************************************************/
+void vTraceStreamSetMemory(uint8_t* buffer, uint32_t size);
+int xTraceStreamMemorySink(const uint8_t* data, uint32_t size);
+uint32_t uiTraceStreamGetMemoryUsed(void);
+
+/*******************************************************************************
+ * prvTraceStreamEarlyWrap
+ *
+ * Called by the recorder within its critical section, before a user event
+ * which does not fit at the end of the event buffer wraps to the beginning.
+ * The records from nextFreeIndex to the end are cleared and skipped.
+ ******************************************************************************/
+void prvTraceStreamEarlyWrap(void);
+
+#if defined(__GNUC__) && (defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+/*******************************************************************************
+ * uiTraceStreamOpenHostFile, xTraceStreamHostFileSink, vTraceStreamCloseHostFile
+ *
+ * Sink writing the stream into a file on the debug host using ARM
+ * semihosting, for offline analysis without extra hardware. Requires a debug
+ * connection with semihosting enabled, and is slow: use large pages.
+ *
+ * Example:
+ *     if (uiTraceStreamOpenHostFile("trace.bin")) {
+ *       vTraceStreamSetSink(xTraceStreamHostFileSink);
+ *       uiTraceStreamStart();
+ *     }
+ *     ...
+ *     vTraceStreamStop();
+ *     vTraceStreamCloseHostFile();
+ ******************************************************************************/
+uint32_t uiTraceStreamOpenHostFile(const char* fileName);
+int xTraceStreamHostFileSink(const uint8_t* data, uint32_t size);
+void vTraceStreamCloseHostFile(void);
+#endif
+
+#else
+
+#define vTraceStreamSetSink(sink)
+#define uiTraceStreamStart() (0)
+#define vTraceStreamStop()
+#define vTraceStreamBlockDone(data)
+#define uiTraceStreamGetDropped() (0)
+#define prvTraceStreamEarlyWrap()
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRCSTREAMING_H */
@@ -315,7 +315,8 @@ uint32_t uiTraceGetTraceBufferSize(void);
  * The second option is faster since no lookup is required on each event, and
  * therefore recommended for user events that are frequently
  * executed and/or located in time-critical code. The lookup operation is
- * however fairly fast due to the design of the symbol table.
+ * however fairly fast due to the design of the symbol table, and repeated
+ * calls with the same string are served from the symbol cache. << EST
  ******************************************************************************/
 traceLabel xTraceOpenLabel(const char* label);
 
@@ -106,6 +106,38 @@ RecorderDataType RecorderData;
 
 RecorderDataType* RecorderDataPtr = NULL;
 
+/*******************************************************************************
+ * Symbol index and symbol cache << EST
+ *
+ * RAM-only lookup structures for the symbol table, see SYMBOL_INDEX_SIZE and
+ * SYMBOL_CACHE_SIZE in trcConfig.h. They are not part of RecorderData, so the
+ * symbol table as read by Tracealyzer (including the checksum chains) is not
+ * changed. Both are reset by prvTraceInitTraceData.
+ ******************************************************************************/
+#if (SYMBOL_INDEX_SIZE > 0)
+/* Symbol table index of the entry, 0 for an empty slot */
+static uint16_t symbolIndexEntry[SYMBOL_INDEX_SIZE];
+
+/* Key (hash and channel) of the entry, compared before the string */
+static uint16_t symbolIndexKey[SYMBOL_INDEX_SIZE];
+
+static uint16_t symbolIndexCount;
+
+/* Set if an entry did not fit into the index and is only in the chains */
+static uint8_t symbolIndexOverflow;
+
+#define SYMBOL_INDEX_KEY(hash, chn) ((uint16_t)((hash) ^ ((uint16_t)(chn) * 0x9E37U)))
+#define SYMBOL_INDEX_SLOT(key) ((uint16_t)(((key) ^ ((key) >> 8)) & (SYMBOL_INDEX_SIZE - 1)))
+#endif
+
+#if (SYMBOL_CACHE_SIZE > 0)
+static const char* symbolCacheName[SYMBOL_CACHE_SIZE];
+static traceLabel symbolCacheChannel[SYMBOL_CACHE_SIZE];
+static traceLabel symbolCacheLabel[SYMBOL_CACHE_SIZE];
+#endif
+
+static void prvTraceResetSymbolIndex(void);
+
 /* This version of the function dynamically allocates the trace data */
 void prvTraceInitTraceData()
 {
@@ -160,6 +192,7 @@ void prvTraceInitTraceData()
     RecorderDataPtr->debugMarker1 = 0xF1F1F1F1;
     RecorderDataPtr->SymbolTable.symTableSize = SYMBOL_TABLE_SIZE;
     RecorderDataPtr->SymbolTable.nextFreeSymbolIndex = 1;
+    prvTraceResetSymbolIndex(); /* << EST */
 #if (INCLUDE_FLOAT_SUPPORT == 1)
     RecorderDataPtr->exampleFloatEncoding = (float)1.0; /* otherwise already zero */
 #endif
@@ -402,25 +435,67 @@ traceLabel prvTraceOpenSymbol(const char* name, traceLabel userEventChannel)
     uint16_t result;
     uint8_t len;
     uint8_t crc;
+    uint16_t hash;
 	TRACE_SR_ALLOC_CRITICAL_SECTION();
 	
     len = 0;
     crc = 0;
+    hash = 0;
     
 
     TRACE_ASSERT(name != NULL, "prvTraceOpenSymbol: name == NULL", (traceLabel)0);
 
-    prvTraceGetChecksum(name, &crc, &len);
+    prvTraceGetChecksum(name, &crc, &hash, &len);
 
     trcCRITICAL_SECTION_BEGIN();
-    result = prvTraceLookupSymbolTableEntry(name, crc, len, userEventChannel);
+    result = prvTraceLookupSymbolTableEntry(name, crc, hash, len, userEventChannel);
     if (!result)
     {
-        result = prvTraceCreateSymbolTableEntry(name, crc, len, userEventChannel);
+        result = prvTraceCreateSymbolTableEntry(name, crc, hash, len, userEventChannel);
+    }
+    trcCRITICAL_SECTION_END();
+
+    return result;
+}
+
+/*******************************************************************************
+ * prvTraceOpenSymbolCached << EST
+ *
+ * Same as prvTraceOpenSymbol, but first checks the symbol cache, indexed by the
+ * address of the string. This is used for labels and format strings, which are
+ * usually string literals passed again and again from the same place. As the
+ * string could be in a buffer which gets reused, a cache hit is confirmed with
+ * a compare against the symbol table entry.
+ ******************************************************************************/
+traceLabel prvTraceOpenSymbolCached(const char* name, traceLabel userEventChannel)
+{
+#if (SYMBOL_CACHE_SIZE > 0)
+    traceLabel result;
+    uint16_t idx;
+	TRACE_SR_ALLOC_CRITICAL_SECTION();
+
+    TRACE_ASSERT(name != NULL, "prvTraceOpenSymbolCached: name == NULL", (traceLabel)0);
+
+    idx = (uint16_t)((((size_t)name >> 2) ^ userEventChannel) & (SYMBOL_CACHE_SIZE - 1));
+
+    trcCRITICAL_SECTION_BEGIN();
+    result = symbolCacheLabel[idx];
+    if ((result == 0) ||
+        (symbolCacheName[idx] != name) ||
+        (symbolCacheChannel[idx] != userEventChannel) ||
+        (strcmp((char*)(& RecorderDataPtr->SymbolTable.symbytes[result + 4]), name) != 0))
+    {
+        result = prvTraceOpenSymbol(name, userEventChannel);
+        symbolCacheName[idx] = name;
+        symbolCacheChannel[idx] = userEventChannel;
+        symbolCacheLabel[idx] = result;
     }
     trcCRITICAL_SECTION_END();
 
     return result;
+#else
+    return prvTraceOpenSymbol(name, userEventChannel);
+#endif
 }
 
 /*******************************************************************************
@@ -673,6 +748,79 @@ uint16_t prvTraceGetDTS(uint16_t param_maxDTS)
     return (uint16_t)dts & param_maxDTS;
 }
 
+/*******************************************************************************
+ * prvTraceSymbolTableEntryMatches << EST
+ *
+ * Returns 1 if the symbol table entry at index i has the given name and
+ * channel, otherwise 0.
+ ******************************************************************************/
+static uint8_t prvTraceSymbolTableEntryMatches(uint16_t i,
+                                               const char* name,
+                                               uint8_t len,
+                                               traceLabel chn)
+{
+    if (RecorderDataPtr->SymbolTable.symbytes[i + 2] == (chn & 0x00FF))
+    {
+        if (RecorderDataPtr->SymbolTable.symbytes[i + 3] == (chn / 0x100))
+        {
+            if (RecorderDataPtr->SymbolTable.symbytes[i + 4 + len] == '\0')
+            {
+                if (strncmp((char*)(& RecorderDataPtr->SymbolTable.symbytes[i + 4]), name, len) == 0)
+                {
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/*******************************************************************************
+ * prvTraceResetSymbolIndex << EST
+ *
+ * Clears the symbol index and the symbol cache, called when the symbol table
+ * is initialized.
+ ******************************************************************************/
+static void prvTraceResetSymbolIndex(void)
+{
+#if (SYMBOL_INDEX_SIZE > 0)
+    (void)memset(symbolIndexEntry, 0, sizeof(symbolIndexEntry));
+    symbolIndexCount = 0;
+    symbolIndexOverflow = 0;
+#endif
+#if (SYMBOL_CACHE_SIZE > 0)
+    (void)memset(symbolCacheLabel, 0, sizeof(symbolCacheLabel));
+#endif
+}
+
+#if (SYMBOL_INDEX_SIZE > 0)
+/*******************************************************************************
+ * prvTraceAddToSymbolIndex << EST
+ *
+ * Adds a new symbol table entry to the symbol index (open addressing with
+ * linear probing). The index is only filled up to 3/4 to keep the probe
+ * sequences short, further entries can only be found through the chains.
+ ******************************************************************************/
+static void prvTraceAddToSymbolIndex(uint16_t i, uint16_t key)
+{
+    uint16_t slot;
+
+    if (symbolIndexCount >= SYMBOL_INDEX_SIZE - (SYMBOL_INDEX_SIZE / 4))
+    {
+        symbolIndexOverflow = 1;
+        return;
+    }
+    slot = SYMBOL_INDEX_SLOT(key);
+    while (symbolIndexEntry[slot] != 0)
+    {
+        slot = (uint16_t)((slot + 1) & (SYMBOL_INDEX_SIZE - 1));
+    }
+    symbolIndexEntry[slot] = i;
+    symbolIndexKey[slot] = key;
+    symbolIndexCount++;
+}
+#endif
+
 /*******************************************************************************
  * prvTraceLookupSymbolTableEntry
  *
@@ -685,31 +833,49 @@ uint16_t prvTraceGetDTS(uint16_t param_maxDTS)
  * format strings only (the handle of the destination channel).
  * byte 4..(4 + length): the string (object name or user event label), with
  * zero-termination
+ *
+ * The symbol index (<< EST) is searched first, the checksum chain only if
+ * some entries did not fit into the index.
  ******************************************************************************/
 traceLabel prvTraceLookupSymbolTableEntry(const char* name,
                                           uint8_t crc6,
+                                          uint16_t hash,
                                           uint8_t len,
                                           traceLabel chn)
 {
-    uint16_t i = RecorderDataPtr->SymbolTable.latestEntryOfChecksum[ crc6 ];
+    uint16_t i;
+#if (SYMBOL_INDEX_SIZE > 0)
+    uint16_t key = SYMBOL_INDEX_KEY(hash, chn);
+    uint16_t slot = SYMBOL_INDEX_SLOT(key);
+#else
+    (void)hash;
+#endif
 
 	TRACE_ASSERT(name != NULL, "prvTraceLookupSymbolTableEntry: name == NULL", (traceLabel)0);
 	TRACE_ASSERT(len != 0, "prvTraceLookupSymbolTableEntry: len == 0", (traceLabel)0);
 
+#if (SYMBOL_INDEX_SIZE > 0)
+    /* The index always has empty slots, so this terminates */
+    while ((i = symbolIndexEntry[slot]) != 0)
+    {
+        if (symbolIndexKey[slot] == key && prvTraceSymbolTableEntryMatches(i, name, len, chn))
+        {
+            return i; /* found */
+        }
+        slot = (uint16_t)((slot + 1) & (SYMBOL_INDEX_SIZE - 1));
+    }
+    if (!symbolIndexOverflow)
+    {
+        return 0;
+    }
+#endif
+
+    i = RecorderDataPtr->SymbolTable.latestEntryOfChecksum[ crc6 ];
     while (i != 0)
     {
-        if (RecorderDataPtr->SymbolTable.symbytes[i + 2] == (chn & 0x00FF))
+        if (prvTraceSymbolTableEntryMatches(i, name, len, chn))
         {
-            if (RecorderDataPtr->SymbolTable.symbytes[i + 3] == (chn / 0x100))
-            {
-                if (RecorderDataPtr->SymbolTable.symbytes[i + 4 + len] == '\0')
-                {
-                    if (strncmp((char*)(& RecorderDataPtr->SymbolTable.symbytes[i + 4]), name, len) == 0)
-                    {
-                        break; /* found */
-                    }
-                }
-            }
+            break; /* found */
         }
         i = (uint16_t)(RecorderDataPtr->SymbolTable.symbytes[i] + (RecorderDataPtr->SymbolTable.symbytes[i + 1] * 0x100));
     }
@@ -731,6 +897,7 @@ traceLabel prvTraceLookupSymbolTableEntry(const char* name,
  ******************************************************************************/
 uint16_t prvTraceCreateSymbolTableEntry(const char* name,
                                         uint8_t crc6,
+                                        uint16_t hash,
                                         uint8_t len,
                                         traceLabel channel)
 {
@@ -779,6 +946,12 @@ uint16_t prvTraceCreateSymbolTableEntry(const char* name,
 
         ret = (uint16_t)(RecorderDataPtr->SymbolTable.nextFreeSymbolIndex -
             (len + 5));
+
+#if (SYMBOL_INDEX_SIZE > 0)
+        prvTraceAddToSymbolIndex(ret, SYMBOL_INDEX_KEY(hash, channel)); /* << EST */
+#else
+        (void)hash;
+#endif
     }
 
     return ret;
@@ -789,16 +962,19 @@ uint16_t prvTraceCreateSymbolTableEntry(const char* name,
  * prvTraceGetChecksum
  *
  * Calculates a simple 6-bit checksum from a string, used to index the string
- * for fast symbol table lookup.
+ * for fast symbol table lookup. << EST: In the same pass, a 16-bit hash is
+ * calculated for the symbol index (djb2 with xor).
  ******************************************************************************/
-void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint8_t* plength)
+void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint16_t* phash, uint8_t* plength)
 {
    unsigned char c;
    int length = 1;
    int crc = 0;
+   uint16_t hash = 5381;
 
    TRACE_ASSERT(pname != NULL, "prvTraceGetChecksum: pname == NULL", ;);
    TRACE_ASSERT(pcrc != NULL, "prvTraceGetChecksum: pcrc == NULL", ;);
+   TRACE_ASSERT(phash != NULL, "prvTraceGetChecksum: phash == NULL", ;);
    TRACE_ASSERT(plength != NULL, "prvTraceGetChecksum: plength == NULL", ;);
 
    if (pname != (const char *) 0)
@@ -806,10 +982,12 @@ void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint8_t* plength)
       for (; (c = *pname++) != '\0';)
       {
          crc += c;
+         hash = (uint16_t)(((hash << 5) + hash) ^ c);
          length++;
       }
    }
    *pcrc = (uint8_t)(crc & 0x3F);
+   *phash = hash;
    *plength = (uint8_t)length;
 }
 
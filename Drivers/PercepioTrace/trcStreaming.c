@@ -0,0 +1,622 @@
+/*******************************************************************************
+ * Tracealyzer v2.6.0 Recorder Library
+ * << EST: streaming extension, not part of the Percepio distribution
+ *
+ * trcStreaming.c
+ *
+ * Streams the events of the recorder ring buffer to a sink while recording,
+ * see trcStreaming.h for the stream format.
+ ******************************************************************************/
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "trcUser.h"
+#include "trcStreaming.h"
+
+#if (USE_TRACEALYZER_RECORDER == 1) && (TRACE_STREAMING == 1)
+
+#include <string.h>
+
+#if (TRACE_RECORDER_STORE_MODE != TRACE_STORE_MODE_RING_BUFFER)
+#error "Trace streaming requires TRACE_RECORDER_STORE_MODE set to TRACE_STORE_MODE_RING_BUFFER"
+#endif
+
+#if ((TRACE_STREAM_PAGE_SIZE % 4) != 0) || (TRACE_STREAM_PAGE_SIZE == 0)
+#error "TRACE_STREAM_PAGE_SIZE must be a multiple of 4"
+#endif
+
+/* Number of records in a page */
+#define TRACE_STREAM_PAGE_RECORDS (TRACE_STREAM_PAGE_SIZE / 4)
+
+/* Distance kept to the write position of the recorder. The recorder clears
+records ahead of it, when a multi-record user event is partially overwritten,
+and a user event which does not fit at the end wraps early. */
+#define TRACE_STREAM_MARGIN 16
+
+/* Max number of records copied within one critical section */
+#define TRACE_STREAM_CHUNK 32
+
+/* A partially filled page is sent after this number of periods */
+#define TRACE_STREAM_FLUSH_PERIODS 10
+
+/* streamWrapIndex if the reader is not before an early wrap */
+#define TRACE_STREAM_NO_WRAP 0xFFFFFFFFUL
+
+typedef struct
+{
+    TraceStreamBlockHeader header;
+    uint8_t data[TRACE_STREAM_PAGE_SIZE];
+} TraceStreamPage;
+
+static TraceStreamPage streamPages[2];
+static volatile uint8_t streamPageOwned[2]; /* Page handed to the sink and not released yet */
+static uint8_t streamPageIdx = 0;           /* Page being filled */
+static uint32_t streamPageFill = 0;         /* Records in the page being filled */
+static uint32_t streamPagePeriods = 0;      /* Periods since the first record went into the page */
+static uint16_t streamPageFlags = 0;        /* Flags of the page being filled */
+
+static TraceStreamBlockHeader streamDataHeader;  /* Header of the RecorderData block */
+static volatile uint8_t streamDataHeaderOwned = 0;
+static volatile uint8_t streamDataOwned = 0;
+static uint8_t streamDataSent = 0;          /* RecorderData block sent after a stop request */
+
+static TraceStreamSink streamSink = NULL;
+static TaskHandle_t streamTask = NULL;
+static volatile uint8_t streamActive = 0;
+static volatile uint8_t streamStopRequest = 0;
+
+static uint32_t streamReadIndex = 0;        /* Next record in eventData to stream */
+static uint32_t streamNumEvents = 0;        /* RecorderDataPtr->numEvents when last synchronized */
+static uint32_t streamPending = 0;          /* Records from streamReadIndex to the write position of the recorder */
+static uint32_t streamWrapIndex = TRACE_STREAM_NO_WRAP; /* Early wrap of the recorder ahead of streamReadIndex */
+static uint32_t streamSequence = 0;
+static volatile uint32_t streamDropped = 0;
+static uint16_t streamFlags = 0;
+
+static uint8_t* streamMemory = NULL;
+static uint32_t streamMemorySize = 0;
+static uint32_t streamMemoryUsed = 0;
+
+/*******************************************************************************
+ * prvTraceStreamSync
+ *
+ * Adds the records written by the recorder since the last call to
+ * streamPending. Records skipped by an early wrap are not counted in
+ * numEvents, they are added by prvTraceStreamEarlyWrap.
+ ******************************************************************************/
+static void prvTraceStreamSync(void)
+{
+    if (RecorderDataPtr->numEvents < streamNumEvents)
+    {
+        /* The recorder has been cleared, start again at the beginning */
+        streamReadIndex = 0;
+        streamNumEvents = 0;
+        streamPending = 0;
+        streamWrapIndex = TRACE_STREAM_NO_WRAP;
+        streamFlags |= TRACE_STREAM_FLAG_DISCONTINUITY;
+    }
+    streamPending += RecorderDataPtr->numEvents - streamNumEvents;
+    streamNumEvents = RecorderDataPtr->numEvents;
+}
+
+/*******************************************************************************
+ * prvTraceStreamFirstEvent
+ *
+ * Returns the first record at least TRACE_STREAM_MARGIN records after the
+ * write position of the recorder which starts an event, and not the data of a
+ * user event. The records from the write position on are whole events: the
+ * recorder clears the data records of a user event it overwrites.
+ ******************************************************************************/
+static uint32_t prvTraceStreamFirstEvent(uint32_t writeIndex)
+{
+    uint32_t index, margin, n;
+    uint8_t type;
+
+    index = writeIndex;
+    margin = 0;
+    while (margin < TRACE_STREAM_MARGIN)
+    {
+        type = RecorderDataPtr->eventData[index * 4];
+        if ((type > USER_EVENT) && (type < USER_EVENT + 16))
+        {
+            n = 1 + type - USER_EVENT;
+        }
+        else if (type == DIV_XPS)
+        {
+            n = 2;
+        }
+        else
+        {
+            n = 1;
+        }
+        index = (index + n) % RecorderDataPtr->maxEvents;
+        margin += n;
+    }
+    return index;
+}
+
+/*******************************************************************************
+ * prvTraceStreamSkipOverwritten
+ *
+ * If the recorder has overwritten records not streamed yet, skips them
+ * instead of streaming inconsistent data, and counts them as dropped.
+ * writeIndex is the write position of the recorder.
+ ******************************************************************************/
+static void prvTraceStreamSkipOverwritten(uint32_t writeIndex)
+{
+    uint32_t maxEvents, keep, skipped, readIndex;
+
+    maxEvents = RecorderDataPtr->maxEvents;
+    keep = maxEvents - TRACE_STREAM_MARGIN;
+    if (streamPending <= keep)
+    {
+        return;
+    }
+    skipped = streamPending; /* records dropped, without the ones skipped by an early wrap */
+    readIndex = prvTraceStreamFirstEvent(writeIndex);
+    keep = maxEvents - (readIndex + maxEvents - writeIndex) % maxEvents;
+    if (streamWrapIndex != TRACE_STREAM_NO_WRAP)
+    {
+        skipped -= maxEvents - streamWrapIndex;
+        if ((streamPending - (maxEvents - streamReadIndex)) >= streamWrapIndex)
+        {
+            /* The recorder has written over the skipped records as well */
+            streamWrapIndex = TRACE_STREAM_NO_WRAP;
+        }
+        else if (readIndex < writeIndex)
+        {
+            /* The early wrap is behind the new read position */
+            streamWrapIndex = TRACE_STREAM_NO_WRAP;
+        }
+    }
+    streamReadIndex = readIndex;
+    streamPending = keep;
+    if (streamWrapIndex != TRACE_STREAM_NO_WRAP)
+    {
+        if (readIndex >= streamWrapIndex)
+        {
+            /* Within the records skipped by the early wrap */
+            streamPending -= maxEvents - readIndex;
+            streamReadIndex = 0;
+            streamWrapIndex = TRACE_STREAM_NO_WRAP;
+        }
+        else
+        {
+            skipped += maxEvents - streamWrapIndex;
+        }
+    }
+    streamDropped += skipped - streamPending;
+    streamFlags |= TRACE_STREAM_FLAG_DISCONTINUITY;
+}
+
+/*******************************************************************************
+ * prvTraceStreamEarlyWrap
+ *
+ * The records from the write position to the end of the buffer are cleared:
+ * if they have not been streamed yet, they are dropped. Otherwise they are
+ * skipped when the stream gets there.
+ ******************************************************************************/
+void prvTraceStreamEarlyWrap(void)
+{
+    uint32_t maxEvents, wrapIndex, lost;
+
+    if ((streamActive == 0) || (RecorderDataPtr == NULL))
+    {
+        return;
+    }
+    maxEvents = RecorderDataPtr->maxEvents;
+    wrapIndex = RecorderDataPtr->nextFreeIndex;
+    prvTraceStreamSync();
+    prvTraceStreamSkipOverwritten(wrapIndex);
+    if ((streamPending > 0) && (streamReadIndex > wrapIndex))
+    {
+        /* The records up to the end of the buffer are cleared before they
+        have been streamed */
+        lost = ((streamWrapIndex != TRACE_STREAM_NO_WRAP) ? streamWrapIndex : maxEvents) - streamReadIndex;
+        streamDropped += lost;
+        streamPending -= maxEvents - streamReadIndex;
+        streamReadIndex = 0;
+        streamWrapIndex = TRACE_STREAM_NO_WRAP;
+        streamFlags |= TRACE_STREAM_FLAG_DISCONTINUITY;
+    }
+    if (streamPending == 0)
+    {
+        /* Continues with the recorder at the beginning */
+        streamReadIndex = 0;
+        streamWrapIndex = TRACE_STREAM_NO_WRAP;
+    }
+    else
+    {
+        streamWrapIndex = wrapIndex;
+        streamPending += maxEvents - wrapIndex;
+    }
+}
+
+/*******************************************************************************
+ * prvTraceStreamCopy
+ *
+ * Copies up to TRACE_STREAM_CHUNK new records from the ring buffer into the
+ * current page. Returns the number of records copied.
+ ******************************************************************************/
+static uint32_t prvTraceStreamCopy(void)
+{
+    uint32_t n, first, maxEvents;
+    uint8_t* dst;
+    TRACE_SR_ALLOC_CRITICAL_SECTION();
+
+    n = 0;
+    trcCRITICAL_SECTION_BEGIN();
+    if (RecorderDataPtr != NULL)
+    {
+        maxEvents = RecorderDataPtr->maxEvents;
+        prvTraceStreamSync();
+        prvTraceStreamSkipOverwritten(RecorderDataPtr->nextFreeIndex);
+        if (streamReadIndex == streamWrapIndex)
+        {
+            /* Skip the records cleared by the early wrap */
+            streamPending -= maxEvents - streamWrapIndex;
+            streamReadIndex = 0;
+            streamWrapIndex = TRACE_STREAM_NO_WRAP;
+        }
+
+        n = streamPending;
+        if ((streamPageFill != 0) && ((streamFlags & TRACE_STREAM_FLAG_DISCONTINUITY) != 0))
+        {
+            /* The records after the dropped ones go into the next page */
+            n = 0;
+        }
+        if (n > TRACE_STREAM_CHUNK)
+        {
+            n = TRACE_STREAM_CHUNK;
+        }
+        if (n > TRACE_STREAM_PAGE_RECORDS - streamPageFill)
+        {
+            n = TRACE_STREAM_PAGE_RECORDS - streamPageFill;
+        }
+        /* records up to the early wrap or the end of the buffer */
+        first = ((streamWrapIndex != TRACE_STREAM_NO_WRAP) ? streamWrapIndex : maxEvents) - streamReadIndex;
+        if ((n > first) && (streamWrapIndex != TRACE_STREAM_NO_WRAP))
+        {
+            n = first;
+        }
+        if (n > 0)
+        {
+            if (streamPageFill == 0)
+            {
+                streamPageFlags = streamFlags;
+                streamFlags = 0;
+            }
+            dst = &streamPages[streamPageIdx].data[streamPageFill * 4];
+            if (n <= first)
+            {
+                (void)memcpy(dst, &RecorderDataPtr->eventData[streamReadIndex * 4], n * 4);
+            }
+            else
+            {
+                (void)memcpy(dst, &RecorderDataPtr->eventData[streamReadIndex * 4], first * 4);
+                (void)memcpy(dst + first * 4, &RecorderDataPtr->eventData[0], (n - first) * 4);
+            }
+            streamReadIndex = (streamReadIndex + n) % maxEvents;
+            streamPending -= n;
+            streamPageFill += n;
+        }
+    }
+    trcCRITICAL_SECTION_END();
+    return n;
+}
+
+/*******************************************************************************
+ * prvTraceStreamSend
+ *
+ * Passes a block to the sink. *owned is set while the sink uses the data.
+ * Returns 0 on success.
+ ******************************************************************************/
+static int prvTraceStreamSend(const uint8_t* data, uint32_t size, volatile uint8_t* owned)
+{
+    int res;
+
+    /* Set before, the transfer may complete before the sink returns */
+    *owned = 1;
+    res = streamSink(data, size);
+    if (res == TRACE_STREAM_SINK_PENDING)
+    {
+        return 0;
+    }
+    *owned = 0;
+    return res;
+}
+
+/*******************************************************************************
+ * prvTraceStreamFlushPage
+ *
+ * Hands the current page to the sink, if not empty, and switches to the other
+ * page.
+ ******************************************************************************/
+static void prvTraceStreamFlushPage(void)
+{
+    TraceStreamPage* page = &streamPages[streamPageIdx];
+
+    if (streamPageFill == 0)
+    {
+        return;
+    }
+    page->header.magic = TRACE_STREAM_MAGIC;
+    page->header.type = TRACE_STREAM_BLOCK_EVENTS;
+    page->header.flags = streamPageFlags;
+    page->header.sequence = streamSequence++;
+    page->header.droppedEvents = streamDropped;
+    page->header.size = streamPageFill * 4;
+    if (prvTraceStreamSend((const uint8_t*)page, sizeof(TraceStreamBlockHeader) + page->header.size,
+                           &streamPageOwned[streamPageIdx]) != 0)
+    {
+        streamDropped += streamPageFill;
+        streamFlags |= TRACE_STREAM_FLAG_DISCONTINUITY;
+    }
+    streamPageIdx ^= 1;
+    streamPageFill = 0;
+    streamPagePeriods = 0;
+}
+
+/*******************************************************************************
+ * prvTraceStreamWriteRecorderData
+ *
+ * Writes the RecorderData block, with the recorder stopped.
+ ******************************************************************************/
+static void prvTraceStreamWriteRecorderData(void)
+{
+    streamDataHeader.magic = TRACE_STREAM_MAGIC;
+    streamDataHeader.type = TRACE_STREAM_BLOCK_RECORDER_DATA;
+    streamDataHeader.flags = streamFlags;
+    streamDataHeader.sequence = streamSequence++;
+    streamDataHeader.droppedEvents = streamDropped;
+    streamDataHeader.size = sizeof(RecorderDataType);
+    streamFlags = 0;
+    if (prvTraceStreamSend((const uint8_t*)&streamDataHeader, sizeof(streamDataHeader), &streamDataHeaderOwned) == 0)
+    {
+        (void)prvTraceStreamSend((const uint8_t*)RecorderDataPtr, sizeof(RecorderDataType), &streamDataOwned);
+    }
+}
+
+/*******************************************************************************
+ * prvTraceStreamTask
+ *
+ * Low priority task draining the event buffer every TRACE_STREAM_PERIOD_MS.
+ ******************************************************************************/
+static void prvTraceStreamTask(void* pvParameters)
+{
+    (void)pvParameters;
+
+    for (;;)
+    {
+        if (streamActive)
+        {
+            /* A page still used by the sink is not filled: the events wait
+            in the ring buffer */
+            while (streamPageOwned[streamPageIdx] == 0)
+            {
+                if (prvTraceStreamCopy() == 0)
+                {
+                    if ((streamPageFill == 0) || ((streamFlags & TRACE_STREAM_FLAG_DISCONTINUITY) == 0))
+                    {
+                        break;
+                    }
+                    /* The page ends before the dropped records */
+                    prvTraceStreamFlushPage();
+                }
+                else if (streamPageFill == TRACE_STREAM_PAGE_RECORDS)
+                {
+                    prvTraceStreamFlushPage();
+                }
+            }
+            if (streamPageFill != 0)
+            {
+                streamPagePeriods++;
+                if (streamPagePeriods >= TRACE_STREAM_FLUSH_PERIODS)
+                {
+                    prvTraceStreamFlushPage();
+                }
+            }
+            if (streamStopRequest)
+            {
+                if ((streamDataSent == 0) && (streamPageOwned[streamPageIdx] == 0))
+                {
+                    /* All events copied */
+                    prvTraceStreamFlushPage();
+                    if (RecorderDataPtr != NULL)
+                    {
+                        prvTraceStreamWriteRecorderData();
+                    }
+                    streamDataSent = 1;
+                }
+                if ((streamDataSent != 0) && (streamPageOwned[0] == 0) && (streamPageOwned[1] == 0) &&
+                    (streamDataHeaderOwned == 0) && (streamDataOwned == 0))
+                {
+                    streamDataSent = 0;
+                    streamActive = 0;
+                    streamStopRequest = 0;
+                }
+            }
+        }
+        vTaskDelay(TRACE_STREAM_PERIOD_MS / portTICK_RATE_MS);
+    }
+}
+
+void vTraceStreamSetSink(TraceStreamSink sink)
+{
+    streamSink = sink;
+}
+
+uint32_t uiTraceStreamStart(void)
+{
+    TRACE_SR_ALLOC_CRITICAL_SECTION();
+
+    if (streamSink == NULL)
+    {
+        return 0;
+    }
+    if (streamTask == NULL)
+    {
+        if (xTaskCreate(prvTraceStreamTask, "TrcStream", TRACE_STREAM_TASK_STACK_SIZE, NULL,
+                        TRACE_STREAM_TASK_PRIORITY, &streamTask) != pdPASS)
+        {
+            streamTask = NULL;
+            return 0;
+        }
+    }
+    trcCRITICAL_SECTION_BEGIN();
+    /* Start with the events already in the buffer */
+    if (RecorderDataPtr != NULL)
+    {
+        streamNumEvents = RecorderDataPtr->numEvents;
+        if (RecorderDataPtr->bufferIsFull)
+        {
+            streamReadIndex = prvTraceStreamFirstEvent(RecorderDataPtr->nextFreeIndex);
+            streamPending = RecorderDataPtr->maxEvents -
+                (streamReadIndex + RecorderDataPtr->maxEvents - RecorderDataPtr->nextFreeIndex) % RecorderDataPtr->maxEvents;
+        }
+        else
+        {
+            streamPending = RecorderDataPtr->nextFreeIndex;
+            streamReadIndex = 0;
+        }
+        streamWrapIndex = TRACE_STREAM_NO_WRAP;
+    }
+    if (streamActive == 0)
+    {
+        /* A new stream */
+        streamSequence = 0;
+        streamDropped = 0;
+        streamFlags = 0;
+    }
+    streamStopRequest = 0;
+    streamActive = 1;
+    trcCRITICAL_SECTION_END();
+    return 1;
+}
+
+void vTraceStreamStop(void)
+{
+    vTraceStop();
+    if (streamActive)
+    {
+        streamStopRequest = 1;
+        while (streamActive)
+        {
+            vTaskDelay(TRACE_STREAM_PERIOD_MS / portTICK_RATE_MS);
+        }
+    }
+}
+
+void vTraceStreamBlockDone(const uint8_t* data)
+{
+    if (data == (const uint8_t*)&streamPages[0])
+    {
+        streamPageOwned[0] = 0;
+    }
+    else if (data == (const uint8_t*)&streamPages[1])
+    {
+        streamPageOwned[1] = 0;
+    }
+    else if (data == (const uint8_t*)&streamDataHeader)
+    {
+        streamDataHeaderOwned = 0;
+    }
+    else if (data == (const uint8_t*)RecorderDataPtr)
+    {
+        streamDataOwned = 0;
+    }
+}
+
+uint32_t uiTraceStreamGetDropped(void)
+{
+    return streamDropped;
+}
+
+/*******************************************************************************
+ * Memory sink
+ ******************************************************************************/
+void vTraceStreamSetMemory(uint8_t* buffer, uint32_t size)
+{
+    streamMemory = buffer;
+    streamMemorySize = size;
+    streamMemoryUsed = 0;
+}
+
+int xTraceStreamMemorySink(const uint8_t* data, uint32_t size)
+{
+    if ((streamMemory == NULL) || (size > streamMemorySize - streamMemoryUsed))
+    {
+        return -1;
+    }
+    (void)memcpy(&streamMemory[streamMemoryUsed], data, size);
+    streamMemoryUsed += size;
+    return 0;
+}
+
+uint32_t uiTraceStreamGetMemoryUsed(void)
+{
+    return streamMemoryUsed;
+}
+
+#if defined(__GNUC__) && (defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+/*******************************************************************************
+ * ARM semihosting host file sink
+ ******************************************************************************/
+#define SEMIHOSTING_SYS_OPEN    0x01
+#define SEMIHOSTING_SYS_CLOSE   0x02
+#define SEMIHOSTING_SYS_WRITE   0x05
+#define SEMIHOSTING_MODE_WB     5 /* fopen() mode "wb" */
+
+static int streamHostFile = -1;
+
+static int prvSemihostingCall(int op, void* arg)
+{
+    register int r0 __asm("r0") = op;
+    register void* r1 __asm("r1") = arg;
+
+    __asm volatile ("bkpt 0xAB" : "+r"(r0) : "r"(r1) : "memory");
+    return r0;
+}
+
+uint32_t uiTraceStreamOpenHostFile(const char* fileName)
+{
+    uint32_t args[3];
+
+    if (streamHostFile != -1)
+    {
+        (void)prvSemihostingCall(SEMIHOSTING_SYS_CLOSE, &streamHostFile);
+    }
+    args[0] = (uint32_t)fileName;
+    args[1] = SEMIHOSTING_MODE_WB;
+    args[2] = (uint32_t)strlen(fileName);
+    streamHostFile = prvSemihostingCall(SEMIHOSTING_SYS_OPEN, args);
+    return (streamHostFile != -1) ? 1 : 0;
+}
+
+int xTraceStreamHostFileSink(const uint8_t* data, uint32_t size)
+{
+    uint32_t args[3];
+
+    if (streamHostFile == -1)
+    {
+        return -1;
+    }
+    args[0] = (uint32_t)streamHostFile;
+    args[1] = (uint32_t)data;
+    args[2] = size;
+    /* Returns the number of bytes not written */
+    return (prvSemihostingCall(SEMIHOSTING_SYS_WRITE, args) == 0) ? 0 : -1;
+}
+
+void vTraceStreamCloseHostFile(void)
+{
+    if (streamHostFile != -1)
+    {
+        (void)prvSemihostingCall(SEMIHOSTING_SYS_CLOSE, &streamHostFile);
+        streamHostFile = -1;
+    }
+}
+#endif
+
+#endif /* (USE_TRACEALYZER_RECORDER == 1) && (TRACE_STREAMING == 1) */
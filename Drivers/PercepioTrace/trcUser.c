@@ -38,6 +38,7 @@
 #include "task.h"
 
 #include "trcUser.h"
+#include "trcStreaming.h" /* << EST */
 #if 1 /* << EST: include own interface for events */
 %for var from EventModules
 #include "%var.h"
@@ -1228,7 +1229,7 @@ void vTracePrintF_Helper(traceLabel eventLabel, const char* formatStr, va_list v
         noOfSlots = prvTraceUserEventFormat(formatStr, vl, (uint8_t*)tempDataBuffer, 4);
 
         /* Store the format string, with a reference to the channel symbol */
-        ue1->payload = prvTraceOpenSymbol(formatStr, eventLabel);       		
+        ue1->payload = prvTraceOpenSymbolCached(formatStr, eventLabel); /* << EST */
 
         ue1->dts = (uint8_t)prvTraceGetDTS(0xFF);
 		
@@ -1241,6 +1242,7 @@ void vTracePrintF_Helper(traceLabel eventLabel, const char* formatStr, va_list v
 			if (RecorderDataPtr->nextFreeIndex + noOfSlots > RecorderDataPtr->maxEvents)
 			{
 				#if (TRACE_RECORDER_STORE_MODE == TRACE_STORE_MODE_RING_BUFFER)
+				prvTraceStreamEarlyWrap(); /* << EST: the streaming skips the cleared records */
 				(void)memset(& RecorderDataPtr->eventData[RecorderDataPtr->nextFreeIndex * 4],
 					   0,
 					   (RecorderDataPtr->maxEvents - RecorderDataPtr->nextFreeIndex)*4);
@@ -1419,13 +1421,14 @@ void vTraceUserEvent(traceLabel eventLabel)
  * The second option is faster since no lookup is required on each event, and
  * therefore recommended for user events that are frequently
  * executed and/or located in time-critical code. The lookup operation is
- * however fairly fast due to the design of the symbol table.
+ * however fairly fast due to the design of the symbol table, and repeated
+ * calls with the same string are served from the symbol cache. << EST
  ******************************************************************************/
 traceLabel xTraceOpenLabel(const char* label)
 {
 	TRACE_ASSERT(label != NULL, "xTraceOpenLabel: label == NULL", (traceLabel)0);
 
-    return prvTraceOpenSymbol(label, 0);
+    return prvTraceOpenSymbolCached(label, 0); /* << EST */
 }
 
 #endif
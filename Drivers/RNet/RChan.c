@@ -0,0 +1,292 @@
+/**
+ * \file
+ * \brief Adaptive channel selection and channel hopping for the radio network.
+ * \author (c) 2013-2014 Erich Styger, http://mcuoneclipse.com/
+ * \note MIT License (http://opensource.org/licenses/mit-license.html), see 'RNet_License.txt'
+ *
+ * This module keeps the link quality of the candidate channels and synchronizes channel changes.
+ */
+
+#include "RNetConf.h"
+#if RNET_CONFIG_CHANNEL_HOPPING
+#include "RChan.h"
+#include "Radio.h"
+#include "RPHY.h"
+#include "RMAC.h"
+#include "RNWK.h"
+#include "%@Utility@'ModuleName'.h"
+#include "%@RTOS@'ModuleName'.h"
+
+#define RCHAN_NOF_SAMPLES_PER_EVAL  16  /* RPD samples per channel and evaluation period */
+#define RCHAN_HOP_HYSTERESIS        32  /* score a new channel needs to be better than the current one */
+#define RCHAN_HOP_DELAY_MS          100 /* the nodes switch this time after the announcement */
+#define RCHAN_HOP_NOF_ANNOUNCE      3   /* number of announcement messages sent */
+#define RCHAN_LOST_LIMIT            8   /* number of packets lost in a row until searching for the network */
+
+#define RCHAN_SAMPLE_PERIOD_MS      (RNET_CONFIG_CHANNEL_HOP_EVAL_PERIOD_MS/(RCHAN_NOF_CHANNELS*RCHAN_NOF_SAMPLES_PER_EVAL))
+#define RCHAN_SAMPLE_PERIOD_TICKS   ((RCHAN_SAMPLE_PERIOD_MS/portTICK_RATE_MS)>0?(RCHAN_SAMPLE_PERIOD_MS/portTICK_RATE_MS):1)
+#define RCHAN_EVAL_PERIOD_TICKS     (RNET_CONFIG_CHANNEL_HOP_EVAL_PERIOD_MS/portTICK_RATE_MS)
+
+/* command message, in the NWK payload: <cmd><channel index><delay (10 ms)> */
+#define RCHAN_CMD_HOP               0x01
+#define RCHAN_CMD_HOP_SIZE          3
+
+/* exponentially weighted moving average with weight 1/8, values 0..255 */
+#define RCHAN_EWMA(avg, val)        ((uint8_t)(((uint16_t)(avg)*7+(val))/8))
+
+typedef struct {
+  uint8_t busy;      /* RPD samples above -64 dBm, 0 (never)..255 (always) */
+  uint8_t txCost;    /* retransmissions per packet, 0 (none)..255 (packet lost) */
+  uint16_t nofTx;    /* number of packets sent on this channel */
+  uint16_t nofLost;  /* number of packets lost on this channel */
+} RCHAN_QualityDesc;
+
+static RCHAN_QualityDesc RCHAN_Quality[RCHAN_NOF_CHANNELS];
+static uint8_t RCHAN_CurrIdx; /* index of the channel in use */
+static uint8_t RCHAN_SampleIdx; /* index of the channel to be sampled next */
+static portTickType RCHAN_LastSampleTick, RCHAN_LastEvalTick;
+static bool RCHAN_HopPending; /* TRUE if a channel change is scheduled */
+static uint8_t RCHAN_HopIdx; /* new channel index of the pending change */
+static portTickType RCHAN_HopStartTick, RCHAN_HopDelayTicks;
+static uint8_t RCHAN_NofLostInRow; /* packets lost in a row: we might have missed a channel change */
+static uint16_t RCHAN_NofHops; /* number of channel changes */
+
+static uint8_t RCHAN_ChannelOfIdx(uint8_t idx) {
+  return (uint8_t)(RNET_CONFIG_TRANSCEIVER_CHANNEL+idx*RNET_CONFIG_CHANNEL_HOP_SPACING); /* at most 125, checked in RNetConf.h */
+}
+
+static uint16_t RCHAN_Score(uint8_t idx) {
+  return (uint16_t)(RCHAN_Quality[idx].busy+RCHAN_Quality[idx].txCost); /* lower is better */
+}
+
+static void RCHAN_ScheduleHop(uint8_t idx, uint16_t delayMs) {
+  RCHAN_HopIdx = idx;
+  RCHAN_HopStartTick = %@RTOS@'ModuleName'%.xTaskGetTickCount();
+  RCHAN_HopDelayTicks = (portTickType)(delayMs/portTICK_RATE_MS);
+  RCHAN_HopPending = TRUE;
+}
+
+static void RCHAN_SwitchTo(uint8_t idx) {
+  RCHAN_HopPending = FALSE;
+  RCHAN_CurrIdx = idx;
+  RCHAN_NofLostInRow = 0;
+  RCHAN_NofHops++;
+  RCHAN_LastEvalTick = %@RTOS@'ModuleName'%.xTaskGetTickCount(); /* give the new channel a full evaluation period */
+  (void)RADIO_SetChannel(RCHAN_ChannelOfIdx(idx));
+}
+
+uint8_t RCHAN_GetChannel(void) {
+  return RCHAN_ChannelOfIdx(RCHAN_CurrIdx);
+}
+
+void RCHAN_OnTxDone(uint8_t nofRetransmits, bool lost) {
+  RCHAN_QualityDesc *q = &RCHAN_Quality[RCHAN_CurrIdx];
+  uint8_t cost;
+
+  q->nofTx++;
+  if (lost) {
+    q->nofLost++;
+    cost = 255;
+    if (RCHAN_NofLostInRow<0xff) {
+      RCHAN_NofLostInRow++;
+    }
+  } else {
+    cost = (uint8_t)(nofRetransmits>15?240:nofRetransmits*16);
+    RCHAN_NofLostInRow = 0;
+  }
+  q->txCost = RCHAN_EWMA(q->txCost, cost);
+#if !RNET_CONFIG_CHANNEL_HOP_MASTER
+  if (RCHAN_NofLostInRow>=RCHAN_LOST_LIMIT && !RCHAN_HopPending) {
+    /* the master probably changed the channel without us: search the network on the next channel */
+    RCHAN_NofLostInRow = 0;
+    RCHAN_ScheduleHop((uint8_t)((RCHAN_CurrIdx+1)%%RCHAN_NOF_CHANNELS), 0);
+  }
+#endif
+}
+
+uint8_t RCHAN_OnPacketRx(RPHY_PacketDesc *packet) {
+  uint8_t *data;
+
+  if (RPHY_BUF_SIZE(packet->phyData)<RMAC_HEADER_SIZE+RNWK_HEADER_SIZE+RCHAN_CMD_HOP_SIZE) {
+    return ERR_FAULT; /* too short for a command */
+  }
+  data = RNWK_BUF_PAYLOAD_START(packet->phyData);
+  if (data[0]!=RCHAN_CMD_HOP) {
+    return ERR_FAULT; /* unknown command */
+  }
+  if (data[1]>=RCHAN_NOF_CHANNELS) {
+    return ERR_RANGE; /* different channel configuration? */
+  }
+  if (data[1]==RCHAN_CurrIdx || (RCHAN_HopPending && data[1]==RCHAN_HopIdx)) {
+    return ERR_OK; /* repeated announcement */
+  }
+  RCHAN_ScheduleHop(data[1], (uint16_t)(data[2]*10));
+  return ERR_OK;
+}
+
+uint8_t RCHAN_HopTo(uint8_t idx) {
+  uint8_t buf[RNWK_BUFFER_SIZE];
+  uint8_t *data;
+  uint8_t i, res = ERR_OK;
+
+  if (idx>=RCHAN_NOF_CHANNELS) {
+    return ERR_RANGE;
+  }
+  data = RNWK_BUF_PAYLOAD_START(buf);
+  data[0] = RCHAN_CMD_HOP;
+  data[1] = idx;
+  data[2] = RCHAN_HOP_DELAY_MS/10;
+  /* announce it on the current channel several times, as broadcasts might get lost */
+  for(i=0;i<RCHAN_HOP_NOF_ANNOUNCE;i++) {
+    if (RNWK_PutCmdPayload(buf, sizeof(buf), RCHAN_CMD_HOP_SIZE, RNWK_ADDR_BROADCAST, RPHY_PACKET_FLAGS_NONE)!=ERR_OK) {
+      res = ERR_FAILED;
+    }
+  }
+  RCHAN_ScheduleHop(idx, RCHAN_HOP_DELAY_MS);
+  return res;
+}
+
+#if RNET_CONFIG_CHANNEL_HOP_MASTER
+static void RCHAN_Evaluate(void) {
+  uint8_t i, best;
+  uint16_t score, bestScore, currScore;
+
+  for(i=0;i<RCHAN_NOF_CHANNELS;i++) {
+    if (i!=RCHAN_CurrIdx) { /* retransmission costs of unused channels get outdated: let them fade out */
+      RCHAN_Quality[i].txCost = RCHAN_EWMA(RCHAN_Quality[i].txCost, 0);
+    }
+  }
+  currScore = RCHAN_Score(RCHAN_CurrIdx);
+  best = RCHAN_CurrIdx;
+  bestScore = currScore;
+  for(i=0;i<RCHAN_NOF_CHANNELS;i++) {
+    score = RCHAN_Score(i);
+    if (score<bestScore) {
+      best = i;
+      bestScore = score;
+    }
+  }
+  if (best!=RCHAN_CurrIdx && bestScore+RCHAN_HOP_HYSTERESIS<currScore) {
+    (void)RCHAN_HopTo(best);
+  }
+}
+#endif
+
+void RCHAN_Process(void) {
+  portTickType now;
+  uint8_t busy, res;
+
+  now = %@RTOS@'ModuleName'%.xTaskGetTickCount();
+  if (RCHAN_HopPending) {
+    /* switch after the delay, and after the announcements have been sent */
+    if ((portTickType)(now-RCHAN_HopStartTick)>=RCHAN_HopDelayTicks && RADIO_CanDoPowerDown()) {
+      RCHAN_SwitchTo(RCHAN_HopIdx);
+    }
+    return;
+  }
+  if ((portTickType)(now-RCHAN_LastSampleTick)>=RCHAN_SAMPLE_PERIOD_TICKS) {
+    res = RADIO_SampleChannel(RCHAN_ChannelOfIdx(RCHAN_SampleIdx), &busy); /* only possible if the radio is idle */
+    if (res==ERR_OK) {
+      RCHAN_Quality[RCHAN_SampleIdx].busy = RCHAN_EWMA(RCHAN_Quality[RCHAN_SampleIdx].busy, busy);
+      RCHAN_SampleIdx = (uint8_t)((RCHAN_SampleIdx+1)%%RCHAN_NOF_CHANNELS);
+      RCHAN_LastSampleTick = now;
+    } else if (res==ERR_DISABLED) { /* no quiet time to leave the channel: continue with the next one */
+      RCHAN_SampleIdx = (uint8_t)((RCHAN_SampleIdx+1)%%RCHAN_NOF_CHANNELS);
+    }
+  }
+#if RNET_CONFIG_CHANNEL_HOP_MASTER
+  if ((portTickType)(now-RCHAN_LastEvalTick)>=RCHAN_EVAL_PERIOD_TICKS && RADIO_CanDoPowerDown()) {
+    RCHAN_LastEvalTick = now;
+    RCHAN_Evaluate();
+  }
+#endif
+}
+
+%if defined(Shell)
+static uint8_t PrintHelp(const %@Shell@'ModuleName'%.StdIOType *io) {
+  %@Shell@'ModuleName'%.SendHelpStr((unsigned char*)"rchan", (unsigned char*)"Group of rchan commands\r\n", io->stdOut);
+  %@Shell@'ModuleName'%.SendHelpStr((unsigned char*)"  help|status", (unsigned char*)"Shows help or status\r\n", io->stdOut);
+  %@Shell@'ModuleName'%.SendHelpStr((unsigned char*)"  hop <idx>", (unsigned char*)"Announces and switches to the candidate channel with the given index\r\n", io->stdOut);
+  return ERR_OK;
+}
+
+static uint8_t PrintStatus(const %@Shell@'ModuleName'%.StdIOType *io) {
+  uint8_t buf[48], title[16];
+  uint8_t i;
+
+  %@Shell@'ModuleName'%.SendStatusStr((unsigned char*)"rchan", (unsigned char*)"\r\n", io->stdOut);
+  %@Shell@'ModuleName'%.SendStatusStr((unsigned char*)"  role", RNET_CONFIG_CHANNEL_HOP_MASTER?(unsigned char*)"master\r\n":(unsigned char*)"follower\r\n", io->stdOut);
+
+  %@Utility@'ModuleName'%.Num8uToStr(buf, sizeof(buf), RCHAN_GetChannel());
+  %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)", hops: ");
+  %@Utility@'ModuleName'%.strcatNum16u(buf, sizeof(buf), RCHAN_NofHops);
+  if (RCHAN_HopPending) {
+    %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)", next: ");
+    %@Utility@'ModuleName'%.strcatNum8u(buf, sizeof(buf), RCHAN_ChannelOfIdx(RCHAN_HopIdx));
+  }
+  %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)"\r\n");
+  %@Shell@'ModuleName'%.SendStatusStr((unsigned char*)"  channel", buf, io->stdOut);
+
+  for(i=0;i<RCHAN_NOF_CHANNELS;i++) {
+    %@Utility@'ModuleName'%.strcpy(title, sizeof(title), (unsigned char*)"  ");
+    %@Utility@'ModuleName'%.strcatNum8u(title, sizeof(title), i);
+    %@Utility@'ModuleName'%.strcat(title, sizeof(title), (unsigned char*)": ch ");
+    %@Utility@'ModuleName'%.strcatNum8u(title, sizeof(title), RCHAN_ChannelOfIdx(i));
+    %@Utility@'ModuleName'%.strcpy(buf, sizeof(buf), (unsigned char*)"score ");
+    %@Utility@'ModuleName'%.strcatNum16u(buf, sizeof(buf), RCHAN_Score(i));
+    %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)", busy ");
+    %@Utility@'ModuleName'%.strcatNum8u(buf, sizeof(buf), RCHAN_Quality[i].busy);
+    %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)", tx ");
+    %@Utility@'ModuleName'%.strcatNum16u(buf, sizeof(buf), RCHAN_Quality[i].nofTx);
+    %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)", lost ");
+    %@Utility@'ModuleName'%.strcatNum16u(buf, sizeof(buf), RCHAN_Quality[i].nofLost);
+    %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)"\r\n");
+    %@Shell@'ModuleName'%.SendStatusStr(title, buf, io->stdOut);
+  }
+  return ERR_OK;
+}
+
+uint8_t RCHAN_ParseCommand(const unsigned char *cmd, bool *handled, const %@Shell@'ModuleName'%.StdIOType *io) {
+  const unsigned char *p;
+  uint8_t val;
+
+  if (%@Utility@'ModuleName'%.strcmp((char*)cmd, (char*)%@Shell@'ModuleName'%.CMD_HELP)==0 || %@Utility@'ModuleName'%.strcmp((char*)cmd, (char*)"rchan help")==0) {
+    *handled = TRUE;
+    return PrintHelp(io);
+  } else if (%@Utility@'ModuleName'%.strcmp((char*)cmd, (char*)%@Shell@'ModuleName'%.CMD_STATUS)==0 || %@Utility@'ModuleName'%.strcmp((char*)cmd, (char*)"rchan status")==0) {
+    *handled = TRUE;
+    return PrintStatus(io);
+  } else if (%@Utility@'ModuleName'%.strncmp((char*)cmd, (char*)"rchan hop", sizeof("rchan hop")-1)==0) {
+    *handled = TRUE;
+    p = cmd+sizeof("rchan hop");
+    if (%@Utility@'ModuleName'%.ScanDecimal8uNumber(&p, &val)==ERR_OK && val<RCHAN_NOF_CHANNELS) {
+      return RCHAN_HopTo(val);
+    }
+    %@Shell@'ModuleName'%.SendStr((unsigned char*)"Wrong argument, must be a candidate channel index\r\n", io->stdErr);
+    return ERR_FAILED;
+  }
+  return ERR_OK;
+}
+%endif
+
+void RCHAN_Deinit(void) {
+  /* nothing needed */
+}
+
+void RCHAN_Init(void) {
+  uint8_t i;
+
+  for(i=0;i<RCHAN_NOF_CHANNELS;i++) {
+    RCHAN_Quality[i].busy = 0;
+    RCHAN_Quality[i].txCost = 0;
+    RCHAN_Quality[i].nofTx = 0;
+    RCHAN_Quality[i].nofLost = 0;
+  }
+  RCHAN_CurrIdx = 0; /* start with RNET_CONFIG_TRANSCEIVER_CHANNEL */
+  RCHAN_SampleIdx = 0;
+  RCHAN_LastSampleTick = RCHAN_LastEvalTick = %@RTOS@'ModuleName'%.xTaskGetTickCount();
+  RCHAN_HopPending = FALSE;
+  RCHAN_NofLostInRow = 0;
+  RCHAN_NofHops = 0;
+}
+#endif /* RNET_CONFIG_CHANNEL_HOPPING */
@@ -0,0 +1,79 @@
+/**
+ * \file
+ * \brief Adaptive channel selection and channel hopping for the radio network.
+ * \author (c) 2013-2014 Erich Styger, http://mcuoneclipse.com/
+ * \note MIT License (http://opensource.org/licenses/mit-license.html), see 'RNet_License.txt'
+ *
+ * The network uses RNET_CONFIG_CHANNEL_HOP_NOF candidate channels, starting with RNET_CONFIG_TRANSCEIVER_CHANNEL
+ * and RNET_CONFIG_CHANNEL_HOP_SPACING channels apart. For each candidate, the link quality is tracked:
+ * - the channel occupancy, sampled periodically with the received power detector (RPD) of the transceiver,
+ * - the number of retransmissions and lost packets (OBSERVE_TX) while the channel is in use.
+ * The channel master (RNET_CONFIG_CHANNEL_HOP_MASTER) compares the channels every RNET_CONFIG_CHANNEL_HOP_EVAL_PERIOD_MS.
+ * If another channel is clearly better, it announces the new channel with a broadcast command message and
+ * all nodes switch after a short delay. A node which misses the announcement notices it by the lost packets
+ * and searches the candidate channels.
+ */
+
+#ifndef RCHAN_H_
+#define RCHAN_H_
+
+#include "RNetConf.h"
+#if RNET_CONFIG_CHANNEL_HOPPING
+#include "RPHY.h"
+
+#define RCHAN_NOF_CHANNELS   (RNET_CONFIG_CHANNEL_HOP_NOF) /* number of candidate channels */
+
+/*!
+ * \brief Called by the radio for each packet sent, to update the link quality of the current channel.
+ * \param nofRetransmits Number of retransmissions needed for the packet.
+ * \param lost TRUE if the packet has not been acknowledged at all.
+ */
+void RCHAN_OnTxDone(uint8_t nofRetransmits, bool lost);
+
+/*!
+ * \brief Called by the NWK layer for received command messages.
+ * \param packet Received packet.
+ * \return Error code, ERR_OK if the packet has been handled.
+ */
+uint8_t RCHAN_OnPacketRx(RPHY_PacketDesc *packet);
+
+/*!
+ * \brief Announces a channel change to the network and switches to the new channel.
+ * \param idx Index of the candidate channel, 0..RCHAN_NOF_CHANNELS-1.
+ * \return Error code, ERR_OK if everything is fine.
+ */
+uint8_t RCHAN_HopTo(uint8_t idx);
+
+/*!
+ * \brief Returns the radio channel in use.
+ * \return Channel number.
+ */
+uint8_t RCHAN_GetChannel(void);
+
+/*!
+ * \brief Samples the channels, evaluates the link quality and performs pending channel changes.
+ * Called from RADIO_Process().
+ */
+void RCHAN_Process(void);
+
+%if defined(Shell)
+#include "%@Shell@'ModuleName'.h"
+/*!
+ * \brief Parses a command
+ * \param cmd Command string to be parsed
+ * \param handled Sets this variable to TRUE if command was handled
+ * \param io I/O stream to be used for input/output
+ * \return Error code, ERR_OK if everything was fine
+ */
+uint8_t RCHAN_ParseCommand(const unsigned char *cmd, bool *handled, const %@Shell@'ModuleName'%.StdIOType *io);
+%endif
+
+/*! \brief Initializes the module */
+void RCHAN_Init(void);
+
+/*! \brief Deinitializes the module */
+void RCHAN_Deinit(void);
+
+#endif /* RNET_CONFIG_CHANNEL_HOPPING */
+
+#endif /* RCHAN_H_ */
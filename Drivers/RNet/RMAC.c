@@ -12,10 +12,76 @@
 #include "RPHY.h"
 #include "RNWK.h"
 #include "%@Utility@'ModuleName'.h"
+#if RNET_CONFIG_LPL
+#include "RMSG.h"
+#include "Radio.h"
+#include "%@RTOS@'ModuleName'.h"
+#endif
 
 static uint8_t RMAC_SeqNr = 0;
 static uint8_t RMAC_ExpectedAckSeqNr;
 
+#if RNET_CONFIG_LPL
+#define RMAC_LPL_PERIOD_TICKS     (RNET_CONFIG_LPL_WAKEUP_PERIOD_MS/portTICK_RATE_MS)
+#define RMAC_LPL_LISTEN_TICKS     ((RNET_CONFIG_LPL_LISTEN_MS/portTICK_RATE_MS)>0?(RNET_CONFIG_LPL_LISTEN_MS/portTICK_RATE_MS):1)
+
+static bool RMAC_LplSleeping; /* TRUE if the transceiver has been powered down by the MAC */
+static portTickType RMAC_LplPeriodStartTick; /* start of the current wake-up period */
+static portTickType RMAC_LplAwakeStartTick;  /* time the transceiver has been woken up */
+static portTickType RMAC_LplListenStartTick; /* start of the listen window, moved with every packet */
+static uint32_t RMAC_LplRadioOnTicks; /* accumulated time the transceiver has been powered */
+static uint32_t RMAC_LplNofDelivered; /* number of packets sent and received */
+
+static void RMAC_LplOnActivity(void) {
+  RMAC_LplNofDelivered++;
+  RMAC_LplListenStartTick = %@RTOS@'ModuleName'%.xTaskGetTickCount(); /* more packets might follow: keep listening */
+}
+
+void RMAC_LplOnTxDone(void) {
+  RMAC_LplOnActivity();
+}
+
+bool RMAC_LplIsSleeping(void) {
+  return RMAC_LplSleeping;
+}
+
+void RMAC_LplProcess(void) {
+  portTickType now;
+
+  now = %@RTOS@'ModuleName'%.xTaskGetTickCount();
+  if (RMAC_LplSleeping) {
+    if ((portTickType)(now-RMAC_LplPeriodStartTick)>=RMAC_LPL_PERIOD_TICKS) { /* time for the next listen window */
+      RMAC_LplPeriodStartTick += RMAC_LPL_PERIOD_TICKS;
+      if ((portTickType)(now-RMAC_LplPeriodStartTick)>=RMAC_LPL_PERIOD_TICKS) {
+        RMAC_LplPeriodStartTick = now; /* missed listen windows, restart the schedule */
+      }
+    } else if (RMSG_TxQueueNofItems()==0) {
+      return; /* nothing to send, keep sleeping */
+    }
+    RMAC_LplSleeping = FALSE;
+    RMAC_LplAwakeStartTick = now; /* the start up counts as radio-on time */
+    (void)RADIO_Wakeup();
+    RMAC_LplListenStartTick = %@RTOS@'ModuleName'%.xTaskGetTickCount(); /* the receiver listens from standby on */
+  } else if ((portTickType)(now-RMAC_LplListenStartTick)>=RMAC_LPL_LISTEN_TICKS) {
+    if (RADIO_Sleep()==ERR_OK) { /* only possible if there is no pending traffic */
+      RMAC_LplSleeping = TRUE;
+      RMAC_LplRadioOnTicks += (portTickType)(now-RMAC_LplAwakeStartTick);
+    }
+  }
+}
+
+uint32_t RMAC_LplTicksToNextEvent(void) {
+  portTickType elapsed;
+
+  if (RMAC_LplSleeping) {
+    elapsed = (portTickType)(%@RTOS@'ModuleName'%.xTaskGetTickCount()-RMAC_LplPeriodStartTick);
+    return (elapsed>=RMAC_LPL_PERIOD_TICKS)?0:(uint32_t)(RMAC_LPL_PERIOD_TICKS-elapsed);
+  }
+  elapsed = (portTickType)(%@RTOS@'ModuleName'%.xTaskGetTickCount()-RMAC_LplListenStartTick);
+  return (elapsed>=RMAC_LPL_LISTEN_TICKS)?1:(uint32_t)(RMAC_LPL_LISTEN_TICKS-elapsed); /* poll while traffic keeps us awake */
+}
+#endif /* RNET_CONFIG_LPL */
+
 uint8_t RMAC_PutPayload(uint8_t *buf, size_t bufSize, uint8_t payloadSize, RPHY_FlagsType flags) {
   if (flags&RPHY_PACKET_FLAGS_REQ_ACK) {
     RMAC_BUF_TYPE(buf) = RMAC_MSG_TYPE_DATA|RMAC_MSG_TYPE_REQ_ACK;
@@ -27,7 +93,16 @@ uint8_t RMAC_PutPayload(uint8_t *buf, size_t bufSize, uint8_t payloadSize, RPHY_
   return RPHY_PutPayload(buf, bufSize, payloadSize+RMAC_HEADER_SIZE, flags);
 }
 
+uint8_t RMAC_PutCmdPayload(uint8_t *buf, size_t bufSize, uint8_t payloadSize, RPHY_FlagsType flags) {
+  RMAC_BUF_TYPE(buf) = RMAC_MSG_TYPE_CMD; /* command messages are not acknowledged by the NWK layer */
+  RMAC_BUF_SEQN(buf) = RMAC_SeqNr++;
+  return RPHY_PutPayload(buf, bufSize, payloadSize+RMAC_HEADER_SIZE, flags);
+}
+
 uint8_t RMAC_OnPacketRx(RPHY_PacketDesc *packet) {
+#if RNET_CONFIG_LPL
+  RMAC_LplOnActivity();
+#endif
   return RNWK_OnPacketRx(packet); /* pass data packet up the stack */
 }
 
@@ -87,6 +162,59 @@ void RMAC_DecodeType(uint8_t *buf, size_t bufSize, RPHY_PacketDesc *packet) {
   %@Utility@'ModuleName'%.chcat(buf, bufSize, ')');
 }
 
+%if defined(Shell)
+static uint8_t PrintHelp(const %@Shell@'ModuleName'%.StdIOType *io) {
+  %@Shell@'ModuleName'%.SendHelpStr((unsigned char*)"rmac", (unsigned char*)"Group of rmac commands\r\n", io->stdOut);
+  %@Shell@'ModuleName'%.SendHelpStr((unsigned char*)"  help|status", (unsigned char*)"Shows help or status\r\n", io->stdOut);
+  return ERR_OK;
+}
+
+static uint8_t PrintStatus(const %@Shell@'ModuleName'%.StdIOType *io) {
+  uint8_t buf[48];
+#if RNET_CONFIG_LPL
+  uint32_t onMs;
+#endif
+
+  %@Shell@'ModuleName'%.SendStatusStr((unsigned char*)"rmac", (unsigned char*)"\r\n", io->stdOut);
+
+  %@Utility@'ModuleName'%.Num8uToStr(buf, sizeof(buf), RMAC_SeqNr);
+  %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)"\r\n");
+  %@Shell@'ModuleName'%.SendStatusStr((unsigned char*)"  seq#", buf, io->stdOut);
+#if RNET_CONFIG_LPL
+  %@Utility@'ModuleName'%.Num16uToStr(buf, sizeof(buf), RNET_CONFIG_LPL_LISTEN_MS);
+  %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)" ms every ");
+  %@Utility@'ModuleName'%.strcatNum16u(buf, sizeof(buf), RNET_CONFIG_LPL_WAKEUP_PERIOD_MS);
+  %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), RMAC_LplSleeping?(unsigned char*)" ms, sleeping\r\n":(unsigned char*)" ms, awake\r\n");
+  %@Shell@'ModuleName'%.SendStatusStr((unsigned char*)"  LPL", buf, io->stdOut);
+
+  onMs = RMAC_LplRadioOnTicks*portTICK_RATE_MS;
+  %@Utility@'ModuleName'%.Num32uToStr(buf, sizeof(buf), onMs);
+  %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)" ms, ");
+  %@Utility@'ModuleName'%.strcatNum32u(buf, sizeof(buf), RMAC_LplNofDelivered);
+  %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)" packets");
+  if (RMAC_LplNofDelivered!=0) {
+    %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)", ");
+    %@Utility@'ModuleName'%.strcatNum32u(buf, sizeof(buf), onMs/RMAC_LplNofDelivered);
+    %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)" ms/packet");
+  }
+  %@Utility@'ModuleName'%.strcat(buf, sizeof(buf), (unsigned char*)"\r\n");
+  %@Shell@'ModuleName'%.SendStatusStr((unsigned char*)"  radio on", buf, io->stdOut);
+#endif
+  return ERR_OK;
+}
+
+uint8_t RMAC_ParseCommand(const unsigned char *cmd, bool *handled, const %@Shell@'ModuleName'%.StdIOType *io) {
+  if (%@Utility@'ModuleName'%.strcmp((char*)cmd, (char*)%@Shell@'ModuleName'%.CMD_HELP)==0 || %@Utility@'ModuleName'%.strcmp((char*)cmd, (char*)"rmac help")==0) {
+    *handled = TRUE;
+    return PrintHelp(io);
+  } else if (%@Utility@'ModuleName'%.strcmp((char*)cmd, (char*)%@Shell@'ModuleName'%.CMD_STATUS)==0 || %@Utility@'ModuleName'%.strcmp((char*)cmd, (char*)"rmac status")==0) {
+    *handled = TRUE;
+    return PrintStatus(io);
+  }
+  return ERR_OK;
+}
+%endif
+
 void RMAC_Deinit(void) {
   /* nothing needed */
 }
@@ -94,4 +222,10 @@ void RMAC_Deinit(void) {
 void RMAC_Init(void) {
   RMAC_SeqNr = 0;
   RMAC_ExpectedAckSeqNr = 0;
+#if RNET_CONFIG_LPL
+  RMAC_LplSleeping = FALSE;
+  RMAC_LplPeriodStartTick = RMAC_LplAwakeStartTick = RMAC_LplListenStartTick = %@RTOS@'ModuleName'%.xTaskGetTickCount();
+  RMAC_LplRadioOnTicks = 0;
+  RMAC_LplNofDelivered = 0;
+#endif
 }
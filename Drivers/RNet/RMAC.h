@@ -58,6 +58,16 @@ uint8_t RMAC_OnPacketRx(RPHY_PacketDesc *packet);
  */
 uint8_t RMAC_PutPayload(uint8_t *buf, size_t bufSize, uint8_t payloadSize, RPHY_FlagsType flags);
 
+/*!
+ * \brief Puts a command message for the network stack itself (e.g. channel hopping) into a buffer to be sent later.
+ * \param[in] buf Buffer with the data, must be of RMAC_BUFFER_SIZE.
+ * \param[in] bufSize Buffer size.
+ * \param[in] payloadSize Size of MAC payload data.
+ * \param[in] flags Packet flags
+ * \return Error code, ERR_OK if everything is ok, ERR_OVERFLOW if buffer is too small.
+ */
+uint8_t RMAC_PutCmdPayload(uint8_t *buf, size_t bufSize, uint8_t payloadSize, RPHY_FlagsType flags);
+
 /*!
  * \brief Sends an acknowledge message for the received MAC payload data.
  * \param[in] packet Packet data for which we need to send the ack.
@@ -97,6 +107,41 @@ void RMAC_SniffPacket(RPHY_PacketDesc *packet, bool isTx);
  */
 void RMAC_DecodeType(uint8_t *buf, size_t bufSize, RPHY_PacketDesc *packet);
 
+#if RNET_CONFIG_LPL
+/*!
+ * \brief Low power listening: wakes up the transceiver for the next listen window or for packets to be sent,
+ * and powers it down again after the listen window. Called from RADIO_Process().
+ */
+void RMAC_LplProcess(void);
+
+/*!
+ * \brief Returns the time until RMAC_LplProcess() needs to be called again.
+ * \return Number of RTOS ticks.
+ */
+uint32_t RMAC_LplTicksToNextEvent(void);
+
+/*!
+ * \brief Low power listening state.
+ * \return TRUE if the transceiver is powered down between two listen windows.
+ */
+bool RMAC_LplIsSleeping(void);
+
+/*! \brief Called by the radio for each packet sent and acknowledged by the receiver. */
+void RMAC_LplOnTxDone(void);
+#endif
+
+%if defined(Shell)
+#include "%@Shell@'ModuleName'.h"
+/*!
+ * \brief Parses a command
+ * \param cmd Command string to be parsed
+ * \param handled Sets this variable to TRUE if command was handled
+ * \param io I/O stream to be used for input/output
+ * \return Error code, ERR_OK if everything was fine
+ */
+uint8_t RMAC_ParseCommand(const unsigned char *cmd, bool *handled, const %@Shell@'ModuleName'%.StdIOType *io);
+%endif
+
 /*! \brief Initializes the module */
 void RMAC_Init(void);
 
@@ -14,6 +14,7 @@
   #include "RTOSTRC1.h"
 #endif
 #include "RPHY.h"
+#include "Radio.h"
 
 /* Configuration for tx and rx queues */
 #define RMSG_QUEUE_RX_NOF_ITEMS   (RNET_CONFIG_MSG_QUEUE_NOF_RX_ITEMS) /* number of items in the queue */
@@ -64,7 +65,7 @@ uint8_t RMSG_QueuePut(uint8_t *buf, size_t bufSize, uint8_t payloadSize, bool fr
   RPHY_BUF_FLAGS(buf) = flags;
   RPHY_BUF_SIZE(buf) = payloadSize;
   if (fromISR) {
-    signed portBASE_TYPE pxHigherPriorityTaskWoken;
+    signed portBASE_TYPE pxHigherPriorityTaskWoken = pdFALSE;
     
     if (toBack) {
       qRes = %@RTOS@'ModuleName'%.xQueueSendToBackFromISR(queue, buf, &pxHigherPriorityTaskWoken);
@@ -74,7 +75,10 @@ uint8_t RMSG_QueuePut(uint8_t *buf, size_t bufSize, uint8_t payloadSize, bool fr
     if (qRes!=pdTRUE) {
       /* was not able to send to the queue. Well, not much we can do here... */
       res = ERR_BUSY;
+    } else {
+      RADIO_NotifyFromISR(); /* wake up radio task to send or process it */
     }
+    portEND_SWITCHING_ISR(pxHigherPriorityTaskWoken);
   } else {
     if (toBack) {
       qRes = %@RTOS@'ModuleName'%.xQueueSendToBack(queue, buf, RMSG_QUEUE_PUT_WAIT);
@@ -83,6 +87,8 @@ uint8_t RMSG_QueuePut(uint8_t *buf, size_t bufSize, uint8_t payloadSize, bool fr
     }
     if (qRes!=pdTRUE) {
       res = ERR_BUSY;
+    } else {
+      RADIO_Notify(); /* wake up radio task to send or process it */
     }
   }
   return res;
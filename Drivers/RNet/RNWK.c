@@ -12,6 +12,7 @@
 #include "RMAC.h"
 #include "RNWK.h"
 #include "RAPP.h"
+#include "RChan.h"
 #include "%@Utility@'ModuleName'.h"
 
 static RNWK_ShortAddrType RNWK_ThisNodeAddr = RNWK_ADDR_BROADCAST; /* address of this network node */
@@ -40,6 +41,15 @@ uint8_t RNWK_PutPayload(uint8_t *buf, size_t bufSize, uint8_t payloadSize, RNWK_
   return RMAC_PutPayload(buf, bufSize, payloadSize+RNWK_HEADER_SIZE, flags);
 }
 
+uint8_t RNWK_PutCmdPayload(uint8_t *buf, size_t bufSize, uint8_t payloadSize, RNWK_ShortAddrType dstAddr, RPHY_FlagsType flags) {
+  RNWK_ShortAddrType srcAddr;
+  
+  srcAddr = RNWK_GetThisNodeAddr();
+  RNWK_BUF_SET_SRC_ADDR(buf, srcAddr);
+  RNWK_BUF_SET_DST_ADDR(buf, dstAddr);
+  return RMAC_PutCmdPayload(buf, bufSize, payloadSize+RNWK_HEADER_SIZE, flags);
+}
+
 uint8_t RNWK_SendACK(RPHY_PacketDesc *rxPacket, RNWK_ShortAddrType saddr) {
   RNWK_ShortAddrType addr;
   uint8_t buf[RMAC_BUFFER_SIZE];
@@ -76,6 +86,10 @@ uint8_t RNWK_OnPacketRx(RPHY_PacketDesc *packet) {
 #endif
         return RNWK_AppOnRxCallback(packet); /* call upper layer */
       }
+#if RNET_CONFIG_CHANNEL_HOPPING
+    } else if (RMAC_MSG_TYPE_IS_CMD(type)) { /* command for the network stack */
+      return RCHAN_OnPacketRx(packet);
+#endif
     } else {
       return ERR_FAULT; /* wrong message type? */
     }
@@ -78,6 +78,16 @@ uint8_t RNWK_OnPacketRx(RPHY_PacketDesc *packet);
  */
 uint8_t RNWK_PutPayload(uint8_t *buf, size_t bufSize, uint8_t payloadSize, RNWK_ShortAddrType dstAddr, RPHY_FlagsType flags);
 
+/*!
+ * \brief Puts a command message for the network stack into the buffer queue to be sent asynchronously.
+ * \param buf Message buffer with payload.
+ * \param bufSize Size of message buffer, must be of RNWK_BUFFER_SIZE.
+ * \param payloadSize Size of the payload in bytes.
+ * \param dstAddr Destination node address.
+ * \param flags Packet flags.
+ */
+uint8_t RNWK_PutCmdPayload(uint8_t *buf, size_t bufSize, uint8_t payloadSize, RNWK_ShortAddrType dstAddr, RPHY_FlagsType flags);
+
 %if defined(Shell)
 #include "%@Shell@'ModuleName'.h"
 uint8_t RNWK_ParseCommand(const unsigned char *cmd, bool *handled, const %@Shell@'ModuleName'%.StdIOType *io);
@@ -128,6 +128,102 @@
   /*!< Blocking time for putting items into the message queue before timeout. Use portMAX_DELAY for blocking. */
 #endif
 
+#ifndef RNET_CONFIG_LPL
+%if defined(LplEnabled) & %LplEnabled='yes'
+#define RNET_CONFIG_LPL                 (1)
+%else
+#define RNET_CONFIG_LPL                 (0)
+%endif
+  /*!< 1 for the duty-cycled low power listening MAC (nRF24L01+ only), 0 for a receiver always on. */
+#endif
+
+#if RNET_CONFIG_LPL
+#ifndef RNET_CONFIG_LPL_WAKEUP_PERIOD_MS
+%if defined(LplWakeupPeriodMs)
+#define RNET_CONFIG_LPL_WAKEUP_PERIOD_MS (%LplWakeupPeriodMs)
+%else
+#define RNET_CONFIG_LPL_WAKEUP_PERIOD_MS (250)
+%endif
+  /*!< Time between two listen windows (ms): maximum latency to reach a sleeping node */
+#endif
+
+#ifndef RNET_CONFIG_LPL_LISTEN_MS
+%if defined(LplListenMs)
+#define RNET_CONFIG_LPL_LISTEN_MS       (%LplListenMs)
+%else
+#define RNET_CONFIG_LPL_LISTEN_MS       (5)
+%endif
+  /*!< Time (ms) the receiver listens after waking up, not counting the 1.5 ms start up of the transceiver. Duty cycle is about (RNET_CONFIG_LPL_LISTEN_MS+2)/RNET_CONFIG_LPL_WAKEUP_PERIOD_MS */
+#endif
+
+#if RNET_CONFIG_TRANSCEIVER_TYPE!=RNET_CONFIG_TRANSCEIVER_NRF24
+  #error "low power listening is only supported for the nRF24L01+"
+#endif
+#endif /* RNET_CONFIG_LPL */
+
+#ifndef RNET_CONFIG_CHANNEL_HOPPING
+%if defined(ChannelHoppingEnabled) & %ChannelHoppingEnabled='yes'
+#define RNET_CONFIG_CHANNEL_HOPPING     (1)
+%else
+#define RNET_CONFIG_CHANNEL_HOPPING     (0)
+%endif
+  /*!< 1 for adaptive channel selection and channel hopping (nRF24L01+ only), 0 for a fixed channel. */
+#endif
+
+#if RNET_CONFIG_CHANNEL_HOPPING
+#ifndef RNET_CONFIG_CHANNEL_HOP_NOF
+%if defined(ChannelHopNofChannels)
+#define RNET_CONFIG_CHANNEL_HOP_NOF     (%ChannelHopNofChannels)
+%else
+#define RNET_CONFIG_CHANNEL_HOP_NOF     (4)
+%endif
+  /*!< Number of candidate channels, the first one is RNET_CONFIG_TRANSCEIVER_CHANNEL */
+#endif
+
+#ifndef RNET_CONFIG_CHANNEL_HOP_SPACING
+%if defined(ChannelHopSpacing)
+#define RNET_CONFIG_CHANNEL_HOP_SPACING (%ChannelHopSpacing)
+%else
+#define RNET_CONFIG_CHANNEL_HOP_SPACING (25)
+%endif
+  /*!< Distance between the candidate channels */
+#endif
+
+#ifndef RNET_CONFIG_CHANNEL_HOP_EVAL_PERIOD_MS
+%if defined(ChannelHopEvalPeriodMs)
+#define RNET_CONFIG_CHANNEL_HOP_EVAL_PERIOD_MS (%ChannelHopEvalPeriodMs)
+%else
+#define RNET_CONFIG_CHANNEL_HOP_EVAL_PERIOD_MS (10000)
+%endif
+  /*!< Period (ms) the channel master compares the link quality of the channels */
+#endif
+
+#ifndef RNET_CONFIG_CHANNEL_HOP_QUIET_MS
+%if defined(ChannelHopQuietMs)
+#define RNET_CONFIG_CHANNEL_HOP_QUIET_MS (%ChannelHopQuietMs)
+%else
+#define RNET_CONFIG_CHANNEL_HOP_QUIET_MS (100)
+%endif
+  /*!< The node does not receive while it samples another channel: only do it after this time (ms) without traffic. 0 to sample whenever the radio is idle. */
+#endif
+
+#ifndef RNET_CONFIG_CHANNEL_HOP_MASTER
+%if defined(ChannelHopMaster) & %ChannelHopMaster='yes'
+#define RNET_CONFIG_CHANNEL_HOP_MASTER  (1)
+%else
+#define RNET_CONFIG_CHANNEL_HOP_MASTER  (0)
+%endif
+  /*!< 1 if this node decides about channel changes, 0 if it follows the announcements. Only one node in the network shall be the master. */
+#endif
+
+#if RNET_CONFIG_TRANSCEIVER_TYPE!=RNET_CONFIG_TRANSCEIVER_NRF24
+  #error "channel hopping is only supported for the nRF24L01+"
+#endif
+#if RNET_CONFIG_TRANSCEIVER_CHANNEL+(RNET_CONFIG_CHANNEL_HOP_NOF-1)*RNET_CONFIG_CHANNEL_HOP_SPACING>125
+  #error "the last candidate channel is above 125: reduce the radio channel, the number of channels or the spacing"
+#endif
+#endif /* RNET_CONFIG_CHANNEL_HOPPING */
+
 #ifndef RNET_CONFIG_REMOTE_STDIO
 %if defined(RStdioEnabled) & %RStdioEnabled='yes'
 #define RNET_CONFIG_REMOTE_STDIO        (1)
@@ -17,6 +17,7 @@
 %if defined(RStdioEnabled) & %RStdioEnabled='yes'
 #include "RStdIO.h"
 %endif
+#include "RChan.h"
 #include "RApp.h"
 
 void RSTACK_Init(void) {
@@ -28,11 +29,17 @@ void RSTACK_Init(void) {
 %if defined(RStdioEnabled) & %RStdioEnabled='yes'
   RSTDIO_Init();
 %endif
+#if RNET_CONFIG_CHANNEL_HOPPING
+  RCHAN_Init();
+#endif
   RAPP_Init();
 }
 
 void RSTACK_Deinit(void) {
   RAPP_Deinit();
+#if RNET_CONFIG_CHANNEL_HOPPING
+  RCHAN_Deinit();
+#endif
 %if defined(RStdioEnabled) & %RStdioEnabled='yes'
   RSTDIO_Deinit();
 %endif
@@ -50,11 +50,58 @@ bool RADIO_CanDoPowerDown(void);
 uint8_t RADIO_PowerDown(void);
 
 /*!
- * \brief Processes the radio state machine. Needs to be called frequently from the application (about every 10 ms).
+ * \brief Processes the radio state machine. Needs to be called frequently from the application (about every 10 ms),
+ * or whenever RADIO_WaitForEvent() returns.
  * \return Error code, ERR_OK for no failure.
  */
 uint8_t RADIO_Process(void);
 
+/*!
+ * \brief Blocks the calling task until the radio needs processing (transceiver interrupt or new Tx message) or the timeout expires.
+ * Intended for a radio task calling RADIO_Process() after each return, instead of polling.
+ * With low power listening (RNET_CONFIG_LPL) it returns at the latest for the next listen window, and blocks
+ * while the transceiver is powered down, so the FreeRTOS tickless idle mode can keep the microcontroller in low power mode.
+ * \param timeoutMs Maximum waiting time in milliseconds.
+ * \return ERR_OK if there is an event, ERR_NOTAVAIL for a timeout.
+ */
+uint8_t RADIO_WaitForEvent(uint32_t timeoutMs);
+
+/*!
+ * \brief Wakes up a task waiting in RADIO_WaitForEvent(). Not to be called from an interrupt.
+ */
+void RADIO_Notify(void);
+
+/*!
+ * \brief Same as RADIO_Notify(), but to be called from an interrupt.
+ */
+void RADIO_NotifyFromISR(void);
+
+#if RNET_CONFIG_CHANNEL_HOPPING
+/*!
+ * \brief Checks with the received power detector if a channel is in use. Only possible while the radio is idle.
+ * The radio does not receive while sampling another channel, so this is only done after RNET_CONFIG_CHANNEL_HOP_QUIET_MS without traffic.
+ * \param channel Channel to sample.
+ * \param busy Share of the received power detector readings above -64 dBm, 0 (none)..255 (all).
+ * \return Error code, ERR_OK if the channel has been sampled, ERR_BUSY if the radio is not idle, ERR_DISABLED for another channel without a quiet time.
+ */
+uint8_t RADIO_SampleChannel(uint8_t channel, uint8_t *busy);
+#endif
+
+#if RNET_CONFIG_LPL
+/*!
+ * \brief Powers down the transceiver between two listen windows, keeping its configuration.
+ * \return Error code, ERR_OK if powered down, ERR_BUSY if there is pending traffic.
+ */
+uint8_t RADIO_Sleep(void);
+
+/*!
+ * \brief Powers up the transceiver again after RADIO_Sleep(), in receive mode. Blocks the caller
+ * for the transceiver start up (Tpd2stby, 1.5 ms), so the listen window starts after it.
+ * \return Error code, ERR_OK if everything is ok.
+ */
+uint8_t RADIO_Wakeup(void);
+#endif
+
 /*! \brief Radio transceiver initialization */
 void RADIO_Init(void);
 
@@ -12,6 +12,7 @@
 #include "RadioSMAC.h"
 #include "%@SMAC@'ModuleName'.h"
 #include "%@Utility@'ModuleName'.h"
+#include "%@RTOS@'ModuleName'.h"
 #include "Event.h"
 #include "RPHY.h"
 #include "RMAC.h"
@@ -60,6 +61,22 @@ void RADIO_OnInterrupt(void) {
   }
 }
 
+void RADIO_Notify(void) {
+  /* nothing to do: the SMAC transceiver state is polled */
+}
+
+void RADIO_NotifyFromISR(void) {
+  /* nothing to do: the SMAC transceiver state is polled */
+}
+
+uint8_t RADIO_WaitForEvent(uint32_t timeoutMs) {
+  /* the SMAC transceiver state is polled, so do not wait longer than a tick */
+  if (timeoutMs>0) {
+    %@RTOS@'ModuleName'%.vTaskDelay(1);
+  }
+  return ERR_NOTAVAIL;
+}
+
 /*!
  * \brief Sets the channel number to be used
  * \param ch The channel to be used, in the range 0..15
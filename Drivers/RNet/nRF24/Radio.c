@@ -14,11 +14,17 @@
 #include "RMSG.h"
 #include "RStdIO.h"
 #include "RPHY.h"
+#include "RMAC.h"
+#include "RChan.h"
 #include "%@Utility@'ModuleName'.h"
+#include "%@RTOS@'ModuleName'.h"
 #include "Events.h" /* for event handler interface */
 
 #define NRF24_DYNAMIC_PAYLOAD  1 /* if set to one, use dynamic payload size */
 #define RADIO_CHANNEL_DEFAULT  RNET_CONFIG_TRANSCEIVER_CHANNEL  /* default communication channel */
+#define RADIO_NOF_TX_FIFO      3 /* number of packets the transceiver TX FIFO can hold */
+#define RADIO_RPD_SAMPLE_TICKS 2 /* the RPD needs 170 us in RX mode: wait at least one full tick */
+#define RADIO_RPD_NOF_SAMPLES  8 /* RPD readings averaged for a channel sample */
 
 /* macros to configure device either for RX or TX operation */
 #define %@nRF24L01p@'ModuleName'%.CONFIG_SETTINGS  (%@nRF24L01p@'ModuleName'%.EN_CRC|%@nRF24L01p@'ModuleName'%.CRCO)
@@ -31,7 +37,20 @@ static const uint8_t RADIO_TADDR[5] = {0x11, 0x22, 0x33, 0x44, 0x55}; /* device
 
 #if RNET_CONFIG_SEND_RETRY_CNT>0
 static uint8_t RADIO_RetryCnt;
-static uint8_t TxDataBuffer[RPHY_BUFFER_SIZE]; /*!< global buffer if using retries */
+#endif
+/* Copy of the packets in the transceiver TX FIFO, oldest first. Needed to send them again after a timeout. */
+static uint8_t RADIO_TxFifo[RADIO_NOF_TX_FIFO][RPHY_BUFFER_SIZE];
+static uint8_t RADIO_TxFifoHead; /* index of the oldest packet in RADIO_TxFifo[] */
+static uint8_t RADIO_TxFifoCnt;  /* number of packets in the transceiver TX FIFO not confirmed as sent yet */
+#if RNET_CONFIG_CHANNEL_HOPPING
+#define RADIO_QUIET_TICKS (RNET_CONFIG_CHANNEL_HOP_QUIET_MS/portTICK_RATE_MS)
+static portTickType RADIO_LastTrafficTick; /* last packet sent or received */
+#endif
+#if RNET_CONFIG_LPL
+#define RADIO_TPD2STBY_TICKS   (((2+portTICK_RATE_MS-1)/portTICK_RATE_MS)+1) /* power down to standby takes up to 1.5 ms (Tpd2stby): 2 ms, plus the partial tick */
+#define RADIO_LPL_STROBE_TICKS ((RNET_CONFIG_LPL_WAKEUP_PERIOD_MS+RNET_CONFIG_LPL_LISTEN_MS)/portTICK_RATE_MS)
+static portTickType RADIO_StrobeStartTick; /* time the oldest packet has been sent first */
+static bool RADIO_IsStrobing; /* oldest packet is sent again until the receiver wakes up */
 #endif
 
 /* Radio state definitions */
@@ -53,6 +72,7 @@ static uint8_t RADIO_CurrChannel = RADIO_CHANNEL_DEFAULT;
 
 /* need to have this in case RF device is still added to project */
 static volatile bool RADIO_isrFlag; /* flag set by ISR */
+static xSemaphoreHandle RADIO_EventSem = NULL; /* given by the ISR and for new Tx messages, wakes up RADIO_WaitForEvent() */
 
 static void Err(unsigned char *msg) {
 %if defined(Shell)
@@ -65,6 +85,52 @@ static void Err(unsigned char *msg) {
 /* callback called from radio driver */
 void RADIO_OnInterrupt(void) {
   RADIO_isrFlag = TRUE;
+#if %@nRF24L01p@'ModuleName'%.IRQ_PIN_ENABLED
+  RADIO_NotifyFromISR();
+#else
+  RADIO_Notify(); /* called by PollInterrupt() in RADIO_Process(), not from an interrupt */
+#endif
+}
+
+void RADIO_Notify(void) {
+  if (RADIO_EventSem!=NULL) {
+    (void)%@RTOS@'ModuleName'%.xSemaphoreGive(RADIO_EventSem);
+  }
+}
+
+void RADIO_NotifyFromISR(void) {
+  signed portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+  if (RADIO_EventSem!=NULL) {
+    (void)%@RTOS@'ModuleName'%.xSemaphoreGiveFromISR(RADIO_EventSem, &xHigherPriorityTaskWoken);
+  }
+  portEND_SWITCHING_ISR(xHigherPriorityTaskWoken);
+}
+
+uint8_t RADIO_WaitForEvent(uint32_t timeoutMs) {
+  portTickType ticks;
+
+  if (RADIO_EventSem==NULL) {
+    return ERR_FAILED; /* not initialized */
+  }
+#if %@nRF24L01p@'ModuleName'%.IRQ_PIN_ENABLED
+  ticks = timeoutMs/portTICK_RATE_MS;
+#else
+  /* without IRQ pin the transceiver is polled in RADIO_Process(), so do not wait longer than a tick */
+  ticks = (timeoutMs>0)?1:0;
+#endif
+#if RNET_CONFIG_LPL
+  if (RMAC_LplIsSleeping()) {
+    ticks = timeoutMs/portTICK_RATE_MS; /* nothing to poll while the transceiver is powered down */
+  }
+  if (ticks>RMAC_LplTicksToNextEvent()) {
+    ticks = (portTickType)RMAC_LplTicksToNextEvent(); /* next listen window */
+  }
+#endif
+  if (%@RTOS@'ModuleName'%.xSemaphoreTake(RADIO_EventSem, ticks)==pdTRUE) {
+    return ERR_OK;
+  }
+  return ERR_NOTAVAIL; /* timeout */
 }
 
 uint8_t RADIO_FlushQueues(void) {
@@ -82,6 +148,7 @@ uint8_t RADIO_FlushQueues(void) {
 static uint8_t RADIO_Flush(void) {
   %@nRF24L01p@'ModuleName'%.Write(%@nRF24L01p@'ModuleName'%.FLUSH_RX); /* flush old data */
   %@nRF24L01p@'ModuleName'%.Write(%@nRF24L01p@'ModuleName'%.FLUSH_TX); /* flush old data */
+  RADIO_TxFifoCnt = 0;
   return ERR_OK;
 }
 
@@ -89,6 +156,9 @@ bool RADIO_CanDoPowerDown(void) {
   if (RADIO_isrFlag) {
     return FALSE; /* interrupt pending */
   }
+  if (RADIO_TxFifoCnt!=0) {
+    return FALSE; /* packets in the transceiver TX FIFO */
+  }
   switch(RADIO_AppStatus) {
     case RADIO_TRANSMIT_DATA:
     case RADIO_WAITING_DATA_SENT:
@@ -121,27 +191,38 @@ uint8_t RADIO_PowerDown(void) {
   return res;
 }
 
+/* writes messages from the Tx queue into the transceiver TX FIFO until it is full, and starts sending */
 static uint8_t CheckTx(void) {
   RPHY_PacketDesc packet;
-  uint8_t res = ERR_OK;
-#if RNET_CONFIG_SEND_RETRY_CNT==0
-  uint8_t TxDataBuffer[RPHY_BUFFER_SIZE]; /* local tx buffer if not using retries */
-#endif
-  RPHY_FlagsType flags;
-  
-  if (RMSG_GetTxMsg(TxDataBuffer, sizeof(TxDataBuffer))==ERR_OK) {
-    flags = RPHY_BUF_FLAGS(TxDataBuffer);
-    if (flags&RPHY_PACKET_FLAGS_POWER_DOWN) {
+  uint8_t *buf;
+
+  while (RADIO_TxFifoCnt<RADIO_NOF_TX_FIFO) {
+    buf = RADIO_TxFifo[(RADIO_TxFifoHead+RADIO_TxFifoCnt)%%RADIO_NOF_TX_FIFO];
+    if (RMSG_GetTxMsg(buf, RPHY_BUFFER_SIZE)!=ERR_OK) {
+      break; /* no more data to send */
+    }
+    if (RPHY_BUF_FLAGS(buf)&RPHY_PACKET_FLAGS_POWER_DOWN) {
       /* special request */
+      if (RADIO_TxFifoCnt>0) { /* send pending packets first, handle request later */
+        (void)RMSG_PutRetryTxMsg(buf, RPHY_BUFFER_SIZE);
+        break;
+      }
       (void)RADIO_PowerDown();
       return ERR_DISABLED; /* no more data, pipes flushed */
     }
-    %@nRF24L01p@'ModuleName'%.StopRxTx();  /* CE low */
-    TX_POWERUP();
+    if (RADIO_TxFifoCnt==0) { /* first packet: switch to transmit mode */
+      %@nRF24L01p@'ModuleName'%.StopRxTx();  /* CE low */
+      TX_POWERUP();
+#if RNET_CONFIG_LPL
+      if (!RADIO_IsStrobing) {
+        RADIO_StrobeStartTick = %@RTOS@'ModuleName'%.xTaskGetTickCount();
+      }
+#endif
+    }
     /* set up packet structure */
-    packet.phyData = &TxDataBuffer[0];
-    packet.flags = flags;
-    packet.phySize = sizeof(TxDataBuffer);
+    packet.phyData = buf;
+    packet.flags = RPHY_BUF_FLAGS(buf);
+    packet.phySize = RPHY_BUFFER_SIZE;
 #if NRF24_DYNAMIC_PAYLOAD
     packet.rxtx = RPHY_BUF_PAYLOAD_START(packet.phyData);
 #else
@@ -151,27 +232,98 @@ static uint8_t CheckTx(void) {
       RPHY_SniffPacket(&packet, TRUE); /* sniff outgoing packet */
     }
 #if NRF24_DYNAMIC_PAYLOAD
-    %@nRF24L01p@'ModuleName'%.TxPayload(packet.rxtx, RPHY_BUF_SIZE(packet.phyData)); /* send data, using dynamic payload size */
+    %@nRF24L01p@'ModuleName'%.WriteRegisterData(%@nRF24L01p@'ModuleName'%.W_TX_PAYLOAD, packet.rxtx, RPHY_BUF_SIZE(packet.phyData)); /* add to TX FIFO, using dynamic payload size */
 #else
-    %@nRF24L01p@'ModuleName'%.TxPayload(packet.rxtx, RPHY_PAYLOAD_SIZE); /* send data, using fixed payload size */
+    %@nRF24L01p@'ModuleName'%.WriteRegisterData(%@nRF24L01p@'ModuleName'%.W_TX_PAYLOAD, packet.rxtx, RPHY_PAYLOAD_SIZE); /* add to TX FIFO, using fixed payload size */
 #endif
-    return ERR_OK;
-  } else {
+    RADIO_TxFifoCnt++;
+#if RNET_CONFIG_CHANNEL_HOPPING
+    RADIO_LastTrafficTick = %@RTOS@'ModuleName'%.xTaskGetTickCount();
+#endif
+  }
+  if (RADIO_TxFifoCnt==0) {
     return ERR_NOTAVAIL; /* no data to send? */
   }
-  return res;
+  %@nRF24L01p@'ModuleName'%.StartRxTx(); /* CE high: the transceiver sends the FIFO content back-to-back */
+  return ERR_OK;
 }
 
-/* called to check if we have something in the RX queue. If so, we queue it */
+/* removes the given number of packets from the head of RADIO_TxFifo[], as they have been sent */
+static void TxFifoSent(uint8_t nofSent, uint8_t nofRetransmitted) {
+  (void)nofRetransmitted; /* only used for channel hopping */
+  while (nofSent>0 && RADIO_TxFifoCnt>0) {
+    RADIO_TxFifoHead = (uint8_t)((RADIO_TxFifoHead+1)%%RADIO_NOF_TX_FIFO);
+    RADIO_TxFifoCnt--;
+    nofSent--;
+#if RNET_CONFIG_SEND_RETRY_CNT>0
+    RADIO_RetryCnt = 0;
+#endif
+#if RNET_CONFIG_CHANNEL_HOPPING
+    RCHAN_OnTxDone(nofRetransmitted, FALSE);
+#endif
+#if RNET_CONFIG_LPL
+    RADIO_IsStrobing = FALSE;
+    RMAC_LplOnTxDone();
+#endif
+#if %'ModuleName'%.CREATE_EVENTS
+    %'ModuleName'%.OnEvent(%'ModuleName'%.RADIO_MSG_SENT);
+#endif
+  }
+}
+
+/* Called after a TX_DS interrupt, with the flag already cleared: removes the packets sent from RADIO_TxFifo[].
+ * TX_DS is sticky, so one interrupt can stand for several packets. While CE is high the transceiver keeps sending,
+ * and FIFO_STATUS only tells empty, full or neither: count only the packets sent for sure, a following TX_DS reports the others. */
+static void CheckTxSent(void) {
+  uint8_t fifoStatus, nofLeft;
+  uint8_t nofRetransmitted = 0;
+#if RNET_CONFIG_CHANNEL_HOPPING
+  uint8_t nofLoss;
+
+  (void)%@nRF24L01p@'ModuleName'%.ReadObserveTxRegister(&nofLoss, &nofRetransmitted); /* retransmissions of the last packet */
+#endif
+  (void)%@nRF24L01p@'ModuleName'%.GetFifoStatus(&fifoStatus);
+  if (fifoStatus&%@nRF24L01p@'ModuleName'%.FIFO_STATUS_TX_EMPTY) {
+    nofLeft = 0;
+  } else if (fifoStatus&%@nRF24L01p@'ModuleName'%.FIFO_STATUS_TX_FULL) {
+    nofLeft = RADIO_NOF_TX_FIFO;
+  } else {
+    nofLeft = RADIO_NOF_TX_FIFO-1; /* one or two packets left */
+  }
+  if (RADIO_TxFifoCnt>nofLeft) {
+    TxFifoSent((uint8_t)(RADIO_TxFifoCnt-nofLeft), nofRetransmitted);
+  }
+}
+
+/* Returns the exact number of packets in the transceiver TX FIFO. CE has to be low, so nothing is sent while counting. */
+static uint8_t TxFifoNofPackets(void) {
+  uint8_t fifoStatus, dummy = 0;
+
+  (void)%@nRF24L01p@'ModuleName'%.GetFifoStatus(&fifoStatus);
+  if (fifoStatus&%@nRF24L01p@'ModuleName'%.FIFO_STATUS_TX_EMPTY) {
+    return 0;
+  } else if (fifoStatus&%@nRF24L01p@'ModuleName'%.FIFO_STATUS_TX_FULL) {
+    return RADIO_NOF_TX_FIFO;
+  }
+  /* one or two packets: add a dummy payload and check if the FIFO is full now. The FIFO gets flushed afterwards. */
+  %@nRF24L01p@'ModuleName'%.WriteRegisterData(%@nRF24L01p@'ModuleName'%.W_TX_PAYLOAD, &dummy, sizeof(dummy));
+  (void)%@nRF24L01p@'ModuleName'%.GetFifoStatus(&fifoStatus);
+  if (fifoStatus&%@nRF24L01p@'ModuleName'%.FIFO_STATUS_TX_FULL) {
+    return RADIO_NOF_TX_FIFO-1;
+  }
+  return 1;
+}
+
+/* reads all packets from the RX FIFO and puts them into the Rx queue */
 static uint8_t CheckRx(void) {
   uint8_t res = ERR_OK;
   uint8_t RxDataBuffer[RPHY_BUFFER_SIZE];
-  uint8_t status;
+  uint8_t fifoStatus;
   RPHY_PacketDesc packet;
-  bool hasRxData;
-  
-  hasRxData = FALSE;
-  packet.flags = RPHY_PACKET_FLAGS_NONE;
+#if NRF24_DYNAMIC_PAYLOAD
+  uint8_t payloadSize;
+#endif
+
   packet.phyData = &RxDataBuffer[0];
   packet.phySize = sizeof(RxDataBuffer);
 #if NRF24_DYNAMIC_PAYLOAD
@@ -179,25 +331,26 @@ static uint8_t CheckRx(void) {
 #else
   packet.rxtx = &RPHY_BUF_SIZE(packet.phyData); /* we transmit the data size too */
 #endif
-  status = %@nRF24L01p@'ModuleName'%.GetStatusClrIRQ();
-  if (status&%@nRF24L01p@'ModuleName'%.STATUS_RX_DR) { /* data received interrupt */
-    hasRxData = TRUE;
+  for(;;) { /* the RX FIFO holds up to three packets */
+    (void)%@nRF24L01p@'ModuleName'%.GetFifoStatus(&fifoStatus);
+    if (fifoStatus&%@nRF24L01p@'ModuleName'%.FIFO_STATUS_RX_EMPTY) {
+      break; /* all packets read */
+    }
+    packet.flags = RPHY_PACKET_FLAGS_NONE;
 #if NRF24_DYNAMIC_PAYLOAD
-    uint8_t payloadSize;
-    
     (void)%@nRF24L01p@'ModuleName'%.ReadNofRxPayload(&payloadSize);
     if (payloadSize>32) { /* packet with error? */
       %@nRF24L01p@'ModuleName'%.Write(%@nRF24L01p@'ModuleName'%.FLUSH_RX); /* flush old data */
       return ERR_FAILED;
-    } else {
-      %@nRF24L01p@'ModuleName'%.RxPayload(packet.rxtx, payloadSize); /* get payload: note that we transmit <size> as payload! */
-      RPHY_BUF_SIZE(packet.phyData) = payloadSize;
     }
+    %@nRF24L01p@'ModuleName'%.RxPayload(packet.rxtx, payloadSize); /* get payload: note that we transmit <size> as payload! */
+    RPHY_BUF_SIZE(packet.phyData) = payloadSize;
 #else
     %@nRF24L01p@'ModuleName'%.RxPayload(packet.rxtx, RPHY_PAYLOAD_SIZE); /* get payload: note that we transmit <size> as payload! */
 #endif
-  }
-  if (hasRxData) {
+#if RNET_CONFIG_CHANNEL_HOPPING
+    RADIO_LastTrafficTick = %@RTOS@'ModuleName'%.xTaskGetTickCount();
+#endif
     /* put message into Rx queue */
 #if %'ModuleName'%.CREATE_EVENTS
     %'ModuleName'%.OnEvent(%'ModuleName'%.RADIO_MSG_RECEIVED);
@@ -225,6 +378,7 @@ static void RADIO_HandleStateMachine(void) {
         break; /* process switch again */
   
       case RADIO_RECEIVER_ALWAYS_ON: /* turn receive on */
+        %@nRF24L01p@'ModuleName'%.StopRxTx(); /* CE low, the transceiver might still be in TX mode */
         RX_POWERUP();
         %@nRF24L01p@'ModuleName'%.StartRxTx(); /* Listening for packets */
         RADIO_AppStatus = RADIO_READY_FOR_TX_RX_DATA;
@@ -236,19 +390,17 @@ static void RADIO_HandleStateMachine(void) {
 #endif
         if (RADIO_isrFlag) { /* Rx interrupt? */
           RADIO_isrFlag = FALSE; /* reset interrupt flag */
-          (void)CheckRx(); /* get message */
+          (void)%@nRF24L01p@'ModuleName'%.GetStatusClrIRQ();
+          (void)CheckRx(); /* get messages */
           RADIO_AppStatus = RADIO_RECEIVER_ALWAYS_ON; /* continue listening */
           break; /* process switch again */
         }
-#if RNET_CONFIG_SEND_RETRY_CNT>0
-        RADIO_RetryCnt=0;
-#endif
         RADIO_AppStatus = RADIO_CHECK_TX; /* check if we can send something */
         break;
         
       case RADIO_CHECK_TX:
         res = CheckTx();
-        if (res==ERR_OK) { /* there was data and it has been sent */
+        if (res==ERR_OK) { /* there is data in the TX FIFO and it is being sent */
           RADIO_AppStatus = RADIO_WAITING_DATA_SENT;
           break; /* process switch again */
         } else if (res==ERR_DISABLED) { /* powered down transceiver */
@@ -267,21 +419,66 @@ static void RADIO_HandleStateMachine(void) {
 #endif
         if (RADIO_isrFlag) { /* check if we have received an interrupt: this is either timeout or low level ack */
           RADIO_isrFlag = FALSE; /* reset interrupt flag */
-          status = %@nRF24L01p@'ModuleName'%.GetStatusClrIRQ();
+          status = %@nRF24L01p@'ModuleName'%.GetStatus();
           if (status&%@nRF24L01p@'ModuleName'%.STATUS_MAX_RT) { /* retry timeout interrupt */
-            %@nRF24L01p@'ModuleName'%.Write(%@nRF24L01p@'ModuleName'%.FLUSH_TX); /* flush old data */
+            %@nRF24L01p@'ModuleName'%.StopRxTx(); /* CE low: clearing MAX_RT would resume sending, the timeout handling needs a stopped TX FIFO */
+          }
+          %@nRF24L01p@'ModuleName'%.ResetStatusIRQ(status&(%@nRF24L01p@'ModuleName'%.STATUS_RX_DR|%@nRF24L01p@'ModuleName'%.STATUS_TX_DS|%@nRF24L01p@'ModuleName'%.STATUS_MAX_RT));
+          if (status&%@nRF24L01p@'ModuleName'%.STATUS_RX_DR) { /* ack payload received */
+            (void)CheckRx();
+          }
+          if (status&%@nRF24L01p@'ModuleName'%.STATUS_MAX_RT) { /* retry timeout interrupt, the packets sent before are counted there */
             RADIO_AppStatus = RADIO_TIMEOUT; /* timeout */
+            break; /* process switch again */
+          }
+          if (status&%@nRF24L01p@'ModuleName'%.STATUS_TX_DS) { /* packet(s) sent */
+            CheckTxSent();
+          }
+          if (RADIO_TxFifoCnt==0 && RMSG_TxQueueNofItems()==0) {
+            RADIO_AppStatus = RADIO_RECEIVER_ALWAYS_ON; /* all sent, turn receive on */
           } else {
-    #if %'ModuleName'%.CREATE_EVENTS
-            %'ModuleName'%.OnEvent(%'ModuleName'%.RADIO_MSG_SENT);
-    #endif
-            RADIO_AppStatus = RADIO_RECEIVER_ALWAYS_ON; /* turn receive on */
+            RADIO_AppStatus = RADIO_CHECK_TX; /* keep the TX FIFO filled */
           }
           break; /* process switch again */
         }
+        if (RADIO_TxFifoCnt==0) { /* TX FIFO has been flushed */
+          RADIO_AppStatus = RADIO_RECEIVER_ALWAYS_ON;
+          break; /* process switch again */
+        }
         return;
         
-      case RADIO_TIMEOUT:
+      case RADIO_TIMEOUT: /* the oldest packet in the TX FIFO has not been acknowledged */
+        res = TxFifoNofPackets(); /* CE is low: the failed packet and the ones behind it are still in the TX FIFO */
+        %@nRF24L01p@'ModuleName'%.Write(%@nRF24L01p@'ModuleName'%.FLUSH_TX); /* flush old data */
+        if (RADIO_TxFifoCnt>res) {
+          TxFifoSent((uint8_t)(RADIO_TxFifoCnt-res), 0); /* sent before the failed packet */
+        }
+        if (RADIO_TxFifoCnt==0) { /* TX FIFO has been flushed in the meantime */
+          RADIO_AppStatus = RADIO_RECEIVER_ALWAYS_ON;
+          break; /* process switch again */
+        }
+        /* the head is the failed packet: put the packets behind it back into the Tx queue, newest first to keep the order */
+        while (RADIO_TxFifoCnt>1) {
+          RADIO_TxFifoCnt--;
+          if (RMSG_PutRetryTxMsg(RADIO_TxFifo[(RADIO_TxFifoHead+RADIO_TxFifoCnt)%%RADIO_NOF_TX_FIFO], RPHY_BUFFER_SIZE)!=ERR_OK) {
+            Err((unsigned char*)"ERR: PutRetryTxMsg failed!\r\n");
+          }
+        }
+        RADIO_TxFifoCnt = 0;
+#if RNET_CONFIG_LPL
+        if ((portTickType)(%@RTOS@'ModuleName'%.xTaskGetTickCount()-RADIO_StrobeStartTick)<RADIO_LPL_STROBE_TICKS) {
+          /* the receiver is probably sleeping: keep sending until its next listen window */
+          RADIO_IsStrobing = TRUE;
+          if (RMSG_PutRetryTxMsg(RADIO_TxFifo[RADIO_TxFifoHead], RPHY_BUFFER_SIZE)==ERR_OK) {
+            RADIO_AppStatus = RADIO_CHECK_TX; /* resend packet */
+            break; /* process switch again */
+          }
+        }
+        RADIO_IsStrobing = FALSE;
+#endif
+#if RNET_CONFIG_CHANNEL_HOPPING
+        RCHAN_OnTxDone(0, TRUE);
+#endif
 #if RNET_CONFIG_SEND_RETRY_CNT>0
         if (RADIO_RetryCnt<RNET_CONFIG_SEND_RETRY_CNT) {
           Err((unsigned char*)"ERR: Retry\r\n");
@@ -289,9 +486,9 @@ static void RADIO_HandleStateMachine(void) {
           %'ModuleName'%.OnEvent(%'ModuleName'%.RADIO_RETRY);
   #endif
           RADIO_RetryCnt++;
-          if (RMSG_PutRetryTxMsg(TxDataBuffer, sizeof(TxDataBuffer))==ERR_OK) {
+          if (RMSG_PutRetryTxMsg(RADIO_TxFifo[RADIO_TxFifoHead], RPHY_BUFFER_SIZE)==ERR_OK) {
             RADIO_AppStatus = RADIO_CHECK_TX; /* resend packet */
-            return; /* iterate state machine next time */
+            break; /* process switch again */
           } else {
             Err((unsigned char*)"ERR: PutRetryTxMsg failed!\r\n");
   #if %'ModuleName'%.CREATE_EVENTS
@@ -299,6 +496,7 @@ static void RADIO_HandleStateMachine(void) {
   #endif
           }
         }
+        RADIO_RetryCnt = 0;
 #endif
         Err((unsigned char*)"ERR: Timeout\r\n");
 #if %'ModuleName'%.CREATE_EVENTS
@@ -355,6 +553,11 @@ uint8_t RADIO_PowerUp(void) {
   %@nRF24L01p@'ModuleName'%.StartRxTx(); /* Listening for packets */
 
   RADIO_AppStatus = RADIO_INITIAL_STATE;
+  RADIO_TxFifoHead = 0;
+  RADIO_TxFifoCnt = 0;
+#if RNET_CONFIG_LPL
+  RADIO_IsStrobing = FALSE;
+#endif
   /* init Rx descriptor */
   radioRx.phyData = &radioRxBuf[0];
   radioRx.phySize = sizeof(radioRxBuf);
@@ -363,12 +566,12 @@ uint8_t RADIO_PowerUp(void) {
 }
 
 uint8_t RADIO_Process(void) {
-  uint8_t res;
-  
+#if RNET_CONFIG_LPL
+  RMAC_LplProcess(); /* wake up or power down the transceiver */
+#endif
   RADIO_HandleStateMachine(); /* process state machine */
   /* process received packets */
-  res = RPHY_GetPayload(&radioRx); /* get message */
-  if (res==ERR_OK) { /* packet received */
+  while (RPHY_GetPayload(&radioRx)==ERR_OK) { /* packet received */
     if (RADIO_isSniffing) {
       RPHY_SniffPacket(&radioRx, FALSE); /* sniff incoming packet */
     }
@@ -380,9 +583,66 @@ uint8_t RADIO_Process(void) {
 #endif
     }
   }
+#if RNET_CONFIG_CHANNEL_HOPPING
+  RCHAN_Process(); /* sample channels and change channel if needed */
+#endif
   return ERR_OK;
 }
 
+#if RNET_CONFIG_LPL
+uint8_t RADIO_Sleep(void) {
+  if (!RADIO_CanDoPowerDown()) {
+    return ERR_BUSY; /* pending traffic */
+  }
+  %@nRF24L01p@'ModuleName'%.StopRxTx(); /* CE low */
+  POWERDOWN(); /* registers keep their values */
+  RADIO_AppStatus = RADIO_POWER_DOWN;
+  return ERR_OK;
+}
+
+uint8_t RADIO_Wakeup(void) {
+  if (RADIO_AppStatus==RADIO_POWER_DOWN) {
+    RX_POWERUP(); /* CE is low: the crystal oscillator starts up */
+    %@RTOS@'ModuleName'%.vTaskDelay(RADIO_TPD2STBY_TICKS); /* CE has to stay low until the transceiver is in standby */
+    RADIO_AppStatus = RADIO_RECEIVER_ALWAYS_ON; /* state machine starts listening, or sends pending packets */
+  }
+  return ERR_OK;
+}
+#endif
+
+#if RNET_CONFIG_CHANNEL_HOPPING
+uint8_t RADIO_SampleChannel(uint8_t channel, uint8_t *busy) {
+  uint8_t rpd, i, nofBusy = 0;
+
+  if (RADIO_AppStatus!=RADIO_READY_FOR_TX_RX_DATA || !RADIO_CanDoPowerDown()) {
+    return ERR_BUSY; /* only while listening without pending traffic */
+  }
+  if (channel!=RADIO_CurrChannel) {
+    if ((portTickType)(%@RTOS@'ModuleName'%.xTaskGetTickCount()-RADIO_LastTrafficTick)<RADIO_QUIET_TICKS) {
+      return ERR_DISABLED; /* the radio would miss packets on its channel */
+    }
+    %@nRF24L01p@'ModuleName'%.StopRxTx();  /* CE low */
+    (void)%@nRF24L01p@'ModuleName'%.SetChannel(channel);
+    %@nRF24L01p@'ModuleName'%.StartRxTx(); /* CE high: RX mode on the sampled channel */
+    %@RTOS@'ModuleName'%.vTaskDelay(RADIO_RPD_SAMPLE_TICKS);
+  }
+  /* a single reading only tells about the last packet on the air: use the share of several readings */
+  for(i=0;i<RADIO_RPD_NOF_SAMPLES;i++) {
+    (void)%@nRF24L01p@'ModuleName'%.ReadReceivedPowerDetector(&rpd);
+    if (rpd&1) {
+      nofBusy++;
+    }
+  }
+  if (channel!=RADIO_CurrChannel) {
+    %@nRF24L01p@'ModuleName'%.StopRxTx();
+    (void)%@nRF24L01p@'ModuleName'%.SetChannel(RADIO_CurrChannel);
+    %@nRF24L01p@'ModuleName'%.StartRxTx(); /* back to listening */
+  }
+  *busy = (uint8_t)((nofBusy*255U)/RADIO_RPD_NOF_SAMPLES);
+  return ERR_OK;
+}
+#endif
+
 %if defined(Shell)
 static const unsigned char *RadioStateStr(RADIO_AppStatusKind state) {
   switch(state) {
@@ -392,6 +652,7 @@ static const unsigned char *RadioStateStr(RADIO_AppStatusKind state) {
     case RADIO_WAITING_DATA_SENT:     return (const unsigned char*)"WAITING_DATA_SENT";
     case RADIO_READY_FOR_TX_RX_DATA:  return (const unsigned char*)"READY_TX_RX";
     case RADIO_CHECK_TX:              return (const unsigned char*)"CHECK_TX";
+    case RADIO_TIMEOUT:               return (const unsigned char*)"TIMEOUT";
     case RADIO_POWER_DOWN:            return (const unsigned char*)"POWER_DOWN"; 
     default:                          return (const unsigned char*)"UNKNOWN";
   }
@@ -609,4 +870,10 @@ void RADIO_Deinit(void) {
 void RADIO_Init(void) {
   RADIO_isSniffing = FALSE;
   RADIO_CurrChannel = RADIO_CHANNEL_DEFAULT;
+  if (RADIO_EventSem==NULL) {
+    %@RTOS@'ModuleName'%.vSemaphoreCreateBinary(RADIO_EventSem);
+    if (RADIO_EventSem==NULL) { /* semaphore creation failed! */
+      for(;;) {} /* not enough memory? */
+    }
+  }
 }
@@ -85,7 +85,7 @@
  *     in FreeRTOS/source/stdint.readme for more information.
  */
 #include "FreeRTOSConfig.h" /* << EST */
-#if configGENERATE_STATIC_SOURCES || configPEX_KINETIS_SDK /* << EST */
+#if configGENERATE_STATIC_SOURCES || configPEX_KINETIS_SDK || (configCOMPILER==configCOMPILER_POSIX_GCC) /* << EST */
   #include <stdint.h> /* READ COMMENT ABOVE. */
 #else
   #include "PE_Types.h"
@@ -111,6 +111,38 @@ is included as it is used by the port layer. */
 	#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
 #endif
 
+/* Block pools are used by portable.h as well. */ /* << EST */
+#ifndef configUSE_BLOCK_POOLS
+	#define configUSE_BLOCK_POOLS 0
+#endif
+
+#ifndef configUSE_BLOCK_POOLS_FOR_KERNEL_OBJECTS
+	#define configUSE_BLOCK_POOLS_FOR_KERNEL_OBJECTS 0
+#endif
+
+/* Heap tracing hooks are defined in portable.h as well. */ /* << EST */
+#ifndef configUSE_HEAP_TRACE
+	#define configUSE_HEAP_TRACE 0
+#endif
+
+/* Run time counter, interrupt time accounting and CPU load tracking are
+declared in portable.h as well. */ /* << EST */
+#ifndef configRUN_TIME_COUNTER_CYCLES
+	#define configRUN_TIME_COUNTER_CYCLES 0
+#endif
+
+#ifndef configRUN_TIME_COUNTER_HZ
+	#define configRUN_TIME_COUNTER_HZ 0
+#endif
+
+#ifndef configRUN_TIME_ISR_ACCOUNTING
+	#define configRUN_TIME_ISR_ACCOUNTING 0
+#endif
+
+#ifndef configUSE_CPU_LOAD
+	#define configUSE_CPU_LOAD 0
+#endif
+
 /* Definitions specific to the port being used. */
 #include "portable.h"
 
@@ -654,6 +686,16 @@ is included as it is used by the port layer. */
 	#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
 #endif
 
+#if ( configUSE_CPU_LOAD == 1 ) /* << EST */
+	#if ( configGENERATE_RUN_TIME_STATS == 0 ) || ( configUSE_TIMERS == 0 ) || ( configUSE_TRACE_FACILITY == 0 )
+		#error configUSE_CPU_LOAD requires configGENERATE_RUN_TIME_STATS, configUSE_TIMERS and configUSE_TRACE_FACILITY to be set to 1: the load is sampled from a software timer with uxTaskGetSystemState().
+	#endif
+#endif
+
+#if ( configRUN_TIME_ISR_ACCOUNTING == 1 ) && ( configGENERATE_RUN_TIME_STATS == 0 ) /* << EST */
+	#error configRUN_TIME_ISR_ACCOUNTING requires configGENERATE_RUN_TIME_STATS to be set to 1.
+#endif
+
 #ifndef configUSE_MALLOC_FAILED_HOOK
 	#define configUSE_MALLOC_FAILED_HOOK 0
 #endif
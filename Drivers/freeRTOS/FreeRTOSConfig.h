@@ -88,6 +88,7 @@
 #define configCOMPILER_CF1_FSL     %>45 7 /* Freescale ColdFire V1 compiler */
 #define configCOMPILER_CF2_FSL     %>45 8 /* Freescale ColdFire V2 compiler */
 #define configCOMPILER_DSC_FSL     %>45 9 /* Freescale DSC compiler */
+#define configCOMPILER_POSIX_GCC   %>45 10 /* GNU gcc on a POSIX host (Linux) */
 
 %if (%configCOMPILER='automatic')
 %if (%Compiler = "IARARM")
@@ -125,11 +126,14 @@
 #define configCPU_FAMILY_ARM_M0P      %>45 6  /* ARM Cortex-M0+ */
 #define configCPU_FAMILY_ARM_M4       %>45 7  /* ARM Cortex-M4 */
 #define configCPU_FAMILY_ARM_M4F      %>45 8  /* ARM Cortex-M4F (with floating point unit) */
+#define configCPU_FAMILY_POSIX        %>45 9  /* POSIX host (Linux), for simulation and performance measurements */
 /* Macros to identify set of core families */
 #define configCPU_FAMILY_IS_ARM_M4(fam)   %>45 (((fam)==configCPU_FAMILY_ARM_M4)  || ((fam)==configCPU_FAMILY_ARM_M4F))
 #define configCPU_FAMILY_IS_ARM(fam)      %>45 (((fam)==configCPU_FAMILY_ARM_M0P) || configCPU_FAMILY_IS_ARM_M4(fam))
 
-%if (CPUfamily = "HCS08") | (CPUfamily = "HC08")
+%if %configCOMPILER='configCOMPILER_POSIX_GCC'
+#define configCPU_FAMILY  %>50 configCPU_FAMILY_POSIX
+%elif (CPUfamily = "HCS08") | (CPUfamily = "HC08")
 #define configCPU_FAMILY  %>50 configCPU_FAMILY_S08
 %elif (CPUfamily = "HCS12") | (CPUfamily = "HCS12X")
 #define configCPU_FAMILY  %>50 configCPU_FAMILY_S12
@@ -177,15 +181,39 @@
 
 %if %CollectRuntimeStatisticsGroup='yes'
 #define configGENERATE_RUN_TIME_STATS                            %>50 1 /* 1: generate runtime statistics; 0: no runtime statistics */
-%if defined(RuntimeCntr)
+%if %configCOMPILER='configCOMPILER_POSIX_GCC' %- runtime counter from the monotonic clock of the host
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()                 %>50 vPortConfigureRunTimeCounter()
+#define portGET_RUN_TIME_RAW_COUNTER_VALUE()                     %>50 ulPortGetRunTimeCounterValue()
+#define configRUN_TIME_COUNTER_HZ                                %>50 1000000UL /* runtime counter counts microseconds */
+%elif defined(RuntimeCycleCounter) & %RuntimeCycleCounter='yes' %- free running cycle counter of the core
+#define configRUN_TIME_COUNTER_CYCLES                            %>50 1 /* 1: runtime counter is the cycle counter of the core, implemented in port.c */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()                 %>50 vPortConfigureRunTimeCounter()
+#define portGET_RUN_TIME_RAW_COUNTER_VALUE()                     %>50 ulPortGetRunTimeCounterValue()
+#define configRUN_TIME_COUNTER_HZ                                %>50 configCPU_CLOCK_HZ /* runtime counter counts core clock cycles */
+%elif defined(RuntimeCntr)
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()                 %>50 {%'ModuleName'%.RunTimeCounter = 0; (void)%@RuntimeCntr@'ModuleName'%.Enable();}
-#define portGET_RUN_TIME_COUNTER_VALUE()                         %>50 %'ModuleName'%.RunTimeCounter
+#define portGET_RUN_TIME_RAW_COUNTER_VALUE()                     %>50 %'ModuleName'%.RunTimeCounter
 %elif defined(RuntimeCntrLDD)
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()                 %>50 {%'ModuleName'%.RunTimeCounter = 0; %'ModuleName'%.RunTimeCounterHandle = %@RuntimeCntrLDD@'ModuleName'%.Init(NULL); (void)%@RuntimeCntrLDD@'ModuleName'%.Enable(%'ModuleName'%.RunTimeCounterHandle);}
-#define portGET_RUN_TIME_COUNTER_VALUE()                         %>50 %'ModuleName'%.RunTimeCounter
+#define portGET_RUN_TIME_RAW_COUNTER_VALUE()                     %>50 %'ModuleName'%.RunTimeCounter
+%endif
+%if defined(RuntimeIsrAccounting) & %RuntimeIsrAccounting='yes'
+#define configRUN_TIME_ISR_ACCOUNTING                            %>50 1 /* 1: time in interrupts using portRUN_TIME_ISR_ENTER()/portRUN_TIME_ISR_EXIT() is not charged to the tasks; 0: no interrupt time accounting */
+#define portGET_RUN_TIME_COUNTER_VALUE()                         %>50 ulPortGetTaskRunTimeCounterValue() /* runtime counter without the time spent in accounted interrupts */
+%else
+#define configRUN_TIME_ISR_ACCOUNTING                            %>50 0 /* 1: time in interrupts using portRUN_TIME_ISR_ENTER()/portRUN_TIME_ISR_EXIT() is not charged to the tasks; 0: no interrupt time accounting */
+#define portGET_RUN_TIME_COUNTER_VALUE()                         %>50 portGET_RUN_TIME_RAW_COUNTER_VALUE()
+%endif
+%if defined(CpuLoadEnabled) & %CpuLoadEnabled='yes'
+#define configUSE_CPU_LOAD                                       %>50 1 /* 1: track the CPU load of each task over 1 s, 10 s and 60 s (cpu_load.c); 0: no CPU load tracking */
+#define configCPU_LOAD_MAX_TASKS                                 %>50 %CpuLoadMaxTasks /* maximum number of tasks, including the idle and timer task */
+%else
+#define configUSE_CPU_LOAD                                       %>50 0 /* 1: track the CPU load of each task over 1 s, 10 s and 60 s (cpu_load.c); 0: no CPU load tracking */
 %endif
 %else
 #define configGENERATE_RUN_TIME_STATS                            %>50 0 /* 1: generate runtime statistics; 0: no runtime statistics */
+#define configRUN_TIME_ISR_ACCOUNTING                            %>50 0 /* 1: time in interrupts using portRUN_TIME_ISR_ENTER()/portRUN_TIME_ISR_EXIT() is not charged to the tasks; 0: no interrupt time accounting */
+#define configUSE_CPU_LOAD                                       %>50 0 /* 1: track the CPU load of each task over 1 s, 10 s and 60 s (cpu_load.c); 0: no CPU load tracking */
 %endif
 %-
 %if UsePreemption = 'yes'
@@ -259,13 +287,15 @@
 /*----------------------------------------------------------*/
 /* Heap Memory */
 %if MemoryScheme = "Scheme1"
-#define configFRTOS_MEMORY_SCHEME                 %>50 1 /* either 1 (only alloc), 2 (alloc/free), 3 (malloc) or 4 (coalesc blocks) */
+#define configFRTOS_MEMORY_SCHEME                 %>50 1 /* either 1 (only alloc), 2 (alloc/free), 3 (malloc), 4 (coalesc blocks) or 5 (TLSF) */
 %elif MemoryScheme = "Scheme2"
-#define configFRTOS_MEMORY_SCHEME                 %>50 2 /* either 1 (only alloc), 2 (alloc/free), 3 (malloc) or 4 (coalesc blocks) */
+#define configFRTOS_MEMORY_SCHEME                 %>50 2 /* either 1 (only alloc), 2 (alloc/free), 3 (malloc), 4 (coalesc blocks) or 5 (TLSF) */
 %elif MemoryScheme = "Scheme3"
-#define configFRTOS_MEMORY_SCHEME                 %>50 3 /* either 1 (only alloc), 2 (alloc/free), 3 (malloc) or 4 (coalesc blocks) */
+#define configFRTOS_MEMORY_SCHEME                 %>50 3 /* either 1 (only alloc), 2 (alloc/free), 3 (malloc), 4 (coalesc blocks) or 5 (TLSF) */
 %elif MemoryScheme = "Scheme4"
-#define configFRTOS_MEMORY_SCHEME                 %>50 4 /* either 1 (only alloc), 2 (alloc/free), 3 (malloc) or 4 (coalesc blocks) */
+#define configFRTOS_MEMORY_SCHEME                 %>50 4 /* either 1 (only alloc), 2 (alloc/free), 3 (malloc), 4 (coalesc blocks) or 5 (TLSF) */
+%elif MemoryScheme = "Scheme5"
+#define configFRTOS_MEMORY_SCHEME                 %>50 5 /* either 1 (only alloc), 2 (alloc/free), 3 (malloc), 4 (coalesc blocks) or 5 (TLSF) */
 %endif
 #define configTOTAL_HEAP_SIZE                                    %>50 ((size_t)(%TotalHeapSize)) /* size of heap in bytes */
 %if defined(HeapSectionName)
@@ -280,6 +310,32 @@
 #define configHEAP_SECTION_NAME_STRING  %>50 ".m_data_20000000" /* heap section name (use e.g. ".m_data_20000000" for gcc and "m_data_20000000" for IAR). Check your linker file for the name used. */
 %endif
 #endif
+/* Block Pools */
+%if defined(BlockPoolsEnabled) & %BlockPoolsEnabled='yes'
+#define configUSE_BLOCK_POOLS                                    %>50 1 /* 1: use fixed size block pools (mempool.c), 0: no block pools */
+%if %BlockPoolsKernelObjects='yes'
+#define configUSE_BLOCK_POOLS_FOR_KERNEL_OBJECTS                 %>50 1 /* 1: allocate queue, semaphore, timer and event group objects from the block pools */
+%else
+#define configUSE_BLOCK_POOLS_FOR_KERNEL_OBJECTS                 %>50 0 /* 1: allocate queue, semaphore, timer and event group objects from the block pools */
+%endif
+#define configBLOCK_POOL0_BLOCK_SIZE                             %>50 %BlockPool0BlockSize /* block size of pool 0 in bytes */
+#define configBLOCK_POOL0_NOF_BLOCKS                             %>50 %BlockPool0NofBlocks /* number of blocks in pool 0, 0 if not used */
+#define configBLOCK_POOL1_BLOCK_SIZE                             %>50 %BlockPool1BlockSize /* block size of pool 1 in bytes */
+#define configBLOCK_POOL1_NOF_BLOCKS                             %>50 %BlockPool1NofBlocks /* number of blocks in pool 1, 0 if not used */
+#define configBLOCK_POOL2_BLOCK_SIZE                             %>50 %BlockPool2BlockSize /* block size of pool 2 in bytes */
+#define configBLOCK_POOL2_NOF_BLOCKS                             %>50 %BlockPool2NofBlocks /* number of blocks in pool 2, 0 if not used */
+%else
+#define configUSE_BLOCK_POOLS                                    %>50 0 /* 1: use fixed size block pools (mempool.c), 0: no block pools */
+#define configUSE_BLOCK_POOLS_FOR_KERNEL_OBJECTS                 %>50 0 /* 1: allocate queue, semaphore, timer and event group objects from the block pools */
+%endif
+/* Heap Trace */
+%if defined(HeapTraceEnabled) & %HeapTraceEnabled='yes'
+#define configUSE_HEAP_TRACE                                     %>50 1 /* 1: record pvPortMalloc()/vPortFree() calls (heap_trace.c), 0: no heap tracing */
+#define configHEAP_TRACE_RING_SIZE                               %>50 %HeapTraceRingSize /* number of most recent malloc/free records kept */
+#define configHEAP_TRACE_LIVE_SIZE                               %>50 %HeapTraceLiveSize /* number of live blocks tracked for the per task usage, must be a power of two */
+%else
+#define configUSE_HEAP_TRACE                                     %>50 0 /* 1: record pvPortMalloc()/vPortFree() calls (heap_trace.c), 0: no heap tracing */
+%endif
 /*----------------------------------------------------------*/
 #define configMAX_TASK_NAME_LEN                                  %>50 %TaskNameLength /* task name length */
 %if %UseTraceFacility='yes'
@@ -0,0 +1,498 @@
+/* << EST */
+#include "FreeRTOSConfig.h"
+#if ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configUSE_CPU_LOAD || configRUN_TIME_ISR_ACCOUNTING )
+
+/*
+ * Interrupt time accounting and CPU load tracking on top of the run time
+ * statistics.
+ *
+ * With configRUN_TIME_ISR_ACCOUNTING, interrupts bracketed with
+ * portRUN_TIME_ISR_ENTER()/portRUN_TIME_ISR_EXIT() sum up their time in
+ * ulIsrRunTime.  Only the outermost accounted interrupt is measured, so nested
+ * interrupts are not counted twice.  The kernel reads the run time counter
+ * through ulPortGetTaskRunTimeCounterValue(), which stands still while an
+ * accounted interrupt runs, so the interrupt time is not charged to the task
+ * which has been interrupted.
+ *
+ * With configUSE_CPU_LOAD, a software timer samples the run time counters of
+ * all tasks once per second with uxTaskGetSystemState().  For each task the
+ * load of the last ten seconds is kept in one second buckets, and the load of
+ * the last minute in ten second buckets.  This gives the 1 s, 10 s and 60 s
+ * windows with 32 bytes per task and nothing added to the context switch.  The
+ * 60 s window slides in steps of ten seconds.
+ */
+#include <string.h>
+
+%- EST: Modification for Processor Expert port
+%for var from EventModules
+#include "%var.h"
+%endfor
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configRUN_TIME_ISR_ACCOUNTING == 1 )
+
+static volatile UBaseType_t uxIsrNesting = 0;	/* Nesting level of accounted interrupts. */
+static volatile uint32_t ulIsrEnterTime = 0;	/* Raw counter value when the outermost accounted interrupt was entered. */
+static volatile uint32_t ulIsrRunTime = 0;		/* Raw counter time spent in accounted interrupts. */
+
+/*-----------------------------------------------------------*/
+
+void vPortRunTimeIsrEnter( void )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( uxIsrNesting == 0 )
+		{
+			ulIsrEnterTime = portGET_RUN_TIME_RAW_COUNTER_VALUE();
+		}
+		uxIsrNesting++;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vPortRunTimeIsrExit( void )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		if( uxIsrNesting > 0 )
+		{
+			uxIsrNesting--;
+			if( uxIsrNesting == 0 )
+			{
+				ulIsrRunTime += portGET_RUN_TIME_RAW_COUNTER_VALUE() - ulIsrEnterTime;
+			}
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetIsrRunTime( void )
+{
+	return ulIsrRunTime;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetTaskRunTimeCounterValue( void )
+{
+uint32_t ulIsr, ulNow;
+
+	/* Called by the kernel with interrupts enabled as well, so read again if
+	an accounted interrupt has completed in between.  Inside an accounted
+	interrupt the counter stands still at the time the interrupt was entered. */
+	do
+	{
+		ulIsr = ulIsrRunTime;
+		if( uxIsrNesting != 0 )
+		{
+			ulNow = ulIsrEnterTime;
+		}
+		else
+		{
+			ulNow = portGET_RUN_TIME_RAW_COUNTER_VALUE();
+		}
+	} while( ulIsr != ulIsrRunTime );
+	return ulNow - ulIsr;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configRUN_TIME_ISR_ACCOUNTING */
+
+#if ( configUSE_CPU_LOAD == 1 )
+
+#define cpuloadSECONDS				( 10 )	/* One second buckets, for the 10 s window. */
+#define cpuloadTEN_SECONDS			( 6 )	/* Ten second buckets, for the 60 s window. */
+#define cpuloadPERMILLE				( 1000UL )
+
+/* Load history in permille, of a task or of the interrupts. */
+typedef struct CPU_LOAD_HISTORY
+{
+	uint16_t usSec[ cpuloadSECONDS ];
+	uint16_t usTenSec[ cpuloadTEN_SECONDS ];
+} CpuLoadHistory_t;
+
+/* Tracked task, uxTaskNumber is 0 for an empty slot. */
+typedef struct CPU_LOAD_SLOT
+{
+	UBaseType_t uxTaskNumber;
+	uint32_t ulRunTime;
+	uint8_t ucState;
+	uint8_t ucPriority;
+	char cName[ configMAX_TASK_NAME_LEN ];
+	CpuLoadHistory_t xHistory;
+} CpuLoadSlot_t;
+
+static TaskStatus_t xStatus[ configCPU_LOAD_MAX_TASKS ];
+static CpuLoadSlot_t xSlots[ configCPU_LOAD_MAX_TASKS ];
+static CpuLoadHistory_t xIsrHistory;
+
+static BaseType_t xStarted = pdFALSE;	/* pdTRUE after the first sample, which only sets the start values. */
+static uint32_t ulLastTimestamp = 0;	/* Raw counter at the last sample. */
+static uint32_t ulLastIsrRunTime = 0;	/* Interrupt time at the last sample. */
+static uint32_t ulSamples = 0;
+static uint32_t ulMissed = 0;
+static uint8_t ucSecIndex = 0;			/* Next one second bucket to write. */
+static uint8_t ucSecCount = 0;			/* Number of valid one second buckets. */
+static uint8_t ucTenSecIndex = 0;		/* Next ten second bucket to write. */
+static uint8_t ucTenSecCount = 0;		/* Number of valid ten second buckets. */
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Timer callback, samples the run time counters once per second.
+ */
+static void prvSampleTimerCallback( TimerHandle_t xTimer );
+
+/*
+ * Takes one sample, called with the scheduler suspended.
+ */
+static void prvSample( void );
+
+/*
+ * Returns ulPart/ulTotal in permille, without 64bit arithmetic.
+ */
+static uint16_t prvPermille( uint32_t ulPart, uint32_t ulTotal );
+
+/*
+ * Adds the load of the last second to the history.
+ */
+static void prvAddSecond( CpuLoadHistory_t *pxHistory, uint16_t usLoad );
+
+/*
+ * Stores the ten second average, called after every tenth second.
+ */
+static void prvAddTenSeconds( CpuLoadHistory_t *pxHistory );
+
+/*
+ * Returns the 1 s, 10 s and 60 s load of a history.
+ */
+static void prvGetLoad( const CpuLoadHistory_t *pxHistory, uint16_t *pusLoad );
+
+/*
+ * Returns the slot of the task, or allocates an empty one, NULL if none left.
+ */
+static CpuLoadSlot_t *prvGetSlot( const TaskStatus_t *pxTaskStatus, BaseType_t *pxNew );
+
+/*-----------------------------------------------------------*/
+
+BaseType_t xCpuLoadCreateTimer( void )
+{
+TimerHandle_t xTimer;
+
+	/* Called by vTaskStartScheduler() after the timer task has been created. */
+	xTimer = xTimerCreate( "CpuLoad", ( TickType_t ) configTICK_RATE_HZ, pdTRUE, NULL, prvSampleTimerCallback );
+	if( xTimer == NULL )
+	{
+		return pdFAIL;
+	}
+	return xTimerStart( xTimer, 0 );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxCpuLoadGetTasks( CpuLoadTask_t *pxTasks, UBaseType_t uxMaxTasks, CpuLoadInfo_t *pxInfo )
+{
+UBaseType_t ux, uxTasks = 0;
+
+	vTaskSuspendAll();
+	{
+		for( ux = 0; ux < configCPU_LOAD_MAX_TASKS; ux++ )
+		{
+			if( xSlots[ ux ].uxTaskNumber == 0 )
+			{
+				continue;
+			}
+			if( uxTasks < uxMaxTasks )
+			{
+				pxTasks[ uxTasks ].ulTaskNumber = ( uint32_t ) xSlots[ ux ].uxTaskNumber;
+				pxTasks[ uxTasks ].ulRunTime = xSlots[ ux ].ulRunTime;
+				pxTasks[ uxTasks ].ucState = xSlots[ ux ].ucState;
+				pxTasks[ uxTasks ].ucPriority = xSlots[ ux ].ucPriority;
+				( void ) memcpy( pxTasks[ uxTasks ].cName, xSlots[ ux ].cName, configMAX_TASK_NAME_LEN );
+				prvGetLoad( &xSlots[ ux ].xHistory, pxTasks[ uxTasks ].usLoad );
+				uxTasks++;
+			}
+		}
+		if( pxInfo != NULL )
+		{
+			pxInfo->ulCounterHz = configRUN_TIME_COUNTER_HZ;
+			pxInfo->ulTimestamp = ulLastTimestamp;
+			pxInfo->ulSamples = ulSamples;
+			pxInfo->ulMissed = ulMissed;
+			pxInfo->ulIsrRunTime = ulLastIsrRunTime;
+			prvGetLoad( &xIsrHistory, pxInfo->usIsrLoad );
+			pxInfo->usNofTasks = ( uint16_t ) uxTasks;
+		}
+	}
+	( void ) xTaskResumeAll();
+	return uxTasks;
+}
+/*-----------------------------------------------------------*/
+
+size_t xCpuLoadGetSnapshot( uint8_t *pucBuffer, size_t xBufferSize )
+{
+CpuLoadBlobHeader_t xHeader;
+UBaseType_t uxTasks;
+
+	/* Header followed by the tasks, in target byte order. */
+	if( xBufferSize < sizeof( CpuLoadBlobHeader_t ) )
+	{
+		return 0;
+	}
+	uxTasks = uxCpuLoadGetTasks( ( CpuLoadTask_t * ) ( void * ) ( pucBuffer + sizeof( CpuLoadBlobHeader_t ) ), ( UBaseType_t ) ( ( xBufferSize - sizeof( CpuLoadBlobHeader_t ) ) / sizeof( CpuLoadTask_t ) ), &xHeader.xInfo );
+	xHeader.ulMagic = cpuloadBLOB_MAGIC;
+	xHeader.usVersion = cpuloadBLOB_VERSION;
+	xHeader.ucNameLength = ( uint8_t ) configMAX_TASK_NAME_LEN;
+	xHeader.ucRecordSize = ( uint8_t ) sizeof( CpuLoadTask_t );
+	( void ) memcpy( pucBuffer, &xHeader, sizeof( CpuLoadBlobHeader_t ) );
+	return sizeof( CpuLoadBlobHeader_t ) + ( uxTasks * sizeof( CpuLoadTask_t ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSampleTimerCallback( TimerHandle_t xTimer )
+{
+	( void ) xTimer;
+	vTaskSuspendAll();
+	{
+		prvSample();
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+static void prvSample( void )
+{
+UBaseType_t uxTasks, ux, uxSlot;
+uint32_t ulNow, ulElapsed, ulIsr;
+CpuLoadSlot_t *pxSlot;
+BaseType_t xNew;
+
+	ulNow = portGET_RUN_TIME_RAW_COUNTER_VALUE();
+	#if ( configRUN_TIME_ISR_ACCOUNTING == 1 )
+	{
+		ulIsr = ulPortGetIsrRunTime();
+	}
+	#else
+	{
+		ulIsr = 0;
+	}
+	#endif
+	uxTasks = uxTaskGetSystemState( xStatus, configCPU_LOAD_MAX_TASKS, NULL );
+	if( uxTasks == 0 )
+	{
+		/* More tasks than configCPU_LOAD_MAX_TASKS, the next sample covers
+		this second as well. */
+		ulMissed++;
+		return;
+	}
+	ulElapsed = ulNow - ulLastTimestamp;
+
+	/* Release the slots of deleted tasks first, so their slots are available
+	for new tasks. */
+	for( uxSlot = 0; uxSlot < configCPU_LOAD_MAX_TASKS; uxSlot++ )
+	{
+		if( xSlots[ uxSlot ].uxTaskNumber == 0 )
+		{
+			continue;
+		}
+		for( ux = 0; ux < uxTasks; ux++ )
+		{
+			if( xStatus[ ux ].xTaskNumber == xSlots[ uxSlot ].uxTaskNumber )
+			{
+				break;
+			}
+		}
+		if( ux == uxTasks )
+		{
+			xSlots[ uxSlot ].uxTaskNumber = 0;
+		}
+	}
+
+	for( ux = 0; ux < uxTasks; ux++ )
+	{
+		pxSlot = prvGetSlot( &xStatus[ ux ], &xNew );
+		if( pxSlot == NULL )
+		{
+			continue;
+		}
+		if( xNew != pdFALSE && xStarted == pdFALSE )
+		{
+			/* Existed before the first sample. */
+			pxSlot->ulRunTime = xStatus[ ux ].ulRunTimeCounter;
+		}
+		if( xStarted != pdFALSE )
+		{
+			prvAddSecond( &pxSlot->xHistory, prvPermille( xStatus[ ux ].ulRunTimeCounter - pxSlot->ulRunTime, ulElapsed ) );
+		}
+		pxSlot->ulRunTime = xStatus[ ux ].ulRunTimeCounter;
+		pxSlot->ucState = ( uint8_t ) xStatus[ ux ].eCurrentState;
+		pxSlot->ucPriority = ( uint8_t ) xStatus[ ux ].uxCurrentPriority;
+	}
+
+	if( xStarted != pdFALSE )
+	{
+		prvAddSecond( &xIsrHistory, prvPermille( ulIsr - ulLastIsrRunTime, ulElapsed ) );
+		ucSecIndex++;
+		if( ucSecCount < cpuloadSECONDS )
+		{
+			ucSecCount++;
+		}
+		if( ucSecIndex == cpuloadSECONDS )
+		{
+			ucSecIndex = 0;
+			for( uxSlot = 0; uxSlot < configCPU_LOAD_MAX_TASKS; uxSlot++ )
+			{
+				if( xSlots[ uxSlot ].uxTaskNumber != 0 )
+				{
+					prvAddTenSeconds( &xSlots[ uxSlot ].xHistory );
+				}
+			}
+			prvAddTenSeconds( &xIsrHistory );
+			ucTenSecIndex++;
+			if( ucTenSecIndex == cpuloadTEN_SECONDS )
+			{
+				ucTenSecIndex = 0;
+			}
+			if( ucTenSecCount < cpuloadTEN_SECONDS )
+			{
+				ucTenSecCount++;
+			}
+		}
+		ulSamples++;
+	}
+	xStarted = pdTRUE;
+	ulLastTimestamp = ulNow;
+	ulLastIsrRunTime = ulIsr;
+}
+/*-----------------------------------------------------------*/
+
+static CpuLoadSlot_t *prvGetSlot( const TaskStatus_t *pxTaskStatus, BaseType_t *pxNew )
+{
+UBaseType_t ux;
+CpuLoadSlot_t *pxFree = NULL;
+
+	*pxNew = pdFALSE;
+	for( ux = 0; ux < configCPU_LOAD_MAX_TASKS; ux++ )
+	{
+		if( xSlots[ ux ].uxTaskNumber == pxTaskStatus->xTaskNumber )
+		{
+			return &xSlots[ ux ];
+		}
+		if( xSlots[ ux ].uxTaskNumber == 0 && pxFree == NULL )
+		{
+			pxFree = &xSlots[ ux ];
+		}
+	}
+	if( pxFree != NULL )
+	{
+		/* Created since the last sample: the run time counter started with
+		zero, and the task had no load in the earlier buckets. */
+		*pxNew = pdTRUE;
+		pxFree->uxTaskNumber = pxTaskStatus->xTaskNumber;
+		pxFree->ulRunTime = 0;
+		( void ) memset( &pxFree->xHistory, 0, sizeof( CpuLoadHistory_t ) );
+		( void ) strncpy( pxFree->cName, pxTaskStatus->pcTaskName, configMAX_TASK_NAME_LEN );
+		pxFree->cName[ configMAX_TASK_NAME_LEN - 1 ] = '\0';
+	}
+	return pxFree;
+}
+/*-----------------------------------------------------------*/
+
+static uint16_t prvPermille( uint32_t ulPart, uint32_t ulTotal )
+{
+uint32_t ulResult;
+
+	if( ulTotal == 0 )
+	{
+		return 0;
+	}
+	if( ulPart >= ulTotal )
+	{
+		return ( uint16_t ) cpuloadPERMILLE;
+	}
+	if( ulTotal <= ( 0xFFFFFFFFUL / cpuloadPERMILLE ) )
+	{
+		ulResult = ( ulPart * cpuloadPERMILLE ) / ulTotal;
+	}
+	else
+	{
+		ulResult = ulPart / ( ulTotal / cpuloadPERMILLE );
+	}
+	if( ulResult > cpuloadPERMILLE )
+	{
+		ulResult = cpuloadPERMILLE;
+	}
+	return ( uint16_t ) ulResult;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddSecond( CpuLoadHistory_t *pxHistory, uint16_t usLoad )
+{
+	pxHistory->usSec[ ucSecIndex ] = usLoad;
+}
+/*-----------------------------------------------------------*/
+
+static void prvAddTenSeconds( CpuLoadHistory_t *pxHistory )
+{
+uint32_t ulSum = 0;
+UBaseType_t ux;
+
+	for( ux = 0; ux < cpuloadSECONDS; ux++ )
+	{
+		ulSum += pxHistory->usSec[ ux ];
+	}
+	pxHistory->usTenSec[ ucTenSecIndex ] = ( uint16_t ) ( ulSum / cpuloadSECONDS );
+}
+/*-----------------------------------------------------------*/
+
+static void prvGetLoad( const CpuLoadHistory_t *pxHistory, uint16_t *pusLoad )
+{
+uint32_t ulSum;
+UBaseType_t ux;
+
+	if( ucSecCount == 0 )
+	{
+		pusLoad[ cpuloadWINDOW_1S ] = 0;
+		pusLoad[ cpuloadWINDOW_10S ] = 0;
+		pusLoad[ cpuloadWINDOW_60S ] = 0;
+		return;
+	}
+	/* The newest one second bucket is the one written last. */
+	pusLoad[ cpuloadWINDOW_1S ] = pxHistory->usSec[ ( ucSecIndex + cpuloadSECONDS - 1 ) % cpuloadSECONDS ];
+	ulSum = 0;
+	for( ux = 0; ux < ucSecCount; ux++ )
+	{
+		ulSum += pxHistory->usSec[ ux ];
+	}
+	pusLoad[ cpuloadWINDOW_10S ] = ( uint16_t ) ( ulSum / ucSecCount );
+	if( ucTenSecCount == 0 )
+	{
+		/* Less than ten seconds sampled so far. */
+		pusLoad[ cpuloadWINDOW_60S ] = pusLoad[ cpuloadWINDOW_10S ];
+		return;
+	}
+	ulSum = 0;
+	for( ux = 0; ux < ucTenSecCount; ux++ )
+	{
+		ulSum += pxHistory->usTenSec[ ux ];
+	}
+	pusLoad[ cpuloadWINDOW_60S ] = ( uint16_t ) ( ulSum / ucTenSecCount );
+}
+
+#endif /* configUSE_CPU_LOAD */
+
+#endif /* configGENERATE_RUN_TIME_STATS */ /* << EST */
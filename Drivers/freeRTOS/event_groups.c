@@ -135,7 +135,7 @@ EventGroupHandle_t xEventGroupCreate( void )
 {
 EventGroup_t *pxEventBits;
 
-	pxEventBits = pvPortMalloc( sizeof( EventGroup_t ) );
+	pxEventBits = pvPortMallocObject( sizeof( EventGroup_t ) ); /* << EST */
 	if( pxEventBits != NULL )
 	{
 		pxEventBits->uxEventBits = 0;
@@ -581,7 +581,7 @@ const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 			( void ) xTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
 		}
 
-		vPortFree( pxEventBits );
+		vPortFreeObject( pxEventBits ); /* << EST */
 	}
 	( void ) xTaskResumeAll();
 }
@@ -142,6 +142,7 @@ static uint8_t *pucAlignedHeap = NULL;
 		}
 
 		traceMALLOC( pvReturn, xWantedSize );
+		portHEAP_TRACE_MALLOC( pvReturn, xWantedSize ); /* << EST */
 	}
 	( void ) xTaskResumeAll();
 
@@ -187,6 +188,15 @@ size_t xPortGetFreeHeapSize( void )
 {
 	return ( configADJUSTED_HEAP_SIZE - xNextFreeByte );
 }
+/*-----------------------------------------------------------*/
+
+#if configUSE_HEAP_TRACE /* << EST */
+void vPortWalkFreeBlocks( void (*pxCallback)( size_t xBlockSize, void *pvArg ), void *pvArg )
+{
+	/* The free memory is always the single block at the end. */
+	pxCallback( configADJUSTED_HEAP_SIZE - xNextFreeByte, pvArg );
+}
+#endif
 #endif /* configFRTOS_MEMORY_SCHEME==1 */ /* << EST */
 
 
@@ -234,6 +234,7 @@ void *pvReturn = NULL;
 		}
 
 		traceMALLOC( pvReturn, xWantedSize );
+		portHEAP_TRACE_MALLOC( pvReturn, xWantedSize ); /* << EST */
 	}
 	( void ) xTaskResumeAll();
 
@@ -277,6 +278,7 @@ BlockLink_t *pxLink;
 			prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
 			xFreeBytesRemaining += pxLink->xBlockSize;
 			traceFREE( pv, pxLink->xBlockSize );
+			portHEAP_TRACE_FREE( pv ); /* << EST */
 		}
 		( void ) xTaskResumeAll();
 	}
@@ -295,6 +297,27 @@ void vPortInitialiseBlocks( void )
 }
 /*-----------------------------------------------------------*/
 
+#if configUSE_HEAP_TRACE /* << EST */
+void vPortWalkFreeBlocks( void (*pxCallback)( size_t xBlockSize, void *pvArg ), void *pvArg )
+{
+BlockLink_t *pxBlock;
+
+	vTaskSuspendAll();
+	{
+		/* The list is empty until the first call to pvPortMalloc(). */
+		if( xStart.pxNextFreeBlock != NULL )
+		{
+			for( pxBlock = xStart.pxNextFreeBlock; pxBlock != &xEnd; pxBlock = pxBlock->pxNextFreeBlock )
+			{
+				pxCallback( pxBlock->xBlockSize, pvArg );
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+#endif
+/*-----------------------------------------------------------*/
+
 static void prvHeapInit( void )
 {
 BlockLink_t *pxFirstFreeBlock;
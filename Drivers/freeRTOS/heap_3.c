@@ -106,6 +106,7 @@ void *pvReturn;
 	{
 		pvReturn = malloc( xWantedSize );
 		traceMALLOC( pvReturn, xWantedSize );
+		portHEAP_TRACE_MALLOC( pvReturn, xWantedSize ); /* << EST */
 	}
 	( void ) xTaskResumeAll();
 
@@ -136,10 +137,21 @@ void vPortFree( void *pv )
 		{
 			free( pv );
 			traceFREE( pv, 0 );
+			portHEAP_TRACE_FREE( pv ); /* << EST */
 		}
 		( void ) xTaskResumeAll();
 	}
 }
+/*-----------------------------------------------------------*/
+
+#if configUSE_HEAP_TRACE /* << EST */
+void vPortWalkFreeBlocks( void (*pxCallback)( size_t xBlockSize, void *pvArg ), void *pvArg )
+{
+	/* The library heap does not expose its free blocks. */
+	( void ) pxCallback;
+	( void ) pvArg;
+}
+#endif
 
 
 #endif /* configFRTOS_MEMORY_SCHEME==3 */ /* << EST */
@@ -287,6 +287,7 @@ void *pvReturn = NULL;
 		}
 
 		traceMALLOC( pvReturn, xWantedSize );
+		portHEAP_TRACE_MALLOC( pvReturn, xWantedSize ); /* << EST */
 	}
 	( void ) xTaskResumeAll();
 
@@ -344,6 +345,7 @@ BlockLink_t *pxLink;
 					/* Add this block to the list of free blocks. */
 					xFreeBytesRemaining += pxLink->xBlockSize;
 					traceFREE( pv, pxLink->xBlockSize );
+					portHEAP_TRACE_FREE( pv ); /* << EST */
 					prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
 				}
 				( void ) xTaskResumeAll();
@@ -379,6 +381,27 @@ void vPortInitialiseBlocks( void )
 }
 /*-----------------------------------------------------------*/
 
+#if configUSE_HEAP_TRACE /* << EST */
+void vPortWalkFreeBlocks( void (*pxCallback)( size_t xBlockSize, void *pvArg ), void *pvArg )
+{
+BlockLink_t *pxBlock;
+
+	vTaskSuspendAll();
+	{
+		/* The list is empty until the first call to pvPortMalloc(). */
+		if( pxEnd != NULL )
+		{
+			for( pxBlock = xStart.pxNextFreeBlock; pxBlock != pxEnd; pxBlock = pxBlock->pxNextFreeBlock )
+			{
+				pxCallback( pxBlock->xBlockSize, pvArg );
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+#endif
+/*-----------------------------------------------------------*/
+
 static void prvHeapInit( void )
 {
 BlockLink_t *pxFirstFreeBlock;
@@ -0,0 +1,704 @@
+/* << EST */
+#include "FreeRTOSConfig.h"
+#if configFRTOS_MEMORY_SCHEME==5
+
+/*
+ * An implementation of pvPortMalloc() and vPortFree() based on the Two-Level
+ * Segregated Fit (TLSF) algorithm.  Free blocks are kept in an array of
+ * segregated free lists, indexed by a first level (power of two size class)
+ * and a second level (linear subdivision of that class).  Two bitmaps record
+ * which lists are non-empty, so finding a suitable free block is a couple of
+ * find-first-set operations instead of a list walk.  Adjacent free blocks are
+ * coalesced immediately in vPortFree().
+ *
+ * Both pvPortMalloc() and vPortFree() execute in bounded, constant time,
+ * independent of the number of free blocks.  This makes the scheme suitable
+ * for applications which allocate and free memory while running and need
+ * predictable latency.
+ *
+ * See heap_1.c, heap_2.c, heap_3.c and heap_4.c for alternative
+ * implementations.
+ */
+#include <stdlib.h>
+
+%- EST: Modification for Processor Expert port
+%for var from EventModules
+#include "%var.h"
+%endfor
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* log2 of the largest block size which can be managed.  With the default of
+16, a heap larger than 64 KByte is managed as several pools of up to 64 KByte,
+so no single allocation can be larger than this.  Increase it for larger
+blocks. */
+#ifndef configTLSF_FL_INDEX_MAX
+	#define configTLSF_FL_INDEX_MAX		16
+#endif
+
+/* log2 of the number of second level lists per first level class.  Larger
+values reduce internal fragmentation, but need more RAM for the list heads. */
+#ifndef configTLSF_SL_INDEX_COUNT_LOG2
+	#define configTLSF_SL_INDEX_COUNT_LOG2	3
+#endif
+
+/* All block sizes are a multiple of this.  The two lowest bits of the size are
+used as flags, so the alignment must be at least 4. */
+#if portBYTE_ALIGNMENT==8
+	#define tlsfALIGN_SIZE_LOG2			3
+#else
+	#define tlsfALIGN_SIZE_LOG2			2
+#endif
+#define tlsfALIGN_SIZE					( ( size_t ) 1 << tlsfALIGN_SIZE_LOG2 )
+
+#define tlsfSL_INDEX_COUNT				( 1 << configTLSF_SL_INDEX_COUNT_LOG2 )
+#define tlsfFL_INDEX_SHIFT				( configTLSF_SL_INDEX_COUNT_LOG2 + tlsfALIGN_SIZE_LOG2 )
+#define tlsfFL_INDEX_COUNT				( configTLSF_FL_INDEX_MAX - tlsfFL_INDEX_SHIFT + 1 )
+#define tlsfSMALL_BLOCK_SIZE			( ( size_t ) 1 << tlsfFL_INDEX_SHIFT )
+
+#if tlsfFL_INDEX_COUNT > 32
+	#error "configTLSF_FL_INDEX_MAX too large for the first level bitmap"
+#endif
+#if tlsfSL_INDEX_COUNT > 32
+	#error "configTLSF_SL_INDEX_COUNT_LOG2 too large for the second level bitmap"
+#endif
+
+/* Flags stored in the lowest bits of xSize. */
+#define tlsfBLOCK_FREE_BIT				( ( size_t ) 1 )
+#define tlsfBLOCK_PREV_FREE_BIT			( ( size_t ) 2 )
+#define tlsfBLOCK_FLAG_MASK				( tlsfBLOCK_FREE_BIT | tlsfBLOCK_PREV_FREE_BIT )
+
+/* A few bytes might be lost to byte aligning the heap start address. */
+#define heapADJUSTED_HEAP_SIZE			( configTOTAL_HEAP_SIZE - tlsfALIGN_SIZE )
+
+/* Allocate the memory for the heap. */
+#if configUSE_HEAP_SECTION_NAME && configCOMPILER==configCOMPILER_ARM_IAR /* << EST */
+  #pragma language=extended
+  #pragma location = configHEAP_SECTION_NAME_STRING
+  static unsigned char ucHeap[configTOTAL_HEAP_SIZE] @ configHEAP_SECTION_NAME_STRING;
+#elif configUSE_HEAP_SECTION_NAME
+  static unsigned char __attribute__((section (configHEAP_SECTION_NAME_STRING))) ucHeap[configTOTAL_HEAP_SIZE];
+#else
+static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif
+
+/* Header placed at the start of each block.  pxNextFree and pxPrevFree are
+only used while the block is free: for an allocated block this memory is part
+of the payload returned to the application. */
+typedef struct TLSF_BLOCK_HEADER
+{
+	struct TLSF_BLOCK_HEADER *pxPrevPhysBlock;	/*<< The block physically in front of this one, NULL for the first block. */
+	size_t xSize;								/*<< Payload size in bytes, ORed with the tlsfBLOCK_*_BIT flags. */
+	struct TLSF_BLOCK_HEADER *pxNextFree;		/*<< Next block in the same segregated free list. */
+	struct TLSF_BLOCK_HEADER *pxPrevFree;		/*<< Previous block in the same segregated free list. */
+} TLSFBlock_t;
+
+/* Bytes in front of the payload of each block, and the smallest payload able
+to hold the free list pointers. */
+#define tlsfBLOCK_OVERHEAD				( ( ( sizeof( TLSFBlock_t * ) + sizeof( size_t ) ) + ( tlsfALIGN_SIZE - 1 ) ) & ~( tlsfALIGN_SIZE - 1 ) )
+#define tlsfBLOCK_SIZE_MIN				( ( ( sizeof( TLSFBlock_t ) - tlsfBLOCK_OVERHEAD ) + ( tlsfALIGN_SIZE - 1 ) ) & ~( tlsfALIGN_SIZE - 1 ) )
+#define tlsfBLOCK_SIZE_MAX				( ( uint32_t ) 1 << ( configTLSF_FL_INDEX_MAX ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void );
+
+/*
+ * Maps a block size to its first and second level list index.
+ */
+static void prvMappingInsert( size_t xSize, BaseType_t *pxFl, BaseType_t *pxSl );
+
+/*
+ * Rounds up the size to the next list, so any block found there is large
+ * enough, and maps it to the first and second level list index.
+ */
+static void prvMappingSearch( size_t xSize, BaseType_t *pxFl, BaseType_t *pxSl );
+
+/*
+ * Returns a free block at least as large as the list selected by *pxFl and
+ * *pxSl, or NULL.  The indices are updated to the list of the returned block.
+ */
+static TLSFBlock_t *prvSearchSuitableBlock( BaseType_t *pxFl, BaseType_t *pxSl );
+
+/*
+ * Add or remove a block to/from the segregated free lists.
+ */
+static void prvInsertFreeBlock( TLSFBlock_t *pxBlock );
+static void prvRemoveFreeBlock( TLSFBlock_t *pxBlock, BaseType_t xFl, BaseType_t xSl );
+
+/*
+ * Splits the block if it is large enough to hold xSize plus another block.
+ * The remainder is put back into the free lists.
+ */
+static void prvTrimBlock( TLSFBlock_t *pxBlock, size_t xSize );
+
+/*
+ * Coalesces a block which is being freed with its free physical neighbours.
+ */
+static TLSFBlock_t *prvMergeBlock( TLSFBlock_t *pxBlock );
+
+/*-----------------------------------------------------------*/
+
+/* Segregated free list heads and the bitmaps marking the non-empty lists. */
+static TLSFBlock_t *pxFreeLists[ tlsfFL_INDEX_COUNT ][ tlsfSL_INDEX_COUNT ];
+static uint32_t ulFlBitmap = 0;
+static uint32_t ulSlBitmap[ tlsfFL_INDEX_COUNT ];
+
+/* Set once prvHeapInit() has been called. */
+static BaseType_t xHeapHasBeenInitialised = pdFALSE;
+
+/* The first block of the heap, and the zero sized end marker of the last
+pool, used to walk all blocks. */
+static TLSFBlock_t *pxHeapStart = NULL;
+static TLSFBlock_t *pxHeapEnd = NULL;
+
+/* Payload bytes in all free blocks, and the lowest value it ever had. */
+static size_t xFreeBytesRemaining = 0;
+static size_t xMinimumEverFreeBytesRemaining = 0;
+
+/* Number of calls to pvPortMalloc() and vPortFree() which succeeded. */
+static size_t xNumberOfSuccessfulAllocations = 0;
+static size_t xNumberOfSuccessfulFrees = 0;
+
+/*-----------------------------------------------------------*/
+
+#define prvBlockSize( pxBlock )			( ( pxBlock )->xSize & ~tlsfBLOCK_FLAG_MASK )
+#define prvBlockIsFree( pxBlock )		( ( ( pxBlock )->xSize & tlsfBLOCK_FREE_BIT ) != 0 )
+#define prvBlockIsPrevFree( pxBlock )	( ( ( pxBlock )->xSize & tlsfBLOCK_PREV_FREE_BIT ) != 0 )
+#define prvBlockToPtr( pxBlock )		( ( void * ) ( ( ( uint8_t * ) ( pxBlock ) ) + tlsfBLOCK_OVERHEAD ) )
+#define prvBlockFromPtr( pv )			( ( TLSFBlock_t * ) ( void * ) ( ( ( uint8_t * ) ( pv ) ) - tlsfBLOCK_OVERHEAD ) )
+#define prvBlockNext( pxBlock )			( ( TLSFBlock_t * ) ( void * ) ( ( ( uint8_t * ) ( pxBlock ) ) + tlsfBLOCK_OVERHEAD + prvBlockSize( pxBlock ) ) )
+
+/*-----------------------------------------------------------*/
+
+/* Find last set: index of the most significant bit set, or -1 for zero. */
+static BaseType_t prvFls( uint32_t ulWord )
+{
+#if defined(__GNUC__)
+	return ( ulWord == 0 ) ? -1 : ( BaseType_t ) ( 31 - __builtin_clz( ulWord ) );
+#else
+BaseType_t xBit = 32;
+
+	/* Binary search, so the number of steps does not depend on the value. */
+	if( ulWord == 0 )
+	{
+		return -1;
+	}
+	if( ( ulWord & 0xffff0000UL ) == 0 ) { ulWord <<= 16; xBit -= 16; }
+	if( ( ulWord & 0xff000000UL ) == 0 ) { ulWord <<= 8; xBit -= 8; }
+	if( ( ulWord & 0xf0000000UL ) == 0 ) { ulWord <<= 4; xBit -= 4; }
+	if( ( ulWord & 0xc0000000UL ) == 0 ) { ulWord <<= 2; xBit -= 2; }
+	if( ( ulWord & 0x80000000UL ) == 0 ) { xBit -= 1; }
+	return xBit - 1;
+#endif
+}
+
+/* Find first set: index of the least significant bit set, or -1 for zero. */
+static BaseType_t prvFfs( uint32_t ulWord )
+{
+#if defined(__GNUC__)
+	return ( ulWord == 0 ) ? -1 : ( BaseType_t ) __builtin_ctz( ulWord );
+#else
+	return prvFls( ulWord & ( ~ulWord + 1UL ) );
+#endif
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortMalloc( size_t xWantedSize )
+{
+TLSFBlock_t *pxBlock;
+BaseType_t xFl, xSl;
+void *pvReturn = NULL;
+
+	vTaskSuspendAll();
+	{
+		/* If this is the first call to malloc then the heap will require
+		initialisation to setup the free lists. */
+		if( xHeapHasBeenInitialised == pdFALSE )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		if( ( xWantedSize > 0 ) && ( xWantedSize < tlsfBLOCK_SIZE_MAX ) )
+		{
+			/* Ensure that blocks are always aligned and large enough to hold
+			the free list pointers once they are returned. */
+			xWantedSize = ( xWantedSize + ( tlsfALIGN_SIZE - 1 ) ) & ~( tlsfALIGN_SIZE - 1 );
+			if( xWantedSize < tlsfBLOCK_SIZE_MIN )
+			{
+				xWantedSize = tlsfBLOCK_SIZE_MIN;
+			}
+
+			prvMappingSearch( xWantedSize, &xFl, &xSl );
+			if( xFl < tlsfFL_INDEX_COUNT )
+			{
+				pxBlock = prvSearchSuitableBlock( &xFl, &xSl );
+				if( pxBlock != NULL )
+				{
+					prvRemoveFreeBlock( pxBlock, xFl, xSl );
+					prvTrimBlock( pxBlock, xWantedSize );
+
+					/* The block is being returned - it is owned by the
+					application now. */
+					pxBlock->xSize &= ~tlsfBLOCK_FREE_BIT;
+					prvBlockNext( pxBlock )->xSize &= ~tlsfBLOCK_PREV_FREE_BIT;
+
+					if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+					{
+						xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+					}
+					else
+					{
+						mtCOVERAGE_TEST_MARKER();
+					}
+					xNumberOfSuccessfulAllocations++;
+					pvReturn = prvBlockToPtr( pxBlock );
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		traceMALLOC( pvReturn, xWantedSize );
+		portHEAP_TRACE_MALLOC( pvReturn, xWantedSize );
+	}
+	( void ) xTaskResumeAll();
+
+	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
+	{
+		if( pvReturn == NULL )
+		{
+%- EST: Modification for Processor Expert port
+%if defined(vApplicationMallocFailedHook)
+      %vApplicationMallocFailedHook();
+%else
+			extern void vApplicationMallocFailedHook( void );
+			vApplicationMallocFailedHook();
+%endif
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	#endif
+
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void *pv )
+{
+TLSFBlock_t *pxBlock;
+
+	if( pv != NULL )
+	{
+		/* The memory being freed has a TLSFBlock_t header in front of it. */
+		pxBlock = prvBlockFromPtr( pv );
+
+		/* Check the block is actually allocated. */
+		configASSERT( !prvBlockIsFree( pxBlock ) );
+
+		if( !prvBlockIsFree( pxBlock ) )
+		{
+			vTaskSuspendAll();
+			{
+				traceFREE( pv, prvBlockSize( pxBlock ) );
+				portHEAP_TRACE_FREE( pv );
+				pxBlock->xSize |= tlsfBLOCK_FREE_BIT;
+				pxBlock = prvMergeBlock( pxBlock );
+				prvBlockNext( pxBlock )->xSize |= tlsfBLOCK_PREV_FREE_BIT;
+				prvInsertFreeBlock( pxBlock );
+				xNumberOfSuccessfulFrees++;
+			}
+			( void ) xTaskResumeAll();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+	return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+	return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats )
+{
+TLSFBlock_t *pxBlock;
+size_t xSize, xMaxSize = 0, xMinSize = ( size_t ) -1, xBlocks = 0;
+
+	vTaskSuspendAll();
+	{
+		if( xHeapHasBeenInitialised == pdFALSE )
+		{
+			prvHeapInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		/* Walk the physical blocks up to the end marker of the last pool.
+		This is not constant time and only meant for diagnostics. */
+		pxBlock = pxHeapStart;
+		while( pxBlock != pxHeapEnd )
+		{
+			if( prvBlockIsFree( pxBlock ) )
+			{
+				xSize = prvBlockSize( pxBlock );
+				if( xSize > xMaxSize )
+				{
+					xMaxSize = xSize;
+				}
+				if( xSize < xMinSize )
+				{
+					xMinSize = xSize;
+				}
+				xBlocks++;
+			}
+			pxBlock = prvBlockNext( pxBlock );
+		}
+
+		pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+		pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+		pxHeapStats->xSizeOfSmallestFreeBlockInBytes = ( xBlocks == 0 ) ? 0 : xMinSize;
+		pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+		pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+		pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+		pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+		/* 0 if all free memory is one block, approaching 100 if the free
+		memory is split into many small blocks. */
+		if( xFreeBytesRemaining == 0 )
+		{
+			pxHeapStats->ucFragmentationIndex = 0;
+		}
+		else
+		{
+			pxHeapStats->ucFragmentationIndex = ( uint8_t ) ( 100 - ( ( ( uint32_t ) xMaxSize * 100UL ) / ( uint32_t ) xFreeBytesRemaining ) );
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+	/* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+#if configUSE_HEAP_TRACE
+void vPortWalkFreeBlocks( void (*pxCallback)( size_t xBlockSize, void *pvArg ), void *pvArg )
+{
+TLSFBlock_t *pxBlock;
+
+	vTaskSuspendAll();
+	{
+		if( xHeapHasBeenInitialised != pdFALSE )
+		{
+			pxBlock = pxHeapStart;
+			while( pxBlock != pxHeapEnd )
+			{
+				if( prvBlockIsFree( pxBlock ) )
+				{
+					pxCallback( prvBlockSize( pxBlock ), pvArg );
+				}
+				pxBlock = prvBlockNext( pxBlock );
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+#endif
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+TLSFBlock_t *pxFirstBlock, *pxEndBlock = NULL;
+uint8_t *pucPool;
+size_t xRemaining, xPoolSize;
+
+	/* Ensure the heap starts on a correctly aligned boundary. */
+	pucPool = ( uint8_t * ) ( ( ( portPOINTER_SIZE_TYPE ) &ucHeap[ tlsfALIGN_SIZE - 1 ] ) & ( ( portPOINTER_SIZE_TYPE ) ~( tlsfALIGN_SIZE - 1 ) ) );
+	pxHeapStart = ( void * ) pucPool;
+	xRemaining = ( ( size_t ) heapADJUSTED_HEAP_SIZE ) & ~( tlsfALIGN_SIZE - 1 );
+
+	/* Each pool holds one free block and a zero sized allocated end marker,
+	so the last block always has a valid physical successor.  Blocks larger
+	than tlsfBLOCK_SIZE_MAX cannot be mapped to a list, so a larger heap is
+	split into several pools.  The end marker of a pool is followed by the
+	first block of the next one, and as it is never free, blocks of different
+	pools are not coalesced. */
+	while( xRemaining >= ( 2 * tlsfBLOCK_OVERHEAD ) + tlsfBLOCK_SIZE_MIN )
+	{
+		xPoolSize = xRemaining - ( 2 * tlsfBLOCK_OVERHEAD );
+		if( xPoolSize >= tlsfBLOCK_SIZE_MAX )
+		{
+			xPoolSize = ( size_t ) ( tlsfBLOCK_SIZE_MAX - tlsfALIGN_SIZE );
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxFirstBlock = ( void * ) pucPool;
+		pxFirstBlock->pxPrevPhysBlock = pxEndBlock;
+		pxFirstBlock->xSize = xPoolSize | tlsfBLOCK_FREE_BIT;
+
+		pxEndBlock = prvBlockNext( pxFirstBlock );
+		pxEndBlock->pxPrevPhysBlock = pxFirstBlock;
+		pxEndBlock->xSize = tlsfBLOCK_PREV_FREE_BIT;
+
+		prvInsertFreeBlock( pxFirstBlock );
+		pucPool = ( uint8_t * ) prvBlockNext( pxEndBlock );
+		xRemaining -= xPoolSize + ( 2 * tlsfBLOCK_OVERHEAD );
+	}
+	/* configTOTAL_HEAP_SIZE is too small to hold a single block. */
+	configASSERT( pxEndBlock != NULL );
+	pxHeapEnd = pxEndBlock;
+
+	xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+	xHeapHasBeenInitialised = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingInsert( size_t xSize, BaseType_t *pxFl, BaseType_t *pxSl )
+{
+BaseType_t xFl, xSl;
+
+	if( xSize < tlsfSMALL_BLOCK_SIZE )
+	{
+		/* Small blocks are stored in the first list, linearly subdivided. */
+		xFl = 0;
+		xSl = ( BaseType_t ) ( xSize / ( tlsfSMALL_BLOCK_SIZE / tlsfSL_INDEX_COUNT ) );
+	}
+	else
+	{
+		xFl = prvFls( ( uint32_t ) xSize );
+		xSl = ( BaseType_t ) ( ( ( uint32_t ) xSize >> ( xFl - configTLSF_SL_INDEX_COUNT_LOG2 ) ) ^ ( 1UL << configTLSF_SL_INDEX_COUNT_LOG2 ) );
+		xFl -= ( tlsfFL_INDEX_SHIFT - 1 );
+	}
+	*pxFl = xFl;
+	*pxSl = xSl;
+}
+/*-----------------------------------------------------------*/
+
+static void prvMappingSearch( size_t xSize, BaseType_t *pxFl, BaseType_t *pxSl )
+{
+uint32_t ulSize = ( uint32_t ) xSize;
+
+	if( ulSize >= tlsfSMALL_BLOCK_SIZE )
+	{
+		ulSize += ( 1UL << ( prvFls( ulSize ) - configTLSF_SL_INDEX_COUNT_LOG2 ) ) - 1UL;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+	if( ulSize >= tlsfBLOCK_SIZE_MAX )
+	{
+		/* Rounded up beyond the largest class: no list can satisfy it. */
+		*pxFl = tlsfFL_INDEX_COUNT;
+		*pxSl = 0;
+		return;
+	}
+	prvMappingInsert( ( size_t ) ulSize, pxFl, pxSl );
+}
+/*-----------------------------------------------------------*/
+
+static TLSFBlock_t *prvSearchSuitableBlock( BaseType_t *pxFl, BaseType_t *pxSl )
+{
+BaseType_t xFl = *pxFl;
+uint32_t ulSlMap, ulFlMap;
+
+	/* First search for a list in the same first level class with a second
+	level index at least as large. */
+	ulSlMap = ulSlBitmap[ xFl ] & ( ~0UL << *pxSl );
+	if( ulSlMap == 0 )
+	{
+		/* None, so take the smallest non-empty larger first level class. */
+		if( xFl + 1 >= 32 )
+		{
+			return NULL;
+		}
+		ulFlMap = ulFlBitmap & ( ~0UL << ( xFl + 1 ) );
+		if( ulFlMap == 0 )
+		{
+			return NULL;
+		}
+		xFl = prvFfs( ulFlMap );
+		ulSlMap = ulSlBitmap[ xFl ];
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+	*pxFl = xFl;
+	*pxSl = prvFfs( ulSlMap );
+	return pxFreeLists[ xFl ][ *pxSl ];
+}
+/*-----------------------------------------------------------*/
+
+static void prvInsertFreeBlock( TLSFBlock_t *pxBlock )
+{
+BaseType_t xFl, xSl;
+TLSFBlock_t *pxHead;
+
+	prvMappingInsert( prvBlockSize( pxBlock ), &xFl, &xSl );
+	pxHead = pxFreeLists[ xFl ][ xSl ];
+	pxBlock->pxNextFree = pxHead;
+	pxBlock->pxPrevFree = NULL;
+	if( pxHead != NULL )
+	{
+		pxHead->pxPrevFree = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+	pxFreeLists[ xFl ][ xSl ] = pxBlock;
+	ulFlBitmap |= ( 1UL << xFl );
+	ulSlBitmap[ xFl ] |= ( 1UL << xSl );
+	xFreeBytesRemaining += prvBlockSize( pxBlock );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRemoveFreeBlock( TLSFBlock_t *pxBlock, BaseType_t xFl, BaseType_t xSl )
+{
+	if( pxBlock->pxPrevFree != NULL )
+	{
+		pxBlock->pxPrevFree->pxNextFree = pxBlock->pxNextFree;
+	}
+	else
+	{
+		/* The block is the list head. */
+		pxFreeLists[ xFl ][ xSl ] = pxBlock->pxNextFree;
+		if( pxBlock->pxNextFree == NULL )
+		{
+			/* The list is empty now. */
+			ulSlBitmap[ xFl ] &= ~( 1UL << xSl );
+			if( ulSlBitmap[ xFl ] == 0 )
+			{
+				ulFlBitmap &= ~( 1UL << xFl );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	if( pxBlock->pxNextFree != NULL )
+	{
+		pxBlock->pxNextFree->pxPrevFree = pxBlock->pxPrevFree;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+	xFreeBytesRemaining -= prvBlockSize( pxBlock );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTrimBlock( TLSFBlock_t *pxBlock, size_t xSize )
+{
+TLSFBlock_t *pxRemaining;
+size_t xBlockSize = prvBlockSize( pxBlock );
+
+	if( xBlockSize >= xSize + tlsfBLOCK_OVERHEAD + tlsfBLOCK_SIZE_MIN )
+	{
+		/* Split off the tail as a new free block. */
+		pxBlock->xSize = xSize | ( pxBlock->xSize & tlsfBLOCK_FLAG_MASK );
+		pxRemaining = prvBlockNext( pxBlock );
+		pxRemaining->pxPrevPhysBlock = pxBlock;
+		pxRemaining->xSize = ( xBlockSize - xSize - tlsfBLOCK_OVERHEAD ) | tlsfBLOCK_FREE_BIT;
+		prvBlockNext( pxRemaining )->pxPrevPhysBlock = pxRemaining;
+		/* The block in front of the remainder gets allocated by the caller,
+		the block behind it already has its previous-free flag set. */
+		prvInsertFreeBlock( pxRemaining );
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static TLSFBlock_t *prvMergeBlock( TLSFBlock_t *pxBlock )
+{
+TLSFBlock_t *pxNeighbour;
+BaseType_t xFl, xSl;
+
+	/* Coalesce with the block in front if it is free. */
+	if( prvBlockIsPrevFree( pxBlock ) )
+	{
+		pxNeighbour = pxBlock->pxPrevPhysBlock;
+		prvMappingInsert( prvBlockSize( pxNeighbour ), &xFl, &xSl );
+		prvRemoveFreeBlock( pxNeighbour, xFl, xSl );
+		pxNeighbour->xSize += prvBlockSize( pxBlock ) + tlsfBLOCK_OVERHEAD;
+		pxBlock = pxNeighbour;
+		prvBlockNext( pxBlock )->pxPrevPhysBlock = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	/* Coalesce with the block behind if it is free.  The end markers are
+	never free, so this does not run past the end of a pool. */
+	pxNeighbour = prvBlockNext( pxBlock );
+	if( prvBlockIsFree( pxNeighbour ) )
+	{
+		prvMappingInsert( prvBlockSize( pxNeighbour ), &xFl, &xSl );
+		prvRemoveFreeBlock( pxNeighbour, xFl, xSl );
+		pxBlock->xSize += prvBlockSize( pxNeighbour ) + tlsfBLOCK_OVERHEAD;
+		prvBlockNext( pxBlock )->pxPrevPhysBlock = pxBlock;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+	return pxBlock;
+}
+
+#endif /* configFRTOS_MEMORY_SCHEME==5 */ /* << EST */
@@ -0,0 +1,464 @@
+/* << EST */
+#include "FreeRTOSConfig.h"
+#if configUSE_HEAP_TRACE
+
+/*
+ * Optional instrumentation of pvPortMalloc() and vPortFree().
+ *
+ * The heap implementations call vPortHeapTraceMalloc() and vPortHeapTraceFree()
+ * through the portHEAP_TRACE_MALLOC()/portHEAP_TRACE_FREE() hooks.  Each call
+ * is recorded with its tick count, address, size, calling task and return
+ * address into a ring of configHEAP_TRACE_RING_SIZE entries, so the latest
+ * allocator activity can be inspected or dumped for an offline timeline.
+ *
+ * Additionally, up to configHEAP_TRACE_LIVE_SIZE currently allocated blocks are
+ * kept in an open addressed table (keyed by address), which is used to report
+ * the live blocks and bytes per task.  Allocations which do not fit into the
+ * table are only counted.
+ */
+#include <string.h>
+
+%- EST: Modification for Processor Expert port
+%for var from EventModules
+#include "%var.h"
+%endfor
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configHEAP_TRACE_LIVE_SIZE & ( configHEAP_TRACE_LIVE_SIZE - 1 ) ) != 0
+	#error "configHEAP_TRACE_LIVE_SIZE must be a power of two"
+#endif
+
+#define heaptraceLIVE_MASK			( configHEAP_TRACE_LIVE_SIZE - 1 )
+#define heaptraceMALLOC_FLAG		( 0x80000000UL )
+
+/* Upper size of the first fragmentation histogram bin is 2^4 bytes. */
+#define heaptraceFIRST_BIN_LOG2		( 4 )
+
+/* Histogram passed to prvBinFreeBlock(). */
+typedef struct HEAP_TRACE_BINS
+{
+	size_t *pxBins;
+	UBaseType_t uxNofBins;
+} HeapTraceBins_t;
+
+/* Currently allocated block, pvAddress is NULL for an empty slot. */
+typedef struct HEAP_TRACE_LIVE
+{
+	void *pvAddress;
+	TaskHandle_t xTask;
+	size_t xSize;
+} HeapTraceLive_t;
+
+static HeapTraceRecord_t xRing[ configHEAP_TRACE_RING_SIZE ];
+static UBaseType_t uxRingNext = 0;			/* Index of the next record to write. */
+static uint32_t ulRingTotal = 0;			/* Number of records ever written. */
+static volatile BaseType_t xRingFrozen = pdFALSE;	/* No records are added while set. */
+
+static HeapTraceLive_t xLive[ configHEAP_TRACE_LIVE_SIZE ];
+static UBaseType_t uxLiveUntracked = 0;		/* Live blocks which did not fit into xLive. */
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the task which is allocating, or NULL if not known.
+ */
+static TaskHandle_t prvCurrentTask( void );
+
+/*
+ * Adds a record to the ring, overwriting the oldest one.
+ */
+static void prvRecord( uint32_t ulTimestamp, void *pv, size_t xSize, void *pvCaller, uint32_t ulFlags, TaskHandle_t xTask );
+
+/*
+ * Fills the blob header for uxRecords records.
+ */
+static void prvFillHeader( HeapTraceBlobHeader_t *pxHeader, UBaseType_t uxRecords );
+
+/*
+ * Adds or removes a block to/from the table of live blocks.
+ */
+static void prvLiveInsert( void *pv, size_t xSize, TaskHandle_t xTask );
+static void prvLiveRemove( void *pv );
+
+/*
+ * Histogram callback for vPortWalkFreeBlocks().
+ */
+static void prvBinFreeBlock( size_t xBlockSize, void *pvArg );
+
+/*-----------------------------------------------------------*/
+
+void vPortHeapTraceMalloc( void *pv, size_t xSize, void *pvCaller )
+{
+TaskHandle_t xTask;
+
+	if( pv != NULL )
+	{
+		xTask = prvCurrentTask();
+		taskENTER_CRITICAL();
+		{
+			prvRecord( ( uint32_t ) xTaskGetTickCount(), pv, xSize, pvCaller, heaptraceMALLOC_FLAG, xTask );
+			prvLiveInsert( pv, xSize, xTask );
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortHeapTraceMallocFromISR( void *pv, size_t xSize, void *pvCaller )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	/* Blocks allocated from an interrupt are not owned by a task. */
+	if( pv != NULL )
+	{
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			prvRecord( ( uint32_t ) xTaskGetTickCountFromISR(), pv, xSize, pvCaller, heaptraceMALLOC_FLAG, NULL );
+			prvLiveInsert( pv, xSize, NULL );
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortHeapTraceFree( void *pv, void *pvCaller )
+{
+TaskHandle_t xTask;
+
+	if( pv != NULL )
+	{
+		xTask = prvCurrentTask();
+		taskENTER_CRITICAL();
+		{
+			prvRecord( ( uint32_t ) xTaskGetTickCount(), pv, 0, pvCaller, 0, xTask );
+			prvLiveRemove( pv );
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortHeapTraceFreeFromISR( void *pv, void *pvCaller )
+{
+UBaseType_t uxSavedInterruptStatus;
+
+	if( pv != NULL )
+	{
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			prvRecord( ( uint32_t ) xTaskGetTickCountFromISR(), pv, 0, pvCaller, 0, NULL );
+			prvLiveRemove( pv );
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vHeapTraceFreeze( BaseType_t xFreeze )
+{
+	xRingFrozen = xFreeze;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxHeapTraceGetRecords( HeapTraceRecord_t *pxRecords, UBaseType_t uxMaxRecords )
+{
+UBaseType_t uxCount, uxIndex, ux;
+
+	taskENTER_CRITICAL();
+	{
+		/* Copy the newest records, oldest first. */
+		uxCount = ( ulRingTotal < configHEAP_TRACE_RING_SIZE ) ? ( UBaseType_t ) ulRingTotal : configHEAP_TRACE_RING_SIZE;
+		if( uxCount > uxMaxRecords )
+		{
+			uxCount = uxMaxRecords;
+		}
+		uxIndex = uxRingNext + configHEAP_TRACE_RING_SIZE - uxCount;
+		for( ux = 0; ux < uxCount; ux++ )
+		{
+			if( uxIndex >= configHEAP_TRACE_RING_SIZE )
+			{
+				uxIndex -= configHEAP_TRACE_RING_SIZE;
+			}
+			pxRecords[ ux ] = xRing[ uxIndex ];
+			uxIndex++;
+		}
+	}
+	taskEXIT_CRITICAL();
+	return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+size_t xHeapTraceGetBlob( uint8_t *pucBuffer, size_t xBufferSize )
+{
+HeapTraceBlobHeader_t xHeader;
+UBaseType_t uxRecords;
+
+	/* Header followed by the records, oldest first, in target byte order. */
+	if( xBufferSize < sizeof( HeapTraceBlobHeader_t ) )
+	{
+		return 0;
+	}
+	uxRecords = uxHeapTraceGetRecords( ( HeapTraceRecord_t * ) ( void * ) ( pucBuffer + sizeof( HeapTraceBlobHeader_t ) ), ( UBaseType_t ) ( ( xBufferSize - sizeof( HeapTraceBlobHeader_t ) ) / sizeof( HeapTraceRecord_t ) ) );
+	prvFillHeader( &xHeader, uxRecords );
+	( void ) memcpy( pucBuffer, &xHeader, sizeof( HeapTraceBlobHeader_t ) );
+	return sizeof( HeapTraceBlobHeader_t ) + ( uxRecords * sizeof( HeapTraceRecord_t ) );
+}
+/*-----------------------------------------------------------*/
+
+size_t xHeapTraceReadBlob( size_t xOffset, uint8_t *pucBuffer, size_t xBufferSize )
+{
+HeapTraceBlobHeader_t xHeader;
+UBaseType_t uxRecords, uxIndex;
+size_t xBlobSize, xPos, xChunk, xCopied = 0;
+const uint8_t *pucSource;
+
+	/* Same content as xHeapTraceGetBlob() with all records, copied piecewise
+	from the ring.  The pieces only fit together while the ring is frozen. */
+	taskENTER_CRITICAL();
+	{
+		uxRecords = ( ulRingTotal < configHEAP_TRACE_RING_SIZE ) ? ( UBaseType_t ) ulRingTotal : configHEAP_TRACE_RING_SIZE;
+		prvFillHeader( &xHeader, uxRecords );
+		xBlobSize = sizeof( HeapTraceBlobHeader_t ) + ( uxRecords * sizeof( HeapTraceRecord_t ) );
+		while( ( xCopied < xBufferSize ) && ( xOffset < xBlobSize ) )
+		{
+			if( xOffset < sizeof( HeapTraceBlobHeader_t ) )
+			{
+				pucSource = ( const uint8_t * ) &xHeader;
+				xPos = xOffset;
+				xChunk = sizeof( HeapTraceBlobHeader_t ) - xPos;
+			}
+			else
+			{
+				/* Record uxIndex of the blob, counted from the oldest one. */
+				uxIndex = ( UBaseType_t ) ( ( xOffset - sizeof( HeapTraceBlobHeader_t ) ) / sizeof( HeapTraceRecord_t ) );
+				uxIndex += uxRingNext + configHEAP_TRACE_RING_SIZE - uxRecords;
+				if( uxIndex >= configHEAP_TRACE_RING_SIZE )
+				{
+					uxIndex -= configHEAP_TRACE_RING_SIZE;
+				}
+				pucSource = ( const uint8_t * ) &xRing[ uxIndex ];
+				xPos = ( xOffset - sizeof( HeapTraceBlobHeader_t ) ) %% sizeof( HeapTraceRecord_t );
+				xChunk = sizeof( HeapTraceRecord_t ) - xPos;
+			}
+			if( xChunk > ( xBufferSize - xCopied ) )
+			{
+				xChunk = xBufferSize - xCopied;
+			}
+			( void ) memcpy( pucBuffer + xCopied, pucSource + xPos, xChunk );
+			xCopied += xChunk;
+			xOffset += xChunk;
+		}
+	}
+	taskEXIT_CRITICAL();
+	return xCopied;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxHeapTraceGetTaskUsage( HeapTraceTaskUsage_t *pxUsage, UBaseType_t uxMaxTasks, UBaseType_t *puxUntracked )
+{
+UBaseType_t uxTasks = 0, ux, uxTask;
+
+	taskENTER_CRITICAL();
+	{
+		for( ux = 0; ux < configHEAP_TRACE_LIVE_SIZE; ux++ )
+		{
+			if( xLive[ ux ].pvAddress == NULL )
+			{
+				continue;
+			}
+			for( uxTask = 0; uxTask < uxTasks; uxTask++ )
+			{
+				if( pxUsage[ uxTask ].pvTask == xLive[ ux ].xTask )
+				{
+					break;
+				}
+			}
+			if( uxTask == uxTasks )
+			{
+				if( uxTasks == uxMaxTasks )
+				{
+					continue; /* no room for another task */
+				}
+				pxUsage[ uxTask ].pvTask = xLive[ ux ].xTask;
+				pxUsage[ uxTask ].xBlocks = 0;
+				pxUsage[ uxTask ].xBytes = 0;
+				uxTasks++;
+			}
+			pxUsage[ uxTask ].xBlocks++;
+			pxUsage[ uxTask ].xBytes += xLive[ ux ].xSize;
+		}
+		if( puxUntracked != NULL )
+		{
+			*puxUntracked = uxLiveUntracked;
+		}
+	}
+	taskEXIT_CRITICAL();
+	return uxTasks;
+}
+/*-----------------------------------------------------------*/
+
+void vHeapTraceGetFragmentation( size_t *pxBins, UBaseType_t uxNofBins )
+{
+HeapTraceBins_t xBins;
+UBaseType_t ux;
+
+	for( ux = 0; ux < uxNofBins; ux++ )
+	{
+		pxBins[ ux ] = 0;
+	}
+	xBins.pxBins = pxBins;
+	xBins.uxNofBins = uxNofBins;
+	vPortWalkFreeBlocks( prvBinFreeBlock, &xBins );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBinFreeBlock( size_t xBlockSize, void *pvArg )
+{
+HeapTraceBins_t *pxBins = ( HeapTraceBins_t * ) pvArg;
+UBaseType_t uxBin = 0;
+
+	/* Bin 0 counts blocks below 2^heaptraceFIRST_BIN_LOG2 bytes, each further
+	bin doubles the size, the last one is open ended. */
+	xBlockSize >>= heaptraceFIRST_BIN_LOG2;
+	while( ( xBlockSize != 0 ) && ( uxBin < ( pxBins->uxNofBins - 1 ) ) )
+	{
+		xBlockSize >>= 1;
+		uxBin++;
+	}
+	pxBins->pxBins[ uxBin ]++;
+}
+/*-----------------------------------------------------------*/
+
+static TaskHandle_t prvCurrentTask( void )
+{
+#if INCLUDE_xTaskGetCurrentTaskHandle && INCLUDE_xTaskGetSchedulerState
+	if( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED )
+	{
+		return xTaskGetCurrentTaskHandle();
+	}
+#endif
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillHeader( HeapTraceBlobHeader_t *pxHeader, UBaseType_t uxRecords )
+{
+	pxHeader->ulMagic = heaptraceBLOB_MAGIC;
+	pxHeader->usVersion = heaptraceBLOB_VERSION;
+	pxHeader->ucPointerSize = ( uint8_t ) sizeof( void * );
+	pxHeader->ucRecordSize = ( uint8_t ) sizeof( HeapTraceRecord_t );
+	pxHeader->ulTickRateHz = configTICK_RATE_HZ;
+	pxHeader->ulNofRecords = ( uint32_t ) uxRecords;
+	pxHeader->ulTotalRecords = ulRingTotal;
+	pxHeader->ulReserved = 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecord( uint32_t ulTimestamp, void *pv, size_t xSize, void *pvCaller, uint32_t ulFlags, TaskHandle_t xTask )
+{
+HeapTraceRecord_t *pxRecord = &xRing[ uxRingNext ];
+
+	if( xRingFrozen != pdFALSE )
+	{
+		/* A dump is in progress: the record is lost, but the live blocks
+		are still tracked by the caller. */
+		return;
+	}
+	pxRecord->ulTimestamp = ulTimestamp;
+	pxRecord->pvAddress = pv;
+	pxRecord->pvCaller = pvCaller;
+	pxRecord->pvTask = xTask;
+	pxRecord->ulSizeAndType = ( ( uint32_t ) xSize & ~heaptraceMALLOC_FLAG ) | ulFlags;
+	uxRingNext++;
+	if( uxRingNext >= configHEAP_TRACE_RING_SIZE )
+	{
+		uxRingNext = 0;
+	}
+	ulRingTotal++;
+}
+/*-----------------------------------------------------------*/
+
+#define prvLiveHome( pv )	( ( UBaseType_t ) ( ( ( portPOINTER_SIZE_TYPE ) ( pv ) ) >> 2 ) & heaptraceLIVE_MASK )
+
+static void prvLiveInsert( void *pv, size_t xSize, TaskHandle_t xTask )
+{
+UBaseType_t ux, uxIndex = prvLiveHome( pv );
+
+	for( ux = 0; ux < configHEAP_TRACE_LIVE_SIZE; ux++ )
+	{
+		if( xLive[ uxIndex ].pvAddress == NULL )
+		{
+			xLive[ uxIndex ].pvAddress = pv;
+			xLive[ uxIndex ].xSize = xSize;
+			xLive[ uxIndex ].xTask = xTask;
+			return;
+		}
+		uxIndex = ( uxIndex + 1 ) & heaptraceLIVE_MASK;
+	}
+	uxLiveUntracked++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLiveRemove( void *pv )
+{
+UBaseType_t ux, uxIndex = prvLiveHome( pv ), uxNext, uxHome;
+
+	for( ux = 0; ux < configHEAP_TRACE_LIVE_SIZE; ux++ )
+	{
+		if( xLive[ uxIndex ].pvAddress == pv )
+		{
+			break;
+		}
+		if( xLive[ uxIndex ].pvAddress == NULL )
+		{
+			/* Not in the table, so it was counted as untracked. */
+			if( uxLiveUntracked > 0 )
+			{
+				uxLiveUntracked--;
+			}
+			return;
+		}
+		uxIndex = ( uxIndex + 1 ) & heaptraceLIVE_MASK;
+	}
+	if( ux == configHEAP_TRACE_LIVE_SIZE )
+	{
+		if( uxLiveUntracked > 0 )
+		{
+			uxLiveUntracked--;
+		}
+		return;
+	}
+
+	/* Backward shift deletion: move following entries of the probe sequence
+	into the hole, so lookups never need tombstones.  If the table is full,
+	every other slot is visited once. */
+	uxNext = uxIndex;
+	for( ux = 1; ux < configHEAP_TRACE_LIVE_SIZE; ux++ )
+	{
+		uxNext = ( uxNext + 1 ) & heaptraceLIVE_MASK;
+		if( xLive[ uxNext ].pvAddress == NULL )
+		{
+			break;
+		}
+		uxHome = prvLiveHome( xLive[ uxNext ].pvAddress );
+		/* Move the entry if its home slot is not cyclically in (uxIndex, uxNext]. */
+		if( ( ( uxNext > uxIndex ) && ( ( uxHome <= uxIndex ) || ( uxHome > uxNext ) ) )
+			|| ( ( uxNext < uxIndex ) && ( uxHome <= uxIndex ) && ( uxHome > uxNext ) ) )
+		{
+			xLive[ uxIndex ] = xLive[ uxNext ];
+			uxIndex = uxNext;
+		}
+	}
+	xLive[ uxIndex ].pvAddress = NULL;
+}
+
+#endif /* configUSE_HEAP_TRACE */ /* << EST */
@@ -0,0 +1,354 @@
+/* << EST */
+#include "FreeRTOSConfig.h"
+#if configUSE_BLOCK_POOLS
+
+/*
+ * Statically configured pools of fixed size memory blocks.
+ *
+ * Each pool is an array of equally sized blocks, with the free blocks linked
+ * through their first word.  Allocation and deallocation pop or push a single
+ * list entry inside a short critical section, so they execute in constant
+ * time, do not need to suspend the scheduler as pvPortMalloc() does, and can
+ * be used from interrupts through the FromISR() variants.
+ *
+ * The pools are searched in order, so they should be configured with
+ * increasing block sizes.  Requests which do not fit into any pool, or which
+ * find all fitting pools exhausted, fall back to pvPortMalloc().
+ */
+#include <stdlib.h>
+
+%- EST: Modification for Processor Expert port
+%for var from EventModules
+#include "%var.h"
+%endfor
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+all the API functions to use the MPU wrappers.  That should only be done when
+task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Storage is declared in units of this type to get the port alignment. */
+#if portBYTE_ALIGNMENT==8
+	typedef uint64_t PoolWord_t;
+#else
+	typedef uint32_t PoolWord_t;
+#endif
+
+/* Block size rounded up to whole words, and at least one word to hold the
+free list link. */
+#define poolBLOCK_WORDS( xSize )	( ( ( xSize ) + sizeof( PoolWord_t ) - 1 ) / sizeof( PoolWord_t ) )
+
+/* Free blocks are linked through their first word. */
+typedef struct A_POOL_BLOCK
+{
+	struct A_POOL_BLOCK *pxNextFreeBlock;
+} PoolBlock_t;
+
+/* Control data of each pool. */
+typedef struct A_POOL
+{
+	PoolWord_t *pxStart;				/*<< First block of the pool. */
+	PoolWord_t *pxEnd;					/*<< First address behind the last block. */
+	size_t xBlockSize;					/*<< Size of each block in bytes. */
+	size_t xNumberOfBlocks;				/*<< Number of blocks in the pool. */
+	PoolBlock_t *pxFreeList;			/*<< Free blocks, NULL if the pool is exhausted. */
+	size_t xBlocksInUse;				/*<< Number of blocks currently allocated. */
+	size_t xMaxBlocksInUse;				/*<< High watermark of xBlocksInUse. */
+	size_t xNumberOfFailedAllocations;	/*<< Requests which fitted but found the pool empty. */
+} Pool_t;
+
+/* An unused pool (no blocks or a block size of zero) still gets one word, as
+C does not allow arrays of size zero. */
+#define poolDECLARE_STORAGE( uxPool, xSize, xBlocks ) \
+	static PoolWord_t uxPool[ ( ( ( xBlocks ) > 0 ) && ( ( xSize ) > 0 ) ) ? poolBLOCK_WORDS( xSize ) * ( xBlocks ) : 1 ]
+
+poolDECLARE_STORAGE( xPool0Storage, configBLOCK_POOL0_BLOCK_SIZE, configBLOCK_POOL0_NOF_BLOCKS );
+poolDECLARE_STORAGE( xPool1Storage, configBLOCK_POOL1_BLOCK_SIZE, configBLOCK_POOL1_NOF_BLOCKS );
+poolDECLARE_STORAGE( xPool2Storage, configBLOCK_POOL2_BLOCK_SIZE, configBLOCK_POOL2_NOF_BLOCKS );
+
+#define poolNOF_POOLS	3
+
+static Pool_t xPools[ poolNOF_POOLS ];
+
+/* Set once prvPoolInit() has been called. */
+static BaseType_t xPoolsHaveBeenInitialised = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Links all blocks of the pools into their free lists.  Called on first use.
+ */
+static void prvPoolInit( void );
+
+/*
+ * Sets up a single pool.
+ */
+static void prvPoolInitOne( Pool_t *pxPool, PoolWord_t *pxStorage, size_t xBlockSize, size_t xNumberOfBlocks );
+
+/*
+ * Takes a block from the first pool which can hold xWantedSize, or returns
+ * NULL.  Must be called with interrupts masked.
+ */
+static void *prvPoolTake( size_t xWantedSize );
+
+/*
+ * Returns the block to its pool, or pdFALSE if pv is not from a pool.  Must be
+ * called with interrupts masked.
+ */
+static BaseType_t prvPoolGive( void *pv );
+
+/*-----------------------------------------------------------*/
+
+void *pvPortPoolMalloc( size_t xWantedSize )
+{
+void *pvReturn;
+
+	taskENTER_CRITICAL();
+	{
+		pvReturn = prvPoolTake( xWantedSize );
+	}
+	taskEXIT_CRITICAL();
+
+	if( pvReturn == NULL )
+	{
+		/* Does not fit into a pool, or the pools are exhausted. */
+		pvReturn = pvPortMalloc( xWantedSize );
+	}
+	else
+	{
+		traceMALLOC( pvReturn, xWantedSize );
+		portHEAP_TRACE_MALLOC( pvReturn, xWantedSize );
+	}
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortPoolFree( void *pv )
+{
+BaseType_t xFromPool;
+
+	if( pv != NULL )
+	{
+		taskENTER_CRITICAL();
+		{
+			xFromPool = prvPoolGive( pv );
+		}
+		taskEXIT_CRITICAL();
+
+		if( xFromPool == pdFALSE )
+		{
+			vPortFree( pv );
+		}
+		else
+		{
+			portHEAP_TRACE_FREE( pv );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortPoolMallocFromISR( size_t xWantedSize )
+{
+void *pvReturn;
+UBaseType_t uxSavedInterruptStatus;
+
+	/* There is no fallback to the heap, as pvPortMalloc() cannot be called
+	from an interrupt. */
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		pvReturn = prvPoolTake( xWantedSize );
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+	portHEAP_TRACE_MALLOC_FROM_ISR( pvReturn, xWantedSize );
+	return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortPoolFreeFromISR( void *pv )
+{
+UBaseType_t uxSavedInterruptStatus;
+BaseType_t xFromPool;
+
+	if( pv != NULL )
+	{
+		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+		{
+			xFromPool = prvPoolGive( pv );
+		}
+		portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+		/* Blocks allocated from an interrupt always come from a pool. */
+		configASSERT( xFromPool != pdFALSE );
+		( void ) xFromPool;
+		portHEAP_TRACE_FREE_FROM_ISR( pv );
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortGetNumberOfPools( void )
+{
+	return poolNOF_POOLS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortGetPoolStats( UBaseType_t uxPool, PoolStats_t *pxPoolStats )
+{
+Pool_t *pxPool;
+
+	if( uxPool >= poolNOF_POOLS )
+	{
+		return pdFAIL;
+	}
+	taskENTER_CRITICAL();
+	{
+		if( xPoolsHaveBeenInitialised == pdFALSE )
+		{
+			prvPoolInit();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+		pxPool = &xPools[ uxPool ];
+		pxPoolStats->xBlockSize = pxPool->xBlockSize;
+		pxPoolStats->xNumberOfBlocks = pxPool->xNumberOfBlocks;
+		pxPoolStats->xBlocksInUse = pxPool->xBlocksInUse;
+		pxPoolStats->xMaxBlocksInUse = pxPool->xMaxBlocksInUse;
+		pxPoolStats->xNumberOfFailedAllocations = pxPool->xNumberOfFailedAllocations;
+	}
+	taskEXIT_CRITICAL();
+	return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPoolInit( void )
+{
+	prvPoolInitOne( &xPools[ 0 ], xPool0Storage, configBLOCK_POOL0_BLOCK_SIZE, configBLOCK_POOL0_NOF_BLOCKS );
+	prvPoolInitOne( &xPools[ 1 ], xPool1Storage, configBLOCK_POOL1_BLOCK_SIZE, configBLOCK_POOL1_NOF_BLOCKS );
+	prvPoolInitOne( &xPools[ 2 ], xPool2Storage, configBLOCK_POOL2_BLOCK_SIZE, configBLOCK_POOL2_NOF_BLOCKS );
+	xPoolsHaveBeenInitialised = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPoolInitOne( Pool_t *pxPool, PoolWord_t *pxStorage, size_t xBlockSize, size_t xNumberOfBlocks )
+{
+size_t xWords, x;
+PoolBlock_t *pxBlock;
+
+	xWords = poolBLOCK_WORDS( xBlockSize );
+	if( xWords == 0 )
+	{
+		/* A zero sized pool is not used. */
+		xNumberOfBlocks = 0;
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+	pxPool->pxStart = pxStorage;
+	pxPool->pxEnd = pxStorage + ( xWords * xNumberOfBlocks );
+	pxPool->xBlockSize = xWords * sizeof( PoolWord_t );
+	pxPool->xNumberOfBlocks = xNumberOfBlocks;
+	pxPool->pxFreeList = NULL;
+	pxPool->xBlocksInUse = 0;
+	pxPool->xMaxBlocksInUse = 0;
+	pxPool->xNumberOfFailedAllocations = 0;
+
+	/* Link the blocks from the end, so the list starts with the lowest
+	address. */
+	for( x = xNumberOfBlocks; x > 0; x-- )
+	{
+		pxBlock = ( PoolBlock_t * ) ( void * ) ( pxStorage + ( ( x - 1 ) * xWords ) );
+		pxBlock->pxNextFreeBlock = pxPool->pxFreeList;
+		pxPool->pxFreeList = pxBlock;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvPoolTake( size_t xWantedSize )
+{
+Pool_t *pxPool;
+PoolBlock_t *pxBlock;
+UBaseType_t ux;
+
+	if( xPoolsHaveBeenInitialised == pdFALSE )
+	{
+		prvPoolInit();
+	}
+	else
+	{
+		mtCOVERAGE_TEST_MARKER();
+	}
+
+	if( xWantedSize == 0 )
+	{
+		return NULL;
+	}
+	for( ux = 0; ux < poolNOF_POOLS; ux++ )
+	{
+		pxPool = &xPools[ ux ];
+		if( ( pxPool->xNumberOfBlocks > 0 ) && ( xWantedSize <= pxPool->xBlockSize ) )
+		{
+			pxBlock = pxPool->pxFreeList;
+			if( pxBlock != NULL )
+			{
+				pxPool->pxFreeList = pxBlock->pxNextFreeBlock;
+				pxPool->xBlocksInUse++;
+				if( pxPool->xBlocksInUse > pxPool->xMaxBlocksInUse )
+				{
+					pxPool->xMaxBlocksInUse = pxPool->xBlocksInUse;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+				return ( void * ) pxBlock;
+			}
+			else
+			{
+				/* Exhausted, try the next larger pool. */
+				pxPool->xNumberOfFailedAllocations++;
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvPoolGive( void *pv )
+{
+Pool_t *pxPool;
+PoolBlock_t *pxBlock;
+UBaseType_t ux;
+
+	for( ux = 0; ux < poolNOF_POOLS; ux++ )
+	{
+		pxPool = &xPools[ ux ];
+		if( ( ( PoolWord_t * ) pv >= pxPool->pxStart ) && ( ( PoolWord_t * ) pv < pxPool->pxEnd ) )
+		{
+			configASSERT( pxPool->xBlocksInUse > 0 );
+			pxBlock = ( PoolBlock_t * ) pv;
+			pxBlock->pxNextFreeBlock = pxPool->pxFreeList;
+			pxPool->pxFreeList = pxBlock;
+			pxPool->xBlocksInUse--;
+			traceFREE( pv, pxPool->xBlockSize );
+			return pdTRUE;
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+	}
+	return pdFALSE;
+}
+
+#endif /* configUSE_BLOCK_POOLS */ /* << EST */
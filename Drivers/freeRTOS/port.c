@@ -250,6 +250,14 @@ static TickCounter_t currTickDuration; /* holds the modulo counter/tick duration
 #define portNVIC_SYSPRI7                    ((volatile unsigned long*)0xe000e41c) /* system handler priority register 7, PRI_28 is LPTMR */
 #define portNVIC_LP_TIMER_PRI               (((unsigned long)configKERNEL_INTERRUPT_PRIORITY)<<0) /* priority of low power timer interrupt */
 
+#if configCPU_FAMILY_IS_ARM_M4(configCPU_FAMILY) && (configGENERATE_RUN_TIME_STATS==1) && configRUN_TIME_COUNTER_CYCLES /* << EST: DWT cycle counter used as runtime counter */
+#define portDEMCR_REG                       (*((volatile unsigned long *)0xe000edfc)) /* DEMCR, Debug Exception and Monitor Control Register */
+#define portDEMCR_TRCENA_BIT                (1UL<<24UL) /* enables the DWT and ITM units */
+#define portDWT_CTRL_REG                    (*((volatile unsigned long *)0xe0001000)) /* DWT_CTRL, DWT Control Register */
+#define portDWT_CYCCNTENA_BIT               (1UL<<0UL)  /* enables the cycle counter */
+#define portDWT_CYCCNT_REG                  (*((volatile unsigned long *)0xe0001004)) /* DWT_CYCCNT, cycle count register */
+#endif
+
 #if configSYSTICK_USE_LOW_POWER_TIMER
 #define IRQn_Type int
 #define __NVIC_PRIO_BITS          configPRIO_BITS
@@ -1278,6 +1286,23 @@ portLONG uxGetTickCounterValue(void) {
 }
 /*-----------------------------------------------------------*/
 %endif
+#if (configGENERATE_RUN_TIME_STATS==1) && configRUN_TIME_COUNTER_CYCLES /* << EST */
+#if !configCPU_FAMILY_IS_ARM_M4(configCPU_FAMILY)
+  #error "The cycle counter as runtime counter is only supported for ARM Cortex-M4(F)"
+#endif
+void vPortConfigureRunTimeCounter(void) {
+  /* Free running 32bit counter, incremented with the core clock. It wraps after 2^32 cycles (about 36 seconds at 120 MHz),
+     the CPU load tracking samples it often enough to handle this. */
+  portDEMCR_REG |= portDEMCR_TRCENA_BIT; /* enable DWT */
+  portDWT_CYCCNT_REG = 0; /* reset counter */
+  portDWT_CTRL_REG |= portDWT_CYCCNTENA_BIT; /* start counting */
+}
+/*-----------------------------------------------------------*/
+uint32_t ulPortGetRunTimeCounterValue(void) {
+  return portDWT_CYCCNT_REG;
+}
+/*-----------------------------------------------------------*/
+#endif
 #if (configCOMPILER==configCOMPILER_ARM_KEIL)
 #if configPEX_KINETIS_SDK /* the SDK expects different interrupt handler names */
 void SysTick_Handler(void) {
@@ -1296,11 +1321,13 @@ void vPortTickHandler(void) {
 #if configUSE_TICKLESS_IDLE == 1
   TICK_INTERRUPT_FLAG_SET();
 #endif
+  portRUN_TIME_ISR_ENTER(); /* account the tick interrupt as interrupt time */
   portSET_INTERRUPT_MASK();   /* disable interrupts */
   if (xTaskIncrementTick()!=pdFALSE) { /* increment tick count */
     taskYIELD();
   }
   portCLEAR_INTERRUPT_MASK(); /* enable interrupts again */
+  portRUN_TIME_ISR_EXIT();
 }
 #endif
 /*-----------------------------------------------------------*/
@@ -1414,11 +1441,13 @@ PE_ISR(RTOSTICKLDD1_Interrupt)
 #if configUSE_TICKLESS_IDLE == 1
   TICK_INTERRUPT_FLAG_SET();
 #endif
+  portRUN_TIME_ISR_ENTER(); /* account the tick interrupt as interrupt time */
   portSET_INTERRUPT_MASK();   /* disable interrupts */
   if (xTaskIncrementTick()!=pdFALSE) { /* increment tick count */
     taskYIELD();
   }
   portCLEAR_INTERRUPT_MASK(); /* enable interrupts again */
+  portRUN_TIME_ISR_EXIT();
 %if defined(useARMSysTickTimer) && useARMSysTickTimer='no'
 #if configCPU_FAMILY_IS_ARM_M4(configCPU_FAMILY) /* Cortex M4 */
   #if __OPTIMIZE_SIZE__ || __OPTIMIZE__
@@ -74,6 +74,19 @@
  *  of one of the standard FreeRTOS header files.
  */
 
+%if %configCOMPILER='configCOMPILER_POSIX_GCC' %- POSIX host version
+#include "portmacro.h"
+
+/*!
+ * \brief Return the time since the last tick in microseconds.
+ * \return Tick counter value. The value is reset at tick interrupt time.
+ * */
+portLONG uxGetTickCounterValue(void);
+
+#define FREERTOS_HWTC_DOWN_COUNTER     0 /* counting up microseconds */
+#define FREERTOS_HWTC_PERIOD           portTICK_PERIOD_US /* counter is incrementing from zero to this value */
+
+%else %- POSIX host version
 %ifdef TickCntr %- non-LDD version
 /* support for trace and access to tick counter */
 #include "%@TickCntr@'ModuleName'.h"
@@ -141,6 +154,7 @@ portLONG uxGetTickCounterValue(void);
   #define FREERTOS_HWTC_PERIOD           ((configCPU_CLOCK_HZ/configTICK_RATE_HZ)-1UL) /* counter is decrementing from this value to zero */
 #endif
 %endif %-TickTimerLDD
+%endif %- POSIX host version
 
 /* tick information for Percepio Trace */
 
@@ -157,7 +171,9 @@ portLONG uxGetTickCounterValue(void);
   #define HWTC_COUNT_DIRECTION  DIRECTION_INCREMENTING
   #define HWTC_PERIOD           FREERTOS_HWTC_PERIOD /* counter is incrementing from zero to this value */
 #endif
-%if %CPUfamily="Kinetis"
+%if %configCOMPILER='configCOMPILER_POSIX_GCC'
+#define HWTC_DIVISOR 1
+%elif %CPUfamily="Kinetis"
 #if configSYSTICK_USE_LOW_POWER_TIMER
   #define HWTC_DIVISOR 1 /* divisor for slow counter tick value */
 #else
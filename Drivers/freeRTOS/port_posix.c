@@ -0,0 +1,488 @@
+/*
+    FreeRTOS V8.0.1 - Copyright (C) 2014 Real Time Engineers Ltd.
+    All rights reserved
+
+    VISIT http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    ***************************************************************************
+     *                                                                       *
+     *    FreeRTOS provides completely free yet professionally developed,    *
+     *    robust, strictly quality controlled, supported, and cross          *
+     *    platform software that has become a de facto standard.             *
+     *                                                                       *
+     *    Help yourself get started quickly and support the FreeRTOS         *
+     *    project by purchasing a FreeRTOS tutorial book, reference          *
+     *    manual, or both from: http://www.FreeRTOS.org/Documentation        *
+     *                                                                       *
+     *    Thank you!                                                         *
+     *                                                                       *
+    ***************************************************************************
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation >>!AND MODIFIED BY!<< the FreeRTOS exception.
+
+    >>! NOTE: The modification to the GPL is included to allow you to distribute
+    >>! a combined work that includes FreeRTOS without being obliged to provide
+    >>! the source code for proprietary components outside of the FreeRTOS
+    >>! kernel.
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  Full license text is available from the following
+    link: http://www.freertos.org/a00114.html
+
+    1 tab == 4 spaces!
+
+    ***************************************************************************
+     *                                                                       *
+     *    Having a problem?  Start by reading the FAQ "My application does   *
+     *    not run, what could be wrong?"                                     *
+     *                                                                       *
+     *    http://www.FreeRTOS.org/FAQHelp.html                               *
+     *                                                                       *
+    ***************************************************************************
+
+    http://www.FreeRTOS.org - Documentation, books, training, latest versions,
+    license and Real Time Engineers Ltd. contact details.
+
+    http://www.FreeRTOS.org/plus - A selection of FreeRTOS ecosystem products,
+    including FreeRTOS+Trace - an indispensable productivity tool, a DOS
+    compatible FAT file system, and our tiny thread aware UDP/IP stack.
+
+    http://www.OpenRTOS.com - Real Time Engineers ltd license FreeRTOS to High
+    Integrity Systems to sell under the OpenRTOS brand.  Low cost OpenRTOS
+    licenses offer ticketed support, indemnification and middleware.
+
+    http://www.SafeRTOS.com - High Integrity Systems also provide a safety
+    engineered and independently SIL3 certified version for use in safety and
+    mission critical applications that require provable dependability.
+
+    1 tab == 4 spaces!
+*/
+
+
+/*-----------------------------------------------------------
+ * FreeRTOS port for a POSIX host (Linux), to run and measure the
+ * application on a workstation.
+ *
+ * Each task runs in its own POSIX thread. A thread only runs while its task
+ * is the one selected by the scheduler: all other task threads wait in
+ * sigsuspend() until they are resumed with SIG_RESUME. A context switch
+ * resumes the thread of the new task and suspends the thread of the previous
+ * task.
+ * The tick interrupt runs in its own thread, woken every tick period with
+ * clock_nanosleep(). Like the processor entering an interrupt, it waits until
+ * interrupts are enabled, then stops the running task thread with SIG_SUSPEND
+ * and increments the tick while no task thread runs. The handler of
+ * SIG_SUSPEND only uses async-signal-safe functions (sem_post(), sigsuspend()
+ * and atomic variables). Interrupts are disabled with the atomic interrupt
+ * state, the critical section nesting count is kept per task.
+ * A task thread can be stopped anywhere outside of a critical section: calls
+ * into C library functions which take locks (printf(), malloc()) shall be
+ * done in a critical section if several tasks use them.
+ * Task threads use their own (host) stack: the stack allocated by the RTOS
+ * only holds the thread data, so the stack high water mark is not meaningful.
+ *----------------------------------------------------------*/
+#if !defined(_XOPEN_SOURCE)
+  #define _XOPEN_SOURCE 700 /* for clock_nanosleep(), sigsetjmp() and pthread_kill() */
+#endif
+#include <pthread.h>
+#include <semaphore.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Kernel includes. */
+#include "portmacro.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "portTicks.h"
+
+#if INCLUDE_xTaskGetCurrentTaskHandle != 1
+  #error "The POSIX port needs xTaskGetCurrentTaskHandle() to find the thread of the running task: enable it in the FreeRTOS component!"
+#endif
+
+#define SIG_SUSPEND   SIGUSR1 /* signal used by the tick interrupt to stop the running task thread */
+#define SIG_RESUME    SIGUSR2 /* signal used to resume a suspended task thread */
+
+/* interrupt state, see vPortDisableInterrupts() */
+#define portINTERRUPTS_ENABLED    0 /* the tick interrupt may run */
+#define portINTERRUPTS_DISABLED   1 /* disabled by the running task, or handed over in a task switch */
+#define portINTERRUPTS_IN_TICK    2 /* the tick interrupt is running */
+
+typedef struct {
+  pthread_t thread;            /* thread running the task */
+  atomic_int xResume;          /* pdTRUE if the thread has been resumed */
+  atomic_int xDying;           /* pdTRUE if the task has been deleted */
+  sigjmp_buf xExit;            /* leaves the thread when the task has been deleted */
+  pdTASK_CODE pxCode;          /* task function */
+  void *pvParameters;          /* task parameter */
+} PortThread_t;
+
+static pthread_once_t xSignalSetupOnce = PTHREAD_ONCE_INIT;
+static sigset_t xWaitSignalMask;            /* signal mask while a thread waits to be resumed */
+static sigset_t xTaskSignalMask;            /* signal mask of a running task thread */
+static pthread_t xTickThread;               /* thread running the tick interrupt */
+static atomic_int xTickStop;                /* set by vPortStopTickTimer() */
+static atomic_int xTickPending;             /* the tick interrupt waits for interrupts to be enabled */
+static sem_t xTickSem;                      /* posted when interrupts are enabled while a tick is pending */
+static sem_t xSuspendedSem;                 /* posted by the task thread stopped with SIG_SUSPEND */
+static sem_t xSchedulerEndSem;              /* posted by vPortEndScheduler() */
+
+static atomic_int xInterruptState = portINTERRUPTS_ENABLED;
+
+/* Each task maintains its own interrupt status in the critical nesting variable,
+   it is saved and restored on a task switch. */
+static volatile unsigned portBASE_TYPE uxCriticalNesting = 0;
+
+static uint64_t ullRunTimeStartNs; /* monotonic time when the runtime counter has been reset */
+static volatile uint64_t ullLastTickNs; /* monotonic time of the last tick interrupt */
+/*-----------------------------------------------------------*/
+static void prvFatalError(const char *pcFunction, int iError) {
+  (void)fprintf(stderr, "FreeRTOS POSIX port: %%s() failed: %%s\n", pcFunction, strerror(iError));
+  abort();
+}
+/*-----------------------------------------------------------*/
+static uint64_t prvGetTimeNs(void) {
+  struct timespec t;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec*1000000000ULL + (uint64_t)t.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+static PortThread_t *prvGetThreadFromTask(void *pvTask) {
+  /* The thread data is stored at the top of the task stack, just above the
+     stack pointer returned by pxPortInitialiseStack(). As the stack pointer
+     in the TCB (first member) is never changed by this port, it is used to
+     find the thread data. */
+  portSTACK_TYPE *pxTopOfStack = *(portSTACK_TYPE**)pvTask;
+
+  return (PortThread_t*)(pxTopOfStack+1);
+}
+/*-----------------------------------------------------------*/
+static void prvWaitForResume(PortThread_t *pxThread) {
+  /* Async-signal-safe, as it is used in prvSuspendHandler() too. SIG_RESUME
+     is blocked outside of sigsuspend(), so it cannot get lost between the
+     test of xResume and sigsuspend(). */
+  while (!atomic_load(&pxThread->xResume)) {
+    (void)sigsuspend(&xWaitSignalMask);
+  }
+  atomic_store(&pxThread->xResume, pdFALSE);
+  if (atomic_load(&pxThread->xDying)) { /* task has been deleted while waiting */
+    siglongjmp(pxThread->xExit, 1);
+  }
+}
+/*-----------------------------------------------------------*/
+static void prvResumeThread(PortThread_t *pxThread) {
+  int iRes;
+
+  atomic_store(&pxThread->xResume, pdTRUE);
+  iRes = pthread_kill(pxThread->thread, SIG_RESUME);
+  if (iRes!=0 && iRes!=ESRCH) { /* ESRCH: a deleted task has already left its thread */
+    prvFatalError("pthread_kill", iRes);
+  }
+}
+/*-----------------------------------------------------------*/
+static void prvSwitchThread(PortThread_t *pxThreadToResume, PortThread_t *pxThreadToSuspend) {
+  unsigned portBASE_TYPE uxSavedCriticalNesting;
+
+  if (pxThreadToSuspend==pxThreadToResume) {
+    return; /* no task switch */
+  }
+  /* the critical nesting count belongs to the task: keep it on the stack of the thread */
+  uxSavedCriticalNesting = uxCriticalNesting;
+  /* interrupts stay disabled: the resumed thread enables them again */
+  prvResumeThread(pxThreadToResume);
+  if (atomic_load(&pxThreadToSuspend->xDying)) { /* task has deleted itself */
+    siglongjmp(pxThreadToSuspend->xExit, 1);
+  }
+  prvWaitForResume(pxThreadToSuspend);
+  uxCriticalNesting = uxSavedCriticalNesting;
+}
+/*-----------------------------------------------------------*/
+static void *prvThreadStart(void *pvParameters) {
+  PortThread_t *pxThread = (PortThread_t*)pvParameters;
+
+  (void)pthread_sigmask(SIG_SETMASK, &xTaskSignalMask, NULL);
+  if (sigsetjmp(pxThread->xExit, 0)!=0) {
+    return NULL; /* the task has been deleted */
+  }
+  prvWaitForResume(pxThread); /* wait until the task runs for the first time */
+  uxCriticalNesting = 0;
+  vPortEnableInterrupts();
+  pxThread->pxCode(pxThread->pvParameters);
+  /* A function that implements a task must not exit or attempt to return to
+  its caller as there is nothing to return to.  If a task wants to exit it
+  should instead call vTaskDelete( NULL ). */
+  configASSERT(pdFALSE);
+  vTaskDelete(NULL);
+  return NULL;
+}
+/*-----------------------------------------------------------*/
+static void prvSuspendHandler(int iSignal) {
+  /* SIG_SUSPEND from the tick interrupt: the running task is interrupted, its
+     thread waits here until the task runs again. */
+  PortThread_t *pxThread = prvGetThreadFromTask(xTaskGetCurrentTaskHandle());
+  unsigned portBASE_TYPE uxSavedCriticalNesting = uxCriticalNesting;
+  int iSavedErrno = errno;
+
+  (void)iSignal;
+  (void)sem_post(&xSuspendedSem); /* the tick interrupt runs now */
+  prvWaitForResume(pxThread);
+  uxCriticalNesting = uxSavedCriticalNesting;
+  errno = iSavedErrno;
+  vPortEnableInterrupts(); /* the task has been interrupted with interrupts enabled */
+}
+/*-----------------------------------------------------------*/
+static void prvResumeHandler(int iSignal) {
+  (void)iSignal; /* only wakes up sigsuspend() */
+}
+/*-----------------------------------------------------------*/
+static void prvTickInterrupt(void) {
+  PortThread_t *pxThread;
+  BaseType_t xSwitchRequired;
+
+  /* stop the running task thread, as the processor does to enter the interrupt */
+  pxThread = prvGetThreadFromTask(xTaskGetCurrentTaskHandle());
+  (void)pthread_kill(pxThread->thread, SIG_SUSPEND);
+  while (sem_wait(&xSuspendedSem)!=0) {
+    /* interrupted by a signal, try again */
+  }
+  ullLastTickNs = prvGetTimeNs();
+  portRUN_TIME_ISR_ENTER(); /* account the tick interrupt as interrupt time, but not the thread switch */
+  xSwitchRequired = xTaskIncrementTick(); /* increment tick count */
+  portRUN_TIME_ISR_EXIT();
+  if (xSwitchRequired!=pdFALSE) {
+    vTaskSwitchContext();
+    pxThread = prvGetThreadFromTask(xTaskGetCurrentTaskHandle());
+  }
+  /* return from the interrupt: the resumed thread enables interrupts again */
+  atomic_store(&xInterruptState, portINTERRUPTS_DISABLED);
+  prvResumeThread(pxThread);
+}
+/*-----------------------------------------------------------*/
+static void *prvTickThread(void *pvParameters) {
+  struct timespec xNext;
+  int iState;
+
+  (void)pvParameters;
+  (void)clock_gettime(CLOCK_MONOTONIC, &xNext);
+  for(;;) {
+    xNext.tv_nsec += (long)(portTICK_PERIOD_US*1000UL);
+    if (xNext.tv_nsec>=1000000000L) {
+      xNext.tv_sec++;
+      xNext.tv_nsec -= 1000000000L;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &xNext, NULL)==EINTR) {
+      /* interrupted by a signal, sleep again */
+    }
+    /* the tick interrupt is pending until interrupts are enabled */
+    atomic_store(&xTickPending, pdTRUE);
+    for(;;) {
+      if (atomic_load(&xTickStop)) {
+        return NULL;
+      }
+      iState = portINTERRUPTS_ENABLED;
+      if (atomic_compare_exchange_strong(&xInterruptState, &iState, portINTERRUPTS_IN_TICK)) {
+        break;
+      }
+      (void)sem_wait(&xTickSem); /* posted by vPortEnableInterrupts() */
+    }
+    atomic_store(&xTickPending, pdFALSE);
+    prvTickInterrupt();
+  }
+}
+/*-----------------------------------------------------------*/
+static void prvSetupSignals(void) {
+  struct sigaction xAction;
+
+  /* task threads keep SIG_RESUME blocked, except while they wait for it */
+  sigemptyset(&xTaskSignalMask);
+  sigaddset(&xTaskSignalMask, SIG_RESUME);
+  sigfillset(&xWaitSignalMask);
+  sigdelset(&xWaitSignalMask, SIG_RESUME);
+  sigdelset(&xWaitSignalMask, SIGINT); /* keep SIGINT to break into the debugger or to stop the application */
+
+  (void)memset(&xAction, 0, sizeof(xAction));
+  sigfillset(&xAction.sa_mask); /* no nested interrupts */
+  sigdelset(&xAction.sa_mask, SIGINT);
+  xAction.sa_flags = SA_RESTART; /* tick shall not interrupt system calls of the application */
+  xAction.sa_handler = prvSuspendHandler;
+  if (sigaction(SIG_SUSPEND, &xAction, NULL)!=0) {
+    prvFatalError("sigaction", errno);
+  }
+  xAction.sa_handler = prvResumeHandler;
+  if (sigaction(SIG_RESUME, &xAction, NULL)!=0) {
+    prvFatalError("sigaction", errno);
+  }
+  (void)sem_init(&xTickSem, 0, 0);
+  (void)sem_init(&xSuspendedSem, 0, 0);
+  (void)sem_init(&xSchedulerEndSem, 0, 0);
+}
+/*-----------------------------------------------------------*/
+portSTACK_TYPE *pxPortInitialiseStack(portSTACK_TYPE *pxTopOfStack, pdTASK_CODE pxCode, void *pvParameters) {
+  PortThread_t *pxThread;
+  int iRes;
+
+  (void)pthread_once(&xSignalSetupOnce, prvSetupSignals);
+  /* store the thread data at the top of the stack */
+  pxThread = (PortThread_t*)(pxTopOfStack+1)-1;
+  pxTopOfStack = (portSTACK_TYPE*)pxThread-1;
+  pxThread->pxCode = pxCode;
+  pxThread->pvParameters = pvParameters;
+  atomic_init(&pxThread->xResume, pdFALSE);
+  atomic_init(&pxThread->xDying, pdFALSE);
+  iRes = pthread_create(&pxThread->thread, NULL, prvThreadStart, pxThread);
+  if (iRes!=0) {
+    prvFatalError("pthread_create", iRes);
+  }
+  return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+void vPortThreadDying(void *pvTaskToDelete) {
+  atomic_store(&prvGetThreadFromTask(pvTaskToDelete)->xDying, pdTRUE);
+}
+/*-----------------------------------------------------------*/
+void vPortCleanUpThread(void *pvTaskToDelete) {
+  PortThread_t *pxThread = prvGetThreadFromTask(pvTaskToDelete);
+
+  /* The task is not running any more: its thread is either waiting in
+     prvWaitForResume() or has already left. Let it leave and release it.
+     The critical section keeps the tick interrupt from stopping the calling
+     task while it waits for the thread. */
+  vPortEnterCritical();
+  atomic_store(&pxThread->xDying, pdTRUE);
+  prvResumeThread(pxThread);
+  (void)pthread_join(pxThread->thread, NULL);
+  vPortExitCritical();
+}
+/*-----------------------------------------------------------*/
+void vPortInitTickTimer(void) {
+  (void)pthread_once(&xSignalSetupOnce, prvSetupSignals);
+}
+/*-----------------------------------------------------------*/
+void vPortStartTickTimer(void) {
+  sigset_t xSignals, xOldSignals;
+  int iRes;
+
+  atomic_store(&xTickStop, pdFALSE);
+  ullLastTickNs = prvGetTimeNs();
+  /* the tick thread does not handle any signal */
+  sigfillset(&xSignals);
+  (void)pthread_sigmask(SIG_SETMASK, &xSignals, &xOldSignals);
+  iRes = pthread_create(&xTickThread, NULL, prvTickThread, NULL);
+  (void)pthread_sigmask(SIG_SETMASK, &xOldSignals, NULL);
+  if (iRes!=0) {
+    prvFatalError("pthread_create", iRes);
+  }
+}
+/*-----------------------------------------------------------*/
+void vPortStopTickTimer(void) {
+  atomic_store(&xTickStop, pdTRUE);
+  (void)sem_post(&xTickSem); /* in case it waits for interrupts to be enabled */
+  (void)pthread_join(xTickThread, NULL);
+}
+/*-----------------------------------------------------------*/
+BaseType_t xPortStartScheduler(void) {
+  vPortInitTickTimer();
+  vPortStartTickTimer();
+  /* Start the first task. Interrupts have been disabled by vTaskStartScheduler(),
+     the first task enables them. */
+  prvResumeThread(prvGetThreadFromTask(xTaskGetCurrentTaskHandle()));
+  /* wait until vPortEndScheduler() is called */
+  while (sem_wait(&xSchedulerEndSem)!=0) {
+    /* interrupted by a signal, try again */
+  }
+  vPortStopTickTimer();
+  atomic_store(&xInterruptState, portINTERRUPTS_ENABLED);
+  return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+void vPortEndScheduler(void) {
+  /* called by a task with interrupts disabled, so no tick interrupt runs any more */
+  (void)sem_post(&xSchedulerEndSem);
+  /* the calling task does not run any more */
+  for(;;) {
+    prvWaitForResume(prvGetThreadFromTask(xTaskGetCurrentTaskHandle()));
+  }
+}
+/*-----------------------------------------------------------*/
+void vPortDisableInterrupts(void) {
+  int iState;
+
+  for(;;) {
+    iState = portINTERRUPTS_ENABLED;
+    if (atomic_compare_exchange_strong(&xInterruptState, &iState, portINTERRUPTS_DISABLED)
+        || iState==portINTERRUPTS_DISABLED) /* already disabled by this task */
+    {
+      return;
+    }
+    /* the tick interrupt is running: it stops this thread until it is done */
+    (void)sched_yield();
+  }
+}
+/*-----------------------------------------------------------*/
+void vPortEnableInterrupts(void) {
+  /* async-signal-safe, as it is used in prvSuspendHandler() too */
+  atomic_store(&xInterruptState, portINTERRUPTS_ENABLED);
+  if (atomic_load(&xTickPending)) {
+    (void)sem_post(&xTickSem);
+  }
+}
+/*-----------------------------------------------------------*/
+void vPortEnterCritical(void) {
+  if (uxCriticalNesting==0) {
+    vPortDisableInterrupts();
+  }
+  uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+void vPortExitCritical(void) {
+  uxCriticalNesting--;
+  if (uxCriticalNesting==0) {
+    vPortEnableInterrupts();
+  }
+}
+/*-----------------------------------------------------------*/
+void vPortYield(void) {
+  PortThread_t *pxThreadToSuspend, *pxThreadToResume;
+
+  vPortEnterCritical();
+  pxThreadToSuspend = prvGetThreadFromTask(xTaskGetCurrentTaskHandle());
+  vTaskSwitchContext();
+  pxThreadToResume = prvGetThreadFromTask(xTaskGetCurrentTaskHandle());
+  prvSwitchThread(pxThreadToResume, pxThreadToSuspend);
+  vPortExitCritical();
+}
+/*-----------------------------------------------------------*/
+void vPortYieldFromISR(void) {
+  /* The tick interrupt (with the tick hook) is the only interrupt: a task
+     woken in it is switched in by xTaskIncrementTick() with xYieldPending. */
+  if (!pthread_equal(pthread_self(), xTickThread)) {
+    vPortYield();
+  }
+}
+/*-----------------------------------------------------------*/
+/* return the time since the last tick in microseconds, counting up to portTICK_PERIOD_US */
+portLONG uxGetTickCounterValue(void) {
+  return (portLONG)((prvGetTimeNs()-ullLastTickNs)/1000ULL);
+}
+/*-----------------------------------------------------------*/
+void vPortConfigureRunTimeCounter(void) {
+  ullRunTimeStartNs = prvGetTimeNs();
+}
+/*-----------------------------------------------------------*/
+uint32_t ulPortGetRunTimeCounterValue(void) {
+  /* microseconds since vPortConfigureRunTimeCounter(), wraps after about 71 minutes */
+  return (uint32_t)((prvGetTimeNs()-ullRunTimeStartNs)/1000ULL);
+}
+/*-----------------------------------------------------------*/
@@ -372,6 +372,238 @@ void vPortInitialiseBlocks( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetMinimumEverFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 
+#if configFRTOS_MEMORY_SCHEME==5 /* << EST */
+/*
+ * Heap statistics as returned by vPortGetHeapStats().  ucFragmentationIndex is
+ * 0 if all the free memory is in one block and approaches 100 the more the
+ * free memory is split into small blocks.
+ */
+typedef struct xHeapStats
+{
+	size_t xAvailableHeapSpaceInBytes;		/* Total free bytes. */
+	size_t xSizeOfLargestFreeBlockInBytes;	/* Largest block which can be allocated. */
+	size_t xSizeOfSmallestFreeBlockInBytes;	/* Smallest free block. */
+	size_t xNumberOfFreeBlocks;				/* Number of free blocks. */
+	size_t xMinimumEverFreeBytesRemaining;	/* Lowest free heap size since startup. */
+	size_t xNumberOfSuccessfulAllocations;	/* Number of pvPortMalloc() calls which returned a block. */
+	size_t xNumberOfSuccessfulFrees;		/* Number of vPortFree() calls which returned a block. */
+	uint8_t ucFragmentationIndex;			/* 0..100, see above. */
+} HeapStats_t;
+
+void vPortGetHeapStats( HeapStats_t *pxHeapStats ) PRIVILEGED_FUNCTION;
+#endif
+
+#if configUSE_BLOCK_POOLS /* << EST */
+/*
+ * Fixed size block pools, see mempool.c.  pvPortPoolMalloc() falls back to
+ * pvPortMalloc() if no pool can satisfy the request, and vPortPoolFree()
+ * accepts both pool and heap blocks.  The FromISR() variants only use the
+ * pools and return NULL if they are exhausted.
+ */
+typedef struct xPoolStats
+{
+	size_t xBlockSize;					/* Size of each block in bytes. */
+	size_t xNumberOfBlocks;				/* Number of blocks, 0 if the pool is not used. */
+	size_t xBlocksInUse;				/* Blocks currently allocated. */
+	size_t xMaxBlocksInUse;				/* High watermark of xBlocksInUse. */
+	size_t xNumberOfFailedAllocations;	/* Requests which found the pool empty. */
+} PoolStats_t;
+
+void *pvPortPoolMalloc( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+void vPortPoolFree( void *pv ) PRIVILEGED_FUNCTION;
+void *pvPortPoolMallocFromISR( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+void vPortPoolFreeFromISR( void *pv ) PRIVILEGED_FUNCTION;
+UBaseType_t uxPortGetNumberOfPools( void ) PRIVILEGED_FUNCTION;
+BaseType_t xPortGetPoolStats( UBaseType_t uxPool, PoolStats_t *pxPoolStats ) PRIVILEGED_FUNCTION;
+#endif
+
+#if configUSE_HEAP_TRACE /* << EST */
+/*
+ * Heap tracing, see heap_trace.c.  The heap implementations report each
+ * successful allocation and each free through the hooks below.
+ */
+typedef struct xHeapTraceRecord
+{
+	uint32_t ulTimestamp;				/* Tick count of the call. */
+	void *pvAddress;					/* Block returned by or passed to the allocator. */
+	void *pvCaller;						/* Return address of the allocator call, NULL if unknown. */
+	void *pvTask;						/* Handle of the calling task, NULL before the scheduler runs and for interrupts. */
+	uint32_t ulSizeAndType;				/* Bit 31 set for malloc, cleared for free; bits 0..30 the size allocated by the heap scheme. */
+} HeapTraceRecord_t;
+
+typedef struct xHeapTraceTaskUsage
+{
+	void *pvTask;						/* Task handle, NULL for allocations before the scheduler has been started and from interrupts. */
+	size_t xBlocks;						/* Number of blocks currently allocated by the task. */
+	size_t xBytes;						/* Sum of their allocated sizes. */
+} HeapTraceTaskUsage_t;
+
+/*
+ * Layout of the buffer filled by xHeapTraceGetBlob() and read piecewise with
+ * xHeapTraceReadBlob() (Drivers/tools/HeapTraceDecode.py decodes a hex dump
+ * of it): this header, followed by
+ * ulNofRecords HeapTraceRecord_t of ucRecordSize bytes each, oldest first.
+ * All values are in the byte order and alignment of the target, ucPointerSize
+ * tells the width of the pointer fields.
+ */
+typedef struct xHeapTraceBlobHeader
+{
+	uint32_t ulMagic;					/* heaptraceBLOB_MAGIC */
+	uint16_t usVersion;					/* heaptraceBLOB_VERSION */
+	uint8_t ucPointerSize;				/* sizeof(void*) */
+	uint8_t ucRecordSize;				/* sizeof(HeapTraceRecord_t) */
+	uint32_t ulTickRateHz;				/* configTICK_RATE_HZ, to convert the timestamps */
+	uint32_t ulNofRecords;				/* Number of records following the header. */
+	uint32_t ulTotalRecords;			/* Number of records ever written, to detect lost ones. */
+	uint32_t ulReserved;
+} HeapTraceBlobHeader_t;
+
+#define heaptraceBLOB_MAGIC			( 0x48545243UL ) /* 'HTRC' */
+#define heaptraceBLOB_VERSION		( 1 )
+
+void vPortHeapTraceMalloc( void *pv, size_t xSize, void *pvCaller ) PRIVILEGED_FUNCTION;
+void vPortHeapTraceFree( void *pv, void *pvCaller ) PRIVILEGED_FUNCTION;
+void vPortHeapTraceMallocFromISR( void *pv, size_t xSize, void *pvCaller ) PRIVILEGED_FUNCTION;
+void vPortHeapTraceFreeFromISR( void *pv, void *pvCaller ) PRIVILEGED_FUNCTION;
+UBaseType_t uxHeapTraceGetRecords( HeapTraceRecord_t *pxRecords, UBaseType_t uxMaxRecords ) PRIVILEGED_FUNCTION;
+size_t xHeapTraceGetBlob( uint8_t *pucBuffer, size_t xBufferSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies up to xBufferSize bytes of the blob starting at xOffset, and returns
+ * the number of bytes copied (0 at the end).  Streams the blob without a
+ * buffer for all of it; freeze the ring with vHeapTraceFreeze( pdTRUE ) while
+ * reading, so the pieces are consistent.  Records of allocations while the
+ * ring is frozen are lost, the live blocks are still tracked.
+ */
+size_t xHeapTraceReadBlob( size_t xOffset, uint8_t *pucBuffer, size_t xBufferSize ) PRIVILEGED_FUNCTION;
+void vHeapTraceFreeze( BaseType_t xFreeze ) PRIVILEGED_FUNCTION;
+UBaseType_t uxHeapTraceGetTaskUsage( HeapTraceTaskUsage_t *pxUsage, UBaseType_t uxMaxTasks, UBaseType_t *puxUntracked ) PRIVILEGED_FUNCTION;
+void vHeapTraceGetFragmentation( size_t *pxBins, UBaseType_t uxNofBins ) PRIVILEGED_FUNCTION;
+
+/*
+ * Calls pxCallback() for each free block of the heap, implemented by each
+ * heap_x.c.
+ */
+void vPortWalkFreeBlocks( void (*pxCallback)( size_t xBlockSize, void *pvArg ), void *pvArg ) PRIVILEGED_FUNCTION;
+
+#ifdef __GNUC__
+	#define portHEAP_TRACE_CALLER()				__builtin_return_address( 0 )
+#else
+	#define portHEAP_TRACE_CALLER()				NULL
+#endif
+#define portHEAP_TRACE_MALLOC( pv, xSize )		vPortHeapTraceMalloc( ( pv ), ( xSize ), portHEAP_TRACE_CALLER() )
+#define portHEAP_TRACE_FREE( pv )				vPortHeapTraceFree( ( pv ), portHEAP_TRACE_CALLER() )
+#define portHEAP_TRACE_MALLOC_FROM_ISR( pv, xSize )	vPortHeapTraceMallocFromISR( ( pv ), ( xSize ), portHEAP_TRACE_CALLER() )
+#define portHEAP_TRACE_FREE_FROM_ISR( pv )		vPortHeapTraceFreeFromISR( ( pv ), portHEAP_TRACE_CALLER() )
+#else
+#define portHEAP_TRACE_MALLOC( pv, xSize )
+#define portHEAP_TRACE_FREE( pv )
+#define portHEAP_TRACE_MALLOC_FROM_ISR( pv, xSize )
+#define portHEAP_TRACE_FREE_FROM_ISR( pv )
+#endif
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configRUN_TIME_COUNTER_CYCLES == 1 ) /* << EST */
+/*
+ * Run time counter implemented by the port with a free running counter of the
+ * core (e.g. the DWT cycle counter), counting at configRUN_TIME_COUNTER_HZ.
+ */
+void vPortConfigureRunTimeCounter( void ) PRIVILEGED_FUNCTION;
+uint32_t ulPortGetRunTimeCounterValue( void ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configRUN_TIME_ISR_ACCOUNTING == 1 ) /* << EST */
+/*
+ * Interrupt time accounting, see cpu_load.c.  An interrupt service routine
+ * calls portRUN_TIME_ISR_ENTER() first and portRUN_TIME_ISR_EXIT() last, the
+ * tick interrupt of the port does this already.  Only interrupts which may
+ * use the FreeRTOS FromISR() API can be accounted.
+ *
+ * The time spent in accounted interrupts is summed up in ulPortGetIsrRunTime()
+ * and removed from the run time counter of the interrupted task:
+ * portGET_RUN_TIME_COUNTER_VALUE() returns ulPortGetTaskRunTimeCounterValue(),
+ * the raw counter (portGET_RUN_TIME_RAW_COUNTER_VALUE()) minus the interrupt
+ * time.
+ */
+void vPortRunTimeIsrEnter( void ) PRIVILEGED_FUNCTION;
+void vPortRunTimeIsrExit( void ) PRIVILEGED_FUNCTION;
+uint32_t ulPortGetIsrRunTime( void ) PRIVILEGED_FUNCTION;
+uint32_t ulPortGetTaskRunTimeCounterValue( void ) PRIVILEGED_FUNCTION;
+
+#define portRUN_TIME_ISR_ENTER()				vPortRunTimeIsrEnter()
+#define portRUN_TIME_ISR_EXIT()					vPortRunTimeIsrExit()
+#else
+#define portRUN_TIME_ISR_ENTER()
+#define portRUN_TIME_ISR_EXIT()
+#endif
+
+#if configUSE_CPU_LOAD /* << EST */
+/*
+ * CPU load tracking, see cpu_load.c.  A software timer samples the run time
+ * counters once per second.  The load of each task, and of the accounted
+ * interrupts, is kept for the last second and averaged over 10 and 60 seconds.
+ * Loads are in permille of the elapsed raw run time counter.
+ */
+#define cpuloadWINDOW_1S			( 0 )
+#define cpuloadWINDOW_10S			( 1 )
+#define cpuloadWINDOW_60S			( 2 )
+#define cpuloadNOF_WINDOWS			( 3 )
+
+typedef struct xCpuLoadTask
+{
+	uint32_t ulTaskNumber;				/* xTaskNumber of the task, unique, 0 for the interrupts. */
+	uint32_t ulRunTime;					/* Run time counter of the task at the last sample. */
+	uint16_t usLoad[ cpuloadNOF_WINDOWS ];	/* Load in permille, indexed by cpuloadWINDOW_xxx. */
+	uint8_t ucState;					/* eTaskState at the last sample. */
+	uint8_t ucPriority;					/* Current priority at the last sample. */
+	char cName[ configMAX_TASK_NAME_LEN ];	/* Zero terminated task name. */
+} CpuLoadTask_t;
+
+typedef struct xCpuLoadInfo
+{
+	uint32_t ulCounterHz;				/* configRUN_TIME_COUNTER_HZ, 0 if unknown. */
+	uint32_t ulTimestamp;				/* Raw run time counter at the last sample. */
+	uint32_t ulSamples;					/* Number of samples taken so far. */
+	uint32_t ulMissed;					/* Samples skipped because of more than configCPU_LOAD_MAX_TASKS tasks. */
+	uint32_t ulIsrRunTime;				/* ulPortGetIsrRunTime() at the last sample, 0 without interrupt accounting. */
+	uint16_t usIsrLoad[ cpuloadNOF_WINDOWS ];	/* Load of the accounted interrupts in permille. */
+	uint16_t usNofTasks;				/* Number of tasks tracked. */
+} CpuLoadInfo_t;
+
+/*
+ * Layout of the buffer filled by xCpuLoadGetSnapshot(): this header, followed
+ * by usNofTasks CpuLoadTask_t of ucRecordSize bytes each.  All values are in
+ * the byte order and alignment of the target.  Two snapshots give the exact
+ * load between them from ulTimestamp, ulIsrRunTime and the ulRunTime values.
+ */
+typedef struct xCpuLoadBlobHeader
+{
+	uint32_t ulMagic;					/* cpuloadBLOB_MAGIC */
+	uint16_t usVersion;					/* cpuloadBLOB_VERSION */
+	uint8_t ucNameLength;				/* configMAX_TASK_NAME_LEN */
+	uint8_t ucRecordSize;				/* sizeof(CpuLoadTask_t) */
+	CpuLoadInfo_t xInfo;
+} CpuLoadBlobHeader_t;
+
+#define cpuloadBLOB_MAGIC			( 0x4C555043UL ) /* 'CPUL' */
+#define cpuloadBLOB_VERSION			( 1 )
+
+BaseType_t xCpuLoadCreateTimer( void ) PRIVILEGED_FUNCTION;
+UBaseType_t uxCpuLoadGetTasks( CpuLoadTask_t *pxTasks, UBaseType_t uxMaxTasks, CpuLoadInfo_t *pxInfo ) PRIVILEGED_FUNCTION;
+size_t xCpuLoadGetSnapshot( uint8_t *pucBuffer, size_t xBufferSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Allocation of the fixed size kernel objects (queues, semaphores, mutexes,
+ * timers and event groups).
+ */
+#if configUSE_BLOCK_POOLS && configUSE_BLOCK_POOLS_FOR_KERNEL_OBJECTS /* << EST */
+	#define pvPortMallocObject( xSize )		pvPortPoolMalloc( xSize )
+	#define vPortFreeObject( pv )			vPortPoolFree( pv )
+#else
+	#define pvPortMallocObject( xSize )		pvPortMalloc( xSize )
+	#define vPortFreeObject( pv )			vPortFree( pv )
+#endif
+
 /*
  * Setup the hardware ready for the scheduler to take control.  This generally
  * sets up a tick interrupt and sets timers for the correct tick frequency.
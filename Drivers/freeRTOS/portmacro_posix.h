@@ -0,0 +1,185 @@
+/*
+    FreeRTOS V8.0.1 - Copyright (C) 2014 Real Time Engineers Ltd.
+    All rights reserved
+
+    VISIT http://www.FreeRTOS.org TO ENSURE YOU ARE USING THE LATEST VERSION.
+
+    ***************************************************************************
+     *                                                                       *
+     *    FreeRTOS provides completely free yet professionally developed,    *
+     *    robust, strictly quality controlled, supported, and cross          *
+     *    platform software that has become a de facto standard.             *
+     *                                                                       *
+     *    Help yourself get started quickly and support the FreeRTOS         *
+     *    project by purchasing a FreeRTOS tutorial book, reference          *
+     *    manual, or both from: http://www.FreeRTOS.org/Documentation        *
+     *                                                                       *
+     *    Thank you!                                                         *
+     *                                                                       *
+    ***************************************************************************
+
+    This file is part of the FreeRTOS distribution.
+
+    FreeRTOS is free software; you can redistribute it and/or modify it under
+    the terms of the GNU General Public License (version 2) as published by the
+    Free Software Foundation >>!AND MODIFIED BY!<< the FreeRTOS exception.
+
+    >>! NOTE: The modification to the GPL is included to allow you to distribute
+    >>! a combined work that includes FreeRTOS without being obliged to provide
+    >>! the source code for proprietary components outside of the FreeRTOS
+    >>! kernel.
+
+    FreeRTOS is distributed in the hope that it will be useful, but WITHOUT ANY
+    WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+    FOR A PARTICULAR PURPOSE.  Full license text is available from the following
+    link: http://www.freertos.org/a00114.html
+
+    1 tab == 4 spaces!
+
+    ***************************************************************************
+     *                                                                       *
+     *    Having a problem?  Start by reading the FAQ "My application does   *
+     *    not run, what could be wrong?"                                     *
+     *                                                                       *
+     *    http://www.FreeRTOS.org/FAQHelp.html                               *
+     *                                                                       *
+    ***************************************************************************
+
+    http://www.FreeRTOS.org - Documentation, books, training, latest versions,
+    license and Real Time Engineers Ltd. contact details.
+
+    http://www.FreeRTOS.org/plus - A selection of FreeRTOS ecosystem products,
+    including FreeRTOS+Trace - an indispensable productivity tool, a DOS
+    compatible FAT file system, and our tiny thread aware UDP/IP stack.
+
+    http://www.OpenRTOS.com - Real Time Engineers ltd license FreeRTOS to High
+    Integrity Systems to sell under the OpenRTOS brand.  Low cost OpenRTOS
+    licenses offer ticketed support, indemnification and middleware.
+
+    http://www.SafeRTOS.com - High Integrity Systems also provide a safety
+    engineered and independently SIL3 certified version for use in safety and
+    mission critical applications that require provable dependability.
+
+    1 tab == 4 spaces!
+*/
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "FreeRTOSConfig.h"
+#include <stdint.h>
+#include <stddef.h>
+/*-----------------------------------------------------------
+ * Port specific definitions for a POSIX host (Linux), used to run and
+ * measure the application on a workstation.
+ *
+ * Each task runs in its own POSIX thread, and only the thread of the task
+ * selected by the scheduler is allowed to run. The tick interrupt runs in a
+ * thread of its own, and stops the running task thread while it increments
+ * the tick. Interrupts are disabled with an atomic interrupt state, which
+ * keeps the tick interrupt waiting.
+ *
+ * The settings in this file configure FreeRTOS correctly for the
+ * given hardware and compiler.
+ *
+ * These settings should not be altered.
+ *-----------------------------------------------------------
+ */
+#if configUSE_TICKLESS_IDLE == 1
+  #error "Tickless idle mode is not supported by the POSIX port!"
+#endif
+
+/* Type definitions. */
+#define portCHAR               char
+#define portFLOAT              float
+#define portDOUBLE             double
+#define portLONG               long
+#define portSHORT              short
+#define portSTACK_TYPE         unsigned long
+typedef portSTACK_TYPE StackType_t;
+%if defined(Custom_portBASE_TYPE) & Custom_portBASE_TYPE='yes'
+#define portBASE_TYPE          %portBASE_TYPE /* custom type as specified in properties */
+%else
+#define portBASE_TYPE          long
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+%endif
+
+#if( configUSE_16_BIT_TICKS == 1 )
+  typedef uint16_t TickType_t;
+  #define portMAX_DELAY      (TickType_t)0xffff
+#else
+  typedef uint32_t TickType_t;
+  #define portMAX_DELAY      (TickType_t)0xffffffff
+#endif
+/* pointers are 64bit on most hosts */
+#define portPOINTER_SIZE_TYPE  size_t
+/*-----------------------------------------------------------*/
+/* Hardware specifics. */
+#define portBYTE_ALIGNMENT     8
+#define portSTACK_GROWTH       -1 /* stack grows from HIGH to LOW */
+
+#define portTICK_PERIOD_MS      ((TickType_t)1000/configTICK_RATE_HZ)
+#define portTICK_PERIOD_US      (1000000UL/configTICK_RATE_HZ)
+/*-----------------------------------------------------------*/
+/* Critical section management. */
+
+/* If set to 1, then this port uses the critical nesting count from the TCB rather than
+maintaining a separate value and then saving this value in the task stack. */
+#define portCRITICAL_NESTING_IN_TCB    0
+
+extern void vPortDisableInterrupts(void);
+extern void vPortEnableInterrupts(void);
+extern void vPortEnterCritical(void);
+extern void vPortExitCritical(void);
+
+/* The only interrupt is the tick, and it does not nest */
+#define portSET_INTERRUPT_MASK_FROM_ISR()    0
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) (void)x
+#define portPOST_ENABLE_DISABLE_INTERRUPTS() /* nothing special needed */
+
+#define portDISABLE_ALL_INTERRUPTS()         vPortDisableInterrupts()
+#define portDISABLE_INTERRUPTS()             vPortDisableInterrupts()
+#define portENABLE_INTERRUPTS()              vPortEnableInterrupts()
+#define portENTER_CRITICAL()                 vPortEnterCritical()
+#define portEXIT_CRITICAL()                  vPortExitCritical()
+/*-----------------------------------------------------------*/
+/* Scheduler utilities. */
+#define portNOP()          /* nothing */
+
+extern void vPortYield(void);
+extern void vPortYieldFromISR(void);
+#define portYIELD()                             vPortYield()
+#define portEND_SWITCHING_ISR(xSwitchRequired)  if(xSwitchRequired) vPortYieldFromISR()
+/*-----------------------------------------------------------*/
+/* Task deletion: the thread of a task is terminated when the task is deleted. */
+extern void vPortThreadDying(void *pvTaskToDelete);
+extern void vPortCleanUpThread(void *pvTaskToDelete);
+#define portPRE_TASK_DELETE_HOOK(pvTaskToDelete, pxYieldPending)  vPortThreadDying(pvTaskToDelete)
+#define portCLEAN_UP_TCB(pxTCB)                                   vPortCleanUpThread(pxTCB)
+/*-----------------------------------------------------------*/
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO(vFunction, pvParameters)   void vFunction(void *pvParameters)
+#define portTASK_FUNCTION(vFunction, pvParameters)         void vFunction(void *pvParameters)
+/*-----------------------------------------------------------*/
+/* Runtime statistics, counted in microseconds with the monotonic clock of the host */
+extern void vPortConfigureRunTimeCounter(void);
+extern uint32_t ulPortGetRunTimeCounterValue(void);
+/*-----------------------------------------------------------*/
+void vPortInitTickTimer(void);
+  /* installs the signal handlers used to suspend and resume the task threads */
+
+void vPortStartTickTimer(void);
+  /* starts the thread of the tick interrupt */
+
+void vPortStopTickTimer(void);
+  /* stops the thread of the tick interrupt */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
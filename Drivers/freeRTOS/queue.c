@@ -318,14 +318,14 @@ QueueHandle_t xReturn = NULL;
 	/* Allocate the new queue structure. */
 	if( uxQueueLength > ( UBaseType_t ) 0 )
 	{
-		pxNewQueue = ( Queue_t * ) pvPortMalloc( sizeof( Queue_t ) );
+		pxNewQueue = ( Queue_t * ) pvPortMallocObject( sizeof( Queue_t ) ); /* << EST */
 		if( pxNewQueue != NULL )
 		{
 			/* Create the list of pointers to queue items.  The queue is one byte
 			longer than asked for to make wrap checking easier/faster. */
 			xQueueSizeInBytes = ( size_t ) ( uxQueueLength * uxItemSize ) + ( size_t ) 1; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
-			pxNewQueue->pcHead = ( int8_t * ) pvPortMalloc( xQueueSizeInBytes );
+			pxNewQueue->pcHead = ( int8_t * ) pvPortMallocObject( xQueueSizeInBytes ); /* << EST */
 			if( pxNewQueue->pcHead != NULL )
 			{
 				/* Initialise the queue members as described above where the
@@ -352,7 +352,7 @@ QueueHandle_t xReturn = NULL;
 			else
 			{
 				traceQUEUE_CREATE_FAILED( ucQueueType );
-				vPortFree( pxNewQueue );
+				vPortFreeObject( pxNewQueue ); /* << EST */
 			}
 		}
 		else
@@ -382,7 +382,7 @@ QueueHandle_t xReturn = NULL;
 		( void ) ucQueueType;
 
 		/* Allocate the new queue structure. */
-		pxNewQueue = ( Queue_t * ) pvPortMalloc( sizeof( Queue_t ) );
+		pxNewQueue = ( Queue_t * ) pvPortMallocObject( sizeof( Queue_t ) ); /* << EST */
 		if( pxNewQueue != NULL )
 		{
 			/* Information required for priority inheritance. */
@@ -1555,9 +1555,9 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 	#endif
 	if( pxQueue->pcHead != NULL )
 	{
-		vPortFree( pxQueue->pcHead );
+		vPortFreeObject( pxQueue->pcHead ); /* << EST */
 	}
-	vPortFree( pxQueue );
+	vPortFreeObject( pxQueue ); /* << EST */
 }
 /*-----------------------------------------------------------*/
 
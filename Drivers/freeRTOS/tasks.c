@@ -1494,6 +1494,16 @@ BaseType_t xReturn;
 	}
 	#endif /* configUSE_TIMERS */
 
+	#if ( configUSE_CPU_LOAD == 1 ) /* << EST */
+	{
+		/* The CPU load is sampled by a software timer. */
+		if( xReturn == pdPASS )
+		{
+			xReturn = xCpuLoadCreateTimer();
+		}
+	}
+	#endif /* configUSE_CPU_LOAD */
+
 	if( xReturn == pdPASS )
 	{
 		/* Interrupts are turned off here, to ensure a tick does not occur
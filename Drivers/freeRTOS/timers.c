@@ -279,7 +279,7 @@ Timer_t *pxNewTimer;
 	}
 	else
 	{
-		pxNewTimer = ( Timer_t * ) pvPortMalloc( sizeof( Timer_t ) );
+		pxNewTimer = ( Timer_t * ) pvPortMallocObject( sizeof( Timer_t ) ); /* << EST */
 		if( pxNewTimer != NULL )
 		{
 			/* Ensure the infrastructure used by the timer service task has been
@@ -692,7 +692,7 @@ TickType_t xTimeNow;
 				case tmrCOMMAND_DELETE :
 					/* The timer has already been removed from the active list,
 					just free up the memory. */
-					vPortFree( pxTimer );
+					vPortFreeObject( pxTimer ); /* << EST */
 					break;
 
 				default	:
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""
+GFontPack - generates the packed font format of the GFont component.
+
+The GFont driver (Drivers/sw/GFont.drv) contains every font as a table of
+256 GFONT_CharInfo entries with the glyph bitmaps in byte aligned rows. This
+script converts these tables into the packed format (GFont property
+'Format' set to 'packed') and writes the result between the lines
+'%-GFONT_PACKED_START' and '%-GFONT_PACKED_END' of the driver.
+
+Packed format, per font:
+- only the characters 0x20..0x7E (plus the default glyph 0x00) and, with the
+  'Latin1' character range, 0xA0..0xFF are stored.
+- every character has a 7 byte descriptor: dwidth, width, height, offsetX,
+  offsetY and the 16 bit offset of its glyph in the glyph data (high byte
+  first, 0xFFFF if the character has no bitmap).
+- the glyphs are stored with one of two encodings, whichever is smaller for
+  the font:
+  GFONT_FORMAT_BITS: the pixel rows are bit packed without padding at the
+    end of a row, MSB first. Each glyph starts at a byte boundary.
+  GFONT_FORMAT_RLE: the pixels, row by row, are coded as run lengths of
+    4 bits (high nibble first). The runs alternate between background and
+    foreground, starting with background. A run of 0 is used to code runs
+    longer than 15 pixels. The runs cover all pixels of the glyph.
+
+Usage:
+  python GFontPack.py [--format auto|bits|rle] [path/to/GFont.drv]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+FORMAT_BITS = 'GFONT_FORMAT_BITS'
+FORMAT_RLE = 'GFONT_FORMAT_RLE'
+
+NO_BMP = 0xFFFF
+RANGE_ASCII = [0x00] + list(range(0x20, 0x7F))  # default glyph first
+RANGE_LATIN1 = list(range(0xA0, 0x100))
+
+MARK_START = '%-GFONT_PACKED_START'
+MARK_END = '%-GFONT_PACKED_END'
+
+FONT_RE = re.compile(r'^%(?:if|elif) (%FontName="\w+" & %FontSize="\d+" & %FontStyle="\w+")\n', re.M)
+BMP_RE = re.compile(r'static const byte\s+(\w+)\[\] = \{(.*?)\};', re.S)
+ENTRY_RE = re.compile(r'\{\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(\w+)\}')
+
+
+class Glyph:
+    def __init__(self, dwidth, width, height, offsetX, offsetY, rows):
+        self.dwidth = dwidth
+        self.width = width
+        self.height = height
+        self.offsetX = offsetX
+        self.offsetY = offsetY
+        self.rows = rows  # byte aligned rows as in the table format, or None
+
+    def pixels(self):
+        """Returns the pixels row by row as list of 0/1."""
+        stride = (self.width + 7) // 8
+        px = []
+        for y in range(self.height):
+            for x in range(self.width):
+                i = y * stride + x // 8
+                b = self.rows[i] if i < len(self.rows) else 0
+                px.append((b >> (7 - x % 8)) & 1)
+        return px
+
+
+def parse_table_fonts(drv):
+    """Extracts the fonts of the table format from the driver."""
+    start = drv.index(MARK_END) if MARK_END in drv else 0
+    start = drv.index('static const GFONT_CharInfo FontBMP[]', start)
+    start = drv.rindex('\n%if %FontName=', 0, start) + 1
+    end = drv.index('%-BW_CUSTOM_VARIABLE_END', start)
+    parts = FONT_RE.split(drv[start:end])
+    fonts = []
+    for cond, body in zip(parts[1::2], parts[2::2]):
+        fbby = int(re.search(r"FBBy\s+(\d+)", body).group(1))
+        bmps = {}
+        for m in BMP_RE.finditer(body):
+            bmps[m.group(1)] = [int(v, 16) for v in re.findall(r'0x[0-9A-Fa-f]{2}', m.group(2))]
+        table = body[body.index('FontBMP[]'):]
+        entries = ENTRY_RE.findall(table)
+        if len(entries) != 256:
+            sys.exit('%s: expected 256 characters, found %d' % (cond, len(entries)))
+        glyphs = []
+        for dw, w, h, ox, oy, ref in entries:
+            glyphs.append(Glyph(int(dw), int(w), int(h), int(ox), int(oy),
+                                None if ref == 'NULL' else bmps[ref]))
+        fonts.append((cond, fbby, glyphs))
+    return fonts
+
+
+def encode_bits(glyph):
+    px = glyph.pixels()
+    out = []
+    for i in range(0, len(px), 8):
+        chunk = px[i:i + 8] + [0] * (8 - len(px[i:i + 8]))
+        out.append(sum(b << (7 - j) for j, b in enumerate(chunk)))
+    return out
+
+
+def encode_rle(glyph):
+    runs = []
+    color, n = 0, 0
+    for p in glyph.pixels():
+        if p == color:
+            n += 1
+        else:
+            runs.append(n)
+            color, n = p, 1
+    runs.append(n)
+    nibbles = []
+    for r in runs:
+        while r > 15:
+            nibbles += [15, 0]  # 15 pixels, followed by an empty run of the other color
+            r -= 15
+        nibbles.append(r)
+    if len(nibbles) % 2:
+        nibbles.append(0)
+    return [(nibbles[i] << 4) | nibbles[i + 1] for i in range(0, len(nibbles), 2)]
+
+
+def decode(fmt, data, npixels):
+    """Reference decoder, mirrors the one in the FontDisplay driver."""
+    px = []
+    if fmt == FORMAT_BITS:
+        for i in range(npixels):
+            px.append((data[i // 8] >> (7 - i % 8)) & 1)
+    else:
+        color, i = 0, 0
+        while len(px) < npixels:
+            run = (data[i // 2] >> (4 if i % 2 == 0 else 0)) & 0xF
+            px += [color] * run
+            color ^= 1
+            i += 1
+    return px
+
+
+def pack_range(glyphs, chars, fmt):
+    """Returns (descriptors, glyph data) of the given characters."""
+    encode = encode_bits if fmt == FORMAT_BITS else encode_rle
+    data, descr = [], []
+    for ch in chars:
+        g = glyphs[ch]
+        if g.rows is None:
+            descr.append((ch, g, NO_BMP, []))
+            continue
+        enc = encode(g)
+        if decode(fmt, enc, g.width * g.height) != g.pixels():
+            sys.exit('character 0x%02X: encoding failed' % ch)
+        descr.append((ch, g, len(data), enc))
+        data += enc
+    if len(data) >= NO_BMP:
+        sys.exit('glyph data too large')
+    return descr, data
+
+
+def emit_range(name, descr, data):
+    rows = []  # (bytes, comment)
+    for ch, g, offs, enc in descr:
+        for i in range(0, len(enc), 8):
+            rows.append((enc[i:i + 8], '/* 0x%02X */' % ch if i == 0 else ''))
+    if not rows:
+        rows.append(([0], ''))
+    lines = ['static const byte %sBMP[] = {' % name]
+    for i, (vals, comment) in enumerate(rows):
+        txt = '  ' + ', '.join('0x%02X' % b for b in vals) + (',' if i < len(rows) - 1 else '')
+        lines.append((txt.ljust(52) + comment).rstrip())
+    lines.append('};')
+    lines.append('')
+    lines.append('static const GFONT_PackedCharInfo %s[] = {' % name)
+    for i, (ch, g, offs, enc) in enumerate(descr):
+        txt = '  {%d, %d, %d, %d, %d, 0x%02X, 0x%02X}%s' % (
+            g.dwidth, g.width, g.height, g.offsetX, g.offsetY, offs >> 8, offs & 0xFF,
+            ',' if i < len(descr) - 1 else '')
+        lines.append(txt.ljust(40) + '/* 0x%02X */' % ch)
+    lines.append('};')
+    lines.append('')
+    return lines
+
+
+def emit_fonts(fonts, force):
+    out = [MARK_START]
+    total = 0
+    for idx, (cond, fbby, glyphs) in enumerate(fonts):
+        best = None
+        for fmt in ([force] if force else [FORMAT_BITS, FORMAT_RLE]):
+            ascii_ = pack_range(glyphs, RANGE_ASCII, fmt)
+            latin1 = pack_range(glyphs, RANGE_LATIN1, fmt)
+            size = len(ascii_[1]) + len(latin1[1])
+            if best is None or size < best[0]:
+                best = (size, fmt, ascii_, latin1)
+        size, fmt, ascii_, latin1 = best
+        total += len(ascii_[1]) + 7 * len(RANGE_ASCII)
+        out.append(('%if ' if idx == 0 else '%elif ') + cond)
+        out.append("#define %'ModuleName'%.FBBy  " + str(fbby))
+        out.append("#define %'ModuleName'%.BMP_FORMAT  " + fmt)
+        out.append('')
+        out += emit_range('FontPacked', *ascii_)
+        out.append("%if %CharacterRange='Latin1'")
+        out += emit_range('FontPackedLatin1', *latin1)
+        out.append('%endif')
+    out.append('%endif')
+    out.append(MARK_END)
+    return out, total
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generates the packed fonts of the GFont driver.')
+    parser.add_argument('--format', choices=['auto', 'bits', 'rle'], default='auto',
+                        help='glyph encoding, default: the smaller one per font')
+    parser.add_argument('drv', nargs='?',
+                        default=os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'sw', 'GFont.drv'))
+    args = parser.parse_args()
+    force = {'auto': None, 'bits': FORMAT_BITS, 'rle': FORMAT_RLE}[args.format]
+
+    with open(args.drv, newline='') as f:
+        drv = f.read()
+    if MARK_START not in drv or MARK_END not in drv:
+        sys.exit('%s: markers %s/%s not found' % (args.drv, MARK_START, MARK_END))
+    fonts = parse_table_fonts(drv)
+    lines, total = emit_fonts(fonts, force)
+    head = drv[:drv.index(MARK_START)]
+    tail = drv[drv.index(MARK_END) + len(MARK_END):]
+    with open(args.drv, 'w', newline='') as f:
+        f.write(head + '\n'.join(lines) + tail)
+    print('%d fonts packed, %d bytes on average for ASCII' % (len(fonts), total // len(fonts)))
+
+
+if __name__ == '__main__':
+    main()
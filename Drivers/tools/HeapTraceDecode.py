@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""
+HeapTraceDecode - decodes the heap trace dump of the FreeRTOS component.
+
+The shell command 'heaptrace dump' (FreeRTOS property 'Heap Trace') prints
+the blob of xHeapTraceGetBlob() as hex bytes, 16 per line. Save the terminal
+output to a file and pass it to this script. Lines which are not hex dump
+lines (command echo, prompt) are ignored.
+
+Blob format (see HeapTraceBlobHeader_t in portable.h), in the byte order of
+the target, which is detected with the magic number:
+- header: magic 'HTRC' (u32), version (u16), pointer size (u8), record size
+  (u8), tick rate in Hz (u32), number of records (u32), number of records
+  ever written (u32), reserved (u32).
+- records, oldest first: timestamp in ticks (u32), address, caller and task
+  (pointers, aligned to their size), size and type (u32, bit 31 set for
+  malloc), padded to the record size.
+
+The script prints the timeline of the records and a summary: blocks which
+are still allocated at the end of the trace, frees of blocks allocated
+before the trace window, and the peak of the bytes allocated in the window.
+
+Usage:
+  python HeapTraceDecode.py [--csv] dump.txt
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MAGIC = 0x48545243  # 'HTRC'
+VERSION = 1
+HEADER_SIZE = 24
+MALLOC_FLAG = 0x80000000
+
+HEX_LINE_RE = re.compile(r'^\s*([0-9A-Fa-f]{2}(?:\s+[0-9A-Fa-f]{2})*)\s*$')
+
+
+class DecodeError(Exception):
+    pass
+
+
+def read_hex(lines):
+    data = bytearray()
+    for line in lines:
+        m = HEX_LINE_RE.match(line)
+        if m:
+            data += bytes(int(b, 16) for b in m.group(1).split())
+    return bytes(data)
+
+
+def decode(data):
+    """Returns (header dict, list of record dicts)."""
+    start = -1
+    for endian in ('<', '>'):
+        start = data.find(struct.pack(endian + 'I', MAGIC))
+        if start >= 0:
+            break
+    if start < 0:
+        raise DecodeError('no heap trace blob found (magic HTRC missing)')
+    data = data[start:]
+    if len(data) < HEADER_SIZE:
+        raise DecodeError('blob header truncated')
+    magic, version, ptr_size, rec_size, tick_hz, nof, total, _ = \
+        struct.unpack(endian + 'IHBBIIII', data[:HEADER_SIZE])
+    if version != VERSION:
+        raise DecodeError('unsupported blob version %d' % version)
+    if ptr_size not in (2, 4, 8):
+        raise DecodeError('unsupported pointer size %d' % ptr_size)
+    ptr_fmt = {2: 'H', 4: 'I', 8: 'Q'}[ptr_size]
+    ptr_offset = (4 + ptr_size - 1) // ptr_size * ptr_size
+    size_offset = ptr_offset + 3 * ptr_size
+    if size_offset + 4 > rec_size:
+        raise DecodeError('record size %d too small for %d bit pointers' % (rec_size, 8 * ptr_size))
+    header = {'endian': 'little' if endian == '<' else 'big', 'pointer_size': ptr_size,
+              'record_size': rec_size, 'tick_hz': tick_hz, 'records': nof, 'total': total}
+    records = []
+    pos = HEADER_SIZE
+    for i in range(nof):
+        rec = data[pos:pos + rec_size]
+        if len(rec) < rec_size:
+            raise DecodeError('blob truncated after %d of %d records' % (i, nof))
+        ts, = struct.unpack_from(endian + 'I', rec, 0)
+        addr, caller, task = struct.unpack_from(endian + 3 * ptr_fmt, rec, ptr_offset)
+        size_type, = struct.unpack_from(endian + 'I', rec, size_offset)
+        records.append({'tick': ts, 'malloc': bool(size_type & MALLOC_FLAG),
+                        'size': size_type & ~MALLOC_FLAG, 'address': addr,
+                        'caller': caller, 'task': task})
+        pos += rec_size
+    return header, records
+
+
+def summary(records):
+    """Blocks live at the end, unmatched frees and the peak of the window."""
+    live = {}
+    unmatched = []
+    bytes_now = peak = 0
+    for r in records:
+        if r['malloc']:
+            live[r['address']] = r
+            bytes_now += r['size']
+            peak = max(peak, bytes_now)
+        elif r['address'] in live:
+            bytes_now -= live.pop(r['address'])['size']
+        else:
+            unmatched.append(r)
+    return live, unmatched, peak
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decodes the heap trace dump of the FreeRTOS component.')
+    parser.add_argument('--csv', action='store_true', help='print the records as CSV only')
+    parser.add_argument('file', help='terminal output of the heaptrace dump command, - for stdin')
+    args = parser.parse_args()
+
+    f = sys.stdin if args.file == '-' else open(args.file)
+    try:
+        header, records = decode(read_hex(f))
+    except DecodeError as e:
+        sys.exit('%s: %s' % (args.file, e))
+    w = 2 * header['pointer_size']
+    hz = header['tick_hz'] or 1
+
+    if args.csv:
+        print('tick,time_s,type,address,size,caller,task')
+        for r in records:
+            print('%d,%.6f,%s,0x%0*X,%d,0x%0*X,0x%0*X' % (
+                r['tick'], r['tick'] / hz, 'malloc' if r['malloc'] else 'free',
+                w, r['address'], r['size'], w, r['caller'], w, r['task']))
+        return
+
+    lost = header['total'] - header['records']
+    print('%d records (%d older ones lost), %s endian, %d bit pointers, %d Hz tick' % (
+        header['records'], lost, header['endian'], 8 * header['pointer_size'], header['tick_hz']))
+    for r in records:
+        print('%10.3f s  %-6s 0x%0*X %7s  caller 0x%0*X  task 0x%0*X' % (
+            r['tick'] / hz, 'malloc' if r['malloc'] else 'free', w, r['address'],
+            str(r['size']) if r['malloc'] else '', w, r['caller'], w, r['task']))
+    live, unmatched, peak = summary(records)
+    print('peak %d bytes allocated within the trace' % peak)
+    print('%d blocks (%d bytes) allocated in the trace are not freed:' % (
+        len(live), sum(r['size'] for r in live.values())))
+    for r in sorted(live.values(), key=lambda r: r['tick']):
+        print('  0x%0*X %7d bytes at %.3f s, caller 0x%0*X task 0x%0*X' % (
+            w, r['address'], r['size'], r['tick'] / hz, w, r['caller'], w, r['task']))
+    if unmatched:
+        print('%d frees of blocks allocated before the trace' % len(unmatched))
+
+
+if __name__ == '__main__':
+    main()
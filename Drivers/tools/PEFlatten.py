@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+"""
+PEFlatten - expands a Processor Expert driver template into plain C.
+
+Processor Expert generates the component sources from the driver templates
+(Drivers/sw/*.drv and the static files in Drivers/freeRTOS, Drivers/RNet,
+...). This script is a small stand-in for that generator, good enough to
+compile the templates on the host, e.g. for the tests in Drivers/tools/test.
+It knows the parts of the template language used by the drivers:
+
+- %if, %ifdef, %ifndef, %elif, %else, %endif, with the expressions
+  defined(X), ndefined(X), X='value', %X="value", X<>'value', X != Y, the
+  number comparisons %X >. '1', %X <. '1', >=. and <=. (also written >=0 and
+  <=0), !, &, |, && and ().
+- property and method symbols: %X, %'X', %get(X, Value), %@Comp@'ModuleName'
+  and the %'ModuleName'%. prefix.
+- integer arithmetic with %EXPR(...) and hex constants with %#hNN.
+- column alignment with %>NN (%>> is written as one space) and %% for a
+  literal percent sign.
+- %define X [value] defines X unless it is given as property, %define!
+  always sets it; without a value X is defined with its own name.
+- %-comments, %include and the section keywords (%INTERFACE,
+  %CODE_BEGIN, ...) are removed. %for..%endfor loops are removed with their
+  body, as the lists they iterate are not known.
+
+Properties are given on the command line or in a file with one symbol per
+line (-f, '#' starts a comment). A symbol without a value is defined with its
+own name, which is what a method or event symbol expands to:
+
+  python PEFlatten.py -m UTIL1 -p StrBuildInit -p Kinetis=yes Utility.drv
+
+Only the interface (%INTERFACE) or implementation (%IMPLEMENTATION) part of
+a driver is written with --part h or --part c, the default is the whole file.
+
+Usage:
+  python PEFlatten.py [-m ModuleName] [-c Comp=Name] [-p Symbol[=value]] [-f file] [--part h|c] [-o out] file
+"""
+
+import argparse
+import re
+import sys
+
+DIRECTIVE_RE = re.compile(r'^\s*%(ifdef|ifndef|if|elif|else|endif)\b\s*(.*)$')
+# lines starting with one of these are template statements, not code
+DROP_RE = re.compile(r'^%(-|define!?\b|include\b|apploc\b|FILE\b|i\b|;|\{|\}|'
+                     r'[A-Z][A-Za-z_]*\s*$|[A-Z][A-Z_]+\b)')
+TOKEN_RE = re.compile(r"\s*(n?defined\s*\(\s*@?[A-Za-z_][\w@]*\s*\)|&&|\|\||<>|!=|[<>]=?[.0]|[()&|!=]|"
+                      r"'[^']*'|\"[^\"]*\"|%?@?[A-Za-z_][\w@]*(?:\([^)]*\))?)")
+
+
+class TemplateError(Exception):
+    pass
+
+
+class Flattener:
+    def __init__(self, module, props, comps):
+        self.module = module
+        self.props = props
+        self.comps = comps
+        self.skip = 0  # > 0 while evaluating a short-circuited operand
+
+    def key(self, name):
+        """Property name of a symbol, %@Comp@Property is looked up as Comp.Property."""
+        name = name.lstrip('%').replace(' ', '')
+        if '@' in name:
+            comp, prop = name.strip('@').split('@', 1)
+            name = comp + '.' + prop
+        return name
+
+    def value(self, name):
+        """Value of a property or method symbol in an expression."""
+        name = self.key(name)
+        m = re.match(r'get\((\w+),\w+\)$', name)
+        if m:
+            name = m.group(1)
+        if name not in self.props:
+            if self.skip:
+                return ''
+            raise TemplateError('undefined symbol in expression: ' + name)
+        return self.props[name]
+
+    def comp(self, name):
+        """Name of a linked component, from -c or else from the property of the link."""
+        return self.comps.get(name, str(self.props.get(name, name)))
+
+    def eval_expr(self, expr):
+        expr = re.sub(r'\s*%-.*$', '', expr).strip()
+        tokens = []
+        pos = 0
+        while pos < len(expr):
+            m = TOKEN_RE.match(expr, pos)
+            if not m:
+                raise TemplateError('cannot parse expression: ' + expr)
+            tokens.append(m.group(1))
+            pos = m.end()
+        tokens = [t for t in tokens if t]
+        self.tokens, self.pos = tokens, 0
+        res = self.parse_or()
+        if self.pos != len(tokens):
+            raise TemplateError('cannot parse expression: ' + expr)
+        return res
+
+    def peek(self):
+        return self.tokens[self.pos] if self.pos < len(self.tokens) else None
+
+    def take(self):
+        self.pos += 1
+        return self.tokens[self.pos - 1]
+
+    def parse_or(self):
+        res = self.parse_and()
+        while self.peek() in ('|', '||'):
+            self.take()
+            self.skip += res
+            rhs = self.parse_and()
+            self.skip -= res
+            res = res or rhs
+        return res
+
+    def parse_and(self):
+        res = self.parse_not()
+        while self.peek() in ('&', '&&'):
+            self.take()
+            self.skip += not res
+            rhs = self.parse_not()
+            self.skip -= not res
+            res = res and rhs
+        return res
+
+    def parse_not(self):
+        if self.peek() == '!':
+            self.take()
+            return not self.parse_not()
+        return self.parse_cmp()
+
+    def parse_cmp(self):
+        tok = self.take()
+        if tok == '(':
+            res = self.parse_or()
+            if self.take() != ')':
+                raise TemplateError('missing )')
+            return res
+        if tok.startswith('defined') or tok.startswith('ndefined'):
+            found = self.key(re.search(r'\(\s*([\w@]+)', tok).group(1)) in self.props
+            return found if tok[0] == 'd' else not found
+        if self.peek() in ('=', '<>', '!='):
+            op = self.take()
+            rhs = self.take()
+            lhs = tok[1:-1] if tok[0] in '\'"' else self.value(tok)
+            rhs = rhs[1:-1] if rhs[0] in '\'"' else self.value(rhs)
+            equal = str(lhs) == str(rhs)
+            return equal if op == '=' else not equal
+        if self.peek() in ('>.', '<.', '>=.', '<=.', '>=0', '<=0'):
+            op = self.take()
+            rhs = self.take()
+            lhs = tok[1:-1] if tok[0] in '\'"' else self.value(tok)
+            rhs = rhs[1:-1] if rhs[0] in '\'"' else self.value(rhs)
+            try:
+                lhs, rhs = int(str(lhs), 0), int(str(rhs), 0)
+            except ValueError:
+                if self.skip:
+                    return False
+                raise TemplateError('expected numbers around ' + op)
+            return {'>': lhs > rhs, '<': lhs < rhs, '>=': lhs >= rhs, '<=': lhs <= rhs}[op[:-1]]
+        raise TemplateError('unsupported expression term: ' + tok)
+
+    def subst(self, line):
+        out = re.sub(r'%-.*$', '', line) if not line.lstrip().startswith('%-') else ''
+        out = out.replace('%%', '\0')
+        out = re.sub(r"%@(\w+)@'ModuleName'%\.", lambda m: self.comp(m.group(1)) + '_', out)
+        out = re.sub(r"%@(\w+)@'ModuleName'", lambda m: self.comp(m.group(1)), out)
+        out = re.sub(r"%@(\w+)@(\w+)", lambda m: str(self.value('@%s@%s' % (m.group(1), m.group(2)))), out)
+        out = out.replace("%'ModuleName'%.", self.module + '_')
+        out = out.replace("%'ModuleName'", self.module).replace('%ModuleName', self.module)
+        out = out.replace('%.', '_')
+        out = re.sub(r'%get\(\s*(\w+)\s*,\s*\w+\s*\)', r'%\1', out)
+        out = re.sub(r'%#h(\d+)', lambda m: '0x%02XU' % int(m.group(1)), out)
+        out = re.sub(r' *%>> *', ' ', out)
+
+        def prop(m):
+            name = m.group(1) or m.group(2)
+            if name in self.props:
+                return str(self.props[name])
+            raise TemplateError('undefined symbol: %' + name)
+        out = re.sub(r"%'(\w+)'|%(?!EXPR\()([A-Za-z_]\w*)", prop, out)
+
+        def expr(m):
+            if not re.match(r'^[\d\s+\-*/()]*$', m.group(1)):
+                raise TemplateError('unsupported %EXPR: ' + m.group(1))
+            return str(int(eval(m.group(1).replace('/', '//'))))
+        while True:
+            res = re.sub(r'%EXPR\(((?:[^()]|\([^()]*\))*)\)', expr, out)
+            if res == out:
+                break
+            out = res
+        # column alignment
+        while True:
+            m = re.search(r'%>(\d+)', out)
+            if not m:
+                break
+            col = int(m.group(1)) - 1
+            head = out[:m.start()]
+            pad = col - len(head) if len(head) < col else 1
+            out = head + ' ' * pad + out[m.end():].lstrip(' ')
+        return out.replace('\0', '%')
+
+    def flatten(self, text, part=None):
+        out = []
+        stack = []  # [active, any branch taken]
+        section = None
+        loops = 0  # %for nesting, the lists are not known so the body is dropped
+        for lineno, line in enumerate(text.split('\n'), 1):
+            line = line.rstrip('\r')
+            try:
+                if re.match(r'^\s*%for\b', line):
+                    loops += 1
+                    continue
+                if re.match(r'^\s*%endfor\b', line):
+                    loops -= 1
+                    continue
+                if loops:
+                    continue
+                m = DIRECTIVE_RE.match(line)
+                parent = all(s[0] for s in stack)
+                if m:
+                    kind, arg = m.groups()
+                    if kind in ('if', 'ifdef', 'ifndef'):
+                        if not parent:
+                            cond = False
+                        elif kind == 'if':
+                            cond = self.eval_expr(arg)
+                        else:
+                            name = self.key(re.match(r'\s*([\w@]+)', arg).group(1))
+                            cond = (name in self.props) == (kind == 'ifdef')
+                        stack.append([cond, cond])
+                    elif kind == 'elif':
+                        top = stack[-1]
+                        cond = not top[1] and all(s[0] for s in stack[:-1]) and self.eval_expr(arg)
+                        top[0] = cond
+                        top[1] = top[1] or cond
+                    elif kind == 'else':
+                        top = stack[-1]
+                        top[0] = not top[1]
+                        top[1] = True
+                    else:
+                        stack.pop()
+                    continue
+                if not parent:
+                    continue
+                if line.startswith('%INTERFACE'):
+                    section = 'h' if line.strip() == '%INTERFACE' else 'event'
+                    continue
+                if line.startswith('%IMPLEMENTATION'):
+                    section = 'c' if line.strip() == '%IMPLEMENTATION' else 'event'
+                    continue
+                if line.startswith('%INITIALIZATION') or line.startswith('%ENABLE'):
+                    section = 'init'
+                    continue
+                m = re.match(r'^\s*%define(!?)\s+(\w+)[ \t]*(.*?)\s*$', line)
+                if m and (m.group(1) or m.group(2) not in self.props):
+                    self.props[m.group(2)] = m.group(3) or m.group(2)
+                if DROP_RE.match(line) or re.match(r'^\s+%(-|define!?\b|include\b)', line):
+                    continue
+                if part is not None and section != part:
+                    continue
+                out.append(self.subst(line))
+            except TemplateError as e:
+                raise TemplateError('line %d: %s' % (lineno, e))
+        if stack:
+            raise TemplateError('missing %endif')
+        return '\n'.join(out) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Expands a Processor Expert driver template into plain C.')
+    parser.add_argument('-m', '--module', default='MOD', help='component name (ModuleName)')
+    parser.add_argument('-c', '--comp', action='append', default=[],
+                        help='name of a linked component, Comp=Name')
+    parser.add_argument('-p', '--prop', action='append', default=[],
+                        help='property or method symbol, Symbol[=value]')
+    parser.add_argument('-f', '--propfile', action='append', default=[],
+                        help='file with one Symbol[=value] per line')
+    parser.add_argument('--part', choices=['h', 'c'], help='only the interface or implementation part')
+    parser.add_argument('-o', '--output', help='output file, default stdout')
+    parser.add_argument('file')
+    args = parser.parse_args()
+
+    lines = []
+    for name in args.propfile:
+        with open(name) as f:
+            lines += [l.split('#', 1)[0].strip() for l in f]
+    props = {}
+    for p in [l for l in lines if l] + args.prop:
+        name, _, val = p.partition('=')
+        props[name] = val if '=' in p else name
+    comps = dict(c.split('=', 1) for c in args.comp)
+    # read and write the bytes unchanged, some templates have Latin-1 characters
+    with open(args.file, newline='', encoding='latin-1') as f:
+        text = f.read()
+    try:
+        res = Flattener(args.module, props, comps).flatten(text, args.part)
+    except TemplateError as e:
+        sys.exit('%s: %s' % (args.file, e))
+    if args.output:
+        with open(args.output, 'w', encoding='latin-1') as f:
+            f.write(res)
+    else:
+        sys.stdout.buffer.write(res.encode('latin-1'))
+
+
+if __name__ == '__main__':
+    main()
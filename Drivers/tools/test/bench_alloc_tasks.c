@@ -0,0 +1,202 @@
+/*
+ * Allocation latency under contention on the FreeRTOS POSIX port with the
+ * scheduler running: the block pools (mempool.c, see pool.c) against
+ * heap_4 and heap_tlsf (heap4.c and heaptlsf.c), all without heap trace.
+ *
+ * Four worker tasks of the same priority allocate and free blocks of 1 to
+ * 64 bytes from the same allocator, and are switched by the tick. A task of
+ * higher priority wakes up with every tick and allocates and frees a 32 byte
+ * block, it preempts the workers in the middle of their calls. Printed for
+ * each allocator: the mean, the median, the 99.9th percentile and the
+ * longest time of a call, for the workers and for the task of higher
+ * priority.
+ *
+ * The pools lock out the tick for the few instructions of a list operation,
+ * heap_4 and heap_tlsf suspend the scheduler for their whole search. A call
+ * in which a worker is switched out includes the time the other tasks run:
+ * the mean, the 99.9th percentile and the longest time of the workers are
+ * those of the host task switches. Each time includes one reading of the
+ * clock, printed first. A task switch on the host is far slower than on a
+ * target, only the ratio between the allocators is meaningful.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "testutil.h"
+
+#define NOF_WORKERS       4
+#define NOF_WORKER_CALLS  400000   /* malloc and free calls of each worker */
+#define NOF_SLOTS         2        /* blocks held by a worker */
+#define HIST_STEP_NS      10
+#define HIST_SIZE         10000    /* up to 100 us, longer calls in the last entry */
+
+void *heap4_pvPortMalloc(size_t xWantedSize);
+void heap4_vPortFree(void *pv);
+void *tlsf_pvPortMalloc(size_t xWantedSize);
+void tlsf_vPortFree(void *pv);
+void *pool_pvPortPoolMalloc(size_t xWantedSize);
+void pool_vPortPoolFree(void *pv);
+BaseType_t pool_xPortGetPoolStats(UBaseType_t uxPool, PoolStats_t *pxPoolStats);
+
+typedef struct {
+  const char *name;
+  void *(*malloc)(size_t);
+  void (*free)(void*);
+} Allocator;
+
+typedef struct {
+  unsigned long long sumNs, maxNs;
+  unsigned long nofCalls;
+  unsigned long hist[HIST_SIZE];
+} Latency;
+
+static const Allocator *allocator;
+static Latency workerLatency[NOF_WORKERS], urgentLatency;
+static SemaphoreHandle_t done;
+static volatile BaseType_t stop;
+
+static void Record(Latency *l, unsigned long long ns) {
+  unsigned long i = (unsigned long)(ns/HIST_STEP_NS);
+
+  l->sumNs += ns;
+  l->nofCalls++;
+  if (ns>l->maxNs) {
+    l->maxNs = ns;
+  }
+  l->hist[i<HIST_SIZE ? i : HIST_SIZE-1]++;
+}
+
+static void Merge(Latency *to, const Latency *from) {
+  unsigned i;
+
+  to->sumNs += from->sumNs;
+  to->nofCalls += from->nofCalls;
+  if (from->maxNs>to->maxNs) {
+    to->maxNs = from->maxNs;
+  }
+  for(i=0;i<HIST_SIZE;i++) {
+    to->hist[i] += from->hist[i];
+  }
+}
+
+/* upper bound of the time the given per mille of the calls are faster than */
+static unsigned long Percentile(const Latency *l, unsigned long perMille) {
+  unsigned long n = 0, i;
+
+  for(i=0;i<HIST_SIZE;i++) {
+    n += l->hist[i];
+    if (n*1000>=l->nofCalls*perMille) {
+      break;
+    }
+  }
+  return (i+1)*HIST_STEP_NS;
+}
+
+static void *Malloc(Latency *l, size_t size) {
+  unsigned long long t = TestTimeNs();
+  void *p = allocator->malloc(size);
+
+  Record(l, TestTimeNs()-t);
+  return p;
+}
+
+static void Free(Latency *l, void *p) {
+  unsigned long long t = TestTimeNs();
+
+  allocator->free(p);
+  Record(l, TestTimeNs()-t);
+}
+
+static void WorkerTask(void *pvParameters) {
+  Latency *l = (Latency*)pvParameters;
+  void *slots[NOF_SLOTS] = {NULL};
+  unsigned seed = (unsigned)(l-workerLatency)+1;
+  unsigned i;
+
+  while (l->nofCalls<NOF_WORKER_CALLS) {
+    i = (unsigned)rand_r(&seed)%NOF_SLOTS;
+    if (slots[i]==NULL) {
+      slots[i] = Malloc(l, 1+(size_t)rand_r(&seed)%64);
+    } else {
+      Free(l, slots[i]);
+      slots[i] = NULL;
+    }
+  }
+  for(i=0;i<NOF_SLOTS;i++) {
+    allocator->free(slots[i]);
+  }
+  (void)xSemaphoreGive(done);
+  vTaskSuspend(NULL);
+}
+
+static void UrgentTask(void *pvParameters) {
+  for(;;) {
+    vTaskDelay(1);
+    if (!stop) {
+      Free(&urgentLatency, Malloc(&urgentLatency, 32));
+    }
+  }
+}
+
+static void Print(const char *who, const Latency *l) {
+  (void)printf("%-10s %-8s %9lu %10.1f %10lu %10lu %10llu\n", allocator->name, who,
+    l->nofCalls, (double)l->sumNs/l->nofCalls, Percentile(l, 500), Percentile(l, 999), l->maxNs);
+}
+
+static void BenchTask(void *pvParameters) {
+  static const Allocator allocators[] = {
+    {"pools", pool_pvPortPoolMalloc, pool_vPortPoolFree},
+    {"heap_4", heap4_pvPortMalloc, heap4_vPortFree},
+    {"heap_tlsf", tlsf_pvPortMalloc, tlsf_vPortFree},
+  };
+  static Latency workers;
+  unsigned long long t;
+  TaskHandle_t tasks[NOF_WORKERS];
+  PoolStats_t stats;
+  unsigned long nofFailed;
+  unsigned a, i;
+
+  t = TestTimeNs();
+  for(i=0;i<NOF_WORKER_CALLS;i++) {
+    (void)TestTimeNs();
+  }
+  t = TestTimeNs()-t;
+  (void)printf("time measurement included in each call: %.1f ns\n", (double)t/NOF_WORKER_CALLS);
+  (void)printf("%-10s %-8s %9s %10s %10s %10s %10s\n", "allocator", "task", "calls", "mean ns", "median ns", "99.9% ns", "max ns");
+  for(a=0;a<sizeof(allocators)/sizeof(allocators[0]);a++) {
+    allocator = &allocators[a];
+    for(i=0;i<NOF_WORKERS;i++) {
+      workerLatency[i] = (Latency){0};
+      (void)xTaskCreate(WorkerTask, "worker", configMINIMAL_STACK_SIZE, &workerLatency[i], tskIDLE_PRIORITY+1, &tasks[i]);
+    }
+    urgentLatency = (Latency){0};
+    stop = pdFALSE;
+    for(i=0;i<NOF_WORKERS;i++) {
+      (void)xSemaphoreTake(done, portMAX_DELAY);
+    }
+    stop = pdTRUE;
+    workers = (Latency){0};
+    for(i=0;i<NOF_WORKERS;i++) {
+      vTaskDelete(tasks[i]);
+      Merge(&workers, &workerLatency[i]);
+    }
+    Print("workers", &workers);
+    Print("urgent", &urgentLatency);
+  }
+  nofFailed = 0;
+  for(i=0;pool_xPortGetPoolStats(i, &stats)==pdPASS;i++) {
+    nofFailed += stats.xNumberOfFailedAllocations;
+  }
+  (void)printf("pool allocations falling back to heap_tlsf: %lu\n", nofFailed);
+  vTaskEndScheduler();
+}
+
+int main(void) {
+  done = xSemaphoreCreateCounting(NOF_WORKERS, 0);
+  (void)xTaskCreate(UrgentTask, "urgent", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+2, NULL);
+  (void)xTaskCreate(BenchTask, "bench", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+3, NULL);
+  vTaskStartScheduler();
+  return 0;
+}
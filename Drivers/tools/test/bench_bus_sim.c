@@ -0,0 +1,102 @@
+/*
+ * Driver operations on the bus simulation of GenericI2C (GI2C1, 400 kHz)
+ * and GenericSWSPI (SWSPI1, 1 MHz): the MMA8451Q MMA1 with a register
+ * model, and the nRF24L01 NRFS with the device model in host/mock_nrf24.c.
+ *
+ * For each operation the bus time per call reported by the simulation,
+ * which does not depend on the host, and the host time per call, which is
+ * the overhead of the driver and the simulation.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "GI2C1.h"
+#include "MMA1.h"
+#include "SWSPI1.h"
+#include "mock_nrf24.h"
+#include "NRFS.h"
+#include "testutil.h"
+
+#define NOF_CALLS  200000
+
+typedef struct {
+  const char *name;
+  void (*op)(void);
+  uint32_t (*busTimeUs)(void);
+  void (*resetBusTime)(void);
+} Operation;
+
+static byte accelRegs[0x32];
+static GI2C1_SimDevice accel = {0x1D, 1, accelRegs, sizeof(accelRegs), 0, NULL, NULL, NULL};
+static uint8_t payload[32];
+
+static byte NrfExchange(SWSPI1_SimDevice *dev, byte mosi) {
+  return MockNrf_Shift(mosi);
+}
+
+static SWSPI1_SimDevice nrf = {NrfExchange, NULL};
+
+static void AccelXYZ(void) {
+  (void)MMA1_GetX();
+  (void)MMA1_GetY();
+  (void)MMA1_GetZ();
+}
+
+static void AccelRaw8XYZ(void) {
+  uint8_t xyz[3];
+
+  (void)MMA1_GetRaw8XYZ(xyz);
+}
+
+static void NrfStatus(void) {
+  (void)NRFS_GetStatus();
+}
+
+static void NrfTx(void) {
+  NRFS_TxPayload(payload, sizeof(payload));
+}
+
+static void NrfRx(void) {
+  (void)MockNrf_Receive(1, payload, sizeof(payload));
+  NRFS_RxPayload(payload, sizeof(payload));
+}
+
+static const Operation ops[] = {
+  {"MMA8451Q GetX()+GetY()+GetZ()", AccelXYZ,     GI2C1_SimGetBusTimeUs, GI2C1_SimResetBusTime},
+  {"MMA8451Q GetRaw8XYZ()",         AccelRaw8XYZ, GI2C1_SimGetBusTimeUs, GI2C1_SimResetBusTime},
+  {"nRF24L01 GetStatus()",          NrfStatus,    SWSPI1_SimGetBusTimeUs, SWSPI1_SimResetBusTime},
+  {"nRF24L01 TxPayload(32)",        NrfTx,        SWSPI1_SimGetBusTimeUs, SWSPI1_SimResetBusTime},
+  {"nRF24L01 RxPayload(32)",        NrfRx,        SWSPI1_SimGetBusTimeUs, SWSPI1_SimResetBusTime},
+};
+
+int main(void) {
+  unsigned long long t;
+  uint32_t busUs;
+  size_t i;
+  int n;
+
+  GI2C1_Init();
+  GI2C1_SimAddDevice(&accel);
+  (void)MMA1_Init();
+  SWSPI1_Init();
+  SWSPI1_SimSetDevice(&nrf);
+  MockNrf_Reset();
+  NRFS_Init();
+
+  (void)printf("%-32s %12s %12s\n", "operation", "bus us/call", "host ns/call");
+  for(i=0;i<sizeof(ops)/sizeof(ops[0]);i++) {
+    ops[i].resetBusTime();
+    ops[i].op();
+    busUs = ops[i].busTimeUs();
+    t = TestTimeNs();
+    for(n=0;n<NOF_CALLS;n++) {
+      ops[i].op();
+      if ((n&1023)==0) {
+        ops[i].resetBusTime(); /* the 32 bit bus time counter would overflow */
+        MockNrf_ClearLog();
+      }
+    }
+    t = TestTimeNs()-t;
+    (void)printf("%-32s %12u %12.1f\n", ops[i].name, (unsigned)busUs, (double)t/NOF_CALLS);
+  }
+  return 0;
+}
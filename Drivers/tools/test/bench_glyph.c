@@ -0,0 +1,177 @@
+/*
+ * GDisplay DrawGlyph() compared with the former FontDisplay WriteChar()
+ * loop, which called PutPixel() for each set pixel of the glyph, on the
+ * display stand-ins of host/mock_lcd.h. The glyph is a bold 8x13 'B', drawn
+ * transparent at all x positions of the display (all bit alignments).
+ *
+ * For each display the host time per glyph, and for the window display the
+ * number of windows opened per glyph: one per set pixel before, one per run
+ * of set pixels with DrawGlyph() and one for an opaque glyph.
+ *
+ * Then FontDisplay WriteChar() and WriteCharBg() with the fonts of
+ * font.props as tables (FTn) and packed (FPn), on LCDW (FDW) and LCDH (FDH):
+ * the host time per character of the printable ASCII range, and on LCDW the
+ * windows opened per character. A packed glyph is decoded into rows before
+ * DrawGlyph(), glyphs larger than its buffer are drawn in parts.
+ */
+#include <stdio.h>
+#include "mock_lcd.h"
+#include "GDH.h"
+#include "GDL.h"
+#include "GDV.h"
+#include "GDM.h"
+#include "GDW.h"
+#include "testutil.h"
+
+#define NOF_GLYPHS   500000
+#define NOF_STRINGS  2000     /* printable ASCII characters written per font and display */
+#define GLYPH_W      8
+#define GLYPH_H      13
+
+typedef struct {
+  const char *name;
+  void (*drawGlyph)(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const byte *bmp, uint16_t fgColor, uint16_t bgColor, bool opaque);
+  void (*putPixel)(uint16_t x, uint16_t y, uint16_t color);
+  unsigned width, height;
+  uint16_t color;
+} Display;
+
+static const Display displays[] = {
+  {"GDH bytes in rows, MSB left",    GDH_DrawGlyph, GDH_PutPixel, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, LCDH_COLOR_BLACK},
+  {"GDL bytes in rows, LSB left",    GDL_DrawGlyph, GDL_PutPixel, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, LCDL_COLOR_BLACK},
+  {"GDV bytes in columns, LSB top",  GDV_DrawGlyph, GDV_PutPixel, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, LCDV_COLOR_BLACK},
+  {"GDM bytes in columns, MSB top",  GDM_DrawGlyph, GDM_PutPixel, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, LCDM_COLOR_BLACK},
+  {"GDW window display",             GDW_DrawGlyph, GDW_PutPixel, MOCK_LCD_W_WIDTH,    MOCK_LCD_W_HEIGHT,    LCDW_COLOR_RED},
+};
+
+typedef struct {
+  const char *name;
+  PGFONT_Callbacks (*table)(void);
+  PGFONT_Callbacks (*packed)(void);
+} Font;
+
+typedef struct {
+  const char *name;
+  void (*writeChar)(byte ch, uint16_t color, uint16_t *xCursor, uint16_t *yCursor, GFONT_Callbacks *font);
+  void (*writeCharBg)(byte ch, uint16_t color, uint16_t bgColor, uint16_t *xCursor, uint16_t *yCursor, GFONT_Callbacks *font);
+  unsigned width, height;
+  uint16_t color, bgColor;
+} FontDisplay;
+
+static const Font fonts[] = {
+  {"Helv 10 normal, bits", FT1_GetFont, FP1_GetFont},
+  {"Cour 14 bold, bits",   FT2_GetFont, FP2_GetFont},
+  {"Helv 24 bold, rle",    FT3_GetFont, FP3_GetFont},
+  {"Cour 18 bold, rle",    FT4_GetFont, FP4_GetFont},
+};
+
+static const FontDisplay fontDisplays[] = {
+  {"FDW", FDW_WriteChar, FDW_WriteCharBg, MOCK_LCD_W_WIDTH, MOCK_LCD_W_HEIGHT, LCDW_COLOR_RED, LCDW_COLOR_WHITE},
+  {"FDH", FDH_WriteChar, FDH_WriteCharBg, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, LCDH_COLOR_BLACK, LCDH_COLOR_WHITE},
+};
+
+static const byte glyph[GLYPH_H] = {0x00, 0xFC, 0x66, 0x66, 0x66, 0x7C, 0x66, 0x66, 0x66, 0x66, 0xFC, 0x00, 0x00};
+
+/* the WriteChar() loop before DrawGlyph() */
+static void PutPixelGlyph(const Display *d, uint16_t x, uint16_t y) {
+  unsigned w, h;
+
+  for(h=0;h<GLYPH_H;h++) {
+    for(w=0;w<GLYPH_W;w++) {
+      if ((glyph[h]<<w)&0x80) {
+        d->putPixel((uint16_t)(x+w), (uint16_t)(y+h), d->color);
+      }
+    }
+  }
+}
+
+/* writes the printable ASCII characters NOF_STRINGS times, returns the host time per character */
+static double WriteAscii(const FontDisplay *d, GFONT_Callbacks *font, bool opaque) {
+  unsigned long long t = TestTimeNs();
+  uint16_t x = 0, y = 0;
+  unsigned n, ch;
+
+  for(n=0;n<NOF_STRINGS;n++) {
+    for(ch=0x20;ch<=0x7E;ch++) {
+      if (x+font->boundingBoxHeight>d->width) {
+        x = 0;
+        y = (uint16_t)(y+font->boundingBoxHeight);
+        if (y+font->boundingBoxHeight>d->height) {
+          y = 0;
+        }
+      }
+      if (opaque) {
+        d->writeCharBg((byte)ch, d->color, d->bgColor, &x, &y, font);
+      } else {
+        d->writeChar((byte)ch, d->color, &x, &y, font);
+      }
+    }
+  }
+  return (double)(TestTimeNs()-t)/(NOF_STRINGS*(0x7F-0x20));
+}
+
+static void BenchFonts(void) {
+  double tTable, tPacked;
+  unsigned long winTable, winPacked;
+  size_t i, j;
+  int opaque;
+
+  (void)printf("\n%-22s %-3s %-6s %9s %10s %6s %10s %10s\n", "font", "", "", "table ns", "packed ns", "ratio", "table win", "packed win");
+  for(i=0;i<sizeof(fonts)/sizeof(fonts[0]);i++) {
+    for(j=0;j<sizeof(fontDisplays)/sizeof(fontDisplays[0]);j++) {
+      const FontDisplay *d = &fontDisplays[j];
+
+      for(opaque=0;opaque<2;opaque++) {
+        MockLcdW_ResetCounters();
+        tTable = WriteAscii(d, fonts[i].table(), (bool)opaque);
+        winTable = mockLcdW.nofWindows;
+        MockLcdW_ResetCounters();
+        tPacked = WriteAscii(d, fonts[i].packed(), (bool)opaque);
+        winPacked = mockLcdW.nofWindows;
+        (void)printf("%-22s %-3s %-6s %9.1f %10.1f %5.2fx", fonts[i].name, d->name, opaque ? "opaque" : "",
+          tTable, tPacked, tPacked/tTable);
+        if (d->writeChar==FDW_WriteChar) {
+          (void)printf(" %10.1f %10.1f", (double)winTable/(NOF_STRINGS*(0x7F-0x20)), (double)winPacked/(NOF_STRINGS*(0x7F-0x20)));
+        }
+        (void)printf("\n");
+      }
+    }
+  }
+}
+
+int main(void) {
+  unsigned long long tPixel, tGlyph;
+  unsigned long winPixel = 0, winGlyph = 0, winOpaque = 0;
+  size_t i;
+  int n;
+
+  (void)printf("%-32s %14s %14s %8s\n", "display", "PutPixel ns", "DrawGlyph ns", "speedup");
+  for(i=0;i<sizeof(displays)/sizeof(displays[0]);i++) {
+    const Display *d = &displays[i];
+
+    tPixel = TestTimeNs();
+    for(n=0;n<NOF_GLYPHS;n++) {
+      PutPixelGlyph(d, (uint16_t)(n%(d->width-GLYPH_W)), (uint16_t)(n%(d->height-GLYPH_H)));
+    }
+    tPixel = TestTimeNs()-tPixel;
+    tGlyph = TestTimeNs();
+    for(n=0;n<NOF_GLYPHS;n++) {
+      d->drawGlyph((uint16_t)(n%(d->width-GLYPH_W)), (uint16_t)(n%(d->height-GLYPH_H)), GLYPH_W, GLYPH_H, glyph, d->color, d->color, FALSE);
+    }
+    tGlyph = TestTimeNs()-tGlyph;
+    (void)printf("%-32s %14.1f %14.1f %7.1fx\n", d->name, (double)tPixel/NOF_GLYPHS, (double)tGlyph/NOF_GLYPHS, (double)tPixel/tGlyph);
+  }
+
+  MockLcdW_ResetCounters();
+  PutPixelGlyph(&displays[4], 10, 10);
+  winPixel = mockLcdW.nofWindows;
+  MockLcdW_ResetCounters();
+  GDW_DrawGlyph(10, 10, GLYPH_W, GLYPH_H, glyph, LCDW_COLOR_RED, LCDW_COLOR_RED, FALSE);
+  winGlyph = mockLcdW.nofWindows;
+  MockLcdW_ResetCounters();
+  GDW_DrawGlyph(10, 10, GLYPH_W, GLYPH_H, glyph, LCDW_COLOR_RED, LCDW_COLOR_WHITE, TRUE);
+  winOpaque = mockLcdW.nofWindows;
+  (void)printf("window display, windows per glyph: PutPixel %lu, DrawGlyph %lu, opaque %lu\n", winPixel, winGlyph, winOpaque);
+  BenchFonts();
+  return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Strip chart of UIGraph GRAPH2 (no border) on the whole 320x240 display of
+ * the SSD1289 component LCDS, through GDisplay GDS and the UserInterface
+ * stand-in UIX, with the serial controller model of host/mock_ssd1289.h.
+ * Compared for each new sample:
+ * - scroll: ScrollBoxLeft() moves the data with the vertical scroll of the
+ *   controller (R41h), the first and the new column are drawn.
+ * - changed pixels: UIX without ScrollBoxLeft(), as on a display which
+ *   cannot scroll, AddStripChartData() writes the pixels which change.
+ * - full repaint: the painter of the graph draws all columns.
+ * with noise (0..100) and with a ramp of one percent per sample.
+ *
+ * Printed: the host time per sample as samples/s, the SPI bytes sent per
+ * sample and the samples/s these bytes allow at an SPI clock of 10 MHz,
+ * the limit on a target, where the bus dominates.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "mock_userinterface.h"
+#include "mock_ssd1289.h"
+#include "GRAPH2.h"
+#include "LCDS.h"
+#include "GDS.h"
+#include "testutil.h"
+
+#define NOF_SAMPLES   5000
+#define NOF_REPAINTS  200
+#define SPI_HZ        10000000.0
+
+static const UIX_Display scroll = {GDS_DrawVLine, GDS_ScrollBoxLeft};
+static const UIX_Display noScroll = {GDS_DrawVLine, NULL};
+
+static UIX_Window window;
+static GRAPH2_Graph graph;
+static uint8_t ring[320+2];
+
+static uint8_t Sample(unsigned i, bool noise) {
+  return (uint8_t)(noise ? rand()%101 : i%101);
+}
+
+static void Print(const char *mode, const char *signal, unsigned n, unsigned long long ns) {
+  double bytes = (double)mockSsd1289.nofBytes/n;
+
+  (void)printf("%-16s %-6s %12.0f %12.0f %12.1f\n", mode, signal, n*1e9/(double)ns, bytes, SPI_HZ/8/bytes);
+}
+
+static void Bench(const char *mode, const UIX_Display *display, bool noise) {
+  unsigned long long t;
+  unsigned i, n = display!=NULL ? NOF_SAMPLES : NOF_REPAINTS;
+
+  UIX_SetDisplay(display!=NULL ? display : &scroll);
+  (void)GRAPH2_SetStripChart(&graph.element, ring, sizeof(ring), LCDS_COLOR_BLUE);
+  (void)graph.element.painter(&window, &graph.element);
+  for(i=0;i<sizeof(ring);i++) {                 /* fill the ring buffer */
+    (void)GRAPH2_AddStripChartData(&graph.element, Sample(i, noise));
+  }
+  MockSsd1289_ResetCounters();
+  t = TestTimeNs();
+  for(i=0;i<n;i++) {
+    if (display!=NULL) {
+      (void)GRAPH2_AddStripChartData(&graph.element, Sample(i, noise));
+    } else {
+      graph.samples[graph.head] = Sample(i, noise); /* what AddStripChartData() stores, then repaint */
+      graph.head = (GRAPH2_PixelDim)((graph.head+1)%graph.nofSamples);
+      (void)graph.element.painter(&window, &graph.element);
+    }
+  }
+  Print(mode, noise ? "noise" : "ramp", n, TestTimeNs()-t);
+}
+
+int main(void) {
+  int noise;
+
+  LCDS_Init();
+  (void)GRAPH2_CreateGraph(&window, &graph, 0, 0, LCDS_WIDTH, LCDS_HEIGHT);
+  (void)printf("320x240 strip chart, SPI bytes at %.0f MHz\n", SPI_HZ/1e6);
+  (void)printf("%-16s %-6s %12s %12s %12s\n", "mode", "signal", "host smpl/s", "SPI bytes", "SPI smpl/s");
+  for(noise=0;noise<2;noise++) {
+    Bench("scroll", &scroll, (bool)noise);
+    Bench("changed pixels", &noScroll, (bool)noise);
+    Bench("full repaint", NULL, (bool)noise);
+  }
+  return 0;
+}
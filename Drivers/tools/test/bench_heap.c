@@ -0,0 +1,113 @@
+/*
+ * Compares heap_tlsf.c with heap_4.c (both without heap trace, see heap4.c
+ * and heaptlsf.c):
+ *
+ * - random: the same random sequence of pvPortMalloc()/vPortFree() calls,
+ *   average time per call and the number of failed allocations.
+ * - fragmented: allocating and freeing a large block while the heap holds
+ *   many small free blocks.  heap_4 walks its free list for this, heap_tlsf
+ *   does not depend on the number of free blocks.
+ *
+ * The times are host times, only the ratio between the two allocators is
+ * meaningful for a target.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "testutil.h"
+
+#define NOF_SLOTS       256
+#define NOF_ROUNDS      2000000
+#define NOF_FRAGMENTS   2000
+#define NOF_LARGE       20000
+
+void *heap4_pvPortMalloc(size_t xWantedSize);
+void heap4_vPortFree(void *pv);
+void *tlsf_pvPortMalloc(size_t xWantedSize);
+void tlsf_vPortFree(void *pv);
+
+typedef struct {
+  const char *name;
+  void *(*malloc)(size_t);
+  void (*free)(void*);
+} Allocator;
+
+static void *slots[NOF_SLOTS];
+static void *fragments[NOF_FRAGMENTS];
+
+static size_t RandomSize(void) {
+  unsigned r = rand()%100;
+
+  if (r<60) {
+    return 1+rand()%64; /* small objects, e.g. queue items and timers */
+  } else if (r<95) {
+    return 64+rand()%1024; /* task stacks and buffers */
+  }
+  return 1024+rand()%16384; /* large buffers */
+}
+
+static void RunRandom(const Allocator *a) {
+  unsigned long long t;
+  unsigned long nofFailed = 0;
+  int round, i;
+
+  srand(1);
+  t = TestTimeNs();
+  for(round=0;round<NOF_ROUNDS;round++) {
+    i = rand()%NOF_SLOTS;
+    if (slots[i]==NULL) {
+      slots[i] = a->malloc(RandomSize());
+      if (slots[i]==NULL) {
+        nofFailed++;
+      }
+    } else {
+      a->free(slots[i]);
+      slots[i] = NULL;
+    }
+  }
+  t = TestTimeNs()-t;
+  for(i=0;i<NOF_SLOTS;i++) {
+    a->free(slots[i]);
+    slots[i] = NULL;
+  }
+  printf("%-10s random:     %5.1f ns per call, %lu failed allocations\n",
+    a->name, (double)t/NOF_ROUNDS, nofFailed);
+}
+
+static void RunFragmented(const Allocator *a) {
+  unsigned long long t;
+  int i;
+
+  /* every other small block is freed, so they cannot be coalesced */
+  for(i=0;i<NOF_FRAGMENTS;i++) {
+    fragments[i] = a->malloc(24);
+  }
+  for(i=0;i<NOF_FRAGMENTS;i+=2) {
+    a->free(fragments[i]);
+  }
+  t = TestTimeNs();
+  for(i=0;i<NOF_LARGE;i++) {
+    a->free(a->malloc(4096));
+  }
+  t = TestTimeNs()-t;
+  for(i=1;i<NOF_FRAGMENTS;i+=2) {
+    a->free(fragments[i]);
+  }
+  printf("%-10s fragmented: %5.1f ns per malloc/free of 4096 bytes with %d free blocks\n",
+    a->name, (double)t/NOF_LARGE, NOF_FRAGMENTS/2);
+}
+
+int main(void) {
+  static const Allocator allocators[] = {
+    {"heap_4", heap4_pvPortMalloc, heap4_vPortFree},
+    {"heap_tlsf", tlsf_pvPortMalloc, tlsf_vPortFree},
+  };
+  unsigned i;
+
+  printf("heap %u bytes\n", (unsigned)configTOTAL_HEAP_SIZE);
+  for(i=0;i<sizeof(allocators)/sizeof(allocators[0]);i++) {
+    RunRandom(&allocators[i]);
+    RunFragmented(&allocators[i]);
+  }
+  return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Key matrix of the Key component with 70 keys: the time of MatrixScan() with
+ * 8 and 32 bit words of vertical counters, without and with long key
+ * detection, compared with a plain debounce counter for each key. The input
+ * has bouncing keys; with no key pressed, and with all keys pressed. The
+ * events are read after each scan.
+ * Printed: the host time per scan.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "KEY8.h"
+#include "KEY8L.h"
+#include "KEY32.h"
+#include "KEY32L.h"
+#include "testutil.h"
+
+#define NOF_KEYS        70
+#define NOF_SCANS       2000000
+#define NOF_INPUTS      4096             /* prepared inputs, used round robin */
+#define DEBOUNCE_SCANS  20
+
+enum { IN_BOUNCE, IN_NONE, IN_ALL, IN_NOF };
+
+static uint8_t raw8[IN_NOF][NOF_INPUTS][KEY8_MATRIX_NOF_WORDS];
+static uint32_t raw32[IN_NOF][NOF_INPUTS][KEY32_MATRIX_NOF_WORDS];
+
+/* plain debounce counter for each key */
+static bool state[NOF_KEYS];
+static uint16_t dbcCnt[NOF_KEYS];
+static uint8_t queue[256];
+static uint8_t queueHead;
+
+static void CounterScan(const uint8_t *raw) {
+  unsigned k;
+  bool key;
+
+  for(k=0;k<NOF_KEYS;k++) {
+    key = (raw[k/8]>>(k%8))&1;
+    if (key!=state[k]) {
+      if (++dbcCnt[k]==DEBOUNCE_SCANS) {
+        dbcCnt[k] = 0;
+        state[k] = key;
+        queue[queueHead++] = (uint8_t)k;
+      }
+    } else {
+      dbcCnt[k] = 0;
+    }
+  }
+}
+
+static void PrepareInputs(void) {
+  unsigned i, k, bounce[NOF_KEYS] = {0};
+  bool pressed[NOF_KEYS] = {0}, key;
+
+  srand(1);
+  for(i=0;i<NOF_INPUTS;i++) {
+    for(k=0;k<NOF_KEYS;k++) {
+      if (rand()%200==0) {                /* change the key, bounces for up to 15 scans */
+        pressed[k] = !pressed[k];
+        bounce[k] = (unsigned)rand()%16;
+      }
+      key = pressed[k];
+      if (bounce[k]>0) {
+        bounce[k]--;
+        key = rand()%2;
+      }
+      if (key) {
+        raw8[IN_BOUNCE][i][k/8] |= (uint8_t)(1u<<(k%8));
+        raw32[IN_BOUNCE][i][k/32] |= 1u<<(k%32);
+      }
+      raw8[IN_ALL][i][k/8] |= (uint8_t)(1u<<(k%8));
+      raw32[IN_ALL][i][k/32] |= 1u<<(k%32);
+    }
+  }
+}
+
+static unsigned long nofEvents;
+
+#define BENCH(mod, raw, in) \
+  do { \
+    mod##_MatrixEvent event; \
+    unsigned long long t; \
+    uint32_t i; \
+    mod##_Init(); \
+    t = TestTimeNs(); \
+    for(i=0;i<NOF_SCANS;i++) { \
+      mod##_MatrixScan(raw[in][i%NOF_INPUTS]); \
+      while (mod##_MatrixGetEvent(&event)) { \
+        nofEvents++; \
+      } \
+    } \
+    t = TestTimeNs()-t; \
+    (void)printf(" %10.1f", (double)t/NOF_SCANS); \
+  } while(0)
+
+int main(void) {
+  static const char *inputs[IN_NOF] = {"bouncing", "no key", "all keys"};
+  unsigned long long t;
+  uint32_t i;
+  int in;
+
+  PrepareInputs();
+  (void)printf("ns/scan    %10s %10s %10s %10s %10s\n", "KEY8", "KEY8L", "KEY32", "KEY32L", "per key");
+  for(in=0;in<IN_NOF;in++) {
+    (void)printf("%-10s", inputs[in]);
+    BENCH(KEY8, raw8, in);
+    BENCH(KEY8L, raw8, in);
+    BENCH(KEY32, raw32, in);
+    BENCH(KEY32L, raw32, in);
+    memset(state, 0, sizeof(state));
+    memset(dbcCnt, 0, sizeof(dbcCnt));
+    t = TestTimeNs();
+    for(i=0;i<NOF_SCANS;i++) {
+      CounterScan(raw8[in][i%NOF_INPUTS]);
+    }
+    t = TestTimeNs()-t;
+    (void)printf(" %10.1f\n", (double)t/NOF_SCANS);
+  }
+  CHECK(nofEvents>0);
+  return TestResult();
+}
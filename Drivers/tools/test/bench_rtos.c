@@ -0,0 +1,113 @@
+/*
+ * Kernel operations on the FreeRTOS POSIX port with the scheduler running:
+ *
+ * - queue send and receive in one task, without a task switch.
+ * - semaphore ping-pong between two tasks: each give switches to the other
+ *   task, the time per round covers two task switches.
+ * - queue round trip: a request to a server task and its reply.
+ * - tick: the mean and the longest tick period of the tick thread.
+ *
+ * A task switch on the host resumes one thread and suspends another, so the
+ * times are far above the times on a target: they are meant to compare the
+ * kernel and application changes, not to predict the target.
+ */
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "testutil.h"
+
+#define NOF_QUEUE_OPS    1000000
+#define NOF_ROUNDS       20000
+#define NOF_TICKS        500
+
+static SemaphoreHandle_t ping, pong;
+static QueueHandle_t request, reply;
+
+static void PongTask(void *pvParameters) {
+  for(;;) {
+    (void)xSemaphoreTake(ping, portMAX_DELAY);
+    (void)xSemaphoreGive(pong);
+  }
+}
+
+static void ServerTask(void *pvParameters) {
+  uint32_t val;
+
+  for(;;) {
+    (void)xQueueReceive(request, &val, portMAX_DELAY);
+    val++;
+    (void)xQueueSend(reply, &val, portMAX_DELAY);
+  }
+}
+
+static void BenchTask(void *pvParameters) {
+  QueueHandle_t queue;
+  unsigned long long t, maxNs, lastNs, ns;
+  uint32_t val;
+  TickType_t tick;
+  int i;
+
+  (void)printf("%-36s %12s\n", "operation", "ns");
+
+  queue = xQueueCreate(8, sizeof(uint32_t));
+  t = TestTimeNs();
+  for(i=0;i<NOF_QUEUE_OPS;i++) {
+    val = (uint32_t)i;
+    (void)xQueueSend(queue, &val, 0);
+    (void)xQueueReceive(queue, &val, 0);
+  }
+  t = TestTimeNs()-t;
+  (void)printf("%-36s %12.1f\n", "queue send+receive, same task", (double)t/NOF_QUEUE_OPS);
+
+  t = TestTimeNs();
+  for(i=0;i<NOF_ROUNDS;i++) {
+    (void)xSemaphoreGive(ping);
+    (void)xSemaphoreTake(pong, portMAX_DELAY);
+  }
+  t = TestTimeNs()-t;
+  (void)printf("%-36s %12.1f\n", "semaphore ping-pong, per switch", (double)t/(2*NOF_ROUNDS));
+
+  t = TestTimeNs();
+  for(i=0;i<NOF_ROUNDS;i++) {
+    val = (uint32_t)i;
+    (void)xQueueSend(request, &val, portMAX_DELAY);
+    (void)xQueueReceive(reply, &val, portMAX_DELAY);
+  }
+  t = TestTimeNs()-t;
+  (void)printf("%-36s %12.1f\n", "queue round trip to a server task", (double)t/NOF_ROUNDS);
+
+  /* tick periods seen by a task waiting for each tick */
+  tick = xTaskGetTickCount();
+  while (xTaskGetTickCount()==tick) {
+    /* start at a tick */
+  }
+  maxNs = 0;
+  lastNs = t = TestTimeNs();
+  for(i=0;i<NOF_TICKS;i++) {
+    vTaskDelay(1);
+    ns = TestTimeNs();
+    if (ns-lastNs>maxNs) {
+      maxNs = ns-lastNs;
+    }
+    lastNs = ns;
+  }
+  t = lastNs-t;
+  (void)printf("%-36s %12.1f\n", "tick period, mean", (double)t/NOF_TICKS);
+  (void)printf("%-36s %12llu\n", "tick period, longest", maxNs);
+
+  vTaskEndScheduler();
+}
+
+int main(void) {
+  ping = xSemaphoreCreateBinary();
+  pong = xSemaphoreCreateBinary();
+  request = xQueueCreate(1, sizeof(uint32_t));
+  reply = xQueueCreate(1, sizeof(uint32_t));
+  (void)xTaskCreate(PongTask, "pong", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+1, NULL);
+  (void)xTaskCreate(ServerTask, "server", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+1, NULL);
+  (void)xTaskCreate(BenchTask, "bench", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+1, NULL);
+  vTaskStartScheduler();
+  return 0;
+}
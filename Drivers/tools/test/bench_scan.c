@@ -0,0 +1,90 @@
+/*
+ * Number scanners of the Utility component on a text of "0x%08X %u" lines,
+ * scanned with ScanHex32uNumber() and ScanDecimal32uNumber() and once more
+ * with xatoi(): UTIL1 converts character by character, UTIL2 converts aligned
+ * words of four characters at once (CONFIG_SCAN_SWAR). Both give the same
+ * values. Printed: the host throughput.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "UTIL1.h"
+#include "UTIL2.h"
+#include "testutil.h"
+
+#define NOF_LINES   20000
+#define NOF_ROUNDS  100
+
+static unsigned char text[NOF_LINES*24+1];
+static size_t textLen;
+
+#define SCAN_LINES(mod, sum) \
+  do { \
+    const unsigned char *p = text; \
+    uint32_t hex, dec; \
+    while (*p!='\0') { \
+      if (mod##_ScanHex32uNumber(&p, &hex)!=ERR_OK || mod##_ScanDecimal32uNumber(&p, &dec)!=ERR_OK) { \
+        break; \
+      } \
+      (sum) += hex^dec; \
+      p++;                                /* '\n' */ \
+    } \
+  } while(0)
+
+#define XATOI_LINES(mod, sum) \
+  do { \
+    const unsigned char *p = text; \
+    int32_t val; \
+    while (*p!='\0') { \
+      if (mod##_xatoi(&p, &val)!=ERR_OK) { \
+        break; \
+      } \
+      (sum) += (uint32_t)val; \
+      p++;                                /* ' ' or '\n' */ \
+    } \
+  } while(0)
+
+static void Report(const char *name, unsigned long long ns) {
+  (void)printf("%-28s %10.1f MB/s\n", name, (double)textLen*NOF_ROUNDS*1000.0/(double)ns);
+}
+
+int main(void) {
+  unsigned long long t;
+  uint32_t sum1 = 0, sum2 = 0, xsum1 = 0, xsum2 = 0;
+  unsigned i;
+
+  srand(1);
+  for(i=0;i<NOF_LINES;i++) {
+    textLen += (size_t)sprintf((char*)text+textLen, "0x%08X %u\n", (unsigned)rand()*2654435761u, (unsigned)rand());
+  }
+  SCAN_LINES(UTIL1, sum1);
+  SCAN_LINES(UTIL2, sum2);
+  CHECK(sum1==sum2);
+  XATOI_LINES(UTIL1, xsum1);
+  XATOI_LINES(UTIL2, xsum2);
+  CHECK(xsum1==xsum2);
+  (void)printf("%u lines, %u characters\n", NOF_LINES, (unsigned)textLen);
+
+  t = TestTimeNs();
+  for(i=0;i<NOF_ROUNDS;i++) {
+    SCAN_LINES(UTIL1, sum1);
+  }
+  Report("ScanHex/ScanDecimal byte", TestTimeNs()-t);
+  t = TestTimeNs();
+  for(i=0;i<NOF_ROUNDS;i++) {
+    SCAN_LINES(UTIL2, sum2);
+  }
+  Report("ScanHex/ScanDecimal SWAR", TestTimeNs()-t);
+  t = TestTimeNs();
+  for(i=0;i<NOF_ROUNDS;i++) {
+    XATOI_LINES(UTIL1, xsum1);
+  }
+  Report("xatoi byte", TestTimeNs()-t);
+  t = TestTimeNs();
+  for(i=0;i<NOF_ROUNDS;i++) {
+    XATOI_LINES(UTIL2, xsum2);
+  }
+  Report("xatoi SWAR", TestTimeNs()-t);
+  CHECK(sum1==sum2 && xsum1==xsum2);
+  return TestResult();
+}
@@ -0,0 +1,83 @@
+/*
+ * Utility UTIL1: a status line of 13 appends built with strcpy() and the
+ * strcat family, compared with the string builder. Both give the same text.
+ * Printed: the host time per line.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "UTIL1.h"
+#include "testutil.h"
+
+#define NOF_LINES   1000000
+
+static uint8_t line[96];
+
+static void StatusStrcat(uint32_t i) {
+  UTIL1_strcpy(line, sizeof(line), (unsigned char*)"ch ");
+  UTIL1_strcatNum32u(line, sizeof(line), i%128);
+  UTIL1_strcat(line, sizeof(line), (unsigned char*)", rssi ");
+  UTIL1_strcatNum32s(line, sizeof(line), -(int32_t)(i%100));
+  UTIL1_strcat(line, sizeof(line), (unsigned char*)" dBm, addr 0x");
+  UTIL1_strcatNum16Hex(line, sizeof(line), (uint16_t)(i*7));
+  UTIL1_strcat(line, sizeof(line), (unsigned char*)", tx ");
+  UTIL1_strcatNum32u(line, sizeof(line), i*13);
+  UTIL1_strcat(line, sizeof(line), (unsigned char*)", rx ");
+  UTIL1_strcatNum32u(line, sizeof(line), i*11);
+  UTIL1_strcat(line, sizeof(line), (unsigned char*)", load ");
+  UTIL1_strcatNum32sDotValue100(line, sizeof(line), (int32_t)(i%10000));
+  UTIL1_strcat(line, sizeof(line), (unsigned char*)"%");
+}
+
+static void StatusBuilder(uint32_t i) {
+  UTIL1_StrBuilder sb;
+
+  UTIL1_StrBuildInit(&sb, line, sizeof(line));
+  UTIL1_StrBuildStr(&sb, (unsigned char*)"ch ");
+  UTIL1_StrBuildNum32u(&sb, i%128);
+  UTIL1_StrBuildStr(&sb, (unsigned char*)", rssi ");
+  UTIL1_StrBuildNum32s(&sb, -(int32_t)(i%100));
+  UTIL1_StrBuildStr(&sb, (unsigned char*)" dBm, addr 0x");
+  UTIL1_StrBuildHex(&sb, (uint16_t)(i*7), 4);
+  UTIL1_StrBuildStr(&sb, (unsigned char*)", tx ");
+  UTIL1_StrBuildNum32u(&sb, i*13);
+  UTIL1_StrBuildStr(&sb, (unsigned char*)", rx ");
+  UTIL1_StrBuildNum32u(&sb, i*11);
+  UTIL1_StrBuildStr(&sb, (unsigned char*)", load ");
+  UTIL1_StrBuildFixed(&sb, (int32_t)(i%10000), 2);
+  UTIL1_StrBuildStr(&sb, (unsigned char*)"%");
+}
+
+int main(void) {
+  uint8_t ref[sizeof(line)];
+  unsigned long long tStrcat, tBuilder;
+  unsigned long sum = 0;
+  uint32_t i;
+  unsigned nofDiff = 0;
+
+  for(i=0;i<100000;i+=7) { /* same text */
+    StatusStrcat(i);
+    (void)memcpy(ref, line, sizeof(ref));
+    StatusBuilder(i);
+    nofDiff += strcmp((char*)ref, (char*)line)!=0;
+  }
+  CHECK(nofDiff==0);
+  StatusBuilder(4242424);
+  (void)printf("line: %s (%u chars)\n", (char*)line, (unsigned)strlen((char*)line));
+
+  tStrcat = TestTimeNs();
+  for(i=0;i<NOF_LINES;i++) {
+    StatusStrcat(i+4000000);
+    sum += line[40];
+  }
+  tStrcat = TestTimeNs()-tStrcat;
+  tBuilder = TestTimeNs();
+  for(i=0;i<NOF_LINES;i++) {
+    StatusBuilder(i+4000000);
+    sum -= line[40];
+  }
+  tBuilder = TestTimeNs()-tBuilder;
+  CHECK(sum==0);
+  (void)printf("%-16s %10.1f ns/line\n", "strcpy/strcat*", (double)tStrcat/NOF_LINES);
+  (void)printf("%-16s %10.1f ns/line\n", "StrBuild*", (double)tBuilder/NOF_LINES);
+  return TestResult();
+}
@@ -0,0 +1,64 @@
+/*
+ * GenericTimeDate TmDt1: AddTick() as called from the tick interrupt, and the
+ * queries GetTime(), GetDate() for the same day (from the cache) and for a
+ * new day, and GetEpochMs(). Printed: the host time per call.
+ */
+#include <stdio.h>
+#include "Cpu.h"   /* TIMEREC and DATEREC come before the include of Cpu.h in TmDt1.h */
+#include "TmDt1.h"
+#include "testutil.h"
+
+#define NOF_CALLS   10000000
+#define SEC_2024    1704067200UL   /* 2024-01-01 00:00:00 */
+
+int main(void) {
+  unsigned long long t;
+  unsigned long sum = 0;
+  DATEREC date;
+  TIMEREC time;
+  uint32_t i;
+
+  TmDt1_Init();
+  TmDt1_SetEpochSec(SEC_2024);
+  t = TestTimeNs();
+  for(i=0;i<NOF_CALLS;i++) {
+    TmDt1_AddTick();
+  }
+  t = TestTimeNs()-t;
+  CHECK(TmDt1_GetEpochSec()==SEC_2024+NOF_CALLS/100);
+  (void)printf("%-24s %8.2f ns\n", "AddTick", (double)t/NOF_CALLS);
+
+  t = TestTimeNs();
+  for(i=0;i<NOF_CALLS;i++) {
+    (void)TmDt1_GetTime(&time);
+    sum += time.Sec;
+  }
+  t = TestTimeNs()-t;
+  (void)printf("%-24s %8.2f ns\n", "GetTime", (double)t/NOF_CALLS);
+
+  t = TestTimeNs();
+  for(i=0;i<NOF_CALLS;i++) {
+    (void)TmDt1_GetDate(&date);
+    sum += date.Day;
+  }
+  t = TestTimeNs()-t;
+  (void)printf("%-24s %8.2f ns\n", "GetDate, same day", (double)t/NOF_CALLS);
+
+  t = TestTimeNs();
+  for(i=0;i<NOF_CALLS;i++) {
+    TmDt1_SetEpochSec(SEC_2024+i*86400UL%(76*365*86400UL));
+    (void)TmDt1_GetDate(&date);
+    sum += date.Day;
+  }
+  t = TestTimeNs()-t;
+  (void)printf("%-24s %8.2f ns\n", "SetEpochSec+GetDate", (double)t/NOF_CALLS);
+
+  t = TestTimeNs();
+  for(i=0;i<NOF_CALLS;i++) {
+    sum += (unsigned long)TmDt1_GetEpochMs();
+  }
+  t = TestTimeNs()-t;
+  (void)printf("%-24s %8.2f ns\n", "GetEpochMs", (double)t/NOF_CALLS);
+  CHECK(sum!=0);
+  return TestResult();
+}
@@ -0,0 +1,180 @@
+/*
+ * Touch event dispatch of the UI component UI1: ProcessTouch() with the hit
+ * index compared with sending each event to all elements, as ProcessTouch()
+ * did before (MsgSendListRecursiveBottomUp() from the root).
+ *
+ * A window on the 320x240 screen holds a grid of buttons with text. The same
+ * random touches (press, up to four moves, release) go to both variants, and
+ * the buttons have to be pressed and released the same way in both. Printed
+ * for each grid: the number of elements, the host time per touch event and
+ * the message handler calls per event.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "ui_components.h"
+#include "testutil.h"
+
+#define MAX_BUTTONS   512
+#define NOF_TOUCHES   20000
+#define MAX_ELEMENTS  (2+2*MAX_BUTTONS)
+
+static UI1_Screen screen;
+static WIN1_WindowWidget window;
+static BTN1_ButtonWidget buttons[MAX_BUTTONS];
+static unsigned nofButtons;
+
+/* message handlers of the elements, to count the handler calls */
+static struct {
+  UI1_Element *element;
+  UI1_MsgHandler handler;
+} handlers[MAX_ELEMENTS];
+static unsigned nofHandlers;
+static unsigned long nofHandlerCalls;
+
+static void CountingMsgHandler(UI1_MsgKind kind, UI1_Element *element, void *pData) {
+  unsigned i;
+
+  nofHandlerCalls++;
+  for(i=0;i<nofHandlers;i++) {
+    if (handlers[i].element==element) {
+      handlers[i].handler(kind, element, pData);
+      return;
+    }
+  }
+}
+
+static void HookHandlers(UI1_Element *element) {
+  while (element!=NULL) {
+    handlers[nofHandlers].element = element;
+    handlers[nofHandlers].handler = element->msgHandler;
+    element->msgHandler = CountingMsgHandler;
+    nofHandlers++;
+    HookHandlers(element->sub);
+    element = element->next;
+  }
+}
+
+static void RestoreHandlers(void) {
+  unsigned i;
+
+  for(i=0;i<nofHandlers;i++) {
+    handlers[i].element->msgHandler = handlers[i].handler;
+  }
+}
+
+static void CreateGrid(unsigned cols, unsigned rows) {
+  unsigned i, w, h;
+  char label[12];
+
+  UI1_Init();
+  UI1_CreateScreen(&screen, UI1_COLOR_WHITE);
+  (void)WIN1_Create(&screen.element, &window, 0, 0, MOCK_LCD_W_WIDTH-1, MOCK_LCD_W_HEIGHT-1);
+  w = (MOCK_LCD_W_WIDTH-2)/cols;
+  h = (MOCK_LCD_W_HEIGHT-2)/rows;
+  nofButtons = cols*rows;
+  for(i=0;i<nofButtons;i++) {
+    (void)BTN1_Create(&window.element, &buttons[i], (UI1_PixelDim)(1+(i%cols)*w), (UI1_PixelDim)(1+(i/cols)*h),
+      (UI1_PixelDim)(w-2), (UI1_PixelDim)(h-2));
+    (void)snprintf(label, sizeof(label), "%u", i);
+    (void)BTN1_SetText(&buttons[i], (unsigned char*)label);
+  }
+  UI1_UpdateScreen(&screen, TRUE);
+}
+
+/* ProcessTouch() before the hit index */
+static void ProcessTouchAll(bool touched, UI1_PixelDim x, UI1_PixelDim y) {
+  static struct {
+    bool touched;
+    UI1_Coordinate pos;
+  } prevState = {FALSE, {0, 0}};
+  UI1_Coordinate pos;
+
+  pos.x = x;
+  pos.y = y;
+  if (touched && !prevState.touched) {
+    UI1_MsgSendListRecursiveBottomUp(UI1_GetRoot(), UI1_MSG_CLICK, (void*)&pos);
+    prevState.touched = touched;
+    prevState.pos = pos;
+  } else if (touched && prevState.touched && x!=prevState.pos.x && y!=prevState.pos.y) {
+    UI1_MsgSendListRecursiveBottomUp(UI1_GetRoot(), UI1_MSG_CLICK_MOVE, (void*)&pos);
+    prevState.pos = pos;
+  } else if (!touched && prevState.touched) {
+    UI1_MsgSendListRecursiveBottomUp(UI1_GetRoot(), UI1_MSG_CLICK_RELEASE, (void*)&pos);
+    prevState.touched = FALSE;
+    prevState.pos.x = 0;
+    prevState.pos.y = 0;
+  }
+}
+
+/* sends the random touches, returns the number of events and with hash!=NULL a hash of the pressed buttons after each event */
+static unsigned long Touch(void (*process)(bool, UI1_PixelDim, UI1_PixelDim), unsigned long *hash) {
+  unsigned long nofEvents = 0;
+  unsigned i, j, m, b;
+  UI1_PixelDim x, y;
+
+  srand(1);
+  if (hash!=NULL) {
+    *hash = 0;
+  }
+  for(i=0;i<NOF_TOUCHES;i++) {
+    x = (UI1_PixelDim)(rand()%MOCK_LCD_W_WIDTH);
+    y = (UI1_PixelDim)(rand()%MOCK_LCD_W_HEIGHT);
+    m = (unsigned)rand()%5;
+    for(j=0;j<=m+1;j++) {
+      if (j==m+1) {
+        process(FALSE, x, y);
+      } else {
+        if (j>0) { /* move a few pixels */
+          x = (UI1_PixelDim)((x+1+rand()%8)%MOCK_LCD_W_WIDTH);
+          y = (UI1_PixelDim)((y+1+rand()%8)%MOCK_LCD_W_HEIGHT);
+        }
+        process(TRUE, x, y);
+      }
+      nofEvents++;
+      if (hash!=NULL) {
+        for(b=0;b<nofButtons;b++) {
+          if (buttons[b].isPressed) {
+            *hash = *hash*31+b+1;
+          }
+        }
+        *hash = *hash*31;
+      }
+    }
+  }
+  return nofEvents;
+}
+
+int main(void) {
+  static const unsigned grids[][2] = {{4, 2}, {8, 4}, {16, 8}, {32, 16}};
+  unsigned long nofEvents, hashAll, hashHit, callsAll, callsHit;
+  unsigned long long tAll, tHit;
+  size_t i;
+
+  (void)printf("%8s %14s %14s %12s %12s\n", "elements", "all us/event", "hit us/event", "calls all", "calls hit");
+  for(i=0;i<sizeof(grids)/sizeof(grids[0]);i++) {
+    CreateGrid(grids[i][0], grids[i][1]);
+
+    tAll = TestTimeNs();
+    nofEvents = Touch(ProcessTouchAll, NULL);
+    tAll = TestTimeNs()-tAll;
+    tHit = TestTimeNs();
+    (void)Touch(UI1_ProcessTouch, NULL);
+    tHit = TestTimeNs()-tHit;
+
+    nofHandlers = 0;
+    HookHandlers(&screen.element);
+    nofHandlerCalls = 0;
+    (void)Touch(ProcessTouchAll, &hashAll);
+    callsAll = nofHandlerCalls;
+    nofHandlerCalls = 0;
+    (void)Touch(UI1_ProcessTouch, &hashHit);
+    callsHit = nofHandlerCalls;
+    RestoreHandlers();
+    CHECK(hashAll==hashHit);   /* same buttons pressed after each event */
+
+    (void)printf("%8u %14.2f %14.2f %12.1f %12.1f\n", nofHandlers,
+      (double)tAll/1000/nofEvents, (double)tHit/1000/nofEvents,
+      (double)callsAll/nofEvents, (double)callsHit/nofEvents);
+  }
+  return TestResult();
+}
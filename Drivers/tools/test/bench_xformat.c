@@ -0,0 +1,92 @@
+/*
+ * XFormat XF1: a typical log line formatted with xformat() and a format
+ * string, the temperature once as two integers and once with %f, compared
+ * with xformatFast() and precompiled format items, and with xsnprintf(),
+ * which writes directly into the buffer. All variants give the same text.
+ * Printed: the host time per line and the output callback calls per line.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "XF1.h"
+#include "testutil.h"
+
+#define NOF_LINES   500000
+
+static char line[128];
+static unsigned lineLen;
+static unsigned long nofCalls;
+
+static void OutChar(void *arg, char c) {
+  (void)arg;
+  nofCalls++;
+  line[lineLen++&(sizeof(line)-1)] = c;
+}
+
+static void OutBlock(void *arg, const char *p, unsigned n) {
+  (void)arg;
+  nofCalls++;
+  while (n-->0) {
+    line[lineLen++&(sizeof(line)-1)] = *p++;
+  }
+}
+
+static const XF1_FormatItem lineFmt[] = {
+  XF1_FMT_LIT("T: "), XF1_FMT_FIX(0, 2, 0), XF1_FMT_LIT(" C, rpm="), XF1_FMT_U(5, 0), XF1_FMT_LIT(", st="),
+  XF1_FMT_S(0, 0), XF1_FMT_LIT(", id=0x"), XF1_FMT_X(4, XF1_FMT_FLAG_ZERO|XF1_FMT_FLAG_UPPER), XF1_FMT_LIT("\r\n"),
+  XF1_FMT_END()
+};
+
+static void Line(int variant, int i) {
+  long t = 2000+i%1000; /* centi degree */
+
+  lineLen = 0;
+  switch (variant) {
+    case 0:
+      (void)XF1_xformat(OutChar, NULL, "T: %d.%02d C, rpm=%5u, st=%s, id=0x%04X\r\n",
+        (int)(t/100), (int)(t%100), (unsigned)(i&0xfff), "run", (unsigned)(i&0xffff));
+      break;
+    case 1:
+      (void)XF1_xformat(OutChar, NULL, "T: %.2f C, rpm=%5u, st=%s, id=0x%04X\r\n",
+        (double)t/100, (unsigned)(i&0xfff), "run", (unsigned)(i&0xffff));
+      break;
+    case 2:
+      (void)XF1_xformatFast(OutBlock, NULL, lineFmt, t, (unsigned)(i&0xfff), "run", (unsigned)(i&0xffff));
+      break;
+    default:
+      lineLen = (unsigned)XF1_xsnprintf(line, sizeof(line), "T: %d.%02d C, rpm=%5u, st=%s, id=0x%04X\r\n",
+        (int)(t/100), (int)(t%100), (unsigned)(i&0xfff), "run", (unsigned)(i&0xffff));
+      break;
+  }
+  line[lineLen&(sizeof(line)-1)] = '\0';
+}
+
+int main(void) {
+  static const char *names[] = {"xformat %d.%02d", "xformat %.2f", "xformatFast", "xsnprintf %d.%02d"};
+  char ref[sizeof(line)];
+  unsigned long long t;
+  int v, i, nofDiff = 0;
+
+  for(i=0;i<1000;i++) { /* same text from all variants */
+    Line(0, i);
+    (void)strcpy(ref, line);
+    for(v=1;v<4;v++) {
+      Line(v, i);
+      nofDiff += strcmp(ref, line)!=0;
+    }
+  }
+  CHECK(nofDiff==0);
+  Line(0, 345);
+  (void)printf("line: %s", line);
+
+  (void)printf("%-20s %12s %16s\n", "", "ns/line", "calls/line");
+  for(v=0;v<4;v++) {
+    nofCalls = 0;
+    t = TestTimeNs();
+    for(i=0;i<NOF_LINES;i++) {
+      Line(v, i);
+    }
+    t = TestTimeNs()-t;
+    (void)printf("%-20s %12.1f %16.1f\n", names[v], (double)t/NOF_LINES, (double)nofCalls/NOF_LINES);
+  }
+  return TestResult();
+}
@@ -0,0 +1,18 @@
+/*
+ * heap_4.c without heap trace and with renamed entry points, so
+ * bench_heap can compare both allocators on the same workload.
+ */
+#include "FreeRTOSConfig.h"
+#undef configFRTOS_MEMORY_SCHEME
+#define configFRTOS_MEMORY_SCHEME 4
+#undef configUSE_HEAP_TRACE
+#define configUSE_HEAP_TRACE 0
+
+#define pvPortMalloc                    heap4_pvPortMalloc
+#define vPortFree                       heap4_vPortFree
+#define xPortGetFreeHeapSize            heap4_xPortGetFreeHeapSize
+#define xPortGetMinimumEverFreeHeapSize heap4_xPortGetMinimumEverFreeHeapSize
+#define vPortInitialiseBlocks           heap4_vPortInitialiseBlocks
+#define vPortWalkFreeBlocks             heap4_vPortWalkFreeBlocks
+
+#include "heap_4.c"
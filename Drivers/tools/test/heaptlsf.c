@@ -0,0 +1,19 @@
+/*
+ * heap_tlsf.c without heap trace and with renamed entry points, so
+ * bench_heap can compare both allocators on the same workload.
+ */
+#include "FreeRTOSConfig.h"
+#undef configFRTOS_MEMORY_SCHEME
+#define configFRTOS_MEMORY_SCHEME 5
+#undef configUSE_HEAP_TRACE
+#define configUSE_HEAP_TRACE 0
+
+#define pvPortMalloc                    tlsf_pvPortMalloc
+#define vPortFree                       tlsf_vPortFree
+#define xPortGetFreeHeapSize            tlsf_xPortGetFreeHeapSize
+#define xPortGetMinimumEverFreeHeapSize tlsf_xPortGetMinimumEverFreeHeapSize
+#define vPortInitialiseBlocks           tlsf_vPortInitialiseBlocks
+#define vPortWalkFreeBlocks             tlsf_vPortWalkFreeBlocks
+#define vPortGetHeapStats               tlsf_vPortGetHeapStats
+
+#include "heap_tlsf.c"
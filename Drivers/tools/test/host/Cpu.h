@@ -0,0 +1,70 @@
+/*
+ * Host replacement for the Processor Expert CPU component header (Cpu.h and
+ * PE_Types.h), with the types and macros the generated components use.
+ */
+#ifndef __Cpu_H
+#define __Cpu_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef TRUE
+  #define TRUE  1U
+#endif
+#ifndef FALSE
+  #define FALSE 0U
+#endif
+
+typedef uint8_t  byte;
+typedef uint16_t word;
+typedef uint32_t dword;
+typedef uint8_t  uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef int8_t   int8;
+typedef int16_t  int16;
+typedef int32_t  int32;
+
+/* logical device drivers (PE_LDD.h) */
+typedef void     LDD_TDeviceData;
+typedef void     LDD_TUserData;
+typedef uint16_t LDD_TError;
+
+/* error codes (PE_Error.h) */
+#define ERR_OK           0x00U
+#define ERR_SPEED        0x01U
+#define ERR_RANGE        0x02U
+#define ERR_VALUE        0x03U
+#define ERR_OVERFLOW     0x04U
+#define ERR_MATH         0x05U
+#define ERR_ENABLED      0x06U
+#define ERR_DISABLED     0x07U
+#define ERR_BUSY         0x08U
+#define ERR_NOTAVAIL     0x09U
+#define ERR_RXEMPTY      0x0AU
+#define ERR_TXFULL       0x0BU
+#define ERR_BUSOFF       0x0CU
+#define ERR_OVERRUN      0x0DU
+#define ERR_FRAMING      0x0EU
+#define ERR_PARITY       0x0FU
+#define ERR_NOISE        0x10U
+#define ERR_IDLE         0x11U
+#define ERR_FAULT        0x12U
+#define ERR_BREAK        0x13U
+#define ERR_CRC          0x14U
+#define ERR_ARBITR       0x15U
+#define ERR_PROTECT      0x16U
+#define ERR_UNDERFLOW    0x17U
+#define ERR_UNDERRUN     0x18U
+#define ERR_COMMON       0x19U
+#define ERR_LINSYNC      0x1AU
+#define ERR_FAILED       0x1BU
+#define ERR_QFULL        0x1CU
+
+#define EnterCritical()  /* single threaded host tests */
+#define ExitCritical()
+
+#define PE_ISR(name) void name(void)
+
+#endif /* __Cpu_H */
@@ -0,0 +1,8 @@
+/*
+ * Host replacement for the Processor Expert Events.h: the host simulation of
+ * the RNet stack does not create component events.
+ */
+#ifndef __Events_H
+#define __Events_H
+
+#endif /* __Events_H */
@@ -0,0 +1,15 @@
+/*
+ * RNet application configuration for the host simulation of the stack. The
+ * configuration items of RNetConf.h can be set with -D on the command line.
+ */
+#ifndef RNET_APPCONFIG_H_
+#define RNET_APPCONFIG_H_
+
+typedef enum RAPP_MSG_Type {
+  RAPP_MSG_TYPE_STDIN = 0x00,
+  RAPP_MSG_TYPE_STDOUT = 0x01,
+  RAPP_MSG_TYPE_STDERR = 0x02,
+  RAPP_MSG_TYPE_DATA = 0x03,
+} RAPP_MSG_Type;
+
+#endif /* RNET_APPCONFIG_H_ */
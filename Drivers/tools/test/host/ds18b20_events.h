@@ -0,0 +1,19 @@
+/*
+ * Events of the OneWire component OW1, handled by the DS18B20 component
+ * DS1, and of DS1, handled by the test. A Processor Expert project declares
+ * them in Events.h.
+ */
+#ifndef DS18B20_EVENTS_H
+#define DS18B20_EVENTS_H
+
+#include "OW1.h"
+
+void OW1_OnError(OW1_Error error);
+void OW1_OnProgramEvent(int8_t key);
+
+void DS1_OnAllTemperaturesGet(int32_t *temperatures, uint8_t count);
+void DS1_OnError(OW1_Error error);
+void DS1_OnRomRead(uint8_t sensor_index, uint8_t *rom_code);
+void DS1_OnTemperatureGet(uint8_t sensor_index, int32_t temperature);
+
+#endif /* DS18B20_EVENTS_H */
@@ -0,0 +1,25 @@
+/*
+ * The headers of the displays and fonts used by the FontDisplay modules FDW
+ * and FDH of the packed font test and benchmark (see font.props). As for the
+ * UI components (ui_components.h), the generated headers do not include the
+ * components they use, so the sources are compiled with -include of this
+ * header. The GFont headers all declare the same types.
+ */
+#ifndef FONT_COMPONENTS_H
+#define FONT_COMPONENTS_H
+
+#include "mock_lcd.h"
+#include "GDW.h"
+#include "GDH.h"
+#include "FT1.h"
+#include "FT2.h"
+#include "FT3.h"
+#include "FT4.h"
+#include "FP1.h"
+#include "FP2.h"
+#include "FP3.h"
+#include "FP4.h"
+#include "FDW.h"
+#include "FDH.h"
+
+#endif /* FONT_COMPONENTS_H */
@@ -0,0 +1,15 @@
+/*
+ * Host stand-in for the CriticalSection component CS1, for the components
+ * which only need it to protect their variables against interrupts. The
+ * host tests are single threaded.
+ */
+#ifndef MOCK_CS_H
+#define MOCK_CS_H
+
+#include "Cpu.h"
+
+#define CS1_CriticalVariable()
+#define CS1_EnterCritical()
+#define CS1_ExitCritical()
+
+#endif /* MOCK_CS_H */
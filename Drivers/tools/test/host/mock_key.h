@@ -0,0 +1,23 @@
+/*
+ * Host stand-ins for the components used by the Key component: the keyboard
+ * interrupt KBI1 with no key pressed (open is a logical one) and the trigger
+ * TRG1. The host tests only use the key matrix, which needs neither of them.
+ */
+#ifndef MOCK_KEY_H
+#define MOCK_KEY_H
+
+#include "Cpu.h"
+
+#define KBI1_GetVal()     ((byte)0xFFU)
+#define KBI1_Enable()     ((void)0)
+
+#define TRG1_TICK_PERIOD_MS  10
+#define TRG1_AddTrigger(trigger, ticks, callback)  ((void)(trigger), (void)(ticks), (void)(callback))
+
+/* trigger of each Key component built by the makefile */
+#define TRG1_KEY8_PRESS    0
+#define TRG1_KEY8L_PRESS   0
+#define TRG1_KEY32_PRESS   0
+#define TRG1_KEY32L_PRESS  0
+
+#endif /* MOCK_KEY_H */
@@ -0,0 +1,77 @@
+/*
+ * Display buffers of the one bit per pixel displays and the window display
+ * model, see mock_lcd.h.
+ */
+#include "mock_lcd.h"
+
+byte LCDH_DisplayBuf[MOCK_LCD_MONO_HEIGHT][MOCK_LCD_MONO_WIDTH/8];
+byte LCDL_DisplayBuf[MOCK_LCD_MONO_HEIGHT][MOCK_LCD_MONO_WIDTH/8];
+byte LCDV_DisplayBuf[MOCK_LCD_MONO_HEIGHT/8][MOCK_LCD_MONO_WIDTH];
+byte LCDM_DisplayBuf[MOCK_LCD_MONO_HEIGHT/8][MOCK_LCD_MONO_WIDTH];
+
+MockLcdW mockLcdW;
+
+void LCDW_OpenWindow(LCDW_PixelDim x0, LCDW_PixelDim y0, LCDW_PixelDim x1, LCDW_PixelDim y1) {
+  mockLcdW.nofWindows++;
+  if (mockLcdW.open || x0>x1 || y0>y1 || x1>=MOCK_LCD_W_WIDTH || y1>=MOCK_LCD_W_HEIGHT) {
+    mockLcdW.nofErrors++;
+  }
+  mockLcdW.open = true;
+  mockLcdW.x0 = mockLcdW.x = x0;
+  mockLcdW.y0 = mockLcdW.y = y0;
+  mockLcdW.x1 = x1;
+  mockLcdW.y1 = y1;
+}
+
+void LCDW_WritePixel(LCDW_PixelColor color) {
+  mockLcdW.nofPixels++;
+  if (!mockLcdW.open || mockLcdW.y>mockLcdW.y1 || mockLcdW.x>=MOCK_LCD_W_WIDTH || mockLcdW.y>=MOCK_LCD_W_HEIGHT) {
+    mockLcdW.nofErrors++;
+    return;
+  }
+  mockLcdW.pixels[mockLcdW.y][mockLcdW.x] = color;
+  if (mockLcdW.nofPixels==1) {
+    mockLcdW.wx0 = mockLcdW.wx1 = mockLcdW.x;
+    mockLcdW.wy0 = mockLcdW.wy1 = mockLcdW.y;
+  } else {
+    mockLcdW.wx0 = mockLcdW.x<mockLcdW.wx0 ? mockLcdW.x : mockLcdW.wx0;
+    mockLcdW.wy0 = mockLcdW.y<mockLcdW.wy0 ? mockLcdW.y : mockLcdW.wy0;
+    mockLcdW.wx1 = mockLcdW.x>mockLcdW.wx1 ? mockLcdW.x : mockLcdW.wx1;
+    mockLcdW.wy1 = mockLcdW.y>mockLcdW.wy1 ? mockLcdW.y : mockLcdW.wy1;
+  }
+  if (mockLcdW.x<mockLcdW.x1) { /* the window is filled row by row */
+    mockLcdW.x++;
+  } else {
+    mockLcdW.x = mockLcdW.x0;
+    mockLcdW.y++;
+  }
+}
+
+void LCDW_CloseWindow(void) {
+  if (!mockLcdW.open) {
+    mockLcdW.nofErrors++;
+  }
+  mockLcdW.open = false;
+}
+
+void LCDW_UpdateFull(void) {
+  mockLcdW.nofUpdates++;
+}
+
+void LCDW_UpdateRegion(LCDW_PixelDim x, LCDW_PixelDim y, LCDW_PixelDim w, LCDW_PixelDim h) {
+  mockLcdW.nofUpdates++;
+  if (w==0 || h==0 || x+w>MOCK_LCD_W_WIDTH || y+h>MOCK_LCD_W_HEIGHT) {
+    mockLcdW.nofErrors++;
+  }
+  mockLcdW.ux0 = x;
+  mockLcdW.uy0 = y;
+  mockLcdW.ux1 = (unsigned)(x+w-1);
+  mockLcdW.uy1 = (unsigned)(y+h-1);
+}
+
+void MockLcdW_ResetCounters(void) {
+  mockLcdW.nofWindows = 0;
+  mockLcdW.nofPixels = 0;
+  mockLcdW.nofUpdates = 0;
+  mockLcdW.nofErrors = 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Host stand-ins for the display components below GDisplay, one for each
+ * display memory layout in the tests:
+ *
+ * - LCDH: 128x64, one bit per pixel, bytes in rows, the MSB is the leftmost
+ *   pixel (DisplayBuf[y][x/8]).
+ * - LCDL: the same with the LSB as the leftmost pixel.
+ * - LCDV: 128x64, bytes in columns of 8 rows (pages), the LSB is the top
+ *   pixel (DisplayBuf[y/8][x], PCD8544 and ChLCD layout).
+ * - LCDM: the same with the MSB as the top pixel.
+ * - LCDW: 320x240 RGB565 display with window capability and no buffer in
+ *   RAM. OpenWindow(), WritePixel() and CloseWindow() write into
+ *   mockLcdW.pixels, and count the windows and the pixels written.
+ *   UpdateFull() and UpdateRegion() count the calls, UpdateRegion() keeps
+ *   the region to check it against the pixels written.
+ *
+ * All displays are used in landscape orientation.
+ */
+#ifndef MOCK_LCD_H
+#define MOCK_LCD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Cpu.h"
+
+#define MOCK_LCD_DECLARE(name, width, height, black, white) \
+  typedef uint16_t name##_PixelDim; \
+  typedef uint16_t name##_PixelColor; \
+  typedef uint32_t name##_PixelCount; \
+  typedef enum { \
+    name##_ORIENTATION_PORTRAIT, name##_ORIENTATION_PORTRAIT180, \
+    name##_ORIENTATION_LANDSCAPE, name##_ORIENTATION_LANDSCAPE180 \
+  } name##_DisplayOrientation; \
+  enum { \
+    name##_COLOR_PIXEL_SET = (black), name##_COLOR_PIXEL_CLR = (white), \
+    name##_COLOR_BLACK = (black), name##_COLOR_WHITE = (white), \
+    name##_COLOR_RED = 0xF800, name##_COLOR_BRIGHT_RED = 0xF810, name##_COLOR_DARK_RED = 0x8000, \
+    name##_COLOR_GREEN = 0x07E0, name##_COLOR_DARK_GREEN = 0x0400, name##_COLOR_BRIGHT_GREEN = 0x87F0, \
+    name##_COLOR_BLUE = 0x001F, name##_COLOR_BRIGHT_BLUE = 0x841F, name##_COLOR_DARK_BLUE = 0x0010, \
+    name##_COLOR_YELLOW = 0xFFE0, name##_COLOR_BRIGHT_YELLOW = 0xFFF0, name##_COLOR_ORANGE = 0xFC00, \
+    name##_COLOR_GREY = 0x8410, name##_COLOR_BRIGHT_GREY = 0xC618 \
+  }; \
+  static inline name##_PixelDim name##_GetLongerSide(void) { return (width); } \
+  static inline name##_PixelDim name##_GetShorterSide(void) { return (height); } \
+  static inline name##_PixelDim name##_GetWidth(void) { return (width); } \
+  static inline name##_PixelDim name##_GetHeight(void) { return (height); }
+
+#define MOCK_LCD_MONO_WIDTH   128
+#define MOCK_LCD_MONO_HEIGHT  64
+#define MOCK_LCD_W_WIDTH      320
+#define MOCK_LCD_W_HEIGHT     240
+
+MOCK_LCD_DECLARE(LCDH, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, 1, 0)
+MOCK_LCD_DECLARE(LCDL, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, 1, 0)
+MOCK_LCD_DECLARE(LCDV, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, 1, 0)
+MOCK_LCD_DECLARE(LCDM, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, 1, 0)
+MOCK_LCD_DECLARE(LCDW, MOCK_LCD_W_WIDTH, MOCK_LCD_W_HEIGHT, 0x0000, 0xFFFF)
+
+extern byte LCDH_DisplayBuf[MOCK_LCD_MONO_HEIGHT][MOCK_LCD_MONO_WIDTH/8];
+extern byte LCDL_DisplayBuf[MOCK_LCD_MONO_HEIGHT][MOCK_LCD_MONO_WIDTH/8];
+extern byte LCDV_DisplayBuf[MOCK_LCD_MONO_HEIGHT/8][MOCK_LCD_MONO_WIDTH];
+extern byte LCDM_DisplayBuf[MOCK_LCD_MONO_HEIGHT/8][MOCK_LCD_MONO_WIDTH];
+
+typedef struct {
+  uint16_t pixels[MOCK_LCD_W_HEIGHT][MOCK_LCD_W_WIDTH];
+  bool open;                        /* a window is open */
+  unsigned x0, y0, x1, y1;          /* window */
+  unsigned x, y;                    /* next pixel in the window */
+  /* statistics */
+  unsigned long nofWindows;         /* OpenWindow() calls */
+  unsigned long nofPixels;          /* WritePixel() calls */
+  unsigned long nofUpdates;         /* UpdateFull() and UpdateRegion() calls */
+  unsigned long nofErrors;          /* pixels outside of a window, windows outside of the display */
+  unsigned wx0, wy0, wx1, wy1;      /* box around the pixels written, if nofPixels>0 */
+  unsigned ux0, uy0, ux1, uy1;      /* box of the last UpdateRegion(), if nofUpdates>0 */
+} MockLcdW;
+
+extern MockLcdW mockLcdW;
+
+void LCDW_OpenWindow(LCDW_PixelDim x0, LCDW_PixelDim y0, LCDW_PixelDim x1, LCDW_PixelDim y1);
+void LCDW_WritePixel(LCDW_PixelColor color);
+void LCDW_CloseWindow(void);
+void LCDW_UpdateFull(void);
+void LCDW_UpdateRegion(LCDW_PixelDim x, LCDW_PixelDim y, LCDW_PixelDim w, LCDW_PixelDim h);
+
+/* clears the statistics of LCDW */
+void MockLcdW_ResetCounters(void);
+
+#endif /* MOCK_LCD_H */
@@ -0,0 +1,410 @@
+/*
+ * Host model of a nRF24L01+ transceiver, see mock_nrf24.h.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "Cpu.h"
+#include "mock_nrf24.h"
+
+#define CMD_R_REGISTER          0x00
+#define CMD_W_REGISTER          0x20
+#define CMD_R_RX_PL_WID         0x60
+#define CMD_R_RX_PAYLOAD        0x61
+#define CMD_W_TX_PAYLOAD        0xA0
+#define CMD_W_ACK_PAYLOAD       0xA8
+#define CMD_W_TX_PAYLOAD_NO_ACK 0xB0
+#define CMD_FLUSH_TX            0xE1
+#define CMD_FLUSH_RX            0xE2
+#define CMD_REUSE_TX_PL         0xE3
+#define CMD_NOP                 0xFF
+
+#define REG_CONFIG      0x00
+#define REG_STATUS      0x07
+#define REG_OBSERVE_TX  0x08
+#define REG_RPD         0x09
+#define REG_RX_ADDR_P0  0x0A
+#define REG_RX_ADDR_P1  0x0B
+#define REG_TX_ADDR     0x10
+#define REG_FIFO_STATUS 0x17
+
+#define STATUS_RX_DR    0x40
+#define STATUS_TX_DS    0x20
+#define STATUS_MAX_RT   0x10
+#define STATUS_IRQ_MASK (STATUS_RX_DR|STATUS_TX_DS|STATUS_MAX_RT)
+
+#define SPI_RX_BUF_SIZE 64
+#define LOG_SIZE        (256*1024)
+
+MockNrf mockNrf;
+uint16_t mockNrfBlockChunk = 4;
+uint8_t mockNrfSpiError = ERR_OK;
+uint8_t (*mockNrfRpd)(void);
+void (*mockNrfOnChange)(void);
+
+static uint8_t spiRx[SPI_RX_BUF_SIZE]; /* bytes shifted in from the device, not read yet */
+static uint16_t spiRxCnt;
+
+static uint8_t frameCmd;        /* command of the current chip select */
+static uint16_t frameIdx;       /* number of bytes in the current chip select */
+static uint8_t frameMosi[40], frameMiso[40];
+static uint8_t framePayload[MOCK_NRF_PAYLOAD];
+
+static char busLog[LOG_SIZE];
+static size_t logLen;
+
+static void Log(const char *fmt, unsigned a) {
+  if (logLen<sizeof(busLog)) {
+    logLen += (size_t)snprintf(busLog+logLen, sizeof(busLog)-logLen, fmt, a);
+    if (logLen>=sizeof(busLog)) {
+      logLen = sizeof(busLog)-1;
+    }
+  }
+}
+
+static bool IsAddrReg(uint8_t reg) {
+  return reg==REG_RX_ADDR_P0 || reg==REG_RX_ADDR_P1 || reg==REG_TX_ADDR;
+}
+
+static uint8_t Status(void) {
+  uint8_t status = mockNrf.reg[REG_STATUS]&STATUS_IRQ_MASK;
+
+  status |= (uint8_t)((mockNrf.nofRx==0 ? 7 : mockNrf.rxPipe[0])<<1); /* RX_P_NO */
+  if (mockNrf.nofTx==MOCK_NRF_FIFO_SIZE) {
+    status |= 0x01; /* TX_FULL */
+  }
+  return status;
+}
+
+static uint8_t FifoStatus(void) {
+  uint8_t val = 0;
+
+  if (mockNrf.nofTx==MOCK_NRF_FIFO_SIZE) {
+    val |= 0x20; /* TX_FULL */
+  } else if (mockNrf.nofTx==0) {
+    val |= 0x10; /* TX_EMPTY */
+  }
+  if (mockNrf.nofRx==MOCK_NRF_FIFO_SIZE) {
+    val |= 0x02; /* RX_FULL */
+  } else if (mockNrf.nofRx==0) {
+    val |= 0x01; /* RX_EMPTY */
+  }
+  return val;
+}
+
+static uint8_t ReadReg(uint8_t reg, uint16_t idx) {
+  if (IsAddrReg(reg)) {
+    return idx<5 ? mockNrf.addr[reg][idx] : 0;
+  }
+  if (idx!=0) {
+    return 0;
+  }
+  if (reg==REG_STATUS) {
+    return Status();
+  }
+  if (reg==REG_FIFO_STATUS) {
+    return FifoStatus();
+  }
+  if (reg==REG_RPD && mockNrfRpd!=NULL) {
+    return mockNrfRpd();
+  }
+  return mockNrf.reg[reg];
+}
+
+static void WriteReg(uint8_t reg, uint16_t idx, uint8_t val) {
+  if (IsAddrReg(reg)) {
+    if (idx<5) {
+      mockNrf.addr[reg][idx] = val;
+    }
+  } else if (idx==0) {
+    mockNrf.nofRegWrites[reg]++;
+    if (reg==REG_STATUS) {
+      mockNrf.reg[REG_STATUS] &= (uint8_t)~(val&STATUS_IRQ_MASK); /* write 1 to clear */
+    } else if (reg!=REG_FIFO_STATUS && reg!=REG_OBSERVE_TX) { /* read only */
+      mockNrf.reg[reg] = val;
+    }
+    if (mockNrfOnChange!=NULL) {
+      mockNrfOnChange();
+    }
+  }
+}
+
+static void PopRx(void) {
+  memmove(&mockNrf.rxFifo[0], &mockNrf.rxFifo[1], sizeof(mockNrf.rxFifo[0])*(MOCK_NRF_FIFO_SIZE-1));
+  memmove(&mockNrf.rxSize[0], &mockNrf.rxSize[1], MOCK_NRF_FIFO_SIZE-1);
+  memmove(&mockNrf.rxPipe[0], &mockNrf.rxPipe[1], MOCK_NRF_FIFO_SIZE-1);
+  mockNrf.nofRx--;
+}
+
+static void PopTx(void) {
+  memmove(&mockNrf.txFifo[0], &mockNrf.txFifo[1], sizeof(mockNrf.txFifo[0])*(MOCK_NRF_FIFO_SIZE-1));
+  memmove(&mockNrf.txSize[0], &mockNrf.txSize[1], MOCK_NRF_FIFO_SIZE-1);
+  mockNrf.nofTx--;
+}
+
+/* one byte on the bus: returns the byte the device shifts out */
+static uint8_t Shift(uint8_t mosi) {
+  uint8_t miso = 0;
+  uint16_t idx;
+
+  mockNrf.nofSpiBytes++;
+  if (mockNrf.csn) {
+    Log("SPI byte 0x%02x without chip select\n", mosi);
+    return 0xFF;
+  }
+  if (frameIdx==0) {
+    frameCmd = mosi;
+    miso = Status();
+  } else {
+    idx = (uint16_t)(frameIdx-1);
+    if (frameCmd<CMD_W_REGISTER) {
+      miso = ReadReg(frameCmd&0x1F, idx);
+    } else if (frameCmd<CMD_R_RX_PL_WID) {
+      WriteReg(frameCmd&0x1F, idx, mosi);
+    } else if (frameCmd==CMD_R_RX_PL_WID) {
+      miso = (idx==0 && mockNrf.nofRx!=0) ? mockNrf.rxSize[0] : 0;
+    } else if (frameCmd==CMD_R_RX_PAYLOAD) {
+      miso = (mockNrf.nofRx!=0 && idx<MOCK_NRF_PAYLOAD) ? mockNrf.rxFifo[0][idx] : 0;
+    } else if (frameCmd==CMD_W_TX_PAYLOAD || frameCmd==CMD_W_TX_PAYLOAD_NO_ACK) {
+      if (idx<MOCK_NRF_PAYLOAD) {
+        framePayload[idx] = mosi;
+      }
+    }
+  }
+  if (frameIdx<sizeof(frameMosi)) {
+    frameMosi[frameIdx] = mosi;
+    frameMiso[frameIdx] = miso;
+  }
+  frameIdx++;
+  return miso;
+}
+
+static void FrameStart(void) {
+  frameIdx = 0;
+  mockNrf.nofFrames++;
+}
+
+static void FrameEnd(void) {
+  uint16_t i, n;
+
+  if (frameIdx==0) {
+    return;
+  }
+  n = frameIdx<sizeof(frameMosi) ? frameIdx : sizeof(frameMosi);
+  Log(">", 0); /* a frame: "> mosi bytes : miso bytes" */
+  for(i=0;i<n;i++) {
+    Log(" %02x", frameMosi[i]);
+  }
+  Log(" :", 0);
+  for(i=0;i<n;i++) {
+    Log(" %02x", frameMiso[i]);
+  }
+  Log("\n", 0);
+  /* commands executed with the rising edge of CSN */
+  if (frameCmd==CMD_R_RX_PAYLOAD && frameIdx>1 && mockNrf.nofRx!=0) {
+    PopRx();
+  } else if ((frameCmd==CMD_W_TX_PAYLOAD || frameCmd==CMD_W_TX_PAYLOAD_NO_ACK) && frameIdx>1) {
+    if (mockNrf.nofTx<MOCK_NRF_FIFO_SIZE) {
+      n = (uint16_t)(frameIdx-1);
+      mockNrf.txSize[mockNrf.nofTx] = (uint8_t)(n>MOCK_NRF_PAYLOAD ? MOCK_NRF_PAYLOAD : n);
+      memcpy(mockNrf.txFifo[mockNrf.nofTx], framePayload, MOCK_NRF_PAYLOAD);
+      mockNrf.nofTx++;
+    } else {
+      Log("TX FIFO overflow\n", 0);
+    }
+  } else if (frameCmd==CMD_FLUSH_TX) {
+    mockNrf.nofTx = 0;
+  } else if (frameCmd==CMD_FLUSH_RX) {
+    mockNrf.nofRx = 0;
+  }
+}
+
+void MockNrf_Reset(void) {
+  memset(&mockNrf, 0, sizeof(mockNrf));
+  mockNrf.reg[REG_CONFIG] = 0x08;
+  mockNrf.reg[0x01] = 0x3F; /* EN_AA */
+  mockNrf.reg[0x02] = 0x03; /* EN_RXADDR */
+  mockNrf.reg[0x03] = 0x03; /* SETUP_AW */
+  mockNrf.reg[0x04] = 0x03; /* SETUP_RETR */
+  mockNrf.reg[0x05] = 0x02; /* RF_CH */
+  mockNrf.reg[0x06] = 0x0E; /* RF_SETUP */
+  memset(mockNrf.addr[REG_RX_ADDR_P0], 0xE7, 5);
+  memset(mockNrf.addr[REG_RX_ADDR_P1], 0xC2, 5);
+  memset(mockNrf.addr[REG_TX_ADDR], 0xE7, 5);
+  mockNrf.csn = true;
+  spiRxCnt = 0;
+  MockNrf_ClearLog();
+}
+
+const char *MockNrf_Log(void) {
+  return busLog;
+}
+
+void MockNrf_ClearLog(void) {
+  logLen = 0;
+  busLog[0] = '\0';
+}
+
+bool MockNrf_Receive(uint8_t pipe, const uint8_t *payload, uint8_t size) {
+  if (mockNrf.nofRx==MOCK_NRF_FIFO_SIZE || size>MOCK_NRF_PAYLOAD) {
+    return false;
+  }
+  memset(mockNrf.rxFifo[mockNrf.nofRx], 0, MOCK_NRF_PAYLOAD);
+  memcpy(mockNrf.rxFifo[mockNrf.nofRx], payload, size);
+  mockNrf.rxSize[mockNrf.nofRx] = size;
+  mockNrf.rxPipe[mockNrf.nofRx] = pipe;
+  mockNrf.nofRx++;
+  mockNrf.reg[REG_STATUS] |= STATUS_RX_DR;
+  return true;
+}
+
+bool MockNrf_Transmit(bool ack) {
+  if (mockNrf.nofTx==0 || (mockNrf.reg[REG_STATUS]&STATUS_MAX_RT)) {
+    return false; /* nothing to send, or stopped until MAX_RT is cleared */
+  }
+  if (ack) {
+    PopTx();
+    mockNrf.reg[REG_STATUS] |= STATUS_TX_DS;
+    mockNrf.reg[REG_OBSERVE_TX] &= 0xF0; /* ARC_CNT */
+  } else { /* payload stays in the FIFO */
+    mockNrf.reg[REG_STATUS] |= STATUS_MAX_RT;
+    mockNrf.reg[REG_OBSERVE_TX] = (uint8_t)((mockNrf.reg[REG_OBSERVE_TX]&0xF0)+0x10); /* PLOS_CNT */
+  }
+  return true;
+}
+
+bool MockNrf_IrqActive(void) {
+  /* CONFIG bits 6..4 mask the interrupts in the same bit positions as STATUS */
+  return (mockNrf.reg[REG_STATUS]&STATUS_IRQ_MASK&~mockNrf.reg[REG_CONFIG])!=0;
+}
+
+uint8_t MockNrf_Shift(uint8_t mosi) {
+  mockNrf.nofSpiCalls++;
+  return Shift(mosi);
+}
+
+/* SPI component */
+uint8_t SM1_SendChar(uint8_t ch) {
+  if (spiRxCnt==SPI_RX_BUF_SIZE) {
+    return ERR_TXFULL;
+  }
+  mockNrf.nofSpiCalls++;
+  spiRx[spiRxCnt++] = Shift(ch);
+  return ERR_OK;
+}
+
+uint8_t SM1_RecvChar(uint8_t *ch) {
+  if (spiRxCnt==0) {
+    return ERR_RXEMPTY;
+  }
+  *ch = spiRx[0];
+  memmove(&spiRx[0], &spiRx[1], --spiRxCnt);
+  return ERR_OK;
+}
+
+uint16_t SM1_GetCharsInTxBuf(void) {
+  return 0; /* bytes are shifted out immediately */
+}
+
+uint16_t SM1_GetCharsInRxBuf(void) {
+  return spiRxCnt;
+}
+
+uint8_t SM1_SendBlock(uint8_t *ptr, uint16_t size, uint16_t *snd) {
+  uint16_t i;
+
+  if (mockNrfSpiError!=ERR_OK) {
+    *snd = 0;
+    return mockNrfSpiError;
+  }
+  if (size>mockNrfBlockChunk) {
+    size = mockNrfBlockChunk; /* output buffer only accepts a part */
+  }
+  if (size>SPI_RX_BUF_SIZE-spiRxCnt) {
+    size = (uint16_t)(SPI_RX_BUF_SIZE-spiRxCnt); /* would overrun the receiver */
+  }
+  mockNrf.nofSpiCalls++;
+  for(i=0;i<size;i++) {
+    spiRx[spiRxCnt++] = Shift(ptr[i]);
+  }
+  *snd = size;
+  return size==0 ? ERR_TXFULL : ERR_OK;
+}
+
+uint8_t SM1_RecvBlock(uint8_t *ptr, uint16_t size, uint16_t *rcv) {
+  if (mockNrfSpiError!=ERR_OK) {
+    *rcv = 0;
+    return mockNrfSpiError;
+  }
+  if (size>spiRxCnt) {
+    size = spiRxCnt;
+  }
+  memcpy(ptr, spiRx, size);
+  spiRxCnt = (uint16_t)(spiRxCnt-size);
+  memmove(&spiRx[0], &spiRx[size], spiRxCnt);
+  *rcv = size;
+  return size==0 ? ERR_RXEMPTY : ERR_OK;
+}
+
+uint8_t SM1_SetBaudRateMode(uint8_t mode) {
+  return ERR_OK;
+}
+
+uint8_t SM1_SetFastMode(void) {
+  return ERR_OK;
+}
+
+uint8_t SM1_SetSlowMode(void) {
+  return ERR_OK;
+}
+
+uint8_t SM1_SetShiftClockPolarity(uint8_t edge) {
+  return ERR_OK;
+}
+
+uint8_t SM1_SetIdleClockPolarity(uint8_t level) {
+  return ERR_OK;
+}
+
+/* pins and wait */
+void CE1_ClrVal(void) {
+  if (mockNrf.ce) {
+    Log("CE 0\n", 0);
+    mockNrf.ce = false;
+    if (mockNrfOnChange!=NULL) {
+      mockNrfOnChange();
+    }
+  }
+}
+
+void CE1_SetVal(void) {
+  if (!mockNrf.ce) {
+    Log("CE 1\n", 0);
+    mockNrf.nofCeHigh++;
+    mockNrf.ce = true;
+    if (mockNrfOnChange!=NULL) {
+      mockNrfOnChange();
+    }
+  }
+}
+
+void CSN1_ClrVal(void) {
+  if (mockNrf.csn) {
+    FrameStart();
+  }
+  mockNrf.csn = false;
+}
+
+void CSN1_SetVal(void) {
+  if (!mockNrf.csn) {
+    mockNrf.csn = true;
+    FrameEnd();
+  }
+}
+
+void WAIT1_Waitus(uint16_t us) {
+  mockNrf.timeUs += us;
+}
+
+void WAIT1_Waitms(uint16_t ms) {
+  mockNrf.timeUs += 1000ULL*ms;
+}
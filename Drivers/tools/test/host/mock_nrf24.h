@@ -0,0 +1,97 @@
+/*
+ * Host model of a nRF24L01+ transceiver behind the components used by the
+ * nRF24L01 driver: SPI (SM1), CE (CE1), CSN (CSN1) and Wait (WAIT1).
+ *
+ * The model implements the SPI commands, the registers, the TX and RX FIFOs
+ * with three entries each and the status flags. The traffic on the bus is
+ * written to a log (one line per chip select with the MOSI and MISO bytes,
+ * and one line per CE change), so tests can compare the traffic of two
+ * driver configurations.
+ */
+#ifndef MOCK_NRF24_H
+#define MOCK_NRF24_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* SPI component (LDD like 8 bit SPI master) */
+uint8_t SM1_SendChar(uint8_t ch);
+uint8_t SM1_RecvChar(uint8_t *ch);
+uint16_t SM1_GetCharsInTxBuf(void);
+uint16_t SM1_GetCharsInRxBuf(void);
+uint8_t SM1_SendBlock(uint8_t *ptr, uint16_t size, uint16_t *snd);
+uint8_t SM1_RecvBlock(uint8_t *ptr, uint16_t size, uint16_t *rcv);
+uint8_t SM1_SetBaudRateMode(uint8_t mode);
+uint8_t SM1_SetFastMode(void);
+uint8_t SM1_SetSlowMode(void);
+uint8_t SM1_SetShiftClockPolarity(uint8_t edge);
+uint8_t SM1_SetIdleClockPolarity(uint8_t level);
+
+/* pins and wait */
+void CE1_ClrVal(void);
+void CE1_SetVal(void);
+void CSN1_ClrVal(void);
+void CSN1_SetVal(void);
+void WAIT1_Waitus(uint16_t us);
+void WAIT1_Waitms(uint16_t ms);
+
+#define MOCK_NRF_FIFO_SIZE  3
+#define MOCK_NRF_PAYLOAD    32
+
+typedef struct {
+  uint8_t reg[0x20];                /* registers, address registers use addr[] */
+  uint8_t addr[0x20][5];            /* RX_ADDR_P0, RX_ADDR_P1 and TX_ADDR */
+  uint8_t txFifo[MOCK_NRF_FIFO_SIZE][MOCK_NRF_PAYLOAD];
+  uint8_t txSize[MOCK_NRF_FIFO_SIZE];
+  uint8_t nofTx;                    /* entries in the TX FIFO */
+  uint8_t rxFifo[MOCK_NRF_FIFO_SIZE][MOCK_NRF_PAYLOAD];
+  uint8_t rxSize[MOCK_NRF_FIFO_SIZE];
+  uint8_t rxPipe[MOCK_NRF_FIFO_SIZE];
+  uint8_t nofRx;                    /* entries in the RX FIFO */
+  bool ce;                          /* CE pin */
+  bool csn;                         /* CSN pin */
+  unsigned long nofCeHigh;          /* number of CE rising edges */
+  unsigned long nofFrames;          /* number of chip selects */
+  unsigned long nofSpiCalls;        /* number of SPI component calls which transfer data */
+  unsigned long nofSpiBytes;        /* number of bytes shifted on the bus */
+  unsigned long long timeUs;        /* time passed in WAIT1 */
+  unsigned long nofRegWrites[0x20]; /* W_REGISTER commands per register, without the address registers */
+} MockNrf;
+
+extern MockNrf mockNrf;
+
+/* block transfer: number of bytes the SPI output buffer accepts per SendBlock() call */
+extern uint16_t mockNrfBlockChunk;
+
+/* block transfer: if not ERR_OK, SendBlock() and RecvBlock() fail with this error without a transfer */
+extern uint8_t mockNrfSpiError;
+
+/* received power detector: if set, reads of the RPD register return its result (bit 0 set above -64 dBm) */
+extern uint8_t (*mockNrfRpd)(void);
+
+/* if set, called after every CE change and register write, e.g. to check the timing of the power states */
+extern void (*mockNrfOnChange)(void);
+
+/* resets the device to the power on state and clears the log */
+void MockNrf_Reset(void);
+
+/* log of the bus traffic since the last reset */
+const char *MockNrf_Log(void);
+void MockNrf_ClearLog(void);
+
+/* puts a received packet into the RX FIFO and sets RX_DR, returns false if the FIFO is full */
+bool MockNrf_Receive(uint8_t pipe, const uint8_t *payload, uint8_t size);
+
+/* transmits the oldest TX FIFO entry and sets TX_DS, or MAX_RT if ack is false;
+   returns false if the TX FIFO is empty or a MAX_RT is pending */
+bool MockNrf_Transmit(bool ack);
+
+/* IRQ pin, active low: true while one of the enabled status flags is set */
+bool MockNrf_IrqActive(void);
+
+/* one byte on the bus for an SPI component other than SM1, e.g. the bus
+   simulation of GenericSWSPI: returns the byte the device shifts out */
+uint8_t MockNrf_Shift(uint8_t mosi);
+
+#endif /* MOCK_NRF24_H */
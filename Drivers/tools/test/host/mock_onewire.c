@@ -0,0 +1,353 @@
+/*
+ * Host model of a 1-Wire bus with DS18B20 sensors, see mock_onewire.h.
+ */
+#include <string.h>
+#include "Cpu.h"
+#include "mock_onewire.h"
+
+#define RESET_MIN_US      480  /* low pulse detected as reset */
+#define PRESENCE_WAIT_US  30   /* presence pulse after the reset pulse */
+#define PRESENCE_US       120
+#define SLOT_SAMPLE_US    15   /* a shorter low pulse writes a 1 */
+#define READ_HOLD_US      30   /* a sensor sending a 0 holds the line low */
+#define CONVERT_12BIT_US  750000ULL
+
+#define ROM_READ          0x33
+#define ROM_MATCH         0x55
+#define ROM_SKIP          0xCC
+#define ROM_SEARCH        0xF0
+#define FUNC_CONVERT_T    0x44
+#define FUNC_WRITE_SCRATCHPAD 0x4E
+#define FUNC_READ_SCRATCHPAD  0xBE
+
+enum {
+  DS_IDLE,            /* waits for a reset */
+  DS_ROM_CMD,         /* receives the ROM command */
+  DS_SEND_ROM,        /* sends the ROM code */
+  DS_MATCH_ROM,       /* receives the ROM code to match */
+  DS_SEARCH_BIT,      /* sends the ROM bit */
+  DS_SEARCH_CMP,      /* sends its complement */
+  DS_SEARCH_DIR,      /* receives the direction */
+  DS_FUNC_CMD,        /* receives the function command */
+  DS_SEND_SCRATCHPAD, /* sends the scratchpad */
+  DS_WRITE_SCRATCHPAD /* receives TH, TL and config */
+};
+
+MockOw mockOw;
+
+uint8_t MockOw_Crc8(const uint8_t *data, unsigned len) {
+  uint8_t crc = 0, b, i;
+
+  while (len-->0) {
+    b = *data++;
+    for(i=0;i<8;i++) {
+      crc = ((crc^b)&0x01) ? (uint8_t)((crc>>1)^0x8C) : (uint8_t)(crc>>1);
+      b >>= 1;
+    }
+  }
+  return crc;
+}
+
+static bool BufBit(const uint8_t *buf, unsigned bit) {
+  return (buf[bit>>3]>>(bit&7))&1;
+}
+
+/* finishes a conversion which is due */
+static void DevUpdate(MockOwDevice *d) {
+  int16_t t;
+
+  if (d->convertEndUs!=0 && mockOw.timeUs>=d->convertEndUs) {
+    t = d->temperature;
+    t &= (int16_t)~((1<<(3-((d->scratchpad[4]>>5)&3)))-1); /* undefined bits of the lower resolutions read as 0 */
+    d->scratchpad[0] = (uint8_t)t;
+    d->scratchpad[1] = (uint8_t)((uint16_t)t>>8);
+    d->scratchpad[8] = MockOw_Crc8(d->scratchpad, 8);
+    d->convertEndUs = 0;
+  }
+}
+
+/* true if the sensor sends in the current slot */
+static bool DevSending(const MockOwDevice *d) {
+  return d->state==DS_SEND_ROM || d->state==DS_SEND_SCRATCHPAD || d->state==DS_SEARCH_BIT || d->state==DS_SEARCH_CMP;
+}
+
+static bool DevSendBit(const MockOwDevice *d) {
+  switch(d->state) {
+    case DS_SEARCH_BIT:
+      return BufBit(d->rom, d->bit);
+    case DS_SEARCH_CMP:
+      return !BufBit(d->rom, d->bit);
+    default:
+      return BufBit(d->buf, d->bit);
+  }
+}
+
+static void DevStartSend(MockOwDevice *d, int state, const uint8_t *data, unsigned nofBytes) {
+  memcpy(d->buf, data, nofBytes);
+  d->state = state;
+  d->bit = 0;
+  d->nofBits = nofBytes*8;
+}
+
+static void DevStartReceive(MockOwDevice *d, int state, unsigned nofBytes) {
+  memset(d->buf, 0, sizeof(d->buf));
+  d->state = state;
+  d->bit = 0;
+  d->nofBits = nofBytes*8;
+}
+
+/* a command or data block has been received, returns true for CONVERT_T */
+static bool DevReceived(MockOwDevice *d) {
+  switch(d->state) {
+    case DS_ROM_CMD:
+      switch(d->buf[0]) {
+        case ROM_READ:
+          DevStartSend(d, DS_SEND_ROM, d->rom, 8);
+          break;
+        case ROM_MATCH:
+          DevStartReceive(d, DS_MATCH_ROM, 8);
+          break;
+        case ROM_SKIP:
+          DevStartReceive(d, DS_FUNC_CMD, 1);
+          break;
+        case ROM_SEARCH:
+          d->state = DS_SEARCH_BIT;
+          d->bit = 0;
+          break;
+        default:
+          d->state = DS_IDLE;
+          break;
+      }
+      break;
+    case DS_MATCH_ROM:
+      if (memcmp(d->buf, d->rom, 8)==0) {
+        DevStartReceive(d, DS_FUNC_CMD, 1);
+      } else {
+        d->state = DS_IDLE;
+      }
+      break;
+    case DS_FUNC_CMD:
+      DevUpdate(d);
+      switch(d->buf[0]) {
+        case FUNC_CONVERT_T:
+          d->convertEndUs = mockOw.timeUs+(CONVERT_12BIT_US>>(3-((d->scratchpad[4]>>5)&3)));
+          d->state = DS_IDLE;
+          return true;
+        case FUNC_READ_SCRATCHPAD:
+          if (d->convertEndUs!=0) {
+            d->nofEarlyReads++;
+          }
+          DevStartSend(d, DS_SEND_SCRATCHPAD, d->scratchpad, 9);
+          if (d->corrupt) {
+            d->buf[8] ^= 0x01;
+          }
+          break;
+        case FUNC_WRITE_SCRATCHPAD:
+          DevStartReceive(d, DS_WRITE_SCRATCHPAD, 3);
+          break;
+        default:
+          d->state = DS_IDLE;
+          break;
+      }
+      break;
+    case DS_WRITE_SCRATCHPAD:
+      d->scratchpad[2] = d->buf[0];
+      d->scratchpad[3] = d->buf[1];
+      d->scratchpad[4] = (uint8_t)((d->buf[2]&0x60)|0x1F);
+      d->scratchpad[8] = MockOw_Crc8(d->scratchpad, 8);
+      d->state = DS_IDLE;
+      break;
+    default:
+      d->state = DS_IDLE;
+      break;
+  }
+  return false;
+}
+
+/* a time slot ended with the master releasing the line after lowUs */
+static void DevSlot(MockOwDevice *d, unsigned long long lowUs, bool *convert) {
+  bool bit = lowUs<SLOT_SAMPLE_US;
+
+  switch(d->state) {
+    case DS_IDLE:
+      return;
+    case DS_SEARCH_BIT:
+      d->state = DS_SEARCH_CMP;
+      return;
+    case DS_SEARCH_CMP:
+      d->state = DS_SEARCH_DIR;
+      return;
+    case DS_SEARCH_DIR:
+      if (bit!=BufBit(d->rom, d->bit)) {
+        d->state = DS_IDLE; /* not on the selected path */
+      } else if (++d->bit==64) {
+        DevStartReceive(d, DS_FUNC_CMD, 1);
+      } else {
+        d->state = DS_SEARCH_BIT;
+      }
+      return;
+    default:
+      break;
+  }
+  if (DevSending(d)) {
+    if (++d->bit==d->nofBits) {
+      if (d->state==DS_SEND_ROM) {
+        DevStartReceive(d, DS_FUNC_CMD, 1);
+      } else {
+        d->state = DS_IDLE;
+      }
+    }
+    return;
+  }
+  if (bit) {
+    d->buf[d->bit>>3] |= (uint8_t)(1<<(d->bit&7));
+  }
+  if (++d->bit==d->nofBits) {
+    *convert |= DevReceived(d);
+  }
+}
+
+void MockOw_Pull(void) {
+  unsigned i;
+  MockOwDevice *d;
+
+  if (mockOw.masterLow) {
+    return;
+  }
+  mockOw.masterLow = true;
+  mockOw.lowStartUs = mockOw.timeUs;
+  for(i=0;i<mockOw.nofDevices;i++) {
+    d = &mockOw.dev[i];
+    if (d->present && DevSending(d) && !DevSendBit(d)) {
+      d->holdEndUs = mockOw.timeUs+READ_HOLD_US;
+    }
+  }
+}
+
+void MockOw_Release(void) {
+  unsigned long long lowUs;
+  unsigned i;
+  bool convert = false;
+  MockOwDevice *d;
+
+  if (!mockOw.masterLow) {
+    return;
+  }
+  mockOw.masterLow = false;
+  lowUs = mockOw.timeUs-mockOw.lowStartUs;
+  if (lowUs>=RESET_MIN_US) {
+    mockOw.nofResets++;
+    mockOw.presenceStartUs = mockOw.timeUs+PRESENCE_WAIT_US;
+    mockOw.presenceEndUs = mockOw.presenceStartUs+PRESENCE_US;
+    for(i=0;i<mockOw.nofDevices;i++) {
+      d = &mockOw.dev[i];
+      DevStartReceive(d, DS_ROM_CMD, 1);
+      d->holdEndUs = 0;
+    }
+    return;
+  }
+  mockOw.nofSlots++;
+  for(i=0;i<mockOw.nofDevices;i++) {
+    d = &mockOw.dev[i];
+    if (d->present) {
+      DevSlot(d, lowUs, &convert);
+    }
+  }
+  if (convert) {
+    mockOw.nofConvertT++;
+  }
+}
+
+bool MockOw_Line(void) {
+  unsigned i;
+  bool anyPresent = false;
+
+  if (mockOw.masterLow) {
+    return false;
+  }
+  for(i=0;i<mockOw.nofDevices;i++) {
+    if (mockOw.dev[i].present) {
+      anyPresent = true;
+      if (mockOw.timeUs<mockOw.dev[i].holdEndUs) {
+        return false;
+      }
+    }
+  }
+  return !(anyPresent && mockOw.timeUs>=mockOw.presenceStartUs && mockOw.timeUs<mockOw.presenceEndUs);
+}
+
+void MockOw_Reset(void) {
+  memset(&mockOw, 0, sizeof(mockOw));
+}
+
+unsigned MockOw_AddDevice(uint8_t family, uint64_t serial) {
+  static const uint8_t powerOn[8] = {0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10}; /* 85 degree, 12 bit */
+  MockOwDevice *d = &mockOw.dev[mockOw.nofDevices];
+  unsigned i;
+
+  memset(d, 0, sizeof(*d));
+  d->rom[0] = family;
+  for(i=1;i<7;i++) {
+    d->rom[i] = (uint8_t)(serial>>(8*(i-1)));
+  }
+  d->rom[7] = MockOw_Crc8(d->rom, 7);
+  memcpy(d->scratchpad, powerOn, sizeof(powerOn));
+  d->scratchpad[8] = MockOw_Crc8(d->scratchpad, 8);
+  d->temperature = 0x0550;
+  d->present = true;
+  d->state = DS_IDLE;
+  return mockOw.nofDevices++;
+}
+
+LDD_TDeviceData *TU1_Init(LDD_TUserData *UserDataPtr) {
+  mockOw.tuEnabled = false;
+  return &mockOw;
+}
+
+LDD_TError TU1_Enable(LDD_TDeviceData *DeviceDataPtr) {
+  if (!mockOw.tuEnabled) {
+    mockOw.tuEnabled = true;
+    mockOw.tuRestartUs = mockOw.timeUs;
+  }
+  return ERR_OK;
+}
+
+LDD_TError TU1_Disable(LDD_TDeviceData *DeviceDataPtr) {
+  mockOw.tuEnabled = false;
+  return ERR_OK;
+}
+
+LDD_TError TU1_ResetCounter(LDD_TDeviceData *DeviceDataPtr) {
+  mockOw.tuRestartUs = mockOw.timeUs;
+  return ERR_OK;
+}
+
+LDD_TError TU1_SetPeriodTicks(LDD_TDeviceData *DeviceDataPtr, uint32_t Ticks) {
+  mockOw.tuNextPeriod = Ticks;
+  if (!mockOw.tuEnabled) {
+    mockOw.tuPeriod = Ticks; /* loaded when the counter starts */
+  }
+  return ERR_OK;
+}
+
+uint32_t TU1_GetInputFrequency(LDD_TDeviceData *DeviceDataPtr) {
+  return 1000000U;
+}
+
+void MockOw_Run(unsigned long long untilUs) {
+  unsigned long long next;
+
+  while (mockOw.tuEnabled) {
+    next = mockOw.tuRestartUs+mockOw.tuPeriod;
+    if (next>untilUs) {
+      mockOw.busyUs += untilUs-mockOw.timeUs;
+      mockOw.timeUs = untilUs;
+      return;
+    }
+    mockOw.busyUs += next-mockOw.timeUs;
+    mockOw.timeUs = next;
+    mockOw.tuRestartUs = next;
+    mockOw.tuPeriod = mockOw.tuNextPeriod;
+    TU1_OnCounterRestart(NULL);
+  }
+}
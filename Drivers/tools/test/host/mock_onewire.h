@@ -0,0 +1,104 @@
+/*
+ * Host model of a 1-Wire bus with DS18B20 sensors behind the components
+ * used by the OneWire driver: the DQ pin (DQ1, GPIO_PDD macros), the timer
+ * unit (TU1) and the critical section (CS1).
+ *
+ * The model runs in simulated time (us): MockOw_Run() advances the time to
+ * the next counter restart of the timer unit and calls its OnCounterRestart
+ * event. The sensors decode the reset pulses and time slots from the length
+ * of the low pulses of the master, answer with presence pulses and drive
+ * their bits low in the read slots. They implement the ROM commands (read,
+ * match, skip, search) and the function commands convert, read and write
+ * scratchpad.
+ */
+#ifndef MOCK_ONEWIRE_H
+#define MOCK_ONEWIRE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Cpu.h"
+
+/* DQ pin: the output data is cleared once, the direction pulls the line low or releases it */
+#define DQ1_MODULE_BASE_ADDRESS  0U
+#define DQ1_PORT_MASK            0x01U
+
+#define GPIO_PDD_ClearPortDataOutputMask(base, mask)   ((void)0)
+#define GPIO_PDD_SetPortInputDirectionMask(base, mask) MockOw_Release()
+#define GPIO_PDD_SetPortOutputDirectionMask(base, mask) MockOw_Pull()
+#define GPIO_PDD_GetPortDirection(base)                (mockOw.masterLow ? DQ1_PORT_MASK : 0U)
+#define GPIO_PDD_GetPortDataInput(base)                (MockOw_Line() ? DQ1_PORT_MASK : 0U)
+#define GPIO_PDD_GetPortDataOutput(base)               0U
+
+/* critical section: single threaded */
+#define CS1_CriticalVariable()
+#define CS1_EnterCritical()
+#define CS1_ExitCritical()
+
+/* timer unit (LDD), 1 MHz input clock: a new period applies from the next
+   counter restart on, like a buffered modulo register */
+LDD_TDeviceData *TU1_Init(LDD_TUserData *UserDataPtr);
+LDD_TError TU1_Enable(LDD_TDeviceData *DeviceDataPtr);
+LDD_TError TU1_Disable(LDD_TDeviceData *DeviceDataPtr);
+LDD_TError TU1_ResetCounter(LDD_TDeviceData *DeviceDataPtr);
+LDD_TError TU1_SetPeriodTicks(LDD_TDeviceData *DeviceDataPtr, uint32_t Ticks);
+uint32_t TU1_GetInputFrequency(LDD_TDeviceData *DeviceDataPtr);
+void TU1_OnCounterRestart(LDD_TUserData *UserDataPtr); /* generated in OW1.c */
+
+/* the DS18B20 component reads the input queue of the OneWire component */
+uint8 Input_Get(void);
+
+#define MOCK_OW_MAX_DEVICES  8
+
+typedef struct {
+  uint8_t rom[8];                   /* family code, serial number, CRC */
+  uint8_t scratchpad[9];            /* temperature, TH, TL, config, reserved, CRC */
+  int16_t temperature;              /* result of the next conversion, 1/16 degree */
+  bool present;                     /* connected to the bus */
+  bool corrupt;                     /* sends the scratchpad with a wrong CRC */
+  unsigned long long convertEndUs;  /* end of the running conversion, 0 if none */
+  unsigned long nofEarlyReads;      /* scratchpad reads while converting */
+  unsigned long long holdEndUs;     /* drives the line low until then in a read slot */
+  /* protocol state */
+  int state;
+  uint8_t cmd;
+  uint8_t buf[9];                   /* bits received or to send */
+  unsigned bit, nofBits;
+  bool selected;
+} MockOwDevice;
+
+typedef struct {
+  unsigned long long timeUs;        /* simulated time */
+  bool masterLow;                   /* master pulls the line low */
+  unsigned long long lowStartUs;    /* start of the low pulse of the master */
+  unsigned long long presenceStartUs, presenceEndUs; /* presence pulse of the sensors */
+  MockOwDevice dev[MOCK_OW_MAX_DEVICES];
+  unsigned nofDevices;
+  /* timer unit */
+  bool tuEnabled;
+  uint32_t tuPeriod, tuNextPeriod;
+  unsigned long long tuRestartUs;
+  /* statistics */
+  unsigned long nofResets, nofSlots, nofConvertT;
+  unsigned long long busyUs;        /* time the timer unit was enabled */
+} MockOw;
+
+extern MockOw mockOw;
+
+/* line model, used by the pin macros */
+void MockOw_Pull(void);
+void MockOw_Release(void);
+bool MockOw_Line(void);
+
+/* removes all sensors and resets the time and the statistics */
+void MockOw_Reset(void);
+
+/* connects a sensor with the given family code and serial number, returns its index */
+unsigned MockOw_AddDevice(uint8_t family, uint64_t serial);
+
+/* CRC of the ROM code and scratchpad, x^8+x^5+x^4+1 */
+uint8_t MockOw_Crc8(const uint8_t *data, unsigned len);
+
+/* runs the timer unit until it is disabled or the time reaches untilUs */
+void MockOw_Run(unsigned long long untilUs);
+
+#endif /* MOCK_ONEWIRE_H */
@@ -0,0 +1,48 @@
+/*
+ * Host stand-in for the Shell component CLS1 used by the command line
+ * interface of the FreeRTOS component (FRTOS1_ParseCommand()): the I/O
+ * types, the command names and the send methods. The send methods write the
+ * strings character by character to the given output, like the Shell does;
+ * status and help lines are sent as item, separator and text, without the
+ * padding to the separator column.
+ */
+#ifndef MOCK_SHELL_H
+#define MOCK_SHELL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef void (*CLS1_StdIO_OutErr_FctType)(uint8_t);
+typedef void (*CLS1_StdIO_In_FctType)(uint8_t *);
+typedef bool (*CLS1_StdIO_KeyPressed_FctType)(void);
+
+typedef struct {
+  CLS1_StdIO_In_FctType stdIn;
+  CLS1_StdIO_OutErr_FctType stdOut;
+  CLS1_StdIO_OutErr_FctType stdErr;
+  CLS1_StdIO_KeyPressed_FctType keyPressed;
+} CLS1_StdIOType;
+
+#define CLS1_DASH_LINE   "--------------------------------------------------------------"
+#define CLS1_CMD_HELP    "help"
+#define CLS1_CMD_STATUS  "status"
+
+static inline void CLS1_SendStr(const uint8_t *str, CLS1_StdIO_OutErr_FctType io) {
+  while (*str!='\0') {
+    io(*str++);
+  }
+}
+
+static inline void CLS1_SendStatusStr(const uint8_t *strItem, const uint8_t *strStatus, CLS1_StdIO_OutErr_FctType io) {
+  CLS1_SendStr(strItem, io);
+  CLS1_SendStr((const uint8_t*)": ", io);
+  CLS1_SendStr(strStatus, io);
+}
+
+static inline void CLS1_SendHelpStr(const uint8_t *strCmd, const uint8_t *strHelp, CLS1_StdIO_OutErr_FctType io) {
+  CLS1_SendStr(strCmd, io);
+  CLS1_SendStr((const uint8_t*)"; ", io);
+  CLS1_SendStr(strHelp, io);
+}
+
+#endif /* MOCK_SHELL_H */
@@ -0,0 +1,121 @@
+/*
+ * SSD1289 controller model, see mock_ssd1289.h.
+ */
+#include <string.h>
+#include "mock_ssd1289.h"
+
+#define ENTRY_ID_HINC  (1u<<4)
+#define ENTRY_ID_VINC  (1u<<5)
+#define ENTRY_AM_VERT  (1u<<3)
+
+MockSsd1289 mockSsd1289;
+
+/* moves the counter inside [start..end], returns TRUE if it wraps around */
+static bool Step(unsigned *ac, unsigned start, unsigned end, bool inc) {
+  if (inc) {
+    if (*ac==end) {
+      *ac = start;
+      return TRUE;
+    }
+    (*ac)++;
+  } else {
+    if (*ac==start) {
+      *ac = end;
+      return TRUE;
+    }
+    (*ac)--;
+  }
+  return FALSE;
+}
+
+static void WriteRam(word w) {
+  MockSsd1289 *m = &mockSsd1289;
+  unsigned hsa = m->reg[0x44]&0xFF, hea = m->reg[0x44]>>8, vsa = m->reg[0x45], vea = m->reg[0x46];
+  word entry = m->reg[0x11];
+
+  m->nofPixels++;
+  if (   hsa>hea || vsa>vea || hea>=MOCK_SSD1289_SOURCES || vea>=MOCK_SSD1289_GATES
+      || m->acSource<hsa || m->acSource>hea || m->acGate<vsa || m->acGate>vea)
+  {
+    m->nofErrors++;
+    return;
+  }
+  m->ram[m->acGate][m->acSource] = w;
+  if (entry&ENTRY_AM_VERT) {
+    if (Step(&m->acGate, vsa, vea, (entry&ENTRY_ID_VINC)!=0)) {
+      (void)Step(&m->acSource, hsa, hea, (entry&ENTRY_ID_HINC)!=0);
+    }
+  } else {
+    if (Step(&m->acSource, hsa, hea, (entry&ENTRY_ID_HINC)!=0)) {
+      (void)Step(&m->acGate, vsa, vea, (entry&ENTRY_ID_VINC)!=0);
+    }
+  }
+}
+
+static void Word(word w) {
+  MockSsd1289 *m = &mockSsd1289;
+
+  if (!m->data) {
+    m->index = (byte)w;
+    m->nofCommands++;
+    return;
+  }
+  if (m->index==0x22) {
+    WriteRam(w);
+    return;
+  }
+  m->reg[m->index] = w;
+  if (m->index==0x4E) {
+    m->acSource = w;
+  } else if (m->index==0x4F) {
+    m->acGate = w;
+  }
+}
+
+/* the component sends the bytes of a word in memory order */
+byte SM1_SendChar(byte ch) {
+  byte b[2];
+  word w;
+
+  mockSsd1289.nofBytes++;
+  if (!mockSsd1289.half) {
+    mockSsd1289.first = ch;
+    mockSsd1289.half = TRUE;
+    return ERR_OK;
+  }
+  b[0] = mockSsd1289.first;
+  b[1] = ch;
+  memcpy(&w, b, sizeof(w));
+  mockSsd1289.half = FALSE;
+  Word(w);
+  return ERR_OK;
+}
+
+word SM1_GetCharsInTxBuf(void) {
+  return 0;
+}
+
+void DC1_ClrVal(void) {
+  if (mockSsd1289.half) {
+    mockSsd1289.nofErrors++;
+  }
+  mockSsd1289.data = FALSE;
+}
+
+void DC1_SetVal(void) {
+  if (mockSsd1289.half) {
+    mockSsd1289.nofErrors++;
+  }
+  mockSsd1289.data = TRUE;
+}
+
+word MockSsd1289_Shown(unsigned gate, unsigned source) {
+  return mockSsd1289.ram[(gate+mockSsd1289.reg[0x41])%MOCK_SSD1289_GATES][source];
+}
+
+void MockSsd1289_ResetCounters(void) {
+  mockSsd1289.nofBytes = 0;
+  mockSsd1289.nofCommands = 0;
+  mockSsd1289.nofPixels = 0;
+  mockSsd1289.nofErrors = 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * Host model of the SSD1289 controller for the SSD1289 component LCDS on the
+ * serial interface: the SPI SM1 sends the words as byte pairs, the D/C pin
+ * DC1 selects between a register index (low) and data (high). The reset pin
+ * RES1 and the wait component WAIT1 do nothing.
+ *
+ * The model keeps the registers and the display RAM of 320 gate lines of 240
+ * sources. Data after the index R22h is written at the address counter
+ * (R4Eh source, R4Fh gate), which then moves as set in the entry mode R11h
+ * (AM, ID) and wraps around inside the window R44h..R46h. The vertical
+ * scroll R41h makes gate line g show the RAM line g+R41h.
+ */
+#ifndef MOCK_SSD1289_H
+#define MOCK_SSD1289_H
+
+#include <stdbool.h>
+#include "Cpu.h"
+
+#define MOCK_SSD1289_GATES    320
+#define MOCK_SSD1289_SOURCES  240
+
+typedef struct {
+  word reg[256];                                  /* registers, written with data after their index */
+  word ram[MOCK_SSD1289_GATES][MOCK_SSD1289_SOURCES];
+  byte index;                                     /* last register index */
+  bool data;                                      /* D/C high */
+  bool half;                                      /* first byte of a word received */
+  byte first;                                     /* the first byte */
+  unsigned acSource, acGate;                      /* address counter */
+  /* statistics */
+  unsigned long nofBytes;                         /* bytes sent */
+  unsigned long nofCommands;                      /* register indexes written */
+  unsigned long nofPixels;                        /* RAM words written */
+  unsigned long nofErrors;                        /* pixels outside of the RAM or with a wrong window, broken words */
+} MockSsd1289;
+
+extern MockSsd1289 mockSsd1289;
+
+byte SM1_SendChar(byte ch);
+word SM1_GetCharsInTxBuf(void);
+void DC1_ClrVal(void);
+void DC1_SetVal(void);
+#define RES1_ClrVal()      ((void)0)
+#define RES1_SetVal()      ((void)0)
+#define WAIT1_Waitms(ms)   ((void)(ms))
+
+/* the pixel the display shows at gate line gate and source source */
+word MockSsd1289_Shown(unsigned gate, unsigned source);
+
+/* clears the statistics */
+void MockSsd1289_ResetCounters(void);
+
+#endif /* MOCK_SSD1289_H */
@@ -0,0 +1,48 @@
+/*
+ * Host model of a 4-wire resistive touch panel, see mock_touch.h.
+ */
+#include <stdlib.h>
+#include "mock_touch.h"
+
+MockTouch mockTouch;
+
+static byte lastChannel;
+
+void TS1_OnADGet(void) {
+  mockTouch.adOwner++;
+}
+
+void TS1_OnADGive(void) {
+  mockTouch.adOwner--;
+}
+
+byte AD1_MeasureChan(bool WaitForResult, byte Channel) {
+  (void)WaitForResult;
+  mockTouch.nofConversions++;
+  if (mockTouch.adOwner!=1) {
+    mockTouch.nofNotOwned++;
+  }
+  lastChannel = Channel;
+  return ERR_OK;
+}
+
+byte AD1_GetChanValue16(byte Channel, word *Value) {
+  int v;
+
+  if (Channel!=lastChannel) {
+    return ERR_VALUE;
+  }
+  if (!mockTouch.touched || (Channel==0 && !mockTouch.ypHigh) || (Channel==1 && !mockTouch.xpHigh)) {
+    v = 0;                                            /* discharged */
+  } else {
+    v = Channel==0 ? mockTouch.x : mockTouch.y;
+    if (mockTouch.noise>0) {
+      v += rand()%(2*mockTouch.noise+1)-mockTouch.noise;
+    }
+    if ((unsigned)rand()%100<mockTouch.spikePercent) {
+      v = rand()%2 ? MOCK_TOUCH_SPIKE_HIGH : MOCK_TOUCH_SPIKE_LOW;
+    }
+  }
+  *Value = (word)(v<<4);
+  return ERR_OK;
+}
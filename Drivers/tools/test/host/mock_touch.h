@@ -0,0 +1,96 @@
+/*
+ * Host model of a 4-wire resistive touch panel behind the components used by
+ * the TouchScreenSensor TS1 and the TouchScreen TSC1:
+ *
+ * - the 12 bit A/D converter AD1 with the X+ wire on channel 0 and the Y+
+ *   wire on channel 1. A channel reads the position of the pen on the other
+ *   axis while the + wire of that axis is driven high (XP or YP), otherwise
+ *   the panel is discharged and reads 0. Each conversion gets noise and, now
+ *   and then, a spike to MOCK_TOUCH_SPIKE_LOW or MOCK_TOUCH_SPIKE_HIGH.
+ * - the pins XP, XM, YP and YM.
+ * - the events TS1_OnADGet() and TS1_OnADGive(), which count the conversions
+ *   done without owning the A/D converter.
+ * - the display LCD1 with 320x240 pixels in the orientation of
+ *   mockTouch.orientation, and the wait component WAIT1.
+ */
+#ifndef MOCK_TOUCH_H
+#define MOCK_TOUCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Cpu.h"
+
+#define MOCK_TOUCH_SPIKE_LOW   500U
+#define MOCK_TOUCH_SPIKE_HIGH  3600U
+
+/* display */
+typedef uint16_t LCD1_PixelDim;
+typedef uint16_t LCD1_PixelColor;
+typedef enum {
+  LCD1_ORIENTATION_PORTRAIT, LCD1_ORIENTATION_PORTRAIT180,
+  LCD1_ORIENTATION_LANDSCAPE, LCD1_ORIENTATION_LANDSCAPE180
+} LCD1_DisplayOrientation;
+
+#define MOCK_TOUCH_LCD_LONGER   320
+#define MOCK_TOUCH_LCD_SHORTER  240
+
+typedef struct {
+  /* panel */
+  bool touched;                     /* pen on the panel */
+  uint16_t x, y;                    /* position of the pen in A/D counts */
+  uint16_t noise;                   /* noise of a conversion, +-counts */
+  unsigned spikePercent;            /* probability of a spike */
+  bool xpHigh, ypHigh;              /* XP or YP drives its wire high */
+  int adOwner;                      /* OnADGet() minus OnADGive() calls */
+  /* display */
+  LCD1_DisplayOrientation orientation;
+  /* statistics */
+  unsigned long nofConversions;
+  unsigned long nofNotOwned;        /* conversions without owning the A/D converter */
+} MockTouch;
+
+extern MockTouch mockTouch;
+
+/* A/D converter, left justified results */
+byte AD1_MeasureChan(bool WaitForResult, byte Channel);
+byte AD1_GetChanValue16(byte Channel, word *Value);
+#define AD1_Connect(channel)     ((void)0)
+#define AD1_Disconnect(channel)  ((void)0)
+
+/* pins */
+#define MOCK_TOUCH_PIN(name, high) \
+  static inline void name##_SetVal(void) { high = TRUE; } \
+  static inline void name##_ClrVal(void) { high = FALSE; } \
+  static inline void name##_SetInput(void) {} \
+  static inline void name##_SetOutput(void) {}
+
+static bool mockTouchLow;           /* XM and YM are only driven low */
+
+MOCK_TOUCH_PIN(XP, mockTouch.xpHigh)
+MOCK_TOUCH_PIN(YP, mockTouch.ypHigh)
+MOCK_TOUCH_PIN(XM, mockTouchLow)
+MOCK_TOUCH_PIN(YM, mockTouchLow)
+
+/* events of TS1 */
+void TS1_OnADGet(void);
+void TS1_OnADGive(void);
+
+static inline LCD1_PixelDim LCD1_GetLongerSide(void) { return MOCK_TOUCH_LCD_LONGER; }
+static inline LCD1_PixelDim LCD1_GetShorterSide(void) { return MOCK_TOUCH_LCD_SHORTER; }
+static inline LCD1_DisplayOrientation LCD1_GetDisplayOrientation(void) { return mockTouch.orientation; }
+static inline LCD1_PixelDim LCD1_GetWidth(void) {
+  return mockTouch.orientation>=LCD1_ORIENTATION_LANDSCAPE ? MOCK_TOUCH_LCD_LONGER : MOCK_TOUCH_LCD_SHORTER;
+}
+static inline LCD1_PixelDim LCD1_GetHeight(void) {
+  return mockTouch.orientation>=LCD1_ORIENTATION_LANDSCAPE ? MOCK_TOUCH_LCD_SHORTER : MOCK_TOUCH_LCD_LONGER;
+}
+#define LCD1_DrawHLine(x, y, length, color)  ((void)(x), (void)(y), (void)(length), (void)(color))
+#define LCD1_DrawVLine(x, y, length, color)  ((void)(x), (void)(y), (void)(length), (void)(color))
+
+#define WAIT1_Waitms(ms)  ((void)(ms))
+
+/* the sensor waits with the HCS08 inline assembly asm {nop}; */
+#define asm
+#define nop
+
+#endif /* MOCK_TOUCH_H */
@@ -0,0 +1,81 @@
+/*
+ * UserInterface stand-in UIX, see mock_userinterface.h.
+ */
+#include <stdlib.h>
+#include "mock_userinterface.h"
+
+static const UIX_Display *display; /* LCDW if NULL */
+
+void UIX_SetDisplay(const UIX_Display *d) {
+  display = d;
+}
+
+void UIX_ElementInitCommon(UIX_Element *element, UIX_ElementType type, UIX_PixelDim x, UIX_PixelDim y, UIX_PixelDim width, UIX_PixelDim height, UIX_PixelColor bgColor, UIX_painterCallback painter) {
+  element->prop.type = type;
+  element->prop.flags = 0;
+  element->prop.x = x;
+  element->prop.y = y;
+  element->prop.width = width;
+  element->prop.height = height;
+  element->prop.color = bgColor;
+  element->painter = painter;
+  element->next = NULL;
+}
+
+byte UIX_WindowAddElement(UIX_Window *window, UIX_Element *element) {
+  element->next = window->first;
+  window->first = element;
+  return ERR_OK;
+}
+
+void UIX_DrawVLine(UIX_Window *window, UIX_PixelDim x, UIX_PixelDim y, UIX_PixelDim h, UIX_PixelColor color) {
+  if (h==0) { /* empty window */
+    mockLcdW.nofErrors++;
+    return;
+  }
+  x = (UIX_PixelDim)(window->prop.x+x);
+  y = (UIX_PixelDim)(window->prop.y+y);
+  if (display!=NULL) {
+    display->drawVLine(x, y, h, color);
+    return;
+  }
+  LCDW_OpenWindow(x, y, x, (LCDW_PixelDim)(y+h-1));
+  while (h>0) {
+    LCDW_WritePixel(color);
+    h--;
+  }
+  LCDW_CloseWindow();
+}
+
+byte UIX_ScrollBoxLeft(UIX_Window *window, UIX_PixelDim x, UIX_PixelDim y, UIX_PixelDim w, UIX_PixelDim h, UIX_PixelDim nofPixels) {
+  if (display==NULL || display->scrollBoxLeft==NULL) {
+    return ERR_NOTAVAIL;
+  }
+  return display->scrollBoxLeft((UIX_PixelDim)(window->prop.x+x), (UIX_PixelDim)(window->prop.y+y), w, h, nofPixels);
+}
+
+void UIX_DrawLine(UIX_Window *window, UIX_PixelDim x0, UIX_PixelDim y0, UIX_PixelDim x1, UIX_PixelDim y1, UIX_PixelColor color) {
+  int dx = abs((int)x1-(int)x0), dy = -abs((int)y1-(int)y0);
+  int sx = x0<x1 ? 1 : -1, sy = y0<y1 ? 1 : -1, err = dx+dy;
+
+  x0 = (UIX_PixelDim)(window->prop.x+x0);
+  y0 = (UIX_PixelDim)(window->prop.y+y0);
+  x1 = (UIX_PixelDim)(window->prop.x+x1);
+  y1 = (UIX_PixelDim)(window->prop.y+y1);
+  for(;;) {
+    LCDW_OpenWindow(x0, y0, x0, y0);
+    LCDW_WritePixel(color);
+    LCDW_CloseWindow();
+    if (x0==x1 && y0==y1) {
+      break;
+    }
+    if (2*err>=dy) {
+      err += dy;
+      x0 = (UIX_PixelDim)(x0+sx);
+    }
+    if (2*err<=dx) {
+      err += dx;
+      y0 = (UIX_PixelDim)(y0+sy);
+    }
+  }
+}
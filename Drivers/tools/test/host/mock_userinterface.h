@@ -0,0 +1,76 @@
+/*
+ * Host stand-in for the UserInterface component UIX (UserInterface.drv), with
+ * the types and methods UIGraph uses. As in UserInterface, the drawing
+ * methods take coordinates inside the window. DrawVLine() and DrawLine()
+ * write through the window display
+ * stand-in LCDW (host/mock_lcd.h), one window per call, so mockLcdW counts
+ * the lines drawn and the pixels written. UIX_SetDisplay() sends
+ * DrawVLine() and ScrollBoxLeft() to the methods of a GDisplay component
+ * instead, ScrollBoxLeft() returns ERR_NOTAVAIL on LCDW. An empty line is
+ * counted in mockLcdW.nofErrors on all displays.
+ */
+#ifndef MOCK_USERINTERFACE_H
+#define MOCK_USERINTERFACE_H
+
+#include "mock_lcd.h"
+
+typedef LCDW_PixelDim UIX_PixelDim;
+typedef LCDW_PixelColor UIX_PixelColor;
+typedef void *UIX_Pvoid;
+
+typedef enum {
+  UIX_WINDOW,
+  UIX_GRAPH
+} UIX_ElementType;
+
+typedef enum {
+  UIX_EVENT_PAINT
+} UIX_EventCallbackKind;
+
+enum {
+  UIX_COLOR_BLACK = LCDW_COLOR_BLACK, UIX_COLOR_WHITE = LCDW_COLOR_WHITE,
+  UIX_COLOR_RED = LCDW_COLOR_RED, UIX_COLOR_GREEN = LCDW_COLOR_GREEN, UIX_COLOR_BLUE = LCDW_COLOR_BLUE
+};
+
+struct UIX_Window;
+
+typedef struct UIX_ElementProperties {
+  UIX_ElementType type;
+  byte flags;
+  UIX_PixelDim x, y, width, height;
+  UIX_PixelColor color;
+} UIX_ElementProperties;
+
+typedef struct UIX_Element {
+  UIX_ElementProperties prop;
+  byte (*painter)(struct UIX_Window *, struct UIX_Element*);
+  struct UIX_Element *next;
+} UIX_Element;
+
+typedef struct UIX_Window {
+  UIX_ElementProperties prop;
+  UIX_Element *first;
+} UIX_Window;
+
+typedef struct {
+  UIX_Window *first;
+} UIX_Screen;
+
+typedef byte (*UIX_painterCallback)(struct UIX_Window *, struct UIX_Element*);
+
+/* methods of the display below UIX, with display coordinates */
+typedef struct {
+  void (*drawVLine)(UIX_PixelDim x, UIX_PixelDim y, UIX_PixelDim h, UIX_PixelColor color);
+  byte (*scrollBoxLeft)(UIX_PixelDim x, UIX_PixelDim y, UIX_PixelDim w, UIX_PixelDim h, UIX_PixelDim nofPixels); /* or NULL */
+} UIX_Display;
+
+/* draws on the display with the given methods, or on LCDW again with NULL */
+void UIX_SetDisplay(const UIX_Display *display);
+
+void UIX_ElementInitCommon(UIX_Element *element, UIX_ElementType type, UIX_PixelDim x, UIX_PixelDim y, UIX_PixelDim width, UIX_PixelDim height, UIX_PixelColor bgColor, UIX_painterCallback painter);
+byte UIX_WindowAddElement(UIX_Window *window, UIX_Element *element);
+void UIX_DrawVLine(UIX_Window *window, UIX_PixelDim x, UIX_PixelDim y, UIX_PixelDim h, UIX_PixelColor color);
+byte UIX_ScrollBoxLeft(UIX_Window *window, UIX_PixelDim x, UIX_PixelDim y, UIX_PixelDim w, UIX_PixelDim h, UIX_PixelDim nofPixels);
+void UIX_DrawLine(UIX_Window *window, UIX_PixelDim x0, UIX_PixelDim y0, UIX_PixelDim x1, UIX_PixelDim y1, UIX_PixelColor color);
+
+#endif /* MOCK_USERINTERFACE_H */
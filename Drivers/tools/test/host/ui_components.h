@@ -0,0 +1,21 @@
+/*
+ * The UI component headers in the order of their dependencies. The generated
+ * headers do not include the components they use (Processor Expert adds them
+ * to the shared modules), so the UI sources are compiled with -include of
+ * this header.
+ */
+#ifndef UI_COMPONENTS_H
+#define UI_COMPONENTS_H
+
+#include "mock_lcd.h"
+#include "GDW.h"
+#include "GFONT1.h"
+#include "UTIL1.h"
+#include "UI1.h"
+#include "FDISP1.h"
+#include "TXT1.h"
+#include "TXTI.h"
+#include "WIN1.h"
+#include "BTN1.h"
+
+#endif /* UI_COMPONENTS_H */
@@ -0,0 +1,19 @@
+/*
+ * mempool.c without heap trace and with renamed entry points, falling back
+ * to the renamed heap_tlsf of heaptlsf.c, so bench_alloc_tasks can compare
+ * the pools with both allocators on the same workload.
+ */
+#include "FreeRTOSConfig.h"
+#undef configUSE_HEAP_TRACE
+#define configUSE_HEAP_TRACE 0
+
+#define pvPortPoolMalloc                pool_pvPortPoolMalloc
+#define vPortPoolFree                   pool_vPortPoolFree
+#define pvPortPoolMallocFromISR         pool_pvPortPoolMallocFromISR
+#define vPortPoolFreeFromISR            pool_vPortPoolFreeFromISR
+#define uxPortGetNumberOfPools          pool_uxPortGetNumberOfPools
+#define xPortGetPoolStats               pool_xPortGetPoolStats
+#define pvPortMalloc                    tlsf_pvPortMalloc
+#define vPortFree                       tlsf_vPortFree
+
+#include "mempool.c"
@@ -0,0 +1,342 @@
+/*
+ * CPU load tracking and interrupt time accounting of FreeRTOS (cpu_load.c,
+ * CpuLoadEnabled and RuntimeIsrAccounting in freertos.props), without
+ * starting the scheduler. The run time counter is simulated in microseconds,
+ * the run time counters of the tasks are set by the test, and the sampling
+ * timer callback is called once per simulated second. Checked:
+ * - the interrupt time: the task run time counter stands still in an
+ *   accounted interrupt, nested interrupts are counted once.
+ * - the first sample only starts the measurement. The 1 s, 10 s and 60 s
+ *   windows of two tasks and of the interrupts: the 60 s window is the 10 s
+ *   window for the first ten seconds, then slides in steps of ten seconds
+ *   and forgets a load after a minute. A task created later starts without
+ *   load, the slot of a deleted task is released.
+ * - the snapshot: header, the records of uxCpuLoadGetTasks(), buffers for
+ *   one record and too small for the header.
+ * - with more tasks than CpuLoadMaxTasks the samples are counted as missed.
+ * - the 'top' command of the shell (FRTOS1_ParseCommand() on the stand-in of
+ *   host/mock_shell.h): the table, the refresh in place and the complete
+ *   table again after a task has been created, stopped by a key press.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "FRTOS1.h"
+#include "testutil.h"
+
+#define SECOND_US   1000000UL
+#define MAX_SIM     16
+
+typedef struct {
+  TaskHandle_t handle;
+  uint32_t runTime;              /* simulated run time counter */
+} SimTask;
+
+static uint32_t nowUs;           /* simulated raw run time counter */
+static TimerCallbackFunction_t sampleCallback;
+static TickType_t samplePeriod;
+static SimTask sim[MAX_SIM];
+static unsigned nofSim;
+
+/* shell I/O */
+static char out[16384];
+static size_t outLen;
+static unsigned nofDelays, keyAfterDelays, nofKeysRead;
+static TaskHandle_t topNewTask;
+
+uint32_t __wrap_ulPortGetRunTimeCounterValue(void) {
+  return nowUs;
+}
+
+TimerHandle_t __real_xTimerCreate(const char * const pcTimerName, const TickType_t xTimerPeriodInTicks, const UBaseType_t uxAutoReload, void * const pvTimerID, TimerCallbackFunction_t pxCallbackFunction);
+
+/* the sampling timer, called by xCpuLoadCreateTimer() */
+TimerHandle_t __wrap_xTimerCreate(const char * const pcTimerName, const TickType_t xTimerPeriodInTicks, const UBaseType_t uxAutoReload, void * const pvTimerID, TimerCallbackFunction_t pxCallbackFunction) {
+  sampleCallback = pxCallbackFunction;
+  samplePeriod = xTimerPeriodInTicks;
+  return __real_xTimerCreate(pcTimerName, xTimerPeriodInTicks, uxAutoReload, pvTimerID, pxCallbackFunction);
+}
+
+UBaseType_t __real_uxTaskGetSystemState(TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize, uint32_t * const pulTotalRunTime);
+
+/* the kernel state with the simulated run time counters. Without the idle
+   task deleted tasks stay in the termination list: they are left out, as if
+   the idle task had freed them. */
+UBaseType_t __wrap_uxTaskGetSystemState(TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize, uint32_t * const pulTotalRunTime) {
+  UBaseType_t n = __real_uxTaskGetSystemState(pxTaskStatusArray, uxArraySize, pulTotalRunTime), i, j = 0;
+  unsigned s;
+
+  for(i=0;i<n;i++) {
+    if (pxTaskStatusArray[i].eCurrentState==eDeleted) {
+      continue;
+    }
+    pxTaskStatusArray[j] = pxTaskStatusArray[i];
+    pxTaskStatusArray[j].ulRunTimeCounter = 0;
+    for(s=0;s<nofSim;s++) {
+      if (sim[s].handle==pxTaskStatusArray[j].xHandle) {
+        pxTaskStatusArray[j].ulRunTimeCounter = sim[s].runTime;
+      }
+    }
+    j++;
+  }
+  return j;
+}
+
+static void Task(void *param) {
+  (void)param;
+  for(;;) {
+    vTaskDelay(1);
+  }
+}
+
+static TaskHandle_t Create(const char *name, UBaseType_t prio) {
+  TaskHandle_t h = NULL;
+
+  CHECK(xTaskCreate(Task, name, configMINIMAL_STACK_SIZE, NULL, prio, &h)==pdPASS);
+  sim[nofSim].handle = h;
+  sim[nofSim].runTime = 0;
+  nofSim++;
+  return h;
+}
+
+static void AddRunTime(TaskHandle_t h, uint32_t us) {
+  unsigned s;
+
+  for(s=0;s<nofSim;s++) {
+    if (sim[s].handle==h) {
+      sim[s].runTime += us;
+    }
+  }
+}
+
+/* one simulated second with an interrupt of isrUs, then the sample */
+static void Second(TaskHandle_t a, uint32_t aUs, TaskHandle_t b, uint32_t bUs, uint32_t isrUs) {
+  vPortRunTimeIsrEnter();
+  nowUs += isrUs;
+  vPortRunTimeIsrExit();
+  nowUs += SECOND_US-isrUs;
+  AddRunTime(a, aUs);
+  AddRunTime(b, bUs);
+  sampleCallback(NULL);
+}
+
+/* record of a task, NULL if not tracked (the task names are unique) */
+static const CpuLoadTask_t *Find(const CpuLoadTask_t *tasks, UBaseType_t n, TaskHandle_t h) {
+  UBaseType_t i;
+
+  for(i=0;i<n;i++) {
+    if (strcmp(tasks[i].cName, pcTaskGetTaskName(h))==0) {
+      return &tasks[i];
+    }
+  }
+  return NULL;
+}
+
+static int Load(TaskHandle_t h, uint16_t l1, uint16_t l10, uint16_t l60) {
+  CpuLoadTask_t tasks[configCPU_LOAD_MAX_TASKS];
+  const CpuLoadTask_t *t;
+
+  t = Find(tasks, uxCpuLoadGetTasks(tasks, configCPU_LOAD_MAX_TASKS, NULL), h);
+  if (t==NULL || t->usLoad[cpuloadWINDOW_1S]!=l1 || t->usLoad[cpuloadWINDOW_10S]!=l10 || t->usLoad[cpuloadWINDOW_60S]!=l60) {
+    (void)printf("load of %s: ", pcTaskGetTaskName(h));
+    if (t!=NULL) {
+      (void)printf("%u %u %u, ", t->usLoad[0], t->usLoad[1], t->usLoad[2]);
+    }
+    (void)printf("expected %u %u %u\n", l1, l10, l60);
+    return 0;
+  }
+  return 1;
+}
+
+static int IsrLoad(uint16_t l1, uint16_t l10, uint16_t l60) {
+  CpuLoadInfo_t info;
+
+  (void)uxCpuLoadGetTasks(NULL, 0, &info);
+  return info.usIsrLoad[cpuloadWINDOW_1S]==l1 && info.usIsrLoad[cpuloadWINDOW_10S]==l10 && info.usIsrLoad[cpuloadWINDOW_60S]==l60;
+}
+
+static void StdOut(uint8_t ch) {
+  if (outLen<sizeof(out)-1) {
+    out[outLen++] = (char)ch;
+    out[outLen] = '\0';
+  }
+}
+
+static void StdIn(uint8_t *ch) {
+  *ch = 'q';
+  nofKeysRead++;
+}
+
+static bool KeyPressed(void) {
+  return nofDelays>=keyAfterDelays;
+}
+
+static const CLS1_StdIOType io = {StdIn, StdOut, StdOut, KeyPressed};
+
+/* 'top' polls for a key every 100 ms: a simulated second every ten polls, a
+   new task in the second second */
+void __wrap_vTaskDelay(const TickType_t xTicksToDelay) {
+  nofDelays++;
+  if (nofDelays==15) {
+    topNewTask = Create("TopNew", tskIDLE_PRIORITY+1);
+  }
+  if (nofDelays%10==0) {
+    Second(sim[0].handle, 250000, NULL, 0, 0);
+  }
+}
+
+static unsigned Count(const char *str, const char *sub) {
+  unsigned n = 0;
+
+  while ((str=strstr(str, sub))!=NULL) {
+    n++;
+    str++;
+  }
+  return n;
+}
+
+int main(void) {
+  static uint8_t blob[sizeof(CpuLoadBlobHeader_t)+configCPU_LOAD_MAX_TASKS*sizeof(CpuLoadTask_t)];
+  CpuLoadTask_t tasks[configCPU_LOAD_MAX_TASKS];
+  CpuLoadBlobHeader_t header;
+  CpuLoadInfo_t info;
+  TaskHandle_t a, b, c;
+  UBaseType_t n;
+  size_t size, freeHeap;
+  uint32_t taskTime;
+  unsigned i;
+  bool handled;
+  char line[64];
+
+  /* interrupt time accounting */
+  nowUs = 1000;
+  CHECK(ulPortGetTaskRunTimeCounterValue()==1000 && ulPortGetIsrRunTime()==0);
+  vPortRunTimeIsrEnter();
+  nowUs += 300;
+  vPortRunTimeIsrEnter();                           /* nested */
+  nowUs += 200;
+  CHECK(ulPortGetTaskRunTimeCounterValue()==1000);
+  vPortRunTimeIsrExit();
+  nowUs += 100;
+  vPortRunTimeIsrExit();
+  CHECK(ulPortGetIsrRunTime()==600);
+  nowUs += 400;
+  CHECK(ulPortGetTaskRunTimeCounterValue()==1400);
+  vPortRunTimeIsrExit();                            /* not entered: ignored */
+  CHECK(ulPortGetIsrRunTime()==600);
+
+  a = Create("TaskA", tskIDLE_PRIORITY+1);
+  b = Create("TaskB", tskIDLE_PRIORITY+2);
+  CHECK(xCpuLoadCreateTimer()==pdPASS);
+  CHECK(sampleCallback!=NULL && samplePeriod==configTICK_RATE_HZ);
+  CHECK(uxCpuLoadGetTasks(tasks, configCPU_LOAD_MAX_TASKS, &info)==0 && info.usNofTasks==0);
+  CHECK(info.ulCounterHz==1000000UL);
+
+  /* first sample: start values, no load */
+  AddRunTime(a, 123456);
+  sampleCallback(NULL);
+  CHECK(uxCpuLoadGetTasks(tasks, configCPU_LOAD_MAX_TASKS, &info)==2 && info.ulSamples==0);
+  CHECK(Load(a, 0, 0, 0) && Load(b, 0, 0, 0));
+
+  /* A 50%, B 40%, interrupts 10% */
+  for(i=1;i<=5;i++) {
+    Second(a, 500000, b, 400000, 100000);
+  }
+  CHECK(Load(a, 500, 500, 500) && Load(b, 400, 400, 400));
+  CHECK(IsrLoad(100, 100, 100));
+  (void)uxCpuLoadGetTasks(NULL, 0, &info);
+  CHECK(info.ulSamples==5 && info.ulTimestamp==nowUs && info.ulIsrRunTime==600+5*100000);
+  Second(a, 500000, b, 400000, 100000);
+  Second(a, 200000, b, 400000, 100000);             /* 1 s window of A */
+  CHECK(Load(a, 200, 457, 457));
+  for(i=8;i<=10;i++) {
+    Second(a, 500000, b, 400000, 100000);
+  }
+  CHECK(Load(a, 500, 470, 470) && Load(b, 400, 400, 400));
+
+  /* B idle: the 10 s window follows, the 60 s window moves in ten second steps */
+  for(i=11;i<=15;i++) {
+    Second(a, 500000, b, 0, 0);
+  }
+  CHECK(Load(b, 0, 200, 400));
+  CHECK(IsrLoad(0, 50, 100));
+  for(i=16;i<=20;i++) {
+    Second(a, 500000, b, 0, 0);
+  }
+  CHECK(Load(b, 0, 0, 200) && Load(a, 500, 500, 485));
+  CHECK(IsrLoad(0, 0, 50));
+
+  /* C created: no load before */
+  for(i=21;i<=25;i++) {
+    Second(a, 500000, b, 0, 0);
+  }
+  c = Create("TaskC", tskIDLE_PRIORITY+3);
+  Second(c, 300000, a, 500000, 0);
+  CHECK(Load(c, 300, 30, 0));
+  CHECK(uxCpuLoadGetTasks(tasks, configCPU_LOAD_MAX_TASKS, NULL)==3);
+  CHECK(Find(tasks, 3, c)->ucPriority==tskIDLE_PRIORITY+3 && strcmp(Find(tasks, 3, c)->cName, "TaskC")==0);
+  for(i=27;i<=60;i++) {
+    Second(c, 300000, a, 500000, 0);
+  }
+  CHECK(Load(b, 0, 0, 400/6) && Load(c, 300, 300, (150+3*300)/6));
+  for(i=61;i<=70;i++) {
+    Second(c, 300000, a, 500000, 0);
+  }
+  CHECK(Load(b, 0, 0, 0));
+  CHECK(IsrLoad(0, 0, 0));
+
+  /* B deleted: its slot is released */
+  vTaskDelete(b);
+  Second(c, 300000, a, 500000, 0);
+  CHECK(uxCpuLoadGetTasks(tasks, configCPU_LOAD_MAX_TASKS, &info)==2 && info.usNofTasks==2);
+  CHECK(Find(tasks, 2, b)==NULL && Find(tasks, 2, a)!=NULL && Find(tasks, 2, c)!=NULL);
+
+  /* snapshot */
+  size = xCpuLoadGetSnapshot(blob, sizeof(blob));
+  CHECK(size==sizeof(header)+2*sizeof(CpuLoadTask_t));
+  (void)memcpy(&header, blob, sizeof(header));
+  CHECK(header.ulMagic==cpuloadBLOB_MAGIC && header.usVersion==cpuloadBLOB_VERSION);
+  CHECK(header.ucNameLength==configMAX_TASK_NAME_LEN && header.ucRecordSize==sizeof(CpuLoadTask_t));
+  CHECK(memcmp(&header.xInfo, &info, sizeof(info))==0);
+  CHECK(memcmp(blob+sizeof(header), tasks, 2*sizeof(CpuLoadTask_t))==0);
+  CHECK(xCpuLoadGetSnapshot(blob, sizeof(header)+sizeof(CpuLoadTask_t)+1)==sizeof(header)+sizeof(CpuLoadTask_t));
+  (void)memcpy(&header, blob, sizeof(header));
+  CHECK(header.xInfo.usNofTasks==1);
+  CHECK(xCpuLoadGetSnapshot(blob, sizeof(header)-1)==0);
+
+  /* top, stopped before the first refresh: the buffer is freed */
+  freeHeap = xPortGetFreeHeapSize();
+  keyAfterDelays = 5;
+  CHECK(FRTOS1_ParseCommand((const unsigned char*)"FRTOS1 top", &handled, &io)==ERR_OK && handled);
+  CHECK(nofKeysRead==1 && xPortGetFreeHeapSize()==freeHeap);
+  CHECK(Count(out, "\033[")==0);
+
+  /* top, A at 25% */
+  outLen = 0;
+  nofDelays = 0;
+  keyAfterDelays = 25;
+  CHECK(FRTOS1_ParseCommand((const unsigned char*)"FRTOS1 top", &handled, &io)==ERR_OK && handled);
+  CHECK(nofKeysRead==2);
+  CHECK(strncmp(out, "CPU load, refreshed every second", 32)==0);
+  CHECK(Count(out, "Name            State Prio      1s     10s     60s\r\n")==2);
+  CHECK(strstr(out, "(interrupts)                  0.0%    0.0%    0.0%\r\n")!=NULL);
+  CHECK(strstr(out, "TaskA           Ready    1   50.0%   50.0%   50.0%\r\n")!=NULL);
+  (void)sprintf(line, "\033[3A\r\033[%uC", 16+5+5);                    /* interrupts and two tasks */
+  CHECK(Count(out, line)==1);
+  CHECK(strstr(out, "\033[16CReady    1   25.0%   47.5%   50.0%\r\n")!=NULL);
+  CHECK(strstr(out, "TaskA           Ready    1   25.0%   45.0%   ")!=NULL);  /* complete table */
+  CHECK(strstr(out, "TopNew          Ready    1    0.0%    0.0%    0.0%\r\n")!=NULL);
+  CHECK(topNewTask!=NULL);
+  CHECK(strstr(out, "\033[4A")==NULL);
+
+  /* more tasks than slots */
+  (void)uxCpuLoadGetTasks(tasks, configCPU_LOAD_MAX_TASKS, &info);
+  taskTime = Find(tasks, info.usNofTasks, a)->ulRunTime;
+  for(n=uxTaskGetNumberOfTasks();n<=configCPU_LOAD_MAX_TASKS;n++) {
+    (void)Create("More", tskIDLE_PRIORITY+1);     /* not tracked */
+  }
+  Second(c, 300000, a, 500000, 0);
+  (void)uxCpuLoadGetTasks(tasks, configCPU_LOAD_MAX_TASKS, &header.xInfo);
+  CHECK(header.xInfo.ulMissed==1 && header.xInfo.ulSamples==info.ulSamples);
+  CHECK(Find(tasks, header.xInfo.usNofTasks, a)->ulRunTime==taskTime);
+  return TestResult();
+}
@@ -0,0 +1,185 @@
+/*
+ * Host simulation of the DS18B20 component DS1 on the OneWire component
+ * OW1, with the bus model in host/mock_onewire.c: four sensors on one bus,
+ * the timer unit driven in simulated time. Checked:
+ * - SearchRom() finds the ROM codes of all sensors.
+ * - ConvertAll() sends CONVERT_T once, waits once for the slowest
+ *   resolution and reads all scratchpads after the conversion end, the
+ *   temperatures match the values of the sensors.
+ * - a scratchpad with a wrong CRC or a sensor that does not answer gives
+ *   TEMPERATURE_INVALID for this sensor only.
+ * - the bus time of ConvertAll(), compared with StartConversion() sensor
+ *   by sensor.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "mock_onewire.h"
+#include "ds18b20_events.h"
+#include "DS1.h"
+#include "testutil.h"
+
+#define NOF_SENSORS   4
+#define FAMILY_DS18B20 0x28
+#define MAX_RUN_US    10000000ULL /* a command sequence ends within 10 s */
+
+/* serial numbers with common prefixes, so the search takes both paths at several bits */
+static const uint64_t serials[NOF_SENSORS] = {0x0000000001A5ULL, 0x0000000001B5ULL, 0x00000080A1A5ULL, 0x00000000FFFFULL};
+/* 25.0625, -10.125, 125 and 0.5 degree */
+static const int16_t temps[NOF_SENSORS] = {0x0191, (int16_t)0xFF5E, 0x07D0, 0x0008};
+
+static unsigned nofRomRead, nofAllTemps;
+static int32_t allTemps[NOF_SENSORS];
+static uint8_t allCount;
+
+void DS1_OnRomRead(uint8_t sensor_index, uint8_t *rom_code) {
+  nofRomRead++;
+}
+
+void DS1_OnAllTemperaturesGet(int32_t *temperatures, uint8_t count) {
+  nofAllTemps++;
+  allCount = count;
+  memcpy(allTemps, temperatures, (count<NOF_SENSORS ? count : NOF_SENSORS)*sizeof(int32_t));
+}
+
+void DS1_OnTemperatureGet(uint8_t sensor_index, int32_t temperature) {
+}
+
+void DS1_OnError(OW1_Error error) {
+}
+
+/* value reported by the component for the scratchpad temperature t */
+static int32_t Expected(int16_t t, unsigned resolution) {
+  t &= (int16_t)~((1<<(3-resolution))-1);
+  return (int32_t)t*10000/16;
+}
+
+/* runs the bus until the component is done, returns the time needed */
+static unsigned long long RunUntilIdle(void) {
+  unsigned long long start = mockOw.timeUs;
+
+  while (DS1_isBusy() && mockOw.tuEnabled && mockOw.timeUs-start<MAX_RUN_US) {
+    MockOw_Run(start+MAX_RUN_US);
+  }
+  CHECK(!DS1_isBusy());
+  return mockOw.timeUs-start;
+}
+
+static int FindDevice(const uint8_t *rom) {
+  unsigned i;
+
+  for(i=0;i<mockOw.nofDevices;i++) {
+    if (memcmp(mockOw.dev[i].rom, rom, 8)==0) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+/* index of each sensor of the component on the bus */
+static int busIdx[NOF_SENSORS];
+
+static void SetTemperatures(int16_t offset) {
+  unsigned i;
+
+  for(i=0;i<NOF_SENSORS;i++) {
+    mockOw.dev[busIdx[i]].temperature = (int16_t)(temps[busIdx[i]]+offset);
+  }
+}
+
+/* ConvertAll() with the temperatures of the sensors changed by offset, returns the time needed */
+static unsigned long long ConvertAll(int16_t offset, unsigned long *nofEarly) {
+  unsigned long long us;
+  unsigned i;
+
+  SetTemperatures(offset);
+  for(i=0;i<NOF_SENSORS;i++) {
+    mockOw.dev[i].nofEarlyReads = 0;
+  }
+  mockOw.nofConvertT = 0;
+  nofAllTemps = 0;
+  CHECK(DS1_ConvertAll());
+  us = RunUntilIdle();
+  CHECK(mockOw.nofConvertT==1);
+  CHECK(nofAllTemps==1 && allCount==NOF_SENSORS);
+  *nofEarly = 0;
+  for(i=0;i<NOF_SENSORS;i++) {
+    *nofEarly += mockOw.dev[i].nofEarlyReads;
+  }
+  return us;
+}
+
+int main(void) {
+  static const unsigned resMixed[NOF_SENSORS] = {0, 1, 0, 0};
+  unsigned long long us, seqUs, readUs;
+  unsigned long nofEarly;
+  unsigned i, foundMask;
+  int idx;
+
+  MockOw_Reset();
+  for(i=0;i<NOF_SENSORS;i++) {
+    (void)MockOw_AddDevice(FAMILY_DS18B20, serials[i]);
+  }
+  OW1_Init();
+  DS1_Init();
+
+  /* enumeration */
+  CHECK(DS1_SearchRom());
+  us = RunUntilIdle();
+  foundMask = 0;
+  for(i=0;i<NOF_SENSORS;i++) {
+    busIdx[i] = idx = FindDevice((uint8_t*)DS1_GetRomCode(i));
+    CHECK(idx>=0);
+    if (idx>=0) {
+      foundMask |= 1u<<idx;
+    }
+  }
+  CHECK(nofRomRead==NOF_SENSORS && foundMask==(1u<<NOF_SENSORS)-1);
+  (void)printf("search: %u of %u ROM codes in %.1f ms\n", nofRomRead, NOF_SENSORS, us/1000.0);
+
+  /* all sensors with 12 bit resolution */
+  us = ConvertAll(0, &nofEarly);
+  CHECK(nofEarly==0);
+  for(i=0;i<NOF_SENSORS;i++) {
+    CHECK(allTemps[i]==Expected(temps[busIdx[i]], 3));
+    CHECK(DS1_GetTemperature(i)==allTemps[i]);
+  }
+  readUs = (us-750000)/NOF_SENSORS;
+  CHECK(us>=750000 && us<750000+NOF_SENSORS*30000ULL);
+
+  /* the same sensor by sensor */
+  SetTemperatures(16);
+  seqUs = 0;
+  for(i=0;i<NOF_SENSORS;i++) {
+    CHECK(DS1_StartConversion(i));
+    seqUs += RunUntilIdle();
+    CHECK(DS1_GetTemperature(i)==Expected((int16_t)(temps[busIdx[i]]+16), 3));
+  }
+  CHECK(us<seqUs/2);
+  (void)printf("ConvertAll: %u sensors in %.1f ms (one conversion of 750 ms, %.1f ms per scratchpad), sensor by sensor %.1f ms\n",
+               NOF_SENSORS, us/1000.0, readUs/1000.0, seqUs/1000.0);
+
+  /* mixed resolutions: waits for the 10 bit sensor */
+  for(i=0;i<NOF_SENSORS;i++) {
+    CHECK(DS1_SetResolution((uint8_t)resMixed[i], (uint8_t)i));
+    (void)RunUntilIdle();
+    CHECK(((mockOw.dev[busIdx[i]].scratchpad[4]>>5)&3)==resMixed[i]);
+  }
+  us = ConvertAll(-32, &nofEarly);
+  CHECK(nofEarly==0);
+  for(i=0;i<NOF_SENSORS;i++) {
+    CHECK(allTemps[i]==Expected((int16_t)(temps[busIdx[i]]-32), resMixed[i]));
+  }
+  CHECK(us>=187500 && us<188000+NOF_SENSORS*30000ULL);
+  (void)printf("mixed resolutions: %u sensors in %.1f ms\n", NOF_SENSORS, us/1000.0);
+
+  /* a wrong CRC and a missing sensor */
+  mockOw.dev[busIdx[1]].corrupt = true;
+  mockOw.dev[busIdx[3]].present = false;
+  (void)ConvertAll(0, &nofEarly);
+  CHECK(allTemps[0]==Expected(temps[busIdx[0]], resMixed[0]));
+  CHECK(allTemps[1]==DS1_TEMPERATURE_INVALID);
+  CHECK(allTemps[2]==Expected(temps[busIdx[2]], resMixed[2]));
+  CHECK(allTemps[3]==DS1_TEMPERATURE_INVALID);
+  (void)printf("bus: %lu resets, %lu slots, %.1f ms busy\n", mockOw.nofResets, mockOw.nofSlots, mockOw.busyUs/1000.0);
+  return TestResult();
+}
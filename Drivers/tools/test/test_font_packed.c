@@ -0,0 +1,166 @@
+/*
+ * Packed GFont fonts against the same fonts as tables, drawn with
+ * FontDisplay on the window display stand-in LCDW (FDW on GDW) and on the
+ * buffered display stand-in LCDH (FDH on GDH, all bit alignments). The fonts
+ * of font.props: FP1 and FP2 bit packed, FP3 and FP4 run length encoded,
+ * each with the Latin-1 range. Checked:
+ * - GetFont() returns the same heights, and the format of the bitmaps.
+ * - GetFontChar() of a packed font fills in the descriptor passed and
+ *   returns it, the one of a table font returns the table entry and leaves
+ *   the descriptor passed unchanged. The descriptors are the same, the
+ *   characters outside of the range have no bitmap. Two descriptors of a
+ *   packed font are valid at the same time.
+ * - WriteChar() and WriteCharBg() of every character of the range give the
+ *   same display content and the same cursor advance with both fonts, on a
+ *   display filled with a pattern. On LCDW, a transparent packed glyph opens
+ *   the same number of windows as the table glyph.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "testutil.h"
+
+typedef struct {
+  const char *name;
+  PGFONT_Callbacks (*table)(void);
+  PGFONT_Callbacks (*packed)(void);
+  byte bmpFormat;
+} Font;
+
+typedef struct {
+  const char *name;
+  void (*writeChar)(byte ch, uint16_t color, uint16_t *xCursor, uint16_t *yCursor, GFONT_Callbacks *font);
+  void (*writeCharBg)(byte ch, uint16_t color, uint16_t bgColor, uint16_t *xCursor, uint16_t *yCursor, GFONT_Callbacks *font);
+  byte *buf;
+  size_t size;
+  unsigned width, height;
+  uint16_t color, bgColor;
+} Display;
+
+static const Font fonts[] = {
+  {"Helv 10 normal", FT1_GetFont, FP1_GetFont, GFONT_FORMAT_BITS},
+  {"Cour 14 bold",   FT2_GetFont, FP2_GetFont, GFONT_FORMAT_BITS},
+  {"Helv 24 bold",   FT3_GetFont, FP3_GetFont, GFONT_FORMAT_RLE},
+  {"Cour 18 bold",   FT4_GetFont, FP4_GetFont, GFONT_FORMAT_RLE},
+};
+
+static const Display displays[] = {
+  {"FDW on LCDW", FDW_WriteChar, FDW_WriteCharBg, (byte*)mockLcdW.pixels, sizeof(mockLcdW.pixels),
+   MOCK_LCD_W_WIDTH, MOCK_LCD_W_HEIGHT, LCDW_COLOR_RED, LCDW_COLOR_BLUE},
+  {"FDH on LCDH", FDH_WriteChar, FDH_WriteCharBg, (byte*)LCDH_DisplayBuf, sizeof(LCDH_DisplayBuf),
+   MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, LCDH_COLOR_BLACK, LCDH_COLOR_WHITE},
+};
+
+static byte shown[sizeof(mockLcdW.pixels)];
+
+/* the characters with a bitmap in the packed fonts */
+static bool InRange(unsigned ch) {
+  return ch==0 || (ch>=0x20 && ch<=0x7E) || ch>=0xA0;
+}
+
+static void Fill(const Display *d) {
+  size_t i;
+
+  for(i=0;i<d->size;i++) {
+    d->buf[i] = (byte)(i*37+11);
+  }
+}
+
+/* draws the character on the filled display, returns the cursor advance */
+static unsigned Draw(const Display *d, GFONT_Callbacks *font, byte ch, bool opaque, uint16_t x, uint16_t y) {
+  uint16_t xCursor = x, yCursor = y;
+
+  Fill(d);
+  if (opaque) {
+    d->writeCharBg(ch, d->color, d->bgColor, &xCursor, &yCursor, font);
+  } else {
+    d->writeChar(ch, d->color, &xCursor, &yCursor, font);
+  }
+  return (unsigned)(xCursor-x);
+}
+
+static void CheckDescriptors(const Font *f) {
+  PGFONT_CharInfo (*tableChar)(byte, GFONT_CharInfo*) = f->table()->GetFontChar;
+  PGFONT_CharInfo (*packedChar)(byte, GFONT_CharInfo*) = f->packed()->GetFontChar;
+  GFONT_CharInfo buf, unused, a, w;
+  PGFONT_CharInfo t, p;
+  unsigned ch, nofBad = 0;
+
+  for(ch=0;ch<256;ch++) {
+    memset(&unused, 0x5A, sizeof(unused));
+    buf = unused;
+    t = tableChar((byte)ch, &buf);
+    if (t==&buf || memcmp(&buf, &unused, sizeof(buf))!=0) {
+      nofBad++;
+    }
+    p = packedChar((byte)ch, &buf);
+    if (p!=&buf) {
+      nofBad++;
+    } else if (!InRange(ch)) {
+      nofBad += p->CharBMP!=NULL || p->dwidth!=0;
+    } else if (   p->dwidth!=t->dwidth || p->width!=t->width || p->height!=t->height
+               || p->offsetX!=t->offsetX || p->offsetY!=t->offsetY || (p->CharBMP==NULL)!=(t->CharBMP==NULL)) {
+      nofBad++;
+    }
+  }
+  CHECK(nofBad==0);
+  (void)packedChar('A', &a);
+  (void)packedChar('W', &w);
+  t = tableChar('A', &buf);
+  CHECK(a.width==t->width && a.height==t->height && a.dwidth==t->dwidth);
+  t = tableChar('W', &buf);
+  CHECK(w.width==t->width && w.height==t->height && w.dwidth==t->dwidth && a.CharBMP!=w.CharBMP);
+}
+
+static void CheckDrawing(const Font *f, const Display *d) {
+  GFONT_Callbacks *table = f->table(), *packed = f->packed();
+  unsigned ch, nofBad = 0, nofDrawn = 0, nofWindowsBad = 0, advance;
+  unsigned long nofWindows;
+  uint16_t x, y;
+  int opaque;
+
+  for(ch=0;ch<256;ch++) {
+    if (!InRange(ch)) {
+      continue;
+    }
+    x = (uint16_t)(1+(ch*3)%(d->width-40));                     /* all bit alignments */
+    y = (uint16_t)(table->boundingBoxHeight/2+ch%(d->height-table->boundingBoxHeight-table->boundingBoxHeight/2)); /* accents above the cell stay on the display */
+    for(opaque=0;opaque<2;opaque++) {
+      MockLcdW_ResetCounters();
+      advance = Draw(d, table, (byte)ch, (bool)opaque, x, y);
+      nofWindows = mockLcdW.nofWindows;
+      memcpy(shown, d->buf, d->size);
+      Fill(d);
+      nofDrawn += memcmp(shown, d->buf, d->size)!=0;
+      MockLcdW_ResetCounters();
+      if (Draw(d, packed, (byte)ch, (bool)opaque, x, y)!=advance || memcmp(shown, d->buf, d->size)!=0) {
+        nofBad++;
+      }
+      if (!opaque && mockLcdW.nofWindows!=nofWindows) {
+        nofWindowsBad++;
+      }
+    }
+  }
+  CHECK(nofBad==0);
+  CHECK(nofWindowsBad==0);
+  CHECK(nofDrawn>0x7E - 0x20);
+  (void)printf("%s, %s: %u characters drawn\n", f->name, d->name, nofDrawn);
+}
+
+int main(void) {
+  size_t i, j;
+
+  for(i=0;i<sizeof(fonts)/sizeof(fonts[0]);i++) {
+    const Font *f = &fonts[i];
+
+    CHECK(f->table()->bmpFormat==GFONT_FORMAT_ROWS);
+    CHECK(f->packed()->bmpFormat==f->bmpFormat);
+    CHECK(f->packed()->boundingBoxHeight==f->table()->boundingBoxHeight);
+    CHECK(f->packed()->underlineBoxHeight==f->table()->underlineBoxHeight);
+    CHECK(f->packed()->lineSpaceBoxHeight==f->table()->lineSpaceBoxHeight);
+    CheckDescriptors(f);
+    for(j=0;j<sizeof(displays)/sizeof(displays[0]);j++) {
+      CheckDrawing(f, &displays[j]);
+    }
+  }
+  return TestResult();
+}
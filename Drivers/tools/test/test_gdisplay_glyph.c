@@ -0,0 +1,160 @@
+/*
+ * GDisplay DrawGlyph() on the display stand-ins of host/mock_lcd.h: the
+ * horizontal byte blitter (GDH, GDL), the vertical 8x8 block blitter (GDV,
+ * GDM) and the window display (GDW). Checked:
+ * - random glyphs (1..30 x 1..20 pixels) at random positions, transparent
+ *   and opaque, give the same pixels as a pixel by pixel reference. Glyphs
+ *   not completely on the display are clipped.
+ * - pixels outside of the glyph box are not changed.
+ * - on the window display no window and no pixel is outside of the display,
+ *   and a transparent glyph opens one window for each horizontal run of set
+ *   pixels, an opaque glyph one window.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mock_lcd.h"
+#include "GDH.h"
+#include "GDL.h"
+#include "GDV.h"
+#include "GDM.h"
+#include "GDW.h"
+#include "testutil.h"
+
+#define NOF_GLYPHS    3000
+#define MAX_GLYPH_W   30
+#define MAX_GLYPH_H   20
+
+typedef struct {
+  const char *name;
+  void (*drawGlyph)(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const byte *bmp, uint16_t fgColor, uint16_t bgColor, bool opaque);
+  void (*putPixel)(uint16_t x, uint16_t y, uint16_t color);
+  uint16_t (*getPixel)(uint16_t x, uint16_t y);
+  unsigned width, height;
+  bool mono;                        /* black and white only */
+} Display;
+
+static uint16_t GetPixelW(uint16_t x, uint16_t y) {
+  return mockLcdW.pixels[y][x];
+}
+
+static const Display displays[] = {
+  {"GDH bytes in rows, MSB left",    GDH_DrawGlyph, GDH_PutPixel, GDH_GetPixel, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, true},
+  {"GDL bytes in rows, LSB left",    GDL_DrawGlyph, GDL_PutPixel, GDL_GetPixel, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, true},
+  {"GDV bytes in columns, LSB top",  GDV_DrawGlyph, GDV_PutPixel, GDV_GetPixel, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, true},
+  {"GDM bytes in columns, MSB top",  GDM_DrawGlyph, GDM_PutPixel, GDM_GetPixel, MOCK_LCD_MONO_WIDTH, MOCK_LCD_MONO_HEIGHT, true},
+  {"GDW window display",             GDW_DrawGlyph, GDW_PutPixel, GetPixelW,    MOCK_LCD_W_WIDTH,    MOCK_LCD_W_HEIGHT,    false},
+};
+
+/* expected display content */
+static uint16_t ref[MOCK_LCD_W_HEIGHT][MOCK_LCD_W_WIDTH];
+
+static bool GlyphPixel(const byte *bmp, unsigned width, unsigned x, unsigned y) {
+  return ((bmp[y*((width+7)/8)+x/8]<<(x%8))&0x80)!=0;
+}
+
+static unsigned NofRuns(const byte *bmp, unsigned width, unsigned height) {
+  unsigned x, y, n = 0;
+
+  for(y=0;y<height;y++) {
+    for(x=0;x<width;x++) {
+      if (GlyphPixel(bmp, width, x, y) && (x==0 || !GlyphPixel(bmp, width, x-1, y))) {
+        n++;
+      }
+    }
+  }
+  return n;
+}
+
+static uint16_t RandomColor(const Display *d) {
+  if (d->mono) {
+    return (uint16_t)(rand()&1);
+  }
+  return (uint16_t)rand();
+}
+
+/* compares the display with ref[][] in the box, returns the number of wrong pixels */
+static unsigned Compare(const Display *d, int x0, int y0, int x1, int y1) {
+  int x, y;
+  unsigned n = 0;
+
+  for(y=(y0<0 ? 0 : y0); y<=y1 && y<(int)d->height; y++) {
+    for(x=(x0<0 ? 0 : x0); x<=x1 && x<(int)d->width; x++) {
+      if (d->getPixel((uint16_t)x, (uint16_t)y)!=ref[y][x]) {
+        n++;
+      }
+    }
+  }
+  return n;
+}
+
+static void TestDisplay(const Display *d) {
+  byte bmp[MAX_GLYPH_H*((MAX_GLYPH_W+7)/8)];
+  unsigned i, x, y, w, h, cx, cy, wrong = 0, nofOnScreen = 0, nofWindowErrors = 0;
+  uint16_t fg, bg;
+  bool opaque;
+
+  /* random start content */
+  for(y=0;y<d->height;y++) {
+    for(x=0;x<d->width;x++) {
+      ref[y][x] = RandomColor(d);
+      d->putPixel((uint16_t)x, (uint16_t)y, ref[y][x]);
+    }
+  }
+  CHECK(Compare(d, 0, 0, (int)d->width-1, (int)d->height-1)==0);
+
+  for(i=0;i<NOF_GLYPHS;i++) {
+    w = 1+(unsigned)rand()%MAX_GLYPH_W;
+    h = 1+(unsigned)rand()%MAX_GLYPH_H;
+    x = (unsigned)rand()%(d->width+8);     /* some glyphs leave the display */
+    y = (unsigned)rand()%(d->height+8);
+    for(cx=0;cx<sizeof(bmp);cx++) {
+      bmp[cx] = (byte)rand();
+    }
+    fg = RandomColor(d);
+    bg = RandomColor(d);
+    opaque = (rand()&1)!=0;
+    for(cy=0;cy<h;cy++) {
+      for(cx=0;cx<w;cx++) {
+        if (x+cx<d->width && y+cy<d->height) {
+          if (GlyphPixel(bmp, w, cx, cy)) {
+            ref[y+cy][x+cx] = fg;
+          } else if (opaque) {
+            ref[y+cy][x+cx] = bg;
+          }
+        }
+      }
+    }
+    MockLcdW_ResetCounters();
+    d->drawGlyph((uint16_t)x, (uint16_t)y, (uint16_t)w, (uint16_t)h, bmp, fg, bg, opaque);
+    wrong += Compare(d, (int)x-8, (int)y-8, (int)(x+w+8), (int)(y+h+8));
+    if (!d->mono) {
+      if (mockLcdW.nofErrors!=0) { /* window or pixel outside of the display */
+        nofWindowErrors++;
+      }
+      if (x+w<=d->width && y+h<=d->height) {
+        nofOnScreen++;
+        if (mockLcdW.nofWindows!=(opaque ? 1 : NofRuns(bmp, w, h))) {
+          nofWindowErrors++;
+        }
+      }
+    }
+  }
+  CHECK(wrong==0);
+  CHECK(Compare(d, 0, 0, (int)d->width-1, (int)d->height-1)==0);
+  CHECK(nofWindowErrors==0);
+  if (!d->mono) {
+    CHECK(nofOnScreen>NOF_GLYPHS/2);
+  }
+  (void)printf("%-32s %u glyphs, %u wrong pixels\n", d->name, NOF_GLYPHS, wrong);
+}
+
+int main(void) {
+  size_t i;
+
+  srand(1);
+  for(i=0;i<sizeof(displays)/sizeof(displays[0]);i++) {
+    TestDisplay(&displays[i]);
+  }
+  return TestResult();
+}
@@ -0,0 +1,235 @@
+/*
+ * GDisplay ScrollBoxLeft() on the display buffers of host/mock_lcd.h (GDH,
+ * GDL, GDV, GDM), on the window display LCDW (GDW) and on the SSD1289
+ * component LCDS (GDS) with its controller model of host/mock_ssd1289.h,
+ * and the ScrollLeft() of LCDS itself. Checked:
+ * - random boxes on the buffered displays, scrolled by 0 to more than their
+ *   width, give the same pixels as a pixel by pixel reference. Pixels
+ *   outside of the box do not change, a box not completely on the display
+ *   returns ERR_RANGE and changes nothing.
+ * - GDW returns ERR_NOTAVAIL, GDS for any box but the whole display.
+ * - LCDS in landscape and landscape 180, with random scrolls and random
+ *   windows written after them: the display shows the content moved to the
+ *   left, the columns scrolled out come back at the right, and the windows
+ *   where they were drawn. A window of several rows across the last gate
+ *   line resets the scroll, the rest of the display moves back. No pixel is
+ *   written outside of the window of the controller.
+ * - LCDS in portrait returns ERR_NOTAVAIL and does not scroll.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mock_lcd.h"
+#include "mock_ssd1289.h"
+#include "GDH.h"
+#include "GDL.h"
+#include "GDV.h"
+#include "GDM.h"
+#include "GDW.h"
+#include "LCDS.h"
+#include "GDS.h"
+#include "testutil.h"
+
+#define NOF_BOXES  3000
+#define NOF_OPS    400
+#define W          LCDS_WIDTH
+#define H          LCDS_HEIGHT
+
+typedef struct {
+  const char *name;
+  byte (*scrollBoxLeft)(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t nofPixels);
+  void (*putPixel)(uint16_t x, uint16_t y, uint16_t color);
+  uint16_t (*getPixel)(uint16_t x, uint16_t y);
+} Buffered;
+
+static const Buffered buffered[] = {
+  {"GDH bytes in rows, MSB left",   GDH_ScrollBoxLeft, GDH_PutPixel, GDH_GetPixel},
+  {"GDL bytes in rows, LSB left",   GDL_ScrollBoxLeft, GDL_PutPixel, GDL_GetPixel},
+  {"GDV bytes in columns, LSB top", GDV_ScrollBoxLeft, GDV_PutPixel, GDV_GetPixel},
+  {"GDM bytes in columns, MSB top", GDM_ScrollBoxLeft, GDM_PutPixel, GDM_GetPixel},
+};
+
+static uint16_t before[MOCK_LCD_MONO_HEIGHT][MOCK_LCD_MONO_WIDTH];
+static word ref[H][W], tmp[H][W];                /* expected LCDS content */
+static unsigned scroll;                          /* expected R41h */
+
+static void Fill(const Buffered *d) {
+  unsigned x, y;
+
+  for(y=0;y<MOCK_LCD_MONO_HEIGHT;y++) {
+    for(x=0;x<MOCK_LCD_MONO_WIDTH;x++) {
+      d->putPixel((uint16_t)x, (uint16_t)y, (uint16_t)(rand()%2));
+      before[y][x] = d->getPixel((uint16_t)x, (uint16_t)y);
+    }
+  }
+}
+
+/* returns the number of pixels different from the content before, moved in the box */
+static unsigned Compare(const Buffered *d, unsigned bx, unsigned by, unsigned bw, unsigned bh, unsigned n) {
+  unsigned x, y, wrong = 0;
+  uint16_t expected;
+
+  for(y=0;y<MOCK_LCD_MONO_HEIGHT;y++) {
+    for(x=0;x<MOCK_LCD_MONO_WIDTH;x++) {
+      expected = before[y][x];
+      if (y>=by && y<by+bh && x>=bx && n<bw && x<bx+bw-n) {
+        expected = before[y][x+n];
+      }
+      wrong += d->getPixel((uint16_t)x, (uint16_t)y)!=expected;
+    }
+  }
+  return wrong;
+}
+
+static void CheckBuffered(const Buffered *d) {
+  unsigned i, x, y, w, h, n, wrong = 0, nofFailed = 0;
+
+  for(i=0;i<NOF_BOXES;i++) {
+    x = (unsigned)rand()%MOCK_LCD_MONO_WIDTH;
+    y = (unsigned)rand()%MOCK_LCD_MONO_HEIGHT;
+    w = 1+(unsigned)rand()%(MOCK_LCD_MONO_WIDTH-x);
+    h = 1+(unsigned)rand()%(MOCK_LCD_MONO_HEIGHT-y);
+    if (i%10==0) {                                  /* whole rows */
+      x = 0;
+      w = MOCK_LCD_MONO_WIDTH;
+    }
+    n = (unsigned)rand()%(w+2);
+    Fill(d);
+    nofFailed += d->scrollBoxLeft((uint16_t)x, (uint16_t)y, (uint16_t)w, (uint16_t)h, (uint16_t)n)!=ERR_OK;
+    wrong += Compare(d, x, y, w, h, n);
+  }
+  CHECK(nofFailed==0);
+  CHECK(wrong==0);
+  Fill(d);
+  CHECK(d->scrollBoxLeft(8, 0, MOCK_LCD_MONO_WIDTH-7, 8, 1)==ERR_RANGE);
+  CHECK(d->scrollBoxLeft(0, 60, 16, 5, 1)==ERR_RANGE);
+  CHECK(d->scrollBoxLeft(MOCK_LCD_MONO_WIDTH, 0, 1, 1, 1)==ERR_RANGE);
+  CHECK(Compare(d, 0, 0, 0, 0, 0)==0);
+  (void)printf("%s: %u boxes, %u wrong pixels\n", d->name, NOF_BOXES, wrong);
+}
+
+/* the pixel LCDS shows at x, y */
+static word Shown(unsigned x, unsigned y) {
+  if (LCDS_GetDisplayOrientation()==LCDS_ORIENTATION_LANDSCAPE) {
+    return MockSsd1289_Shown(x, MOCK_SSD1289_SOURCES-1-y);
+  }
+  return MockSsd1289_Shown(MOCK_SSD1289_GATES-1-x, y);
+}
+
+static unsigned CompareShown(void) {
+  unsigned x, y, wrong = 0;
+
+  for(y=0;y<H;y++) {
+    for(x=0;x<W;x++) {
+      wrong += Shown(x, y)!=ref[y][x];
+    }
+  }
+  return wrong;
+}
+
+/* moves the expected content left by n columns, around the display */
+static void MoveRef(unsigned n) {
+  unsigned x, y;
+
+  memcpy(tmp, ref, sizeof(tmp));
+  for(y=0;y<H;y++) {
+    for(x=0;x<W;x++) {
+      ref[y][x] = tmp[y][(x+n)%W];
+    }
+  }
+}
+
+static void Window(unsigned x0, unsigned y0, unsigned x1, unsigned y1) {
+  unsigned x, y;
+  word color;
+
+  LCDS_OpenWindow((LCDS_PixelDim)x0, (LCDS_PixelDim)y0, (LCDS_PixelDim)x1, (LCDS_PixelDim)y1);
+  for(y=y0;y<=y1;y++) {
+    for(x=x0;x<=x1;x++) {
+      color = (word)rand();
+      LCDS_WritePixel(color);
+      ref[y][x] = color;
+    }
+  }
+  LCDS_CloseWindow();
+}
+
+static void CheckScroll(LCDS_DisplayOrientation orientation, const char *name) {
+  bool landscape = orientation==LCDS_ORIENTATION_LANDSCAPE;
+  unsigned i, n, x0, y0, x1, y1, g0, g1, wrong = 0, nofResets = 0, nofScrolls = 0, nofWrapped = 0;
+
+  LCDS_SetDisplayOrientation(orientation);
+  scroll = 0;
+  MockSsd1289_ResetCounters();
+  Window(0, 0, W-1, H-1);
+  for(i=0;i<NOF_OPS;i++) {
+    if (i%3==0) {
+      n = 1+(unsigned)rand()%(W+80);
+      CHECK(LCDS_ScrollLeft((LCDS_PixelDim)n)==ERR_OK);
+      scroll = landscape ? (scroll+n)%W : (scroll+W-n%W)%W;
+      MoveRef(n%W);
+      nofScrolls++;
+    } else {
+      x0 = (unsigned)rand()%W;
+      y0 = (unsigned)rand()%H;
+      switch (rand()%4) {
+        case 0:  x1 = x0; y1 = y0+(unsigned)rand()%(H-y0); break;         /* column */
+        case 1:  x1 = x0+(unsigned)rand()%(W-x0); y1 = y0; break;         /* row */
+        case 2:  x0 = 0; x1 = W-1; y1 = y0; break;                         /* whole row */
+        default: x1 = x0+(unsigned)rand()%(W-x0); y1 = y0+(unsigned)rand()%(H-y0<8 ? H-y0 : 8); break;
+      }
+      g0 = landscape ? x0+scroll : W-1-x1+scroll;                        /* gate lines of the window */
+      g1 = landscape ? x1+scroll : W-1-x0+scroll;
+      if (scroll!=0 && g0<W && g1>=W) {
+        if (y0!=y1) {                                                      /* the scroll is reset */
+          MoveRef(landscape ? W-scroll : scroll);
+          scroll = 0;
+          nofResets++;
+        } else {
+          nofWrapped++;
+        }
+      }
+      Window(x0, y0, x1, y1);
+    }
+    CHECK(mockSsd1289.reg[0x41]==scroll);
+    wrong += CompareShown();
+  }
+  CHECK(wrong==0);
+  CHECK(mockSsd1289.nofErrors==0);
+  CHECK(nofResets>0 && nofWrapped>0);
+  (void)printf("%s: %u scrolls, %u rows across the last gate line, %u resets, %u wrong pixels\n",
+    name, nofScrolls, nofWrapped, nofResets, wrong);
+}
+
+int main(void) {
+  size_t i;
+
+  srand(1);
+  for(i=0;i<sizeof(buffered)/sizeof(buffered[0]);i++) {
+    CheckBuffered(&buffered[i]);
+  }
+
+  MockLcdW_ResetCounters();
+  CHECK(GDW_ScrollBoxLeft(0, 0, MOCK_LCD_W_WIDTH, MOCK_LCD_W_HEIGHT, 1)==ERR_NOTAVAIL);
+  CHECK(GDW_ScrollBoxLeft(10, 10, 50, 50, 1)==ERR_NOTAVAIL);
+  CHECK(mockLcdW.nofWindows==0);
+
+  LCDS_Init();
+  CheckScroll(LCDS_ORIENTATION_LANDSCAPE, "LCDS landscape");
+  CheckScroll(LCDS_ORIENTATION_LANDSCAPE180, "LCDS landscape 180");
+
+  LCDS_SetDisplayOrientation(LCDS_ORIENTATION_LANDSCAPE);
+  CHECK(mockSsd1289.reg[0x41]==0);
+  CHECK(GDS_ScrollBoxLeft(0, 0, W-1, H, 1)==ERR_NOTAVAIL);
+  CHECK(GDS_ScrollBoxLeft(10, 10, 50, 50, 1)==ERR_NOTAVAIL);
+  CHECK(GDS_ScrollBoxLeft(0, 0, W, H+1, 1)==ERR_RANGE);
+  CHECK(mockSsd1289.reg[0x41]==0);
+  CHECK(GDS_ScrollBoxLeft(0, 0, W, H, 7)==ERR_OK);
+  CHECK(mockSsd1289.reg[0x41]==7);
+
+  LCDS_SetDisplayOrientation(LCDS_ORIENTATION_PORTRAIT);
+  CHECK(mockSsd1289.reg[0x41]==0);
+  CHECK(LCDS_ScrollLeft(5)==ERR_NOTAVAIL);
+  CHECK(mockSsd1289.reg[0x41]==0);
+  return TestResult();
+}
@@ -0,0 +1,125 @@
+/*
+ * Host test of heap_tlsf.c (configFRTOS_MEMORY_SCHEME 5).
+ *
+ * - the whole configTOTAL_HEAP_SIZE is usable, also above the 64 KByte
+ *   managed by a single TLSF pool (configTLSF_FL_INDEX_MAX 16).
+ * - random pvPortMalloc()/vPortFree() sequences keep the payloads intact,
+ *   and the free byte count matches the free blocks of the heap walk.
+ * - after freeing everything the heap is back to its initial state.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "testutil.h"
+
+#define NOF_SLOTS  256
+#define NOF_ROUNDS 200000
+
+static struct {
+  uint8_t *p;
+  size_t size;
+  uint8_t pattern;
+} slots[NOF_SLOTS];
+
+static void SumFreeBlock(size_t xBlockSize, void *pvArg) {
+  *(size_t*)pvArg += xBlockSize;
+}
+
+static size_t WalkFreeBytes(void) {
+  size_t sum = 0;
+
+  vPortWalkFreeBlocks(SumFreeBlock, &sum);
+  return sum;
+}
+
+static void TestLargeHeap(void) {
+  void *blocks[8];
+  size_t initialFree;
+  HeapStats_t stats;
+  int i, nof = 0;
+
+  vPortFree(pvPortMalloc(1)); /* the heap is initialized with the first allocation */
+  initialFree = xPortGetFreeHeapSize();
+  /* the heap is 256 KByte: more than a single pool of 64 KByte is usable */
+  CHECK(initialFree > configTOTAL_HEAP_SIZE-512);
+  CHECK(WalkFreeBytes()==initialFree);
+  vPortGetHeapStats(&stats);
+  CHECK(stats.xNumberOfFreeBlocks==(configTOTAL_HEAP_SIZE+0xFFFF)/0x10000);
+
+  /* a block can be as large as a pool */
+  while (nof<8 && (blocks[nof]=pvPortMalloc(60000))!=NULL) {
+    memset(blocks[nof], 0xA5, 60000);
+    nof++;
+  }
+  CHECK(nof==configTOTAL_HEAP_SIZE/0x10000);
+  /* a block cannot span pools */
+  CHECK(pvPortMalloc(0x10000)==NULL);
+  for(i=0;i<nof;i++) {
+    vPortFree(blocks[i]);
+  }
+  CHECK(xPortGetFreeHeapSize()==initialFree);
+  CHECK(WalkFreeBytes()==initialFree);
+}
+
+static size_t RandomSize(void) {
+  unsigned r = rand()%100;
+
+  if (r<60) {
+    return 1+rand()%64; /* small objects, e.g. queue items and timers */
+  } else if (r<95) {
+    return 64+rand()%1024; /* task stacks and buffers */
+  }
+  return 1024+rand()%16384; /* large buffers */
+}
+
+static void TestRandom(void) {
+  size_t initialFree = xPortGetFreeHeapSize();
+  unsigned long nofFailed = 0;
+  int round, i;
+
+  srand(1);
+  for(round=0;round<NOF_ROUNDS;round++) {
+    i = rand()%NOF_SLOTS;
+    if (slots[i].p==NULL) {
+      slots[i].size = RandomSize();
+      slots[i].pattern = (uint8_t)round;
+      slots[i].p = pvPortMalloc(slots[i].size);
+      if (slots[i].p==NULL) {
+        nofFailed++;
+      } else {
+        CHECK(((uintptr_t)slots[i].p%portBYTE_ALIGNMENT)==0);
+        memset(slots[i].p, slots[i].pattern, slots[i].size);
+      }
+    } else {
+      size_t j;
+
+      for(j=0;j<slots[i].size;j++) {
+        if (slots[i].p[j]!=slots[i].pattern) {
+          CHECK(slots[i].p[j]==slots[i].pattern); /* block has been overwritten */
+          break;
+        }
+      }
+      vPortFree(slots[i].p);
+      slots[i].p = NULL;
+    }
+    if ((round%1000)==0) {
+      CHECK(WalkFreeBytes()==xPortGetFreeHeapSize());
+    }
+  }
+  for(i=0;i<NOF_SLOTS;i++) {
+    vPortFree(slots[i].p); /* freeing NULL is allowed */
+    slots[i].p = NULL;
+  }
+  CHECK(xPortGetFreeHeapSize()==initialFree);
+  CHECK(WalkFreeBytes()==initialFree);
+  printf("%d rounds, %lu failed allocations, minimum free %u bytes\n",
+    NOF_ROUNDS, nofFailed, (unsigned)xPortGetMinimumEverFreeHeapSize());
+}
+
+int main(void) {
+  TestLargeHeap();
+  TestRandom();
+  return TestResult();
+}
@@ -0,0 +1,104 @@
+/*
+ * Host test of the heap trace (heap_trace.c).
+ *
+ * - allocations and frees from task and interrupt level (block pools) are
+ *   recorded, interrupt level ones without a task.
+ * - xHeapTraceReadBlob() streams the same bytes as xHeapTraceGetBlob(), and
+ *   no records are added while the ring is frozen.
+ * - the dump is written as the 'heaptrace dump' shell command prints it to
+ *   the file given as argument, for HeapTraceDecode.py.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "testutil.h"
+
+#define BLOB_SIZE (sizeof(HeapTraceBlobHeader_t)+configHEAP_TRACE_RING_SIZE*sizeof(HeapTraceRecord_t))
+
+static uint8_t blob[BLOB_SIZE], streamed[BLOB_SIZE];
+
+static HeapTraceRecord_t *LastRecord(void) {
+  static HeapTraceRecord_t records[configHEAP_TRACE_RING_SIZE];
+  UBaseType_t n = uxHeapTraceGetRecords(records, configHEAP_TRACE_RING_SIZE);
+
+  return n==0 ? NULL : &records[n-1];
+}
+
+static void TestRecords(void) {
+  HeapTraceTaskUsage_t usage[4];
+  HeapTraceRecord_t *rec;
+  UBaseType_t nof, untracked;
+  void *p, *q;
+
+  p = pvPortMalloc(100);
+  rec = LastRecord();
+  CHECK(rec!=NULL && rec->pvAddress==p && (rec->ulSizeAndType&0x80000000UL)!=0);
+  q = pvPortPoolMallocFromISR(20);
+  CHECK(q!=NULL);
+  rec = LastRecord();
+  CHECK(rec!=NULL && rec->pvAddress==q && rec->pvTask==NULL && (rec->ulSizeAndType&0x7FFFFFFFUL)==20);
+  nof = uxHeapTraceGetTaskUsage(usage, 4, &untracked);
+  CHECK(nof==1 && usage[0].xBlocks==2 && untracked==0); /* no scheduler: all without task */
+  vPortPoolFreeFromISR(q);
+  rec = LastRecord();
+  CHECK(rec!=NULL && rec->pvAddress==q && (rec->ulSizeAndType&0x80000000UL)==0);
+  nof = uxHeapTraceGetTaskUsage(usage, 4, &untracked);
+  CHECK(nof==1 && usage[0].xBlocks==1);
+  vPortFree(p);
+  CHECK(uxHeapTraceGetTaskUsage(usage, 4, &untracked)==0);
+}
+
+static void TestBlob(const char *dumpFile) {
+  size_t size, offset, n, i;
+  uint8_t chunk[16];
+  HeapTraceBlobHeader_t header;
+  void *leak[3];
+  FILE *f;
+
+  /* more records than the ring holds, and a few blocks not freed */
+  for(i=0;i<configHEAP_TRACE_RING_SIZE;i++) {
+    vPortFree(pvPortMalloc(8+i));
+  }
+  for(i=0;i<3;i++) {
+    leak[i] = pvPortMalloc(1000*(i+1));
+  }
+  size = xHeapTraceGetBlob(blob, sizeof(blob));
+  CHECK(size==BLOB_SIZE);
+  memcpy(&header, blob, sizeof(header));
+  CHECK(header.ulMagic==heaptraceBLOB_MAGIC);
+  CHECK(header.ulNofRecords==configHEAP_TRACE_RING_SIZE);
+  CHECK(header.ulTotalRecords>header.ulNofRecords);
+
+  vHeapTraceFreeze(pdTRUE);
+  offset = 0;
+  while ((n=xHeapTraceReadBlob(offset, chunk, sizeof(chunk)))!=0) {
+    if (offset==32) {
+      vPortFree(pvPortMalloc(1)); /* not recorded while frozen */
+    }
+    CHECK(offset+n<=sizeof(streamed));
+    memcpy(streamed+offset, chunk, n);
+    offset += n;
+  }
+  vHeapTraceFreeze(pdFALSE);
+  CHECK(offset==size);
+  CHECK(memcmp(blob, streamed, size)==0);
+
+  if (dumpFile!=NULL && (f=fopen(dumpFile, "w"))!=NULL) {
+    fprintf(f, "CMD> FRTOS1 heaptrace dump\r\n");
+    for(i=0;i<size;i++) {
+      fprintf(f, "%02X%s", streamed[i], (i%16)==15 || i==size-1 ? "\r\n" : " ");
+    }
+    fprintf(f, "CMD> \r\n");
+    fclose(f);
+  }
+  for(i=0;i<3;i++) {
+    vPortFree(leak[i]);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  TestRecords();
+  TestBlob(argc>1 ? argv[1] : NULL);
+  return TestResult();
+}
@@ -0,0 +1,185 @@
+/*
+ * Key matrix of the Key component with 70 keys, 20 ms debounce and 500 ms
+ * long key time at a 1 ms scan: KEY8 and KEY32 with 8 and 32 bit words of
+ * vertical counters, KEY8L and KEY32L with long key detection. The keys are
+ * pressed and released at random, each change bounces for up to 15 scans and
+ * single scans are disturbed now and then. The bits of the non-existing keys
+ * in the last word are set. After each scan, the events are read. Checked
+ * against a model with a plain counter for each key:
+ * - the press, release and long press events, in the order of the keys.
+ * - MatrixIsPressed() of each key and isIdle().
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "KEY8.h"
+#include "KEY8L.h"
+#include "KEY32.h"
+#include "KEY32L.h"
+#include "testutil.h"
+
+#define NOF_KEYS        70
+#define NOF_SCANS       500000
+#define DEBOUNCE_SCANS  20
+#define LONG_SCANS      500
+
+typedef struct {
+  const char *name;
+  bool hasLong;
+  void (*init)(void);
+  void (*scan)(const bool *keys);
+  bool (*getEvent)(uint8_t *key, uint8_t *kind);
+  bool (*isPressed)(uint8_t key);
+  bool (*isIdle)(void);
+} Matrix;
+
+/* the key bitmap of the raw key states, with the bits of the non-existing keys set */
+#define MATRIX_OPS(mod) \
+  static void mod##_Scan(const bool *keys) { \
+    mod##_MatrixWord raw[mod##_MATRIX_NOF_WORDS]; \
+    unsigned k; \
+    memset(raw, 0, sizeof(raw)); \
+    raw[mod##_MATRIX_NOF_WORDS-1] = (mod##_MatrixWord)~(mod##_MatrixWord)0; \
+    for(k=0;k<NOF_KEYS;k++) { \
+      if (k/mod##_MATRIX_WORD_BITS==mod##_MATRIX_NOF_WORDS-1) { \
+        raw[k/mod##_MATRIX_WORD_BITS] &= (mod##_MatrixWord)~((mod##_MatrixWord)1<<(k%mod##_MATRIX_WORD_BITS)); \
+      } \
+      if (keys[k]) { \
+        raw[k/mod##_MATRIX_WORD_BITS] |= (mod##_MatrixWord)1<<(k%mod##_MATRIX_WORD_BITS); \
+      } \
+    } \
+    mod##_MatrixScan(raw); \
+  } \
+  static bool mod##_GetEvent(uint8_t *key, uint8_t *kind) { \
+    mod##_MatrixEvent event; \
+    if (!mod##_MatrixGetEvent(&event)) { \
+      return false; \
+    } \
+    *key = event.key; \
+    *kind = event.kind; \
+    return true; \
+  }
+
+MATRIX_OPS(KEY8)
+MATRIX_OPS(KEY8L)
+MATRIX_OPS(KEY32)
+MATRIX_OPS(KEY32L)
+
+static const Matrix matrices[] = {
+  {"KEY8",   false, KEY8_Init,   KEY8_Scan,   KEY8_GetEvent,   KEY8_MatrixIsPressed,   KEY8_isIdle},
+  {"KEY8L",  true,  KEY8L_Init,  KEY8L_Scan,  KEY8L_GetEvent,  KEY8L_MatrixIsPressed,  KEY8L_isIdle},
+  {"KEY32",  false, KEY32_Init,  KEY32_Scan,  KEY32_GetEvent,  KEY32_MatrixIsPressed,  KEY32_isIdle},
+  {"KEY32L", true,  KEY32L_Init, KEY32L_Scan, KEY32L_GetEvent, KEY32L_MatrixIsPressed, KEY32L_isIdle},
+};
+
+/* model: a counter for each key */
+static bool state[NOF_KEYS], longDone[NOF_KEYS];
+static unsigned dbcCnt[NOF_KEYS], longCnt[NOF_KEYS];
+static uint8_t events[2*NOF_KEYS][2];
+static unsigned nofEvents;
+
+static void ModelScan(const bool *keys, bool hasLong) {
+  unsigned k;
+
+  nofEvents = 0;
+  for(k=0;k<NOF_KEYS;k++) {
+    dbcCnt[k] = keys[k]!=state[k] ? dbcCnt[k]+1 : 0;
+    if (dbcCnt[k]==DEBOUNCE_SCANS) {                   /* stable for the debounce time */
+      dbcCnt[k] = 0;
+      state[k] = !state[k];
+      events[nofEvents][0] = (uint8_t)k;
+      events[nofEvents++][1] = state[k] ? KEY8_MATRIX_EVENT_PRESSED : KEY8_MATRIX_EVENT_RELEASED;
+    }
+    if (hasLong) {
+      longCnt[k] = state[k] && !longDone[k] ? longCnt[k]+1 : 0;
+      if (longCnt[k]==LONG_SCANS) {                    /* once for each press */
+        longDone[k] = true;
+        events[nofEvents][0] = (uint8_t)k;
+        events[nofEvents++][1] = KEY8_MATRIX_EVENT_LONG_PRESSED;
+      }
+      longDone[k] &= state[k];
+    }
+  }
+}
+
+/* raw input of the keys */
+static bool pressed[NOF_KEYS], keys[NOF_KEYS];
+static unsigned hold[NOF_KEYS], bounce[NOF_KEYS];
+
+static void NextInput(void) {
+  unsigned k;
+
+  for(k=0;k<NOF_KEYS;k++) {
+    if (hold[k]==0) {                                  /* change the key */
+      pressed[k] = !pressed[k];
+      hold[k] = pressed[k] ? 5+(unsigned)rand()%1500 : 5+(unsigned)rand()%3000;
+      bounce[k] = (unsigned)rand()%16;
+    }
+    hold[k]--;
+    if (bounce[k]>0) {
+      bounce[k]--;
+      keys[k] = rand()%2;
+    } else if (rand()%1000==0) {                       /* glitch */
+      keys[k] = !pressed[k];
+    } else {
+      keys[k] = pressed[k];
+    }
+  }
+}
+
+int main(void) {
+  const Matrix *m;
+  unsigned i, k, n, wrongEvents, wrongState;
+  unsigned long nofPressed, nofLong;
+  uint8_t key, kind;
+  bool idle;
+
+  for(m=matrices;m<matrices+sizeof(matrices)/sizeof(matrices[0]);m++) {
+    memset(state, 0, sizeof(state));
+    memset(longDone, 0, sizeof(longDone));
+    memset(dbcCnt, 0, sizeof(dbcCnt));
+    memset(longCnt, 0, sizeof(longCnt));
+    memset(pressed, 0, sizeof(pressed));
+    memset(hold, 0, sizeof(hold));
+    memset(bounce, 0, sizeof(bounce));
+    wrongEvents = wrongState = 0;
+    nofPressed = nofLong = 0;
+    m->init();
+    CHECK(m->isIdle());
+    srand(1);
+    for(i=0;i<NOF_SCANS;i++) {
+      NextInput();
+      if (i%100000>=99000) {                           /* all keys released for a while */
+        memset(keys, 0, sizeof(keys));
+      }
+      m->scan(keys);
+      ModelScan(keys, m->hasLong);
+      for(n=0;m->getEvent(&key, &kind);n++) {
+        if (n>=nofEvents || key!=events[n][0] || kind!=events[n][1]) {
+          wrongEvents++;
+        }
+        nofPressed += kind==KEY8_MATRIX_EVENT_PRESSED;
+        nofLong += kind==KEY8_MATRIX_EVENT_LONG_PRESSED;
+      }
+      if (n!=nofEvents) {
+        wrongEvents++;
+      }
+      idle = true;
+      for(k=0;k<NOF_KEYS;k++) {
+        if (m->isPressed((uint8_t)k)!=state[k]) {
+          wrongState++;
+        }
+        idle &= !state[k] && !keys[k];
+      }
+      if (m->isIdle()!=idle || m->isPressed(NOF_KEYS)) {
+        wrongState++;
+      }
+    }
+    CHECK(wrongEvents==0);
+    CHECK(wrongState==0);
+    CHECK(nofPressed>0 && (nofLong>0)==m->hasLong);
+    (void)printf("%-7s %u scans, %lu presses, %lu long presses, %u wrong events, %u wrong states\n",
+      m->name, NOF_SCANS, nofPressed, nofLong, wrongEvents, wrongState);
+  }
+  return TestResult();
+}
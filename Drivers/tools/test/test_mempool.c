@@ -0,0 +1,118 @@
+/*
+ * Host test of the fixed size block pools (mempool.c).
+ *
+ * mempool.c is included with its own pool configuration:
+ *   pool 0: block size 0 (not used)
+ *   pool 1: 4 blocks of 16 bytes
+ *   pool 2: 64 byte blocks, but no blocks (not used)
+ * and checks exhausted pools, the failed allocation count, the fallback to
+ * the heap and the unused pools.
+ */
+#include "FreeRTOSConfig.h"
+#undef configBLOCK_POOL0_BLOCK_SIZE
+#undef configBLOCK_POOL0_NOF_BLOCKS
+#undef configBLOCK_POOL1_BLOCK_SIZE
+#undef configBLOCK_POOL1_NOF_BLOCKS
+#undef configBLOCK_POOL2_BLOCK_SIZE
+#undef configBLOCK_POOL2_NOF_BLOCKS
+#define configBLOCK_POOL0_BLOCK_SIZE  0
+#define configBLOCK_POOL0_NOF_BLOCKS  4
+#define configBLOCK_POOL1_BLOCK_SIZE  16
+#define configBLOCK_POOL1_NOF_BLOCKS  4
+#define configBLOCK_POOL2_BLOCK_SIZE  64
+#define configBLOCK_POOL2_NOF_BLOCKS  0
+
+#include <string.h>
+#include "mempool.c"
+#include "testutil.h"
+
+#define POOL1_BLOCKS configBLOCK_POOL1_NOF_BLOCKS
+
+static BaseType_t IsFromPool(UBaseType_t uxPool, void *pv) {
+  return (PoolWord_t*)pv>=xPools[uxPool].pxStart && (PoolWord_t*)pv<xPools[uxPool].pxEnd;
+}
+
+static void TestUnusedPools(void) {
+  PoolStats_t stats;
+
+  CHECK(uxPortGetNumberOfPools()==3);
+  CHECK(xPortGetPoolStats(0, &stats)==pdPASS);
+  CHECK(stats.xNumberOfBlocks==0); /* zero block size */
+  CHECK(xPortGetPoolStats(2, &stats)==pdPASS);
+  CHECK(stats.xNumberOfBlocks==0); /* zero blocks */
+  CHECK(xPortGetPoolStats(3, &stats)==pdFAIL);
+  /* a zero sized request is not served from a pool */
+  CHECK(pvPortPoolMallocFromISR(0)==NULL);
+  CHECK(pvPortPoolMalloc(0)==NULL); /* and the heap returns NULL for it too */
+}
+
+static void TestExhausted(void) {
+  void *blocks[POOL1_BLOCKS], *pvHeap, *pvIsr;
+  PoolStats_t stats;
+  int i;
+
+  for(i=0;i<POOL1_BLOCKS;i++) {
+    blocks[i] = pvPortPoolMalloc(1+i*5);
+    CHECK(blocks[i]!=NULL && IsFromPool(1, blocks[i]));
+  }
+  (void)xPortGetPoolStats(1, &stats);
+  CHECK(stats.xBlockSize==16);
+  CHECK(stats.xBlocksInUse==POOL1_BLOCKS);
+  CHECK(stats.xNumberOfFailedAllocations==0);
+
+  /* pool 1 is exhausted: the task level call falls back to the heap */
+  pvHeap = pvPortPoolMalloc(16);
+  CHECK(pvHeap!=NULL && !IsFromPool(1, pvHeap));
+  /* the interrupt level call has no fallback */
+  pvIsr = pvPortPoolMallocFromISR(8);
+  CHECK(pvIsr==NULL);
+  (void)xPortGetPoolStats(1, &stats);
+  CHECK(stats.xNumberOfFailedAllocations==2);
+  CHECK(stats.xBlocksInUse==POOL1_BLOCKS);
+  /* larger than any used pool: heap, not counted as failed in a pool */
+  vPortPoolFree(pvPortPoolMalloc(17));
+  (void)xPortGetPoolStats(1, &stats);
+  CHECK(stats.xNumberOfFailedAllocations==2);
+  (void)xPortGetPoolStats(2, &stats);
+  CHECK(stats.xNumberOfFailedAllocations==0);
+
+  /* heap blocks are returned to the heap */
+  vPortPoolFree(pvHeap);
+  (void)xPortGetPoolStats(1, &stats);
+  CHECK(stats.xBlocksInUse==POOL1_BLOCKS);
+
+  /* a freed block is reused, also from an interrupt */
+  vPortPoolFreeFromISR(blocks[2]);
+  pvIsr = pvPortPoolMallocFromISR(16);
+  CHECK(pvIsr==blocks[2]);
+  blocks[2] = pvIsr;
+  for(i=0;i<POOL1_BLOCKS;i++) {
+    vPortPoolFree(blocks[i]);
+  }
+  vPortPoolFree(NULL);
+  (void)xPortGetPoolStats(1, &stats);
+  CHECK(stats.xBlocksInUse==0);
+  CHECK(stats.xMaxBlocksInUse==POOL1_BLOCKS);
+  CHECK(stats.xNumberOfFailedAllocations==2);
+}
+
+static void TestAlignment(void) {
+  void *pv;
+  int i;
+
+  for(i=0;i<POOL1_BLOCKS;i++) {
+    pv = pvPortPoolMalloc(1);
+    CHECK(((uintptr_t)pv%portBYTE_ALIGNMENT)==0);
+    /* the free list link is in the first word, the whole block is payload */
+    memset(pv, 0xFF, 16);
+    vPortPoolFree(pv);
+  }
+  CHECK(pvPortPoolMallocFromISR(16)!=NULL);
+}
+
+int main(void) {
+  TestUnusedPools();
+  TestExhausted();
+  TestAlignment();
+  return TestResult();
+}
@@ -0,0 +1,99 @@
+/*
+ * Host simulation of the MMA8451Q component MMA1 on the GenericI2C
+ * component GI2C1 with the bus simulation at 400 kHz: a register model of
+ * the accelerometer (fast read mode skips the LSB registers in a burst
+ * read) and a second device on the bus. Checked:
+ * - Init() and Enable()/Disable() set the ACTIVE bit, WhoAmI() and
+ *   GetX()/GetY()/GetZ() read the model registers.
+ * - GetRaw8XYZ() in fast read mode returns the three MSB registers with
+ *   one burst read.
+ * - a device address without a device gives an error and no data.
+ * - the bus time of each transfer, in bit clocks: START, device address,
+ *   register address, repeated START, device address, data, STOP.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "GI2C1.h"
+#include "MMA1.h"
+#include "testutil.h"
+
+#define BUS_KHZ          400
+#define BITS_TO_US(b)    ((b)*1000U/BUS_KHZ)
+#define BITS_READ(n)     (1+9+9+1+9+(n)*9+1) /* register read of n bytes */
+#define BITS_WRITE(n)    (1+9+9+(n)*9+1)     /* register write of n bytes */
+
+static byte accelRegs[0x32], otherRegs[0x10];
+static unsigned nofReads;
+
+/* fast read mode: the auto increment skips the LSB data registers */
+static void AccelOnRead(GI2C1_SimDevice *dev, word regAddr) {
+  nofReads++;
+  if ((accelRegs[MMA1_CTRL_REG_1]&MMA1_F_READ_BIT_MASK)
+      && (regAddr==MMA1_OUT_X_LSB || regAddr==MMA1_OUT_Y_LSB || regAddr==MMA1_OUT_Z_LSB)) {
+    dev->regAddr = (word)(regAddr+1);
+  }
+}
+
+static GI2C1_SimDevice accel = {0x1D, 1, accelRegs, sizeof(accelRegs), 0, AccelOnRead, NULL, NULL};
+static GI2C1_SimDevice other = {0x50, 1, otherRegs, sizeof(otherRegs), 0, NULL, NULL, NULL};
+
+static void SetAxis(byte msbReg, int16_t value) {
+  accelRegs[msbReg] = (byte)((uint16_t)value>>8);
+  accelRegs[msbReg+1] = (byte)value;
+}
+
+int main(void) {
+  uint8_t val, xyz[3];
+  bool enabled;
+  uint32_t axisUs, burstUs;
+
+  GI2C1_Init();
+  GI2C1_SimAddDevice(&accel);
+  GI2C1_SimAddDevice(&other);
+  accelRegs[MMA1_WHO_AM_I] = MMA1_WHO_AM_I_VAL;
+
+  /* control register */
+  GI2C1_SimResetBusTime();
+  CHECK(MMA1_Init()==ERR_OK);
+  CHECK(accelRegs[MMA1_CTRL_REG_1]==MMA1_ACTIVE_BIT_MASK);
+  CHECK(GI2C1_SimGetBusTimeUs()==BITS_TO_US(BITS_WRITE(1)));
+  CHECK(MMA1_WhoAmI(&val)==ERR_OK && val==MMA1_WHO_AM_I_VAL);
+  CHECK(MMA1_Disable()==ERR_OK && accelRegs[MMA1_CTRL_REG_1]==0);
+  CHECK(MMA1_isEnabled(&enabled)==ERR_OK && !enabled);
+  CHECK(MMA1_Enable()==ERR_OK && accelRegs[MMA1_CTRL_REG_1]==MMA1_ACTIVE_BIT_MASK);
+  CHECK(MMA1_isEnabled(&enabled)==ERR_OK && enabled);
+  CHECK(otherRegs[MMA1_CTRL_REG_1%sizeof(otherRegs)]==0); /* not addressed */
+
+  /* 14 bit axis values, left aligned */
+  SetAxis(MMA1_OUT_X_MSB, 1000<<2);
+  SetAxis(MMA1_OUT_Y_MSB, -2000<<2);
+  SetAxis(MMA1_OUT_Z_MSB, 4096<<2);
+  GI2C1_SimResetBusTime();
+  CHECK(MMA1_GetX()==1000);
+  CHECK(MMA1_GetY()==-2000);
+  CHECK(MMA1_GetZ()==4096);
+  axisUs = GI2C1_SimGetBusTimeUs();
+  CHECK(axisUs==BITS_TO_US(3*BITS_READ(2)));
+
+  /* fast read: MSB registers only, in one burst */
+  CHECK(MMA1_SetFastMode(TRUE)==ERR_OK);
+  CHECK((accelRegs[MMA1_CTRL_REG_1]&MMA1_F_READ_BIT_MASK)!=0);
+  GI2C1_SimResetBusTime();
+  nofReads = 0;
+  CHECK(MMA1_GetRaw8XYZ(xyz)==ERR_OK);
+  burstUs = GI2C1_SimGetBusTimeUs();
+  CHECK(nofReads==3);
+  CHECK(xyz[0]==accelRegs[MMA1_OUT_X_MSB] && xyz[1]==accelRegs[MMA1_OUT_Y_MSB] && xyz[2]==accelRegs[MMA1_OUT_Z_MSB]);
+  CHECK(burstUs==BITS_TO_US(BITS_READ(3)));
+  CHECK(MMA1_SetFastMode(FALSE)==ERR_OK && accelRegs[MMA1_CTRL_REG_1]==MMA1_ACTIVE_BIT_MASK);
+
+  /* no device at this address */
+  CHECK(GI2C1_ScanDevice(0x1D)==ERR_OK);
+  CHECK(GI2C1_ScanDevice(0x1C)!=ERR_OK);
+  val = 0x5A;
+  CHECK(GI2C1_ReadByteAddress8(0x1C, MMA1_WHO_AM_I, &val)!=ERR_OK && val==0x5A);
+
+  (void)printf("MMA8451Q at %u kHz: GetX()+GetY()+GetZ() %u us, GetRaw8XYZ() %u us\n",
+               BUS_KHZ, (unsigned)axisUs, (unsigned)burstUs);
+  return TestResult();
+}
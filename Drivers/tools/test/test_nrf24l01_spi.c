@@ -0,0 +1,208 @@
+/*
+ * Host test of the SPI transfers of the nRF24L01 driver (nRF24L01.drv).
+ *
+ * The driver is generated three times, as NRFB with 'Block Transfer'
+ * enabled (SPIBurst() with SendBlock()/RecvBlock()), as NRFC with byte-wise
+ * transfers and as NRFS with byte-wise transfers on the GenericSWSPI
+ * component SWSPI1 with the bus simulation, and all run the same command
+ * sequence against the device model in host/mock_nrf24.c:
+ * - the bus traffic (chip selects with all MOSI and MISO bytes, CE changes)
+ *   is the same, for an SPI output buffer accepting 1, 3, 4 and 64 bytes
+ *   per SendBlock() call, and on the simulated software SPI.
+ * - register, address, TX and RX payload contents end up as expected.
+ * - the block transfer needs fewer calls into the SPI component.
+ * - the simulated software SPI counts 8 bit clocks per byte on the bus.
+ * - the GenericSPI component GSPI1 with the bus simulation: register writes
+ *   and reads with its methods and macros reach the device model, and 8 bit
+ *   clocks per byte are counted.
+ * - a bus error in SendBlock()/RecvBlock() ends the burst with the chip
+ *   select released, and TxPayload() does not start the transmission.
+ * - PollInterrupt() pulls CE low when a flag is set ('CE Low on Interrupt'
+ *   is enabled by default).
+ */
+#include <stdio.h>
+#include <string.h>
+#include "mock_nrf24.h"
+#include "NRFB.h"
+#include "NRFC.h"
+#include "NRFS.h"
+#include "SWSPI1.h"
+#include "GSPI1.h"
+#include "testutil.h"
+
+static const uint8_t addr[5] = {0x11, 0x22, 0x33, 0x44, 0x55};
+static uint8_t tx[3][32], rx[2][32];
+
+/* same command sequence for both driver variants, checks the results */
+#define SEQUENCE(m) \
+static void Sequence_##m(void) { \
+  uint8_t buf[32], val; \
+  int i; \
+  \
+  m##_Init(); \
+  m##_WriteRegisterData(m##_RX_ADDR_P0, (uint8_t*)addr, sizeof(addr)); \
+  memset(buf, 0, sizeof(buf)); \
+  m##_ReadRegisterData(m##_RX_ADDR_P0, buf, sizeof(addr)); \
+  CHECK(memcmp(buf, addr, sizeof(addr))==0); \
+  CHECK(memcmp(mockNrf.addr[m##_RX_ADDR_P0], addr, sizeof(addr))==0); \
+  m##_WriteRegister(m##_CONFIG, m##_EN_CRC|m##_CRCO|m##_PWR_UP|m##_PRIM_RX); \
+  CHECK(m##_ReadRegister(m##_CONFIG)==(m##_EN_CRC|m##_CRCO|m##_PWR_UP|m##_PRIM_RX)); \
+  CHECK(m##_SetChannel(76)==ERR_OK); \
+  CHECK(m##_GetChannel(&val)==ERR_OK && val==76); \
+  /* TxPayload() flushes the FIFO, then three payloads fill it */ \
+  m##_TxPayload(tx[0], 32); \
+  CHECK(mockNrf.nofTx==1 && mockNrf.txSize[0]==32 && memcmp(mockNrf.txFifo[0], tx[0], 32)==0); \
+  m##_WriteRegisterData(m##_W_TX_PAYLOAD, tx[1], 17); \
+  m##_WriteRegisterData(m##_W_TX_PAYLOAD, tx[2], 1); \
+  CHECK(mockNrf.nofTx==3 && mockNrf.txSize[1]==17 && mockNrf.txSize[2]==1); \
+  CHECK(memcmp(mockNrf.txFifo[1], tx[1], 17)==0 && mockNrf.txFifo[2][0]==tx[2][0]); \
+  CHECK(m##_GetFifoStatus(&val)==ERR_OK && (val&m##_FIFO_STATUS_TX_FULL)!=0); \
+  CHECK((m##_GetStatus()&m##_STATUS_TX_FULL)!=0); \
+  /* two received packets */ \
+  CHECK(MockNrf_Receive(1, rx[0], 32)); \
+  CHECK(MockNrf_Receive(2, rx[1], 9)); \
+  CHECK(m##_ReadNofRxPayload(&val)==ERR_OK && val==32); \
+  m##_RxPayload(buf, 32); \
+  CHECK(memcmp(buf, rx[0], 32)==0); \
+  CHECK((m##_GetStatus()&m##_STATUS_RX_P_NO)==(2<<1)); \
+  memset(buf, 0xAA, sizeof(buf)); \
+  m##_RxPayload(buf, 9); \
+  CHECK(memcmp(buf, rx[1], 9)==0 && buf[9]==0xAA); \
+  CHECK((m##_GetStatusClrIRQ()&m##_STATUS_RX_DR)!=0); \
+  CHECK((m##_GetStatus()&m##_STATUS_RX_DR)==0); \
+  CHECK(MockNrf_Transmit(true)); \
+  CHECK(m##_GetFifoStatus(&val)==ERR_OK && (val&m##_FIFO_STATUS_TX_FULL)==0); \
+  for(i=0;i<3;i++) { /* flush commands without data bytes */ \
+    m##_Write(m##_FLUSH_TX); \
+  } \
+  CHECK(mockNrf.nofTx==0); \
+  m##_StopRxTx(); \
+}
+
+SEQUENCE(NRFB)
+SEQUENCE(NRFC)
+SEQUENCE(NRFS)
+
+static byte SimExchange(SWSPI1_SimDevice *dev, byte mosi) {
+  return MockNrf_Shift(mosi);
+}
+
+static SWSPI1_SimDevice simNrf = {SimExchange, NULL};
+
+static byte GSPI1Exchange(GSPI1_SimDevice *dev, byte mosi) {
+  return MockNrf_Shift(mosi);
+}
+
+static GSPI1_SimDevice gspiNrf = {GSPI1Exchange, NULL};
+
+/* register accesses with GSPI1, the way a driver on the register SPI does them */
+static void GSPI1WriteRegister(uint8_t reg, uint8_t val) {
+  CSN1_ClrVal();
+  GSPI1_Write_ReadDummy(NRFC_W_REGISTER|reg);
+  GSPI1_WaitTxEmpty();
+  GSPI1_SendChar(val);
+  GSPI1_WaitTransferDone();
+  GSPI1_ClearReceiveStatReg();
+  GSPI1_ClearReceiveDataReg();
+  CSN1_SetVal();
+}
+
+static uint8_t GSPI1ReadRegister(uint8_t reg, uint8_t *status) {
+  uint8_t val;
+
+  CSN1_ClrVal();
+  GSPI1_WaitTxEmpty();
+  GSPI1_SendChar(NRFC_R_REGISTER|reg);
+  GSPI1_WaitRxFull();
+  *status = GSPI1_RecvChar();
+  val = GSPI1_WriteDummy_Read();
+  CSN1_SetVal();
+  return val;
+}
+
+static char byteLog[256*1024];
+
+int main(void) {
+  static const uint16_t chunks[] = {1, 3, 4, 64};
+  unsigned long byteCalls, blockCalls, ceHigh;
+  uint8_t buf[sizeof(addr)], status;
+  size_t i, j;
+
+  for(i=0;i<3;i++) {
+    for(j=0;j<32;j++) {
+      tx[i][j] = (uint8_t)(0x10*i+j);
+    }
+  }
+  for(i=0;i<2;i++) {
+    for(j=0;j<32;j++) {
+      rx[i][j] = (uint8_t)(0x80+0x20*i+j);
+    }
+  }
+  MockNrf_Reset();
+  Sequence_NRFC();
+  strcpy(byteLog, MockNrf_Log());
+  byteCalls = mockNrf.nofSpiCalls;
+  CHECK(strstr(byteLog, "> 2a 11 22 33 44 55 :")!=NULL); /* one chip select for the address */
+  CHECK(strstr(byteLog, "without chip select")==NULL && strstr(byteLog, "overflow")==NULL);
+
+  for(i=0;i<sizeof(chunks)/sizeof(chunks[0]);i++) {
+    mockNrfBlockChunk = chunks[i];
+    MockNrf_Reset();
+    Sequence_NRFB();
+    CHECK(strcmp(MockNrf_Log(), byteLog)==0);
+    if (strcmp(MockNrf_Log(), byteLog)!=0) {
+      (void)fprintf(stderr, "block transfer with %u byte chunks:\n%s\nbyte-wise:\n%s\n",
+                    (unsigned)chunks[i], MockNrf_Log(), byteLog);
+    }
+    blockCalls = mockNrf.nofSpiCalls;
+    if (chunks[i]>=32) {
+      CHECK(blockCalls<byteCalls);
+    }
+    (void)printf("%2u byte chunks: %lu SPI transfer calls, byte-wise %lu\n", (unsigned)chunks[i], blockCalls, byteCalls);
+  }
+
+  /* bus error during the block transfer */
+  MockNrf_Reset();
+  NRFB_Init();
+  ceHigh = mockNrf.nofCeHigh;
+  mockNrfSpiError = ERR_OVERRUN;
+  NRFB_TxPayload(tx[0], 32);
+  NRFB_ReadRegisterData(NRFB_RX_ADDR_P0, buf, sizeof(addr));
+  mockNrfSpiError = ERR_OK;
+  CHECK(mockNrf.nofCeHigh==ceHigh && mockNrf.csn);
+
+  /* interrupt flag */
+  MockNrf_Reset();
+  NRFC_Init();
+  NRFC_StartRxTx();
+  NRFC_PollInterrupt();
+  CHECK(mockNrf.ce);
+  CHECK(MockNrf_Receive(1, rx[0], 32));
+  NRFC_PollInterrupt();
+  CHECK(!mockNrf.ce);
+
+  /* simulated software SPI, 1 MHz */
+  SWSPI1_Init();
+  SWSPI1_SimSetDevice(&simNrf);
+  MockNrf_Reset();
+  Sequence_NRFS();
+  CHECK(strcmp(MockNrf_Log(), byteLog)==0);
+  if (strcmp(MockNrf_Log(), byteLog)!=0) {
+    (void)fprintf(stderr, "simulated software SPI:\n%s\nbyte-wise:\n%s\n", MockNrf_Log(), byteLog);
+  }
+  CHECK(SWSPI1_SimGetBusTimeUs()==mockNrf.nofSpiBytes*8);
+  (void)printf("software SPI at 1 MHz: %lu bytes in %lu us\n", mockNrf.nofSpiBytes, (unsigned long)SWSPI1_SimGetBusTimeUs());
+
+  /* simulated register SPI, 1 MHz; no device gives 0xFF */
+  MockNrf_Reset();
+  GSPI1_SimResetBusTime();
+  CHECK(GSPI1_WriteDummy_Read()==0xFF && GSPI1_SimGetBusTimeUs()==8);
+  GSPI1_SimResetBusTime();
+  GSPI1_SimSetDevice(&gspiNrf);
+  GSPI1WriteRegister(NRFC_RF_CH, 42);
+  CHECK(mockNrf.reg[NRFC_RF_CH]==42 && mockNrf.nofRegWrites[NRFC_RF_CH]==1);
+  CHECK(GSPI1ReadRegister(NRFC_RF_CH, &status)==42 && (status&NRFC_STATUS_RX_P_NO)==NRFC_STATUS_RX_P_NO); /* RX FIFO empty */
+  CHECK(mockNrf.nofFrames==2 && mockNrf.nofSpiBytes==4);
+  CHECK(GSPI1_SimGetBusTimeUs()==4*8);
+  return TestResult();
+}
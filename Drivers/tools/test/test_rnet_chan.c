@@ -0,0 +1,325 @@
+/*
+ * Host simulation of the adaptive channel selection (RChan.c) with the
+ * nRF24L01+ radio (nRF24/Radio.c), built as channel hopping master with
+ * four candidate channels (0, 25, 50, 75) and a 2 s evaluation period.
+ *
+ * Same setup as test_rnet_radio.c: simulated time without the scheduler,
+ * the radio task loop calls RNET1_Process() on events and periodically, and
+ * vTaskDelay() (used while sampling another channel) advances the time. The
+ * channel model gives each channel a number of retransmissions, a packet
+ * loss rate and a share of received power detector hits. Checked:
+ * - while a peer sends every 20 ms on average the node stays on its channel (no RF_CH
+ *   write) and receives every packet, and still samples its own channel.
+ *   Other channels are sampled once the peer is quiet.
+ * - with a lossy channel the master moves to a clean and free channel, not
+ *   to the busy one.
+ * - hop commands shorter than their header and command are rejected.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "mock_nrf24.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "RNET1.h"
+#include "RApp.h"
+#include "RChan.h"
+#include "RMSG.h"
+#include "RNWK.h"
+#include "Radio.h"
+#include "testutil.h"
+
+#define SIM_PACKET_US        465  /* 130 us PLL settling, 32 byte payload at 2 Mbps, ack */
+#define SIM_ARD_US           750  /* auto retransmit delay in SETUP_RETR */
+#define SIM_MAX_RT_US        (16*SIM_PACKET_US+15*SIM_ARD_US) /* first transmission and 15 retransmissions */
+#define SIM_SPI_BYTE_US      1    /* 8 MHz SPI clock */
+#define SIM_TICK_US          (1000000/configTICK_RATE_HZ)
+#define RADIO_TASK_PERIOD_US 10000 /* the radio task waits at most 10 ms for an event */
+
+#define REG_RF_CH            0x05
+#define NOF_CHANNELS         RCHAN_NOF_CHANNELS
+#define PEER_ADDR            0x02
+
+typedef struct {
+  uint8_t nofRetransmits;   /* retransmissions of a packet which gets through */
+  unsigned lossPermille;    /* packets lost after all retransmissions */
+  unsigned busyPermille;    /* RPD readings above -64 dBm */
+} ChannelModel;
+
+void IRQ1_OnInterrupt(void); /* generated in RF1.c */
+
+static ChannelModel chanModel[NOF_CHANNELS];
+static unsigned long nofRpd[NOF_CHANNELS]; /* RPD readings per channel */
+
+static unsigned long long simTimeUs;
+static unsigned long long airDoneUs; /* end of the packet on the air, 0 if none */
+static bool airAck;                  /* packet on the air gets through */
+static uint8_t airRetransmits;
+static bool simEvent;                /* interrupt raised */
+static uint32_t simRand;
+
+static unsigned long long peerPeriodUs, peerNextUs; /* peer sends a packet every peerPeriodUs on average, 0 if quiet */
+static unsigned nofPeerTx, nofPeerMissed, nofPeerRx;
+static unsigned long long burstPeriodUs, burstNextUs; /* node sends a burst of packets every burstPeriodUs, 0 if none */
+
+static uint32_t SimRand(void) {
+  simRand = simRand*1103515245u+12345u;
+  return simRand>>16;
+}
+
+/* candidate index of the channel in RF_CH, NOF_CHANNELS for another one */
+static unsigned ChannelIdx(uint8_t ch) {
+  unsigned i;
+
+  for(i=0;i<NOF_CHANNELS;i++) {
+    if (ch==RNET_CONFIG_TRANSCEIVER_CHANNEL+i*RNET_CONFIG_CHANNEL_HOP_SPACING) {
+      return i;
+    }
+  }
+  return NOF_CHANNELS;
+}
+
+static uint8_t SimRpd(void) {
+  unsigned idx = ChannelIdx(mockNrf.reg[REG_RF_CH]);
+
+  if (idx>=NOF_CHANNELS) {
+    return 0;
+  }
+  nofRpd[idx]++;
+  return (uint8_t)(SimRand()%1000<chanModel[idx].busyPermille);
+}
+
+static bool AirTxEnabled(void) {
+  /* CONFIG: PWR_UP set, PRIM_RX cleared */
+  return mockNrf.ce && (mockNrf.reg[0x00]&0x03)==0x02;
+}
+
+static bool AirRxEnabled(void) {
+  /* CONFIG: PWR_UP and PRIM_RX set */
+  return mockNrf.ce && (mockNrf.reg[0x00]&0x03)==0x03;
+}
+
+static void Interrupt(bool wasActive) {
+  if (!wasActive && MockNrf_IrqActive()) {
+    simEvent = true;
+    IRQ1_OnInterrupt();
+  }
+}
+
+static void AirDone(void) {
+  bool irq = MockNrf_IrqActive();
+
+  if (mockNrf.nofTx==0) {
+    return; /* flushed */
+  }
+  if (MockNrf_Transmit(airAck)) {
+    if (airAck) {
+      mockNrf.reg[0x08] = (uint8_t)((mockNrf.reg[0x08]&0xF0)|airRetransmits); /* OBSERVE_TX ARC_CNT */
+    }
+    Interrupt(irq);
+  }
+}
+
+/* the peer follows the channel of the node, the packet is lost if the node does not listen there */
+static void PeerSend(void) {
+  uint8_t air[MOCK_NRF_PAYLOAD];
+  bool irq = MockNrf_IrqActive();
+
+  memset(air, 0, sizeof(air)); /* dynamic payload size: the air payload is the PHY payload */
+  air[RMAC_BUF_IDX_TYPE-RPHY_BUF_IDX_PAYLOAD] = RMAC_MSG_TYPE_DATA;
+  air[RMAC_BUF_IDX_SEQNR-RPHY_BUF_IDX_PAYLOAD] = (uint8_t)nofPeerTx;
+  air[RNWK_BUF_IDX_SRC_ADDR-RPHY_BUF_IDX_PAYLOAD] = PEER_ADDR;
+  air[RNWK_BUF_IDX_DST_ADDR-RPHY_BUF_IDX_PAYLOAD] = (uint8_t)RNWK_GetThisNodeAddr();
+  air[RAPP_BUF_IDX_TYPE-RPHY_BUF_IDX_PAYLOAD] = RAPP_MSG_TYPE_DATA;
+  air[RAPP_BUF_IDX_SIZE-RPHY_BUF_IDX_PAYLOAD] = 1;
+  nofPeerTx++;
+  if (!AirRxEnabled() || mockNrf.reg[REG_RF_CH]!=RCHAN_GetChannel() || !MockNrf_Receive(1, air, RAPP_BUF_IDX_PAYLOAD+1-RPHY_BUF_IDX_PAYLOAD)) {
+    nofPeerMissed++;
+    return;
+  }
+  Interrupt(irq);
+}
+
+static uint8_t OnPeerData(RAPP_MSG_Type type, uint8_t size, uint8_t *data, RNWK_ShortAddrType srcAddr, bool *handled, RPHY_PacketDesc *packet) {
+  if (type==RAPP_MSG_TYPE_DATA && srcAddr==PEER_ADDR) {
+    nofPeerRx++;
+    *handled = TRUE;
+  }
+  return ERR_OK;
+}
+
+static const RAPP_MsgHandler handlerTable[] = {
+  OnPeerData,
+  NULL
+};
+
+/* advances the simulated time, returns early after an interrupt if stopAtEvent is set */
+static void SimRunUntil(unsigned long long t, bool stopAtEvent) {
+  unsigned long long next;
+  unsigned idx;
+
+  while (!stopAtEvent || !simEvent) {
+    if (airDoneUs==0 && AirTxEnabled() && mockNrf.nofTx>0 && !(mockNrf.reg[0x07]&0x10)) { /* stopped while MAX_RT is set */
+      idx = ChannelIdx(mockNrf.reg[REG_RF_CH]);
+      airAck = idx<NOF_CHANNELS && SimRand()%1000>=chanModel[idx].lossPermille;
+      airRetransmits = idx<NOF_CHANNELS ? chanModel[idx].nofRetransmits : 0;
+      airDoneUs = simTimeUs+(airAck?(airRetransmits+1)*SIM_PACKET_US+airRetransmits*SIM_ARD_US:SIM_MAX_RT_US);
+    }
+    next = (simTimeUs/SIM_TICK_US+1)*SIM_TICK_US;
+    if (airDoneUs!=0 && airDoneUs<next) {
+      next = airDoneUs;
+    }
+    if (peerPeriodUs!=0 && peerNextUs<next) {
+      next = peerNextUs;
+    }
+    if (next>t) {
+      simTimeUs = t;
+      return;
+    }
+    simTimeUs = next;
+    if (simTimeUs%SIM_TICK_US==0) {
+      (void)xTaskIncrementTick();
+    }
+    if (airDoneUs==simTimeUs) {
+      airDoneUs = 0;
+      AirDone();
+    }
+    if (peerPeriodUs!=0 && peerNextUs==simTimeUs) {
+      peerNextUs += peerPeriodUs/2+SimRand()%peerPeriodUs; /* peerPeriodUs on average */
+      PeerSend();
+    }
+  }
+}
+
+/* the radio task blocks while sampling another channel */
+void __wrap_vTaskDelay(const TickType_t xTicksToDelay) {
+  SimRunUntil(simTimeUs+xTicksToDelay*SIM_TICK_US, false);
+}
+
+/* radio task loop, with the application sending a burst of packets every burstPeriodUs */
+static void RunRadioTask(unsigned long long durationUs) {
+  unsigned long long end = simTimeUs+durationUs;
+  unsigned long spiBytes, waitUs;
+  uint32_t i;
+
+  while (simTimeUs<end) {
+    if (burstPeriodUs!=0 && simTimeUs>=burstNextUs) {
+      burstNextUs += burstPeriodUs;
+      for(i=0;i<4 && RMSG_TxQueueNofItems()<RNET_CONFIG_MSG_QUEUE_NOF_TX_ITEMS-3;i++) {
+        (void)RAPP_SendPayloadDataBlock((uint8_t*)&i, sizeof(i), RAPP_MSG_TYPE_DATA, 0x01, RPHY_PACKET_FLAGS_NONE);
+      }
+    }
+    spiBytes = mockNrf.nofSpiBytes;
+    waitUs = (unsigned long)mockNrf.timeUs;
+    (void)RNET1_Process();
+    SimRunUntil(simTimeUs+(mockNrf.nofSpiBytes-spiBytes)*SIM_SPI_BYTE_US+((unsigned long)mockNrf.timeUs-waitUs), false);
+    if (RNET1_WaitForEvent(0)!=ERR_OK) { /* block until the next interrupt, at most for the task period */
+      simEvent = false;
+      SimRunUntil(simTimeUs+RADIO_TASK_PERIOD_US, true);
+      (void)RNET1_WaitForEvent(0);
+    }
+    simEvent = false;
+  }
+}
+
+static void RadioTask(void *pvParameters) {
+  for(;;) {} /* never runs, the scheduler is not started */
+}
+
+static void SetChannel(unsigned idx, uint8_t nofRetransmits, unsigned lossPermille, unsigned busyPermille) {
+  chanModel[idx].nofRetransmits = nofRetransmits;
+  chanModel[idx].lossPermille = lossPermille;
+  chanModel[idx].busyPermille = busyPermille;
+}
+
+/* hop command of the given NWK payload size, with the candidate index idx */
+static uint8_t HopCommand(uint8_t size, uint8_t idx) {
+  uint8_t buf[RPHY_BUFFER_SIZE];
+  RPHY_PacketDesc packet;
+  uint8_t *data;
+
+  memset(buf, 0, sizeof(buf));
+  packet.flags = RPHY_PACKET_FLAGS_NONE;
+  packet.phySize = sizeof(buf);
+  packet.phyData = buf;
+  packet.rxtx = RPHY_BUF_PAYLOAD_START(buf);
+  RPHY_BUF_SIZE(buf) = (uint8_t)(RMAC_HEADER_SIZE+RNWK_HEADER_SIZE+size);
+  RMAC_BUF_TYPE(buf) = RMAC_MSG_TYPE_CMD;
+  data = RNWK_BUF_PAYLOAD_START(buf);
+  data[0] = 0x01; /* hop */
+  data[1] = idx;
+  data[2] = 0; /* no delay */
+  return RCHAN_OnPacketRx(&packet);
+}
+
+int main(void) {
+  unsigned long chWrites, rpdStart[NOF_CHANNELS];
+  unsigned i, nofOther;
+  uint8_t ch;
+
+  /* xTaskIncrementTick() needs a current task */
+  CHECK(xTaskCreate(RadioTask, "Radio", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+1, NULL)==pdPASS);
+  MockNrf_Reset();
+  mockNrfRpd = SimRpd;
+  simRand = 1;
+  RNET1_Init();
+  (void)RAPP_SetMessageHandlerTable(handlerTable);
+  (void)RNET1_PowerUp();
+  for(i=0;i<NOF_CHANNELS;i++) {
+    SetChannel(i, 0, 0, 0);
+  }
+
+  /* peer sends every 20 ms: the node must not leave its channel. The node might sample another channel before the first packet. */
+  RunRadioTask(1000000);
+  peerPeriodUs = 20000;
+  peerNextUs = simTimeUs+peerPeriodUs;
+  RunRadioTask(peerPeriodUs+1000);
+  chWrites = mockNrf.nofRegWrites[REG_RF_CH];
+  memcpy(rpdStart, nofRpd, sizeof(rpdStart));
+  RunRadioTask(10000000);
+  CHECK(mockNrf.nofRegWrites[REG_RF_CH]==chWrites);
+  CHECK(nofRpd[0]>rpdStart[0]); /* own channel sampled without switching */
+  CHECK(RCHAN_GetChannel()==RNET_CONFIG_TRANSCEIVER_CHANNEL);
+  (void)printf("peer every 20 ms on average: %lu RF_CH changes, %lu RPD readings of the own channel\n",
+               mockNrf.nofRegWrites[REG_RF_CH]-chWrites, nofRpd[0]-rpdStart[0]);
+
+  /* peer quiet: the other channels get sampled */
+  peerPeriodUs = 0;
+  memcpy(rpdStart, nofRpd, sizeof(rpdStart));
+  RunRadioTask(2000000);
+  CHECK(nofPeerTx>=450 && nofPeerMissed==0 && nofPeerRx==nofPeerTx);
+  nofOther = 0;
+  for(i=1;i<NOF_CHANNELS;i++) {
+    if (nofRpd[i]>rpdStart[i]) {
+      nofOther++;
+    }
+  }
+  CHECK(nofOther==NOF_CHANNELS-1 && mockNrf.nofRegWrites[REG_RF_CH]>chWrites);
+  (void)printf("%u of %u peer packets received, %u missed, %u other channels sampled in 2 s quiet time\n",
+               nofPeerRx, nofPeerTx, nofPeerMissed, nofOther);
+
+  /* the current channel gets lossy, channel 1 is in use by others: move to channel 2 or 3 */
+  SetChannel(0, 8, 200, 0);
+  SetChannel(1, 0, 0, 600);
+  burstPeriodUs = 300000;
+  burstNextUs = simTimeUs;
+  for(i=0;i<20 && (RCHAN_GetChannel()==RNET_CONFIG_TRANSCEIVER_CHANNEL || !RADIO_CanDoPowerDown());i++) {
+    RunRadioTask(1000000);
+  }
+  ch = RCHAN_GetChannel();
+  CHECK(ch==RNET_CONFIG_TRANSCEIVER_CHANNEL+2*RNET_CONFIG_CHANNEL_HOP_SPACING || ch==RNET_CONFIG_TRANSCEIVER_CHANNEL+3*RNET_CONFIG_CHANNEL_HOP_SPACING);
+  CHECK(mockNrf.reg[REG_RF_CH]==ch);
+  (void)printf("lossy channel %u: moved to channel %u after %u s\n", RNET_CONFIG_TRANSCEIVER_CHANNEL, ch, i+1);
+
+  /* commands shorter than the header and the command are rejected */
+  burstPeriodUs = 0;
+  CHECK(HopCommand(0, 1)==ERR_FAULT);
+  CHECK(HopCommand(2, 1)==ERR_FAULT);
+  CHECK(HopCommand(3, NOF_CHANNELS)==ERR_RANGE);
+  CHECK(HopCommand((uint8_t)-RNWK_HEADER_SIZE, 1)==ERR_FAULT); /* size below the NWK header */
+  RunRadioTask(100000);
+  CHECK(RCHAN_GetChannel()==ch);
+  CHECK(HopCommand(3, 1)==ERR_OK);
+  RunRadioTask(100000);
+  CHECK(RCHAN_GetChannel()==RNET_CONFIG_TRANSCEIVER_CHANNEL+RNET_CONFIG_CHANNEL_HOP_SPACING);
+  return TestResult();
+}
@@ -0,0 +1,234 @@
+/*
+ * Host simulation of the low power listening MAC (RMAC.c) with the
+ * nRF24L01+ radio (nRF24/Radio.c), 250 ms wake-up period and 5 ms listen
+ * time.
+ *
+ * Same setup as test_rnet_radio.c: simulated time without the scheduler,
+ * the radio task loop calls RNET1_Process() on events and when the MAC
+ * needs it, and vTaskDelay() advances the time. The power model follows
+ * PWR_UP in CONFIG and CE. Checked:
+ * - CE goes high at the earliest 1.5 ms (Tpd2stby) after PWR_UP.
+ * - an idle node listens after the start up in every wake-up period, for
+ *   the listen time in ticks, the radio-on time stays below
+ *   (listen time+start up+one tick)/wake-up period.
+ * - packets to a node with the same listen schedule and an unknown phase
+ *   are sent again until its listen window, and all get acknowledged.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "mock_nrf24.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "RNET1.h"
+#include "RApp.h"
+#include "RMAC.h"
+#include "RMSG.h"
+#include "Radio.h"
+#include "testutil.h"
+
+#define SIM_PACKET_US        465  /* 130 us PLL settling, 32 byte payload at 2 Mbps, ack */
+#define SIM_ARD_US           750  /* auto retransmit delay in SETUP_RETR */
+#define SIM_MAX_RT_US        (16*SIM_PACKET_US+15*SIM_ARD_US) /* first transmission and 15 retransmissions */
+#define SIM_SPI_BYTE_US      1    /* 8 MHz SPI clock */
+#define SIM_TICK_US          (1000000/configTICK_RATE_HZ)
+#define SIM_TPD2STBY_US      1500 /* power down to standby */
+#define RADIO_TASK_PERIOD_US 10000 /* the radio task waits at most 10 ms for an event */
+
+#define PERIOD_US            (RNET_CONFIG_LPL_WAKEUP_PERIOD_MS*1000ULL)
+#define LISTEN_US            (RNET_CONFIG_LPL_LISTEN_MS*1000ULL)
+#define NOF_PACKETS          20
+#define PACKET_PERIOD_US     1000000 /* the application sends a packet every second */
+
+void IRQ1_OnInterrupt(void); /* generated in RF1.c */
+
+static unsigned long long simTimeUs;
+static unsigned long long airDoneUs; /* end of the packet on the air, 0 if none */
+static bool airAck;                  /* packet on the air gets acknowledged */
+static bool simEvent;                /* interrupt raised */
+static unsigned long long peerPhaseUs; /* start of the listen windows of the receiver in the wake-up period */
+
+/* power model */
+static bool pwrUp;
+static unsigned long long pwrUpUs, rxStartUs, onUs, minListenUs;
+static unsigned nofWakeups, nofEarlyCe, nofDelivered;
+
+static bool AirTxEnabled(void) {
+  /* CONFIG: PWR_UP set, PRIM_RX cleared */
+  return mockNrf.ce && (mockNrf.reg[0x00]&0x03)==0x02;
+}
+
+/* the receiver listens after its start up, for the listen time */
+static bool PeerListening(unsigned long long t) {
+  unsigned long long inPeriod = (t+PERIOD_US-peerPhaseUs)%PERIOD_US;
+
+  return inPeriod>=SIM_TPD2STBY_US && inPeriod<SIM_TPD2STBY_US+LISTEN_US;
+}
+
+static void OnChange(void) {
+  bool up = (mockNrf.reg[0x00]&0x02)!=0;
+
+  if (up && !pwrUp) {
+    pwrUpUs = simTimeUs;
+    nofWakeups++;
+  } else if (!up && pwrUp) {
+    onUs += simTimeUs-pwrUpUs;
+    if (rxStartUs!=0 && simTimeUs-rxStartUs<minListenUs) {
+      minListenUs = simTimeUs-rxStartUs;
+    }
+    rxStartUs = 0;
+  }
+  pwrUp = up;
+  if (pwrUp && mockNrf.ce) {
+    if (simTimeUs-pwrUpUs<SIM_TPD2STBY_US) {
+      nofEarlyCe++; /* not in standby yet */
+    }
+    if ((mockNrf.reg[0x00]&0x01) && rxStartUs==0) {
+      rxStartUs = simTimeUs;
+    }
+  }
+}
+
+static void AirDone(void) {
+  bool irq = MockNrf_IrqActive();
+
+  if (mockNrf.nofTx==0) {
+    return; /* flushed */
+  }
+  if (MockNrf_Transmit(airAck)) {
+    if (airAck) {
+      nofDelivered++;
+    }
+    if (!irq && MockNrf_IrqActive()) {
+      simEvent = true;
+      IRQ1_OnInterrupt();
+    }
+  }
+}
+
+/* advances the simulated time, returns early after an interrupt if stopAtEvent is set */
+static void SimRunUntil(unsigned long long t, bool stopAtEvent) {
+  unsigned long long next, us;
+
+  while (!stopAtEvent || !simEvent) {
+    if (airDoneUs==0 && AirTxEnabled() && mockNrf.nofTx>0 && !(mockNrf.reg[0x07]&0x10)) { /* stopped while MAX_RT is set */
+      /* acknowledged by the first (re)transmission in a listen window of the receiver */
+      airAck = false;
+      for(us=SIM_PACKET_US;us<=SIM_MAX_RT_US && !airAck;us+=SIM_PACKET_US+SIM_ARD_US) {
+        if (PeerListening(simTimeUs+us)) {
+          airAck = true;
+          airDoneUs = simTimeUs+us;
+        }
+      }
+      if (!airAck) {
+        airDoneUs = simTimeUs+SIM_MAX_RT_US;
+      }
+    }
+    next = (simTimeUs/SIM_TICK_US+1)*SIM_TICK_US;
+    if (airDoneUs!=0 && airDoneUs<next) {
+      next = airDoneUs;
+    }
+    if (next>t) {
+      simTimeUs = t;
+      return;
+    }
+    simTimeUs = next;
+    if (simTimeUs%SIM_TICK_US==0) {
+      (void)xTaskIncrementTick();
+    }
+    if (airDoneUs==simTimeUs) {
+      airDoneUs = 0;
+      AirDone();
+    }
+  }
+}
+
+/* the radio task blocks during the transceiver start up */
+void __wrap_vTaskDelay(const TickType_t xTicksToDelay) {
+  SimRunUntil(simTimeUs+xTicksToDelay*SIM_TICK_US, false);
+}
+
+/* radio task loop, the application sends nofPackets one per PACKET_PERIOD_US */
+static void RunRadioTask(unsigned long long durationUs, uint32_t nofPackets) {
+  unsigned long long end = simTimeUs+durationUs, nextPacketUs = simTimeUs, waitUs;
+  unsigned long spiBytes, timeUs;
+  uint32_t seq = 0;
+
+  while (simTimeUs<end) {
+    if (seq<nofPackets && simTimeUs>=nextPacketUs) {
+      (void)RAPP_SendPayloadDataBlock((uint8_t*)&seq, sizeof(seq), RAPP_MSG_TYPE_DATA, 0x01, RPHY_PACKET_FLAGS_NONE);
+      seq++;
+      nextPacketUs += PACKET_PERIOD_US;
+    }
+    spiBytes = mockNrf.nofSpiBytes;
+    timeUs = (unsigned long)mockNrf.timeUs;
+    (void)RNET1_Process();
+    SimRunUntil(simTimeUs+(mockNrf.nofSpiBytes-spiBytes)*SIM_SPI_BYTE_US+((unsigned long)mockNrf.timeUs-timeUs), false);
+    if (RNET1_WaitForEvent(0)!=ERR_OK) { /* block until the next interrupt or MAC event, at most for the task period */
+      waitUs = RMAC_LplTicksToNextEvent()*SIM_TICK_US;
+      if (waitUs>RADIO_TASK_PERIOD_US && !RMAC_LplIsSleeping()) {
+        waitUs = RADIO_TASK_PERIOD_US;
+      }
+      if (seq<nofPackets && nextPacketUs-simTimeUs<waitUs) {
+        waitUs = nextPacketUs-simTimeUs;
+      }
+      simEvent = false;
+      SimRunUntil(simTimeUs+(waitUs>0?waitUs:SIM_TICK_US), true);
+      (void)RNET1_WaitForEvent(0);
+    }
+    simEvent = false;
+  }
+}
+
+static void RadioTask(void *pvParameters) {
+  for(;;) {} /* never runs, the scheduler is not started */
+}
+
+static void StartMeasure(void) {
+  onUs = 0;
+  nofWakeups = nofEarlyCe = nofDelivered = 0;
+  minListenUs = ~0ULL;
+  if (pwrUp) {
+    pwrUpUs = simTimeUs;
+  }
+}
+
+int main(void) {
+  unsigned long long start, us;
+  double duty, dutyBound;
+
+  /* xTaskIncrementTick() needs a current task */
+  CHECK(xTaskCreate(RadioTask, "Radio", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+1, NULL)==pdPASS);
+  MockNrf_Reset();
+  RNET1_Init();
+  (void)RNET1_PowerUp();
+  OnChange();
+  mockNrfOnChange = OnChange; /* the driver initialization waits for the start up itself */
+
+  /* idle node */
+  RunRadioTask(PERIOD_US, 0);
+  StartMeasure();
+  start = simTimeUs;
+  RunRadioTask(40*PERIOD_US, 0);
+  us = simTimeUs-start;
+  duty = (double)onUs/(double)us;
+  dutyBound = (double)(LISTEN_US+3*SIM_TICK_US+SIM_TICK_US)/(double)PERIOD_US; /* start up in ticks, partial tick */
+  CHECK(nofEarlyCe==0);
+  CHECK(nofWakeups>=39 && nofWakeups<=41);
+  CHECK(minListenUs>=LISTEN_US-SIM_TICK_US); /* listen ticks, the first one partial */
+  CHECK(duty>(double)LISTEN_US/(double)PERIOD_US && duty<dutyBound);
+  (void)printf("idle: %u wake-ups in %.0f ms, CE high before standby %u times, listen at least %.1f ms, radio on %.2f%% (listen time %.2f%%)\n",
+               nofWakeups, us/1000.0, nofEarlyCe, minListenUs/1000.0, 100.0*duty, 100.0*LISTEN_US/(double)PERIOD_US);
+
+  /* sending to a node with an unknown listen phase */
+  peerPhaseUs = 117000;
+  StartMeasure();
+  start = simTimeUs;
+  RunRadioTask(NOF_PACKETS*(unsigned long long)PACKET_PERIOD_US, NOF_PACKETS);
+  us = simTimeUs-start;
+  CHECK(nofEarlyCe==0);
+  CHECK(nofDelivered==NOF_PACKETS);
+  CHECK(onUs<NOF_PACKETS*(PERIOD_US+2*LISTEN_US)+(us/PERIOD_US)*(LISTEN_US+4*SIM_TICK_US)); /* strobing at most one period per packet */
+  (void)printf("sender: %u of %u packets acknowledged, radio on %.1f ms per packet\n",
+               nofDelivered, NOF_PACKETS, onUs/1000.0/NOF_PACKETS);
+  return TestResult();
+}
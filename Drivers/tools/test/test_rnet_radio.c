@@ -0,0 +1,208 @@
+/*
+ * Host simulation of the RNet stack with the nRF24L01+ radio (nRF24/Radio.c),
+ * the driver RF1 with IRQ pin and the device model in host/mock_nrf24.c.
+ *
+ * The simulation runs without the scheduler, in simulated time: the radio
+ * task loop calls RNET1_Process() whenever RNET1_WaitForEvent() reports an
+ * event, and at the latest after RADIO_TASK_PERIOD_US. Other tasks delay the
+ * radio task at times by up to SIM_MAX_LATENCY_US, so several packets can be
+ * sent between two calls of RNET1_Process(). The air model sends
+ * the TX FIFO content while CE is high in TX mode, and fails a packet (MAX_RT
+ * after all retransmissions) while the receiver is absent. Checked:
+ * - on a good link all packets arrive in order, and CE stays high between
+ *   the packets of the TX FIFO (back-to-back sending).
+ * - with the receiver absent from time to time, no packet arrives twice or
+ *   out of order, packets are only lost after their retries.
+ * - the throughput, compared with the air time bound and with sending one
+ *   packet per task period.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "mock_nrf24.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "RNET1.h"
+#include "RApp.h"
+#include "RMSG.h"
+#include "Radio.h"
+#include "testutil.h"
+
+#define SIM_PACKET_US        465  /* 130 us PLL settling, 32 byte payload at 2 Mbps, ack */
+#define SIM_ARD_US           750  /* auto retransmit delay in SETUP_RETR */
+#define SIM_MAX_RT_US        (16*SIM_PACKET_US+15*SIM_ARD_US) /* first transmission and 15 retransmissions */
+#define SIM_SPI_BYTE_US      1    /* 8 MHz SPI clock */
+#define SIM_TICK_US          (1000000/configTICK_RATE_HZ)
+#define RADIO_TASK_PERIOD_US 10000 /* the radio task waits at most 10 ms for an event */
+#define SIM_MAX_LATENCY_US   2000  /* the radio task is delayed by up to 2 ms after one of four events */
+
+#define NOF_PACKETS          2000
+#define SEQ_OFFSET           (RAPP_BUF_IDX_PAYLOAD-RPHY_BUF_IDX_PAYLOAD) /* sequence number in the air payload */
+
+void IRQ1_OnInterrupt(void); /* generated in RF1.c */
+
+static unsigned long long simTimeUs;
+static unsigned long long airDoneUs; /* end of the packet on the air, 0 if none */
+static bool airAck;                  /* packet on the air gets acknowledged */
+static bool simEvent;                /* interrupt raised */
+static unsigned long long absentPeriodUs, absentUs; /* receiver absent for absentUs in every absentPeriodUs */
+static uint32_t simRand;
+
+static uint32_t rxSeq[NOF_PACKETS];
+static unsigned nofRx, nofDup;
+
+static bool ReceiverPresent(void) {
+  return absentPeriodUs==0 || simTimeUs%absentPeriodUs>=absentUs;
+}
+
+static bool AirTxEnabled(void) {
+  /* CONFIG: PWR_UP set, PRIM_RX cleared */
+  return mockNrf.ce && (mockNrf.reg[0x00]&0x03)==0x02;
+}
+
+static void AirDone(void) {
+  bool irq = MockNrf_IrqActive();
+  uint32_t seq;
+
+  if (mockNrf.nofTx==0) {
+    return; /* flushed */
+  }
+  if (airAck) {
+    memcpy(&seq, &mockNrf.txFifo[0][SEQ_OFFSET], sizeof(seq));
+    if (nofRx>0 && seq<=rxSeq[nofRx-1]) {
+      nofDup++; /* duplicate or out of order */
+    } else if (nofRx<NOF_PACKETS) {
+      rxSeq[nofRx++] = seq;
+    }
+  }
+  if (MockNrf_Transmit(airAck) && !irq && MockNrf_IrqActive()) {
+    simEvent = true;
+    IRQ1_OnInterrupt();
+  }
+}
+
+static uint32_t SimRand(void) {
+  simRand = simRand*1103515245u+12345u;
+  return simRand>>16;
+}
+
+/* advances the simulated time, returns early after an interrupt if stopAtEvent is set */
+static void SimRunUntil(unsigned long long t, bool stopAtEvent) {
+  unsigned long long next;
+
+  while (!stopAtEvent || !simEvent) {
+    if (airDoneUs==0 && AirTxEnabled() && mockNrf.nofTx>0 && !(mockNrf.reg[0x07]&0x10)) { /* stopped while MAX_RT is set */
+      airAck = ReceiverPresent();
+      airDoneUs = simTimeUs+(airAck?SIM_PACKET_US:SIM_MAX_RT_US);
+    }
+    next = (simTimeUs/SIM_TICK_US+1)*SIM_TICK_US;
+    if (airDoneUs!=0 && airDoneUs<next) {
+      next = airDoneUs;
+    }
+    if (next>t) {
+      simTimeUs = t;
+      return;
+    }
+    simTimeUs = next;
+    if (simTimeUs%SIM_TICK_US==0) {
+      (void)xTaskIncrementTick();
+    }
+    if (airDoneUs==simTimeUs) {
+      airDoneUs = 0;
+      AirDone();
+    }
+  }
+}
+
+/* radio task: sends nofPackets with the sequence number as payload, returns the simulated time needed */
+static unsigned long long RunRadioTask(uint32_t nofPackets) {
+  unsigned long long start = simTimeUs;
+  unsigned long spiBytes, waitUs;
+  uint32_t seq = 0;
+
+  while ((seq<nofPackets || !RADIO_CanDoPowerDown()) && simTimeUs-start<60000000ULL) {
+    /* leave room in the Tx queue for the packets the radio puts back after a timeout */
+    while (seq<nofPackets && RMSG_TxQueueNofItems()<RNET_CONFIG_MSG_QUEUE_NOF_TX_ITEMS-3) {
+      if (RAPP_SendPayloadDataBlock((uint8_t*)&seq, sizeof(seq), RAPP_MSG_TYPE_DATA, 0x01, RPHY_PACKET_FLAGS_NONE)!=ERR_OK) {
+        break;
+      }
+      seq++;
+    }
+    spiBytes = mockNrf.nofSpiBytes;
+    waitUs = (unsigned long)mockNrf.timeUs;
+    (void)RNET1_Process();
+    SimRunUntil(simTimeUs+(mockNrf.nofSpiBytes-spiBytes)*SIM_SPI_BYTE_US+((unsigned long)mockNrf.timeUs-waitUs), false);
+    if (RNET1_WaitForEvent(0)!=ERR_OK) { /* block until the next interrupt, at most for the task period */
+      simEvent = false;
+      SimRunUntil(simTimeUs+RADIO_TASK_PERIOD_US, true);
+      (void)RNET1_WaitForEvent(0);
+    }
+    simEvent = false;
+    if (SimRand()%4==0) { /* other tasks run first */
+      SimRunUntil(simTimeUs+SimRand()%SIM_MAX_LATENCY_US, false);
+    }
+  }
+  return simTimeUs-start;
+}
+
+static void RadioTask(void *pvParameters) {
+  for(;;) {} /* never runs, the scheduler is not started */
+}
+
+static void StartRun(unsigned long long period, unsigned long long absent) {
+  MockNrf_Reset();
+  airDoneUs = 0;
+  simEvent = false;
+  simRand = 1;
+  absentPeriodUs = period;
+  absentUs = absent;
+  nofRx = nofDup = 0;
+  (void)RNET1_PowerUp();
+}
+
+/* sends NOF_PACKETS with the receiver absent for absent us in every period us */
+static void RunAbsent(unsigned long long period, unsigned long long absent) {
+  unsigned long long us;
+  unsigned i, nofGaps;
+
+  StartRun(period, absent);
+  us = RunRadioTask(NOF_PACKETS);
+  nofGaps = 0;
+  for(i=1;i<nofRx;i++) {
+    nofGaps += rxSeq[i]-rxSeq[i-1]-1;
+  }
+  CHECK(nofDup==0);
+  CHECK(nofRx>NOF_PACKETS/2 && nofRx+nofGaps+rxSeq[0]+(NOF_PACKETS-1-rxSeq[nofRx-1])==NOF_PACKETS);
+  CHECK(mockNrf.nofTx==0);
+  (void)printf("receiver absent %u%%: %u of %u packets in %.1f ms, %u lost after retries, %u duplicate or out of order\n",
+               (unsigned)(100*absent/period), nofRx, NOF_PACKETS, us/1000.0, NOF_PACKETS-nofRx, nofDup);
+}
+
+int main(void) {
+  unsigned long long us;
+  double pps, airPps, pollPps;
+
+  /* xTaskIncrementTick() needs a current task */
+  CHECK(xTaskCreate(RadioTask, "Radio", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+1, NULL)==pdPASS);
+  RNET1_Init();
+  airPps = 1e6/SIM_PACKET_US;
+  pollPps = 1e6/RADIO_TASK_PERIOD_US;
+
+  /* good link */
+  StartRun(0, 0);
+  us = RunRadioTask(NOF_PACKETS);
+  pps = NOF_PACKETS*1e6/(double)us;
+  CHECK(nofRx==NOF_PACKETS && nofDup==0);
+  CHECK(nofRx>0 && rxSeq[nofRx-1]==NOF_PACKETS-1);
+  CHECK(mockNrf.nofCeHigh<NOF_PACKETS/4); /* CE stays high while the TX FIFO is refilled, pulses only after it ran empty */
+  CHECK(pps>0.7*airPps);
+  (void)printf("good link: %u packets in %.1f ms, %.0f packets/s (air time bound %.0f, one per task period %.0f), %lu CE pulses\n",
+               nofRx, us/1000.0, pps, airPps, pollPps, mockNrf.nofCeHigh);
+
+  /* receiver absent for 5 ms every 50 ms: MAX_RT with packets behind the failed one in the TX FIFO, sent on retry */
+  RunAbsent(50000, 5000);
+  CHECK(nofRx==NOF_PACKETS);
+  /* absent for 60 ms every 200 ms: packets dropped after their retries */
+  RunAbsent(200000, 60000);
+  CHECK(nofRx<NOF_PACKETS);
+  return TestResult();
+}
@@ -0,0 +1,107 @@
+/*
+ * FreeRTOS POSIX port with the scheduler running: the tick interrupt runs in
+ * its own thread and stops the running task thread. Checked:
+ * - vTaskDelay() blocks for the number of ticks, and the tick count follows
+ *   the monotonic clock of the host.
+ * - the tick preempts tasks that never call the kernel: a higher priority
+ *   task wakes up from its delay, and two busy tasks of the same priority
+ *   share the processor (time slicing).
+ * - a semaphore given to a waiting higher priority task switches to it at
+ *   once.
+ * - deleting preempted busy tasks and a task deleting itself: the idle task
+ *   joins their threads, the number of tasks drops back.
+ * - vTaskEndScheduler() returns to main().
+ */
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "testutil.h"
+
+#define DELAY_TICKS   100
+
+static volatile unsigned long busyCount[2];
+static volatile int nofGiven, nofTaken;
+static SemaphoreHandle_t sem;
+
+static void BusyTask(void *pvParameters) {
+  volatile unsigned long *count = (volatile unsigned long*)pvParameters;
+
+  for(;;) {
+    (*count)++;
+  }
+}
+
+static void WaitTask(void *pvParameters) {
+  for(;;) {
+    if (xSemaphoreTake(sem, portMAX_DELAY)==pdTRUE) {
+      nofTaken++;
+    }
+  }
+}
+
+static void SelfDeleteTask(void *pvParameters) {
+  vTaskDelete(NULL);
+}
+
+static void MainTask(void *pvParameters) {
+  TaskHandle_t busy[2], wait;
+  TickType_t ticks;
+  unsigned long long ns;
+  unsigned long count[2];
+  UBaseType_t nofTasks;
+  int i;
+
+  nofTasks = uxTaskGetNumberOfTasks();
+
+  /* tick count and host time */
+  ns = TestTimeNs();
+  ticks = xTaskGetTickCount();
+  vTaskDelay(DELAY_TICKS);
+  ticks = xTaskGetTickCount()-ticks;
+  ns = TestTimeNs()-ns;
+  CHECK(ticks>=DELAY_TICKS && ticks<=DELAY_TICKS+1);
+  CHECK(ns>=(DELAY_TICKS-1)*portTICK_PERIOD_US*1000ULL && ns<5ULL*DELAY_TICKS*portTICK_PERIOD_US*1000ULL);
+  (void)printf("vTaskDelay(%u): %u ticks in %.1f ms\n", DELAY_TICKS, (unsigned)ticks, ns/1e6);
+
+  /* busy tasks below this task are preempted by the tick */
+  CHECK(xTaskCreate(BusyTask, "busy0", configMINIMAL_STACK_SIZE, (void*)&busyCount[0], tskIDLE_PRIORITY+1, &busy[0])==pdPASS);
+  CHECK(xTaskCreate(BusyTask, "busy1", configMINIMAL_STACK_SIZE, (void*)&busyCount[1], tskIDLE_PRIORITY+1, &busy[1])==pdPASS);
+  ticks = xTaskGetTickCount();
+  vTaskDelay(DELAY_TICKS);
+  CHECK(xTaskGetTickCount()-ticks>=DELAY_TICKS);
+  for(i=0;i<2;i++) {
+    count[i] = busyCount[i];
+    CHECK(count[i]>0);
+  }
+  (void)printf("time slicing: busy tasks counted to %lu and %lu\n", count[0], count[1]);
+
+  /* immediate switch to the task waiting on the semaphore */
+  CHECK(xTaskCreate(WaitTask, "wait", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+3, &wait)==pdPASS);
+  for(i=0;i<1000;i++) {
+    nofGiven++;
+    (void)xSemaphoreGive(sem);
+    CHECK(nofTaken==nofGiven);
+  }
+
+  /* delete the preempted tasks and a task deleting itself */
+  vTaskDelete(busy[0]);
+  vTaskDelete(busy[1]);
+  vTaskDelete(wait);
+  CHECK(xTaskCreate(SelfDeleteTask, "self", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+3, NULL)==pdPASS);
+  count[0] = busyCount[0];
+  vTaskDelay(10); /* the idle task cleans up */
+  CHECK(busyCount[0]==count[0]);
+  CHECK(uxTaskGetNumberOfTasks()==nofTasks);
+
+  vTaskEndScheduler();
+}
+
+int main(void) {
+  sem = xSemaphoreCreateBinary();
+  CHECK(sem!=NULL);
+  CHECK(xTaskCreate(MainTask, "main", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+2, NULL)==pdPASS);
+  vTaskStartScheduler();
+  (void)printf("scheduler ended after %u ticks\n", (unsigned)xTaskGetTickCount());
+  return TestResult();
+}
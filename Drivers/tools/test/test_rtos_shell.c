@@ -0,0 +1,101 @@
+/*
+ * Command line interface of the FreeRTOS component (FRTOS1_ParseCommand(),
+ * generated with the Shell CLS1 of host/mock_shell.h), without starting the
+ * scheduler. Checked:
+ * - help, status, heap, pools and the heaptrace commands are handled, return
+ *   ERR_OK and print their title, other commands are not handled.
+ * - status lists a created task, pools shows the blocks in use, heaptrace
+ *   log the last allocation.
+ * - heaptrace dump prints the blob of xHeapTraceReadBlob() as hex bytes.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "FRTOS1.h"
+#include "testutil.h"
+
+static char out[16384];
+static size_t outLen;
+
+static void StdOut(uint8_t ch) {
+  if (outLen<sizeof(out)-1) {
+    out[outLen++] = (char)ch;
+    out[outLen] = '\0';
+  }
+}
+
+static void StdIn(uint8_t *ch) {
+  *ch = '\0';
+}
+
+static bool KeyPressed(void) {
+  return FALSE;
+}
+
+static const CLS1_StdIOType io = {StdIn, StdOut, StdOut, KeyPressed};
+
+/* runs the command, returns TRUE if it is handled without error */
+static bool Command(const char *cmd) {
+  bool handled = FALSE;
+  byte res;
+
+  outLen = 0;
+  out[0] = '\0';
+  res = FRTOS1_ParseCommand((const unsigned char*)cmd, &handled, &io);
+  return handled && res==ERR_OK;
+}
+
+static void Task(void *param) {
+  (void)param;
+  for(;;) {
+    vTaskDelay(1);
+  }
+}
+
+/* hex bytes of the dump, as written by 'heaptrace dump' */
+static size_t DumpBytes(uint8_t *data, size_t size) {
+  const char *p = out;
+  unsigned int b;
+  int n;
+  size_t i = 0;
+
+  while (i<size && sscanf(p, "%2x%n", &b, &n)==1) {
+    data[i++] = (uint8_t)b;
+    p += n;
+  }
+  return i;
+}
+
+int main(void) {
+  static uint8_t blob[4096], dump[4096];
+  size_t blobSize, offset, n;
+  void *block;
+
+  CHECK(FRTOS1_xTaskCreate(Task, "ShellTask", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+1, NULL)==pdPASS);
+
+  CHECK(Command("help") && strstr(out, "FRTOS1")!=NULL);
+  CHECK(Command("FRTOS1 help") && strstr(out, "heaptrace")!=NULL);
+  CHECK(Command("status") && strstr(out, "ShellTask")!=NULL);
+  CHECK(Command("FRTOS1 status") && strstr(out, "TASK LIST")!=NULL);
+  CHECK(Command("FRTOS1 heap") && strstr(out, "Free blocks")!=NULL);
+
+  block = pvPortPoolMalloc(20);
+  CHECK(block!=NULL);
+  CHECK(Command("FRTOS1 pools") && strstr(out, "32 bytes, used 1/16")!=NULL);
+  CHECK(Command("FRTOS1 heaptrace") && strstr(out, "FRTOS1 heaptrace")!=NULL);
+  CHECK(Command("FRTOS1 heaptrace log") && strstr(out, "malloc 0x")!=NULL);
+  vPortPoolFree(block);
+  CHECK(Command("FRTOS1 pools") && strstr(out, "used 0/16, max 1")!=NULL);
+
+  blobSize = 0;
+  while ((n=xHeapTraceReadBlob(blobSize, blob+blobSize, sizeof(blob)-blobSize))!=0) {
+    blobSize += n;
+  }
+  CHECK(blobSize>0 && blobSize<sizeof(blob));
+  CHECK(Command("FRTOS1 heaptrace dump"));
+  offset = DumpBytes(dump, sizeof(dump));
+  CHECK(offset==blobSize && memcmp(blob, dump, blobSize)==0);
+
+  CHECK(!Command("FRTOS1 unknown") && outLen==0);
+  CHECK(!Command("FRTOS1") && outLen==0);
+  return TestResult();
+}
@@ -0,0 +1,272 @@
+/*
+ * Number scanners of the Utility component: UTIL1 converts character by
+ * character, UTIL2 has the settings of a Kinetis core and converts aligned
+ * words of four characters at once (CONFIG_SCAN_SWAR), UTIL0 is the Utility
+ * before ScanDigits() (UTIL_BASE in the Makefile). Random strings of
+ * digits, hex letters in both cases, spaces, signs, prefixes and the
+ * characters next to the digit ranges (also with the upper bit set) and
+ * edge cases are scanned at the offsets 0..7 of an aligned buffer. The edge
+ * cases: no digits, a bare sign or "0x", leading spaces and zeros, the
+ * limits of each type, one digit less and one more than the methods allow,
+ * and more than 255 digits for xatoi(). Checked:
+ * - UTIL1 and UTIL2 give the same error code, value and end pointer as
+ *   UTIL0 for xatoi() and all ScanDecimal and ScanHex methods.
+ * - the unsigned ScanDecimal and ScanHex methods give the same as a reference
+ *   built from their description.
+ * - nothing is read behind the word which holds the terminating zero: each
+ *   string is scanned once more with the zero as last byte before an
+ *   inaccessible page.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "UTIL0.h"
+#include "UTIL1.h"
+#include "UTIL2.h"
+#include "testutil.h"
+
+#define NOF_STRINGS   300000
+#define MAX_LEN       28
+#define MAX_EDGE_LEN  300
+
+typedef enum {
+  F_XATOI, F_DEC8U, F_DEC16U, F_DEC32U, F_DEC8S, F_DEC16S, F_DEC32S, F_HEX8U, F_HEX16U, F_HEX32U, F_HEX8U_NO_PREFIX, F_NOF
+} Func;
+
+typedef struct {
+  uint8_t res;
+  uint32_t val;           /* sign extended for the signed methods */
+  size_t end;             /* offset of the end pointer */
+} Result;
+
+/* pattern in the value before the call, shows which methods leave it as it is */
+#define VAL_UNCHANGED  0xA5A5A5A5u
+
+#define SCAN(mod, f, str, r) \
+  do { \
+    const unsigned char *p = (str); \
+    uint32_t u32 = VAL_UNCHANGED; uint16_t u16 = (uint16_t)VAL_UNCHANGED; uint8_t u8 = (uint8_t)VAL_UNCHANGED; \
+    int32_t s32 = (int32_t)VAL_UNCHANGED; int16_t s16 = (int16_t)VAL_UNCHANGED; signed char s8 = (signed char)VAL_UNCHANGED; \
+    switch (f) { \
+      case F_XATOI:           (r)->res = mod##_xatoi(&p, &s32); (r)->val = (uint32_t)s32; break; \
+      case F_DEC8U:           (r)->res = mod##_ScanDecimal8uNumber(&p, &u8); (r)->val = u8; break; \
+      case F_DEC16U:          (r)->res = mod##_ScanDecimal16uNumber(&p, &u16); (r)->val = u16; break; \
+      case F_DEC32U:          (r)->res = mod##_ScanDecimal32uNumber(&p, &u32); (r)->val = u32; break; \
+      case F_DEC8S:           (r)->res = mod##_ScanDecimal8sNumber(&p, &s8); (r)->val = (uint32_t)s8; break; \
+      case F_DEC16S:          (r)->res = mod##_ScanDecimal16sNumber(&p, &s16); (r)->val = (uint32_t)s16; break; \
+      case F_DEC32S:          (r)->res = mod##_ScanDecimal32sNumber(&p, &s32); (r)->val = (uint32_t)s32; break; \
+      case F_HEX8U:           (r)->res = mod##_ScanHex8uNumber(&p, &u8); (r)->val = u8; break; \
+      case F_HEX16U:          (r)->res = mod##_ScanHex16uNumber(&p, &u16); (r)->val = u16; break; \
+      case F_HEX32U:          (r)->res = mod##_ScanHex32uNumber(&p, &u32); (r)->val = u32; break; \
+      default:                (r)->res = mod##_ScanHex8uNumberNoPrefix(&p, &u8); (r)->val = u8; break; \
+    } \
+    (r)->end = (size_t)(p-(str)); \
+  } while(0)
+
+static bool Same(const Result *a, const Result *b) {
+  return a->res==b->res && a->val==b->val && a->end==b->end;
+}
+
+static int DigitValue(unsigned char c, bool isHex) {
+  if (c>='0' && c<='9') {
+    return c-'0';
+  }
+  if (isHex && (c|0x20)>='a' && (c|0x20)<='f') {
+    return (c|0x20)-'a'+10;
+  }
+  return -1;
+}
+
+/* unsigned ScanDecimal and ScanHex methods, from their description. Returns false for the other methods. */
+static bool Reference(Func f, const unsigned char *str, Result *r) {
+  static const struct { bool isHex, prefix; unsigned maxDigits; uint32_t mask; } desc[F_NOF] = {
+    [F_DEC8U]  = {false, false, 3, 0xFF}, [F_DEC16U] = {false, false, 5, 0xFFFF}, [F_DEC32U] = {false, false, 10, 0xFFFFFFFF},
+    [F_HEX8U]  = {true, true, 2, 0xFF},   [F_HEX16U] = {true, true, 4, 0xFFFF},   [F_HEX32U] = {true, true, 8, 0xFFFFFFFF},
+    [F_HEX8U_NO_PREFIX] = {true, false, 2, 0xFF},
+  };
+  const unsigned char *p = str;
+  uint32_t v = 0;
+  unsigned n = 0;
+
+  if (desc[f].maxDigits==0) {
+    return false;
+  }
+  r->end = 0;
+  r->val = VAL_UNCHANGED&desc[f].mask;
+  while (*p==' ') {
+    p++;
+  }
+  if (desc[f].prefix) {
+    if (p[0]!='0' || p[1]!='x') {
+      r->res = ERR_FAILED;
+      return true;
+    }
+    p += 2;
+  }
+  while (n<=desc[f].maxDigits && DigitValue(*p, desc[f].isHex)>=0) { /* stops after one digit too much */
+    v = v*(desc[f].isHex ? 16 : 10)+(uint32_t)DigitValue(*p, desc[f].isHex);
+    p++; n++;
+  }
+  r->val = v&desc[f].mask;
+  if (n>desc[f].maxDigits) {
+    r->res = ERR_OVERFLOW;
+  } else if (n==0 && !desc[f].isHex) {
+    r->res = ERR_FAILED;
+  } else {
+    r->res = ERR_OK;
+    r->end = (size_t)(p-str);
+  }
+  return true;
+}
+
+static unsigned RandomString(char *s) {
+  static const char others[] = " -.x/:@G`g\xAF\xB0\xB9\xBA\xC0\xC1\xC6\xE0\xE1\xE6\xE7";
+  static const char *prefixes[] = {"", "", " ", "  -", "0x", " 0x", "-0x", "0b", "0"};
+  unsigned len, i;
+  int c;
+
+  strcpy(s, prefixes[rand()%(int)(sizeof(prefixes)/sizeof(prefixes[0]))]);
+  len = (unsigned)strlen(s);
+  i = len+(unsigned)(rand()%(MAX_LEN-4));
+  while (len<i) {
+    c = rand()%20;
+    if (c<12) {
+      s[len] = (char)('0'+rand()%10);
+    } else if (c<16) {
+      s[len] = (char)((rand()%2 ? 'a' : 'A')+rand()%6);
+    } else {
+      s[len] = others[rand()%(int)(sizeof(others)-1)];
+    }
+    len++;
+  }
+  s[len] = '\0';
+  return len;
+}
+
+/* scans s at the offsets 0..7 of an aligned buffer, returns the number of results different from UTIL0 */
+static unsigned ScanBase(const char *s, unsigned long *nofScans) {
+  static uint32_t buf[(MAX_EDGE_LEN+16)/4];
+  size_t len = strlen(s);
+  unsigned offset, wrong = 0;
+  unsigned char *str;
+  Result r0, r1, r2;
+  Func f;
+
+  for(offset=0;offset<8;offset++) {
+    str = (unsigned char*)buf+offset;
+    memset(buf, '7', sizeof(buf));
+    memcpy(str, s, len+1);
+    for(f=F_XATOI;f<F_NOF;f++) {
+      SCAN(UTIL0, f, str, &r0);
+      SCAN(UTIL1, f, str, &r1);
+      SCAN(UTIL2, f, str, &r2);
+      (*nofScans)++;
+      if (!Same(&r1, &r0) || !Same(&r2, &r0)) {
+        wrong++;
+      }
+    }
+  }
+  return wrong;
+}
+
+/* edge cases against UTIL0, returns the number of different results */
+static unsigned CheckEdges(unsigned long *nofScans) {
+  static const char *limits[] = {
+    "", " ", "   ", "-", " -", "--1", "- 1", "0x", " 0x", "-0x", "0x ", "0x.", "0X1", "0x-1", "0b", "0b2", "x1",
+    "0", "-0", "00", "0 ", "0.", "0.5", "08", "0777", "0b101",
+    "127", "128", "-128", "-129", "255", "256", "32767", "32768", "-32768", "-32769", "65535", "65536",
+    "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296", "9999999999",
+    "0xff", "0xFF", "0x100", "0xffff", "0x10000", "0xffffffff", "0xFFFFFFFF", "0x100000000",
+    "1.2.3", "12:30", "1,2", "12a", "0x1g", "0xfg", "\xB0", "1\xB1",
+  };
+  static const char *leads[] = {"", " ", "    ", "-", " -"};
+  static const char *prefixes[] = {"", " ", "    ", "-", " -", "0", "0x", " 0x", "-0x", "00", "0x00"};
+  static const char *suffixes[] = {"", " ", ".", ",", "x", "g", "G", "\xB5"};
+  static const char digits[] = "019afF";
+  static const unsigned lengths[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 15, 16, 17, 31, 32, 33, 254, 255, 256, 257, 280};
+  char s[MAX_EDGE_LEN+1];
+  unsigned i, p, d, l, x, wrong = 0;
+  size_t n;
+
+  for(i=0;i<sizeof(limits)/sizeof(limits[0]);i++) {
+    for(p=0;p<sizeof(leads)/sizeof(leads[0]);p++) {
+      (void)snprintf(s, sizeof(s), "%s%s", leads[p], limits[i]);
+      wrong += ScanBase(s, nofScans);
+    }
+  }
+  for(p=0;p<sizeof(prefixes)/sizeof(prefixes[0]);p++) {
+    for(d=0;d<sizeof(digits)-1;d++) {
+      for(l=0;l<sizeof(lengths)/sizeof(lengths[0]);l++) {
+        for(x=0;x<sizeof(suffixes)/sizeof(suffixes[0]);x++) {
+          strcpy(s, prefixes[p]);                   /* prefix, lengths[l] times the digit, suffix */
+          n = strlen(s);
+          memset(s+n, digits[d], lengths[l]);
+          strcpy(s+n+lengths[l], suffixes[x]);
+          wrong += ScanBase(s, nofScans);
+        }
+      }
+    }
+  }
+  return wrong;
+}
+
+int main(void) {
+  static uint32_t buf[(MAX_LEN+16)/4];   /* aligned */
+  char s[MAX_LEN+1];
+  unsigned char *str, *pageEnd;
+  size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+  unsigned i, len, offset, wrong = 0, wrongRef = 0, wrongPageEnd = 0, wrongEdges;
+  unsigned long nofScans = 0, nofRefs = 0, nofEdgeScans = 0;
+  Result r0, r1, r2, ref;
+  Func f;
+
+  pageEnd = mmap(NULL, 2*pageSize, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  CHECK(pageEnd!=MAP_FAILED);
+  CHECK(mprotect(pageEnd+pageSize, pageSize, PROT_NONE)==0);
+  pageEnd += pageSize;
+
+  srand(1);
+  for(i=0;i<NOF_STRINGS;i++) {
+    len = RandomString(s);
+    for(offset=0;offset<8;offset++) {
+      str = (unsigned char*)buf+offset;
+      memset(buf, '7', sizeof(buf));    /* digits behind the terminating zero */
+      memcpy(str, s, len+1);
+      for(f=F_XATOI;f<F_NOF;f++) {
+        SCAN(UTIL0, f, str, &r0);
+        SCAN(UTIL1, f, str, &r1);
+        SCAN(UTIL2, f, str, &r2);
+        nofScans++;
+        if (!Same(&r1, &r0) || !Same(&r2, &r0)) {
+          wrong++;
+        }
+        if (Reference(f, str, &ref)) {
+          nofRefs++;
+          if (!Same(&r2, &ref)) {
+            wrongRef++;
+          }
+        }
+      }
+    }
+    str = pageEnd-len-1;                /* zero in the last byte before the inaccessible page */
+    memcpy(str, s, len+1);
+    for(f=F_XATOI;f<F_NOF;f++) {
+      SCAN(UTIL2, f, str, &r2);
+      SCAN(UTIL1, f, str, &r1);
+      if (!Same(&r1, &r2)) {
+        wrongPageEnd++;
+      }
+    }
+  }
+  wrongEdges = CheckEdges(&nofEdgeScans);
+  CHECK(wrong==0);
+  CHECK(wrongRef==0);
+  CHECK(wrongPageEnd==0);
+  CHECK(wrongEdges==0);
+  (void)printf("%u strings at offsets 0..7, %lu scans with %u different from UTIL0, %lu against the reference with %u wrong\n",
+    NOF_STRINGS, nofScans, wrong, nofRefs, wrongRef);
+  (void)printf("edge cases: %lu scans with %u different from UTIL0\n", nofEdgeScans, wrongEdges);
+  return TestResult();
+}
@@ -0,0 +1,170 @@
+/*
+ * String builder of the Utility component UTIL1 compared with the strcat
+ * family. Random lines of 1..16 appends (strings, chars, signed and unsigned
+ * numbers, formatted with ' ' and '0' fill, hex with 2..8 digits and fixed
+ * point with 0..9 fraction digits) are built both ways. Checked:
+ * - the same string for every buffer size from 1 to beyond the line length,
+ *   and the truncated flag set exactly when the line did not fit.
+ * - no write behind the buffer.
+ * The deliberate differences to the strcat family are built with snprintf():
+ * the sign before '0' fill characters, -0.xx for small negative fixed point
+ * numbers and fraction digits other than two.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "UTIL1.h"
+#include "testutil.h"
+
+#define NOF_LINES     3000
+#define MAX_APPENDS   16
+#define LINE_SIZE     400
+
+typedef enum {
+  OP_STR, OP_CHAR, OP_NUM_U, OP_NUM_S, OP_NUM_U_FMT, OP_NUM_S_FMT, OP_HEX, OP_FIXED, OP_NOF
+} Op;
+
+typedef struct {
+  Op op;
+  int32_t val;
+  char fill;
+  uint8_t n;             /* nofFill, hex digits or fraction digits */
+} Append;
+
+static const char *words[] = {"", "ch ", ", rssi ", " dBm", "addr 0x", "a longer string with some words "};
+
+static void Build(UTIL1_StrBuilder *sb, const Append *a) {
+  switch (a->op) {
+    case OP_STR:       UTIL1_StrBuildStr(sb, (const unsigned char*)words[a->val]); break;
+    case OP_CHAR:      UTIL1_StrBuildChar(sb, (unsigned char)a->val); break;
+    case OP_NUM_U:     UTIL1_StrBuildNum32u(sb, (uint32_t)a->val); break;
+    case OP_NUM_S:     UTIL1_StrBuildNum32s(sb, a->val); break;
+    case OP_NUM_U_FMT: UTIL1_StrBuildNum32uFormatted(sb, (uint32_t)a->val, a->fill, a->n); break;
+    case OP_NUM_S_FMT: UTIL1_StrBuildNum32sFormatted(sb, a->val, a->fill, a->n); break;
+    case OP_HEX:       UTIL1_StrBuildHex(sb, (uint32_t)a->val, a->n); break;
+    default:           UTIL1_StrBuildFixed(sb, a->val, a->n); break;
+  }
+}
+
+/* fixed point number as text, with integer arithmetic */
+static void FixedToStr(char *buf, size_t size, int32_t val, unsigned nofFrac) {
+  uint32_t v = val<0 ? (uint32_t)0-(uint32_t)val : (uint32_t)val, scale = 1;
+  unsigned i;
+
+  for(i=0;i<nofFrac;i++) {
+    scale *= 10;
+  }
+  if (nofFrac==0) {
+    (void)snprintf(buf, size, "%s%lu", val<0 ? "-" : "", (unsigned long)v);
+  } else {
+    (void)snprintf(buf, size, "%s%lu.%0*lu", val<0 ? "-" : "", (unsigned long)(v/scale), (int)nofFrac, (unsigned long)(v%scale));
+  }
+}
+
+static void Reference(uint8_t *dst, size_t size, const Append *a) {
+  char buf[300];
+
+  switch (a->op) {
+    case OP_STR:       UTIL1_strcat(dst, size, (const unsigned char*)words[a->val]); break;
+    case OP_CHAR:      buf[0] = (char)a->val; buf[1] = '\0'; UTIL1_strcat(dst, size, (unsigned char*)buf); break;
+    case OP_NUM_U:     UTIL1_strcatNum32u(dst, size, (uint32_t)a->val); break;
+    case OP_NUM_S:     UTIL1_strcatNum32s(dst, size, a->val); break;
+    case OP_NUM_U_FMT: UTIL1_strcatNum32uFormatted(dst, size, (uint32_t)a->val, a->fill, a->n); break;
+    case OP_NUM_S_FMT:
+      if (a->fill=='0' && a->val<0) { /* sign before the fill characters */
+        (void)snprintf(buf, sizeof(buf), "%0*ld", a->n, (long)a->val);
+        UTIL1_strcat(dst, size, (unsigned char*)buf);
+      } else {
+        UTIL1_strcatNum32sFormatted(dst, size, a->val, a->fill, a->n);
+      }
+      break;
+    case OP_HEX:
+      switch (a->n) {
+        case 2:  UTIL1_strcatNum8Hex(dst, size, (uint8_t)a->val); break;
+        case 4:  UTIL1_strcatNum16Hex(dst, size, (uint16_t)a->val); break;
+        case 6:  UTIL1_strcatNum24Hex(dst, size, (uint32_t)a->val); break;
+        default: UTIL1_strcatNum32Hex(dst, size, (uint32_t)a->val); break;
+      }
+      break;
+    default:
+      if (a->n==2 && (a->val>=0 || a->val<=-100)) {
+        UTIL1_strcatNum32sDotValue100(dst, size, a->val);
+      } else { /* keeps the sign of -0.xx */
+        FixedToStr(buf, sizeof(buf), a->val, a->n);
+        UTIL1_strcat(dst, size, (unsigned char*)buf);
+      }
+      break;
+  }
+}
+
+static int32_t RandomValue(void) {
+  uint32_t v = ((uint32_t)rand()<<16)^(uint32_t)rand();
+
+  return (int32_t)(v>>(rand()%32));   /* all magnitudes */
+}
+
+static void RandomAppend(Append *a) {
+  a->op = (Op)(rand()%OP_NOF);
+  a->val = RandomValue();
+  if (rand()%2) {
+    a->val = (int32_t)((uint32_t)0-(uint32_t)a->val);
+  }
+  a->fill = rand()%2 ? ' ' : '0';
+  a->n = (uint8_t)(rand()%11);           /* the strcat family has room for 10 characters */
+  switch (a->op) {
+    case OP_STR:  a->val = rand()%(int)(sizeof(words)/sizeof(words[0])); break;
+    case OP_CHAR: a->val = 'A'+rand()%26; break;
+    case OP_HEX:  a->n = (uint8_t)(2+2*(rand()%4)); break;
+    case OP_FIXED:
+      a->n = (uint8_t)(rand()%10);
+      if (rand()%4==0) {
+        a->val %= 100;                  /* integer part 0 */
+      }
+      break;
+    default: break;
+  }
+}
+
+int main(void) {
+  Append line[MAX_APPENDS];
+  uint8_t ref[LINE_SIZE], buf[LINE_SIZE+8];
+  UTIL1_StrBuilder sb;
+  unsigned i, j, nofAppends, wrong = 0, wrongFlag = 0, overflow = 0;
+  unsigned long nofBuilds = 0;
+  size_t size, len;
+
+  srand(1);
+  for(i=0;i<NOF_LINES;i++) {
+    nofAppends = 1+(unsigned)rand()%MAX_APPENDS;
+    for(j=0;j<nofAppends;j++) {
+      RandomAppend(&line[j]);
+    }
+    ref[0] = '\0';
+    for(j=0;j<nofAppends;j++) {
+      Reference(ref, sizeof(ref), &line[j]);
+    }
+    len = strlen((char*)ref);
+    for(size=1;size<=len+2;size++) {
+      memset(buf, '#', sizeof(buf));
+      UTIL1_StrBuildInit(&sb, buf, size);
+      for(j=0;j<nofAppends;j++) {
+        Build(&sb, &line[j]);
+      }
+      nofBuilds++;
+      if (strlen((char*)buf)!=sb.len || strncmp((char*)buf, (char*)ref, size-1)!=0 || sb.len!=(len<size ? len : size-1)) {
+        wrong++;
+      }
+      if (sb.truncated!=(len>=size)) {
+        wrongFlag++;
+      }
+      if (buf[size]!='#') {
+        overflow++;
+      }
+    }
+  }
+  CHECK(wrong==0);
+  CHECK(wrongFlag==0);
+  CHECK(overflow==0);
+  (void)printf("%u lines, %lu builds for all buffer sizes, %u wrong\n", NOF_LINES, nofBuilds, wrong);
+  return TestResult();
+}
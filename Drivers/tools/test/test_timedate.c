@@ -0,0 +1,145 @@
+/*
+ * GenericTimeDate TmDt1 with a tick of 10 ms, compared with gmtime() of the C
+ * library. Checked:
+ * - random times from 1998 to 2099 set with SetEpochSec() and AddTicks():
+ *   GetDate(), GetTime(), GetEpochSec() and GetEpochMs().
+ * - the same times set with SetDate() and SetTime(), in both orders, give the
+ *   same seconds since 1970. SetDate() keeps the time of day and SetTime()
+ *   keeps the date.
+ * - AddTick() and AddTicks() across the day, month and year rollovers, also
+ *   at the end of February in leap and common years.
+ * - SetDate() and SetTime() reject invalid values and keep the time.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Cpu.h"   /* TIMEREC and DATEREC come before the include of Cpu.h in TmDt1.h */
+#include "TmDt1.h"
+#include "testutil.h"
+
+#define NOF_TIMES     2000000
+#define NOF_ROLLOVERS 3000
+#define TICKS_PER_S   100
+
+#define SEC_1998      883612800UL    /* 1998-01-01 00:00:00 */
+#define SEC_2100      4102444800UL   /* 2100-01-01 00:00:00 */
+
+static uint32_t RandomSec(uint32_t from, uint32_t to) {
+  uint32_t r = ((uint32_t)rand()<<16)^(uint32_t)rand();
+
+  return from+r%(to-from);
+}
+
+/* compares the component with gmtime() of sec and ticks, returns true if all is the same */
+static bool SameAs(uint32_t sec, unsigned ticks) {
+  time_t t = (time_t)sec;
+  struct tm tm;
+  DATEREC date;
+  TIMEREC time;
+
+  (void)gmtime_r(&t, &tm);
+  if (TmDt1_GetDate(&date)!=ERR_OK || TmDt1_GetTime(&time)!=ERR_OK) {
+    return false;
+  }
+  return date.Year==tm.tm_year+1900 && date.Month==tm.tm_mon+1 && date.Day==tm.tm_mday
+      && time.Hour==tm.tm_hour && time.Min==tm.tm_min && time.Sec==tm.tm_sec && time.Sec100==ticks
+      && TmDt1_GetEpochSec()==sec && TmDt1_GetEpochMs()==(uint64_t)sec*1000U+ticks*10U;
+}
+
+/* last second of a random month, or of February */
+static uint32_t EndOfMonth(void) {
+  struct tm tm = {0};
+
+  tm.tm_year = 98+rand()%102;
+  tm.tm_mon = rand()%3==0 ? 2 : rand()%12+1;        /* the first of the next month */
+  if (tm.tm_mon==12) {
+    tm.tm_mon = 0;
+    tm.tm_year++;
+  }
+  tm.tm_mday = 1;
+  return (uint32_t)timegm(&tm)-1;
+}
+
+int main(void) {
+  DATEREC date;
+  TIMEREC time;
+  struct tm tm;
+  time_t t;
+  uint32_t sec, i, n;
+  unsigned ticks, wrong = 0, wrongSet = 0, wrongTick = 0, nofDays = 0;
+
+  TmDt1_Init();
+  srand(1);
+  for(i=0;i<NOF_TIMES;i++) {
+    sec = RandomSec(SEC_1998, SEC_2100);
+    ticks = (unsigned)rand()%TICKS_PER_S;
+    TmDt1_SetEpochSec(sec);
+    TmDt1_AddTicks((uint16_t)ticks);
+    if (!SameAs(sec, ticks)) {
+      wrong++;
+    }
+    t = (time_t)sec;
+    (void)gmtime_r(&t, &tm);
+    TmDt1_SetEpochSec(RandomSec(SEC_1998, SEC_2100));
+    if (i&1) {
+      (void)TmDt1_SetDate((uint16_t)(tm.tm_year+1900), (uint8_t)(tm.tm_mon+1), (uint8_t)tm.tm_mday);
+      (void)TmDt1_SetTime((uint8_t)tm.tm_hour, (uint8_t)tm.tm_min, (uint8_t)tm.tm_sec, (uint8_t)ticks);
+    } else {
+      (void)TmDt1_SetTime((uint8_t)tm.tm_hour, (uint8_t)tm.tm_min, (uint8_t)tm.tm_sec, (uint8_t)ticks);
+      (void)TmDt1_SetDate((uint16_t)(tm.tm_year+1900), (uint8_t)(tm.tm_mon+1), (uint8_t)tm.tm_mday);
+    }
+    if (!SameAs(sec, ticks)) {
+      wrongSet++;
+    }
+  }
+  CHECK(wrong==0);
+  CHECK(wrongSet==0);
+
+  for(i=0;i<NOF_ROLLOVERS;i++) {
+    sec = EndOfMonth()-(uint32_t)(rand()%3);
+    ticks = (unsigned)rand()%TICKS_PER_S;
+    TmDt1_SetEpochSec(sec);
+    TmDt1_AddTicks((uint16_t)ticks);
+    nofDays += SameAs(sec, ticks);             /* date of the old day in the cache */
+    for(n=0;n<5*TICKS_PER_S;n++) {
+      TmDt1_AddTick();
+      if (++ticks==TICKS_PER_S) {
+        ticks = 0;
+        sec++;
+      }
+      if (!SameAs(sec, ticks)) {
+        wrongTick++;
+      }
+    }
+    n = (uint32_t)rand()%65536;                 /* up to 11 minutes at once */
+    TmDt1_AddTicks((uint16_t)n);
+    ticks += n;
+    sec += ticks/TICKS_PER_S;
+    ticks %= TICKS_PER_S;
+    if (!SameAs(sec, ticks)) {
+      wrongTick++;
+    }
+  }
+  CHECK(nofDays==NOF_ROLLOVERS);
+  CHECK(wrongTick==0);
+
+  /* invalid values leave the time as it is */
+  sec = SEC_1998+59*86400UL+3600;               /* 1998-03-01 01:00:00 */
+  TmDt1_SetEpochSec(sec);
+  CHECK(TmDt1_SetDate(2001, 2, 29)==ERR_RANGE);
+  CHECK(TmDt1_SetDate(1997, 12, 31)==ERR_RANGE);
+  CHECK(TmDt1_SetDate(2100, 1, 1)==ERR_RANGE);
+  CHECK(TmDt1_SetDate(2000, 13, 1)==ERR_RANGE);
+  CHECK(TmDt1_SetDate(2000, 4, 31)==ERR_RANGE);
+  CHECK(TmDt1_SetTime(24, 0, 0, 0)==ERR_RANGE);
+  CHECK(TmDt1_SetTime(0, 60, 0, 0)==ERR_RANGE);
+  CHECK(TmDt1_SetTime(0, 0, 60, 0)==ERR_RANGE);
+  CHECK(TmDt1_SetTime(0, 0, 0, 100)==ERR_RANGE);
+  CHECK(SameAs(sec, 0));
+  CHECK(TmDt1_SetDate(2000, 2, 29)==ERR_OK);
+  CHECK(TmDt1_GetDate(&date)==ERR_OK && date.Year==2000 && date.Month==2 && date.Day==29);
+  CHECK(TmDt1_GetTime(&time)==ERR_OK && time.Hour==1 && time.Min==0 && time.Sec==0);
+
+  (void)printf("%u random times, %u rollovers, %u wrong\n", NOF_TIMES, NOF_ROLLOVERS, wrong+wrongSet+wrongTick);
+  return TestResult();
+}
@@ -0,0 +1,165 @@
+/*
+ * TouchScreenSensor TS1 (12 bit A/D converter, bursts of 5 conversions, IIR
+ * filter with 1/4) and TouchScreen TSC1 on the panel model of
+ * host/mock_touch.c. Checked:
+ * - a clean panel gives the position of the pen, no touch gives FALSE. All
+ *   conversions are done while owning the A/D converter.
+ * - a noisy panel (+-8 counts, 20% of the conversions are spikes to one of
+ *   two levels) with touches of 10 readings each: no reading is further off
+ *   than the noise band (2*SAMPLE_MARGIN) and the noise, and less than 1% of
+ *   the touched readings are dropped. Printed: the conversions per reading
+ *   and the dropped readings.
+ * - GetPosition() in all display orientations, for random calibrations down
+ *   to 0.1 sensor bits per pixel and offsets up to 65535, against the
+ *   calibration formula computed with 64 bits: at most one pixel apart.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "TS1.h"
+#include "TSC1.h"
+#include "testutil.h"
+
+#define NOF_CLEAN       10000
+#define NOF_TOUCHES     20000
+#define TOUCH_READINGS  10
+#define NOF_MAPPINGS    1000000
+#define NOISE           8
+#define MAX_OFF         (2*TS1_SAMPLE_MARGIN+NOISE)
+
+/* same layout as the calibration data of TSC1 */
+typedef struct {
+  bool ScreenCalibrated;
+  TS1_TouchSensorValue TouchScreenXoffset;
+  TS1_TouchSensorValue TouchScreenYoffset;
+  word TouchScreenXBitsPerPixelx10;
+  word TouchScreenYBitsPerPixelx10;
+} Calib;
+
+static uint16_t RandomPos(void) {
+  return (uint16_t)(TS1_TOUCH_MIN+50+rand()%(TS1_TOUCH_MAX-TS1_TOUCH_MIN-100));
+}
+
+/* pixel of a sensor value with the calibration, before the orientation is applied */
+static long RefPixel(long val, long offset, long bitsPerPixelx10, long side) {
+  long long p;
+
+  if (val<offset) {
+    return 0;
+  }
+  p = (long long)(val-offset)*10/bitsPerPixelx10;
+  return p>side ? side : (long)p;
+}
+
+static void RefPosition(const Calib *c, long xVal, long yVal, long *x, long *y) {
+  long px = RefPixel(xVal, c->TouchScreenXoffset, c->TouchScreenXBitsPerPixelx10, MOCK_TOUCH_LCD_LONGER);
+  long py = RefPixel(yVal, c->TouchScreenYoffset, c->TouchScreenYBitsPerPixelx10, MOCK_TOUCH_LCD_SHORTER);
+
+  switch(mockTouch.orientation) {
+    case LCD1_ORIENTATION_PORTRAIT:
+      *x = py; *y = MOCK_TOUCH_LCD_LONGER-px;
+      break;
+    case LCD1_ORIENTATION_PORTRAIT180:
+      *x = MOCK_TOUCH_LCD_SHORTER-py; *y = px;
+      break;
+    case LCD1_ORIENTATION_LANDSCAPE:
+      *x = MOCK_TOUCH_LCD_LONGER-px; *y = MOCK_TOUCH_LCD_SHORTER-py;
+      break;
+    default:
+      *x = px; *y = py;
+      break;
+  }
+}
+
+/* sensor bits per pixel x10 from 1 to 1000, most of them around 100 */
+static word RandomBitsPerPixel(void) {
+  return (word)(rand()%4==0 ? 1+rand()%1000 : 80+rand()%40);
+}
+
+/* offset from 0 to 65535, most of them around 500 */
+static word RandomOffset(void) {
+  return (word)(rand()%4==0 ? rand()%65536 : 300+rand()%400);
+}
+
+int main(void) {
+  TS1_TouchSensorValue x, y;
+  TSC1_PixelDim px, py;
+  Calib calib;
+  long rx, ry;
+  unsigned i, n, wrong = 0, nofOff = 0, nofDropped = 0, nofIdentical = 0, nofWrongMap = 0;
+  unsigned long nofConversions;
+
+  TS1_Init();
+  srand(1);
+  for(i=0;i<NOF_CLEAN;i++) {
+    mockTouch.touched = TRUE;
+    mockTouch.x = RandomPos();
+    mockTouch.y = RandomPos();
+    if (!TS1_GetPositionRaw(&x, &y) || x!=mockTouch.x || y!=mockTouch.y) {
+      wrong++;
+    }
+    mockTouch.touched = FALSE;
+    if (TS1_GetPositionRaw(&x, &y)) {
+      wrong++;
+    }
+  }
+  CHECK(wrong==0);
+  CHECK(mockTouch.nofNotOwned==0 && mockTouch.adOwner==0);
+
+  mockTouch.noise = NOISE;
+  mockTouch.spikePercent = 20;
+  mockTouch.nofConversions = 0;
+  for(i=0;i<NOF_TOUCHES;i++) {
+    mockTouch.touched = TRUE;
+    mockTouch.x = RandomPos();
+    mockTouch.y = RandomPos();
+    for(n=0;n<TOUCH_READINGS;n++) {
+      if (!TS1_GetPositionRaw(&x, &y)) {
+        nofDropped++;
+      } else if (abs((int)x-mockTouch.x)>MAX_OFF || abs((int)y-mockTouch.y)>MAX_OFF) {
+        nofOff++;
+      }
+    }
+    mockTouch.touched = FALSE;
+    (void)TS1_GetPositionRaw(&x, &y);
+  }
+  nofConversions = mockTouch.nofConversions;
+  CHECK(nofOff==0);
+  CHECK(nofDropped<NOF_TOUCHES*TOUCH_READINGS/100);
+  CHECK(mockTouch.nofNotOwned==0 && mockTouch.adOwner==0);
+  (void)printf("noisy panel: %u readings, %.1f conversions per reading, %u dropped, %u off by more than %d counts\n",
+    NOF_TOUCHES*TOUCH_READINGS, (double)nofConversions/(NOF_TOUCHES*(TOUCH_READINGS+1)), nofDropped, nofOff, MAX_OFF);
+
+  mockTouch.noise = 0;
+  mockTouch.spikePercent = 0;
+  CHECK(!TSC1_isCalibrated());
+  for(i=0;i<NOF_MAPPINGS;i++) {
+    if (i%100==0) {                                   /* new calibration */
+      calib.ScreenCalibrated = TRUE;
+      calib.TouchScreenXoffset = RandomOffset();
+      calib.TouchScreenYoffset = RandomOffset();
+      calib.TouchScreenXBitsPerPixelx10 = RandomBitsPerPixel();
+      calib.TouchScreenYBitsPerPixelx10 = RandomBitsPerPixel();
+      TSC1_SetCalibrationData((byte*)&calib, sizeof(calib));
+    }
+    mockTouch.orientation = (LCD1_DisplayOrientation)(rand()%4);
+    mockTouch.x = RandomPos();
+    mockTouch.y = RandomPos();
+    mockTouch.touched = TRUE;
+    if (!TSC1_GetPosition(&px, &py)) {
+      nofWrongMap++;
+      continue;
+    }
+    mockTouch.touched = FALSE;                        /* restarts the filter */
+    CHECK(!TSC1_GetPosition(&px, &py));
+    RefPosition(&calib, mockTouch.x, mockTouch.y, &rx, &ry);
+    if (labs(px-rx)>1 || labs(py-ry)>1) {
+      nofWrongMap++;
+    }
+    nofIdentical += px==rx && py==ry;
+  }
+  CHECK(TSC1_isCalibrated());
+  CHECK(nofWrongMap==0);
+  (void)printf("GetPosition(): %u positions, %.1f%% identical, %u more than one pixel apart\n",
+    NOF_MAPPINGS, 100.0*nofIdentical/NOF_MAPPINGS, nofWrongMap);
+  return TestResult();
+}
@@ -0,0 +1,266 @@
+/*
+ * Streaming of the Percepio trace recorder PTRC1 (trcStreaming.c, with the
+ * settings in trace.props: ring buffer of 301 records, pages of 32 records)
+ * on the FreeRTOS POSIX port with the scheduler running. A task writes user
+ * events of 2 and 4 records ("%d" and "%d %d %d") with a running number, the
+ * stream is decoded. Checked, for the memory sink and for an asynchronous
+ * sink releasing the data later from another task:
+ * - the blocks have the magic and consecutive sequence numbers, the last one
+ *   is the RecorderData block, with the format strings of the events in its
+ *   symbol table. A second capture starts again with sequence 0.
+ * - with the task pausing every few events: all numbers arrive in order,
+ *   although the odd buffer size makes the user events wrap early. Only the
+ *   events still in the ring buffer when a burst starts can be dropped.
+ * - with a burst faster than the streaming: events are dropped, the numbers
+ *   arriving still increase and each gap is in a block marked with a
+ *   discontinuity. The streamed and the dropped records add up to the
+ *   records written by the recorder.
+ * - the asynchronous sink: no data is changed before it is released, and
+ *   vTraceStreamStop() waits for the releases.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "trcUser.h"
+#include "trcStreaming.h"
+#include "testutil.h"
+
+#define NOF_PAUSED       2000    /* events written 4 per tick, before the burst */
+#define NOF_BURST        3000    /* events written without pause */
+#define NOF_AFTER        400     /* events written 4 per tick, after the burst */
+#define EVENTS_PER_TICK  4
+#define NOF_TRANSFERS    4       /* two pages, the RecorderData header and data */
+#define TRANSFER_SIZE    8192
+
+typedef struct {
+  uint32_t nofBlocks;            /* blocks decoded */
+  uint32_t nofRecords;           /* event records streamed */
+  uint32_t dropped;              /* dropped records of the last block */
+  uint32_t nofValues;            /* numbers received */
+  uint32_t nofGaps;              /* numbers missing after a discontinuity */
+  uint32_t nofBad;               /* wrong blocks, records or numbers */
+  int32_t firstGap, lastGap;     /* numbers after the first and the last gap */
+  int32_t last;                  /* last number received */
+  uint16_t format[2];            /* symbols of "%d" and "%d %d %d" */
+  BaseType_t recorderData;       /* the last block is the RecorderData */
+} Decoded;
+
+typedef struct {
+  const uint8_t *data;
+  uint32_t size;
+  BaseType_t busy;
+  uint8_t copy[TRANSFER_SIZE];
+} Transfer;
+
+static uint8_t stream[256*1024];
+static RecorderDataType recorderData;
+static Transfer transfers[NOF_TRANSFERS];
+static QueueHandle_t transferQueue;
+static volatile uint32_t nofChanged, nofNoTransfer;
+static int32_t number;
+
+/* sink queuing the data for the transfer task, like a DMA transfer */
+static int AsyncSink(const uint8_t *data, uint32_t size) {
+  Transfer *t;
+  uint8_t i;
+
+  for(i=0;i<NOF_TRANSFERS && transfers[i].busy;i++) {
+  }
+  if (i==NOF_TRANSFERS || size>TRANSFER_SIZE) {
+    nofNoTransfer++;
+    return -1;
+  }
+  t = &transfers[i];
+  t->busy = pdTRUE;
+  t->data = data;
+  t->size = size;
+  (void)memcpy(t->copy, data, size);
+  (void)xQueueSendToBack(transferQueue, &i, portMAX_DELAY);
+  return TRACE_STREAM_SINK_PENDING;
+}
+
+/* completes the transfers a tick later: the data still has to be unchanged */
+static void TransferTask(void *pvParameters) {
+  Transfer *t;
+  uint8_t i;
+
+  for(;;) {
+    (void)xQueueReceive(transferQueue, &i, portMAX_DELAY);
+    t = &transfers[i];
+    vTaskDelay(1);
+    if (memcmp(t->data, t->copy, t->size)!=0) {
+      nofChanged++;
+    }
+    (void)xTraceStreamMemorySink(t->data, t->size);
+    t->busy = pdFALSE;
+    vTraceStreamBlockDone(t->data);
+  }
+}
+
+static void Number(Decoded *d, int32_t val, BaseType_t *discontinuity) {
+  if (val==d->last+1) {
+    /* in order */
+  } else if (val>d->last+1 && *discontinuity) {
+    d->nofGaps += (uint32_t)(val-d->last-1);
+    if (d->firstGap<0) {
+      d->firstGap = val;
+    }
+    d->lastGap = val;
+  } else {
+    d->nofBad++;
+  }
+  d->last = val;
+  d->nofValues++;
+  *discontinuity = pdFALSE;
+}
+
+/* a user event of 2 or 4 records */
+static void DecodeUserEvent(Decoded *d, const uint8_t *ev, uint32_t nofSlots, BaseType_t *discontinuity) {
+  const UserEvent *ue = (const UserEvent*)ev;
+  int32_t val[3];
+  uint32_t f = nofSlots==2 ? 0 : 1;
+
+  if (nofSlots!=2 && nofSlots!=4) {
+    d->nofBad++;
+    return;
+  }
+  if (d->format[f]==0) {
+    d->format[f] = ue->payload;
+  } else if (d->format[f]!=ue->payload) {
+    d->nofBad++;
+  }
+  (void)memcpy(val, ev+4, (nofSlots-1)*4);
+  if (nofSlots==4 && (val[1]!=-val[0] || val[2]!=val[0])) {
+    d->nofBad++;
+  }
+  Number(d, val[0], discontinuity);
+}
+
+static void Decode(const uint8_t *buf, uint32_t size, int32_t first, Decoded *d) {
+  TraceStreamBlockHeader h;
+  uint8_t ev[16*4], type;
+  uint32_t pos = 0, i, evFill = 0, evSlots = 0;
+  BaseType_t discontinuity = pdFALSE;
+
+  (void)memset(d, 0, sizeof(*d));
+  d->last = first-1;
+  d->firstGap = d->lastGap = -1;
+  while (pos+sizeof(h)<=size) {
+    (void)memcpy(&h, buf+pos, sizeof(h));
+    pos += sizeof(h);
+    if (h.magic!=TRACE_STREAM_MAGIC || h.sequence!=d->nofBlocks || h.size>size-pos || d->recorderData) {
+      d->nofBad++;
+      return;
+    }
+    d->nofBlocks++;
+    d->dropped = h.droppedEvents;
+    if (h.flags&TRACE_STREAM_FLAG_DISCONTINUITY) {
+      evFill = 0;                                     /* the rest of the event is lost */
+      discontinuity = pdTRUE;
+    }
+    if (h.type==TRACE_STREAM_BLOCK_EVENTS) {
+      for(i=0;i<h.size;i+=4) {
+        d->nofRecords++;
+        if (evFill>0) {                               /* data of a user event */
+          (void)memcpy(&ev[evFill*4], buf+pos+i, 4);
+          if (++evFill==evSlots) {
+            DecodeUserEvent(d, ev, evSlots, &discontinuity);
+            evFill = 0;
+          }
+          continue;
+        }
+        type = buf[pos+i];
+        if (type>USER_EVENT && type<USER_EVENT+16) {
+          (void)memcpy(ev, buf+pos+i, 4);
+          evSlots = 1u+type-USER_EVENT;
+          evFill = 1;
+        } else if (type==USER_EVENT || type==EVENT_BEING_WRITTEN) {
+          d->nofBad++;
+        }
+      }
+    } else if (h.type==TRACE_STREAM_BLOCK_RECORDER_DATA && h.size==sizeof(recorderData)) {
+      (void)memcpy(&recorderData, buf+pos, sizeof(recorderData));
+      d->recorderData = pdTRUE;
+    } else {
+      d->nofBad++;
+    }
+    pos += h.size;
+  }
+  if (pos!=size) {
+    d->nofBad++;
+  }
+}
+
+static void Events(traceLabel label, int32_t n, BaseType_t pause) {
+  int32_t i;
+
+  for(i=0;i<n;i++) {
+    if (number%3==0) {
+      vTracePrintF(label, "%d %d %d", number, -number, number);
+    } else {
+      vTracePrintF(label, "%d", number);
+    }
+    number++;
+    if (pause && i%EVENTS_PER_TICK==EVENTS_PER_TICK-1) {
+      vTaskDelay(1);
+    }
+  }
+}
+
+static void Capture(traceLabel label, TraceStreamSink sink, const char *name) {
+  int32_t first, afterPaused, afterBurst;
+  Decoded d;
+
+  vTraceClear();
+  CHECK(uiTraceStart()==1);
+  vTraceStreamSetMemory(stream, sizeof(stream));
+  vTraceStreamSetSink(sink);
+  CHECK(uiTraceStreamStart()==1);
+  first = number;
+  Events(label, NOF_PAUSED, pdTRUE);
+  afterPaused = number;
+  Events(label, NOF_BURST, pdFALSE);
+  afterBurst = number;
+  vTaskDelay(20);
+  Events(label, NOF_AFTER, pdTRUE);
+  vTraceStreamStop();
+  CHECK(uiTraceStreamGetDropped()>0);
+
+  Decode(stream, uiTraceStreamGetMemoryUsed(), first, &d);
+  CHECK(d.nofBad==0);
+  CHECK(d.recorderData);
+  CHECK(d.nofValues>NOF_PAUSED+NOF_AFTER && d.last==number-1);
+  CHECK(d.nofGaps>0 && d.firstGap>afterPaused-EVENT_BUFFER_SIZE/2 && d.lastGap<=afterBurst);
+  CHECK(d.dropped==uiTraceStreamGetDropped());
+  CHECK(d.nofRecords+d.dropped==recorderData.numEvents);
+  CHECK(d.format[0]!=0 && strcmp((const char*)&recorderData.SymbolTable.symbytes[d.format[0]+4], "%d")==0);
+  CHECK(d.format[1]!=0 && strcmp((const char*)&recorderData.SymbolTable.symbytes[d.format[1]+4], "%d %d %d")==0);
+  (void)printf("%s: %lu blocks, %lu of %ld numbers, %lu of %lu records dropped\n", name,
+    (unsigned long)d.nofBlocks, (unsigned long)d.nofValues, (long)(number-first),
+    (unsigned long)d.dropped, (unsigned long)recorderData.numEvents);
+}
+
+static void TestTask(void *pvParameters) {
+  traceLabel label = xTraceOpenLabel("test");
+  uint8_t i;
+
+  Capture(label, xTraceStreamMemorySink, "memory sink");
+  Capture(label, AsyncSink, "asynchronous sink");
+  CHECK(nofChanged==0 && nofNoTransfer==0);
+  for(i=0;i<NOF_TRANSFERS;i++) {
+    CHECK(!transfers[i].busy);
+  }
+  vTaskEndScheduler();
+}
+
+int main(void) {
+  CHECK(sizeof(RecorderDataType)<=TRANSFER_SIZE);
+  vTraceInitTraceData();
+  transferQueue = xQueueCreate(NOF_TRANSFERS, sizeof(uint8_t));
+  (void)xTaskCreate(TransferTask, "transfer", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+3, NULL);
+  (void)xTaskCreate(TestTask, "test", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY+2, NULL);
+  vTaskStartScheduler();
+  return TestResult();
+}
@@ -0,0 +1,223 @@
+/*
+ * Strip chart of UIGraph on the UserInterface stand-in UIX: GRAPH1 draws on
+ * the window display stand-in LCDW, with a 300x200 data area in a window at
+ * 10,8. GRAPH2 scrolls with ScrollBoxLeft() of UIX, and has no border: on
+ * GDH (display buffer shifted in memory, 100x50 data area at an odd
+ * position), on GDS with the whole 320x240 display (scroll of the SSD1289
+ * controller LCDS) and on GDS with a 300x200 data area (the controller
+ * cannot scroll it, GRAPH2 writes the changed pixels). Checked:
+ * - SetStripChart() needs a ring buffer of at least the data width plus two.
+ * - after each AddStripChartData(), the display shows the last samples, one
+ *   per column with the newest at the right and a vertical line from the
+ *   previous sample, compared with a reference built from the samples. This
+ *   covers the first column once the ring buffer has wrapped around.
+ * - the painter of the graph gives the same content on a scrambled display.
+ * - with the scroll of the controller only the first and the last column
+ *   are written for a sample.
+ * - no line is drawn outside of the display, and no empty line.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mock_userinterface.h"
+#include "mock_ssd1289.h"
+#include "GRAPH1.h"
+#include "GRAPH2.h"
+#include "GDH.h"
+#include "LCDS.h"
+#include "GDS.h"
+#include "testutil.h"
+
+#define NOF_SAMPLES  3000
+#define MAX_W        320
+#define MAX_H        240
+
+typedef struct {
+  const char *name;
+  const UIX_Display *display;               /* NULL for LCDW */
+  UIX_Window *window;
+  UIX_Element *element;
+  byte (*setStripChart)(UIX_Element *element, uint8_t *samples, UIX_PixelDim nofSamples, UIX_PixelColor color);
+  byte (*addStripChartData)(UIX_Element *element, uint8_t data);
+  unsigned x0, y0, w, h;                    /* data area on the display */
+  UIX_PixelColor dataColor;
+  uint16_t dataPixel, bgPixel;              /* pixel values read for the data and the background */
+  uint16_t (*pixel)(unsigned x, unsigned y);
+  void (*scramble)(void);
+  unsigned long (*pixelsWritten)(void);
+  unsigned repaintEvery;                    /* samples between the checks of the painter */
+  unsigned maxPixels;                       /* pixels written for a sample at most, or 0 */
+} Config;
+
+static const UIX_Display gdh = {GDH_DrawVLine, GDH_ScrollBoxLeft};
+static const UIX_Display gds = {GDS_DrawVLine, GDS_ScrollBoxLeft};
+
+static UIX_Window windows[4];
+static GRAPH1_Graph graph1;
+static GRAPH2_Graph graph2[3];
+static uint8_t ring[MAX_W+2];
+static uint8_t samples[NOF_SAMPLES];
+static uint16_t shown[MAX_H][MAX_W];
+
+static uint16_t PixelW(unsigned x, unsigned y) {
+  return mockLcdW.pixels[y][x];
+}
+
+static uint16_t PixelH(unsigned x, unsigned y) {
+  return GDH_GetPixel((GDH_PixelDim)x, (GDH_PixelDim)y);
+}
+
+static uint16_t PixelS(unsigned x, unsigned y) {
+  return MockSsd1289_Shown(x, MOCK_SSD1289_SOURCES-1-y); /* landscape */
+}
+
+static void ScrambleW(void) {
+  memset(mockLcdW.pixels, 0x5a, sizeof(mockLcdW.pixels));
+}
+
+static void ScrambleH(void) {
+  memset(LCDH_DisplayBuf, 0x5a, sizeof(LCDH_DisplayBuf));
+}
+
+static void ScrambleS(void) {
+  memset(mockSsd1289.ram, 0x5a, sizeof(mockSsd1289.ram));
+}
+
+static unsigned long PixelsW(void) {
+  return mockLcdW.nofPixels;
+}
+
+static unsigned long PixelsS(void) {
+  return mockSsd1289.nofPixels;
+}
+
+static const Config configs[] = {
+  {"GRAPH1 on LCDW, changed pixels", NULL, &windows[0], &graph1.element, GRAPH1_SetStripChart, GRAPH1_AddStripChartData,
+   10+5+1, 8+7+1, 300, 200, UIX_COLOR_BLUE, UIX_COLOR_BLUE, UIX_COLOR_WHITE, PixelW, ScrambleW, PixelsW, 1, 0},
+  {"GRAPH2 on GDH, buffer shifted", &gdh, &windows[1], &graph2[0].element, GRAPH2_SetStripChart, GRAPH2_AddStripChartData,
+   3+4, 2+5, 100, 50, GDH_COLOR_BLACK, 1, 0, PixelH, ScrambleH, NULL, 1, 0},
+  {"GRAPH2 on GDS, controller scroll", &gds, &windows[2], &graph2[1].element, GRAPH2_SetStripChart, GRAPH2_AddStripChartData,
+   0, 0, 320, 240, LCDS_COLOR_BLUE, LCDS_COLOR_BLUE, LCDS_COLOR_WHITE, PixelS, ScrambleS, PixelsS, 25, 2*240},
+  {"GRAPH2 on GDS, changed pixels", &gds, &windows[3], &graph2[2].element, GRAPH2_SetStripChart, GRAPH2_AddStripChartData,
+   10+5, 8+7, 300, 200, LCDS_COLOR_BLUE, LCDS_COLOR_BLUE, LCDS_COLOR_WHITE, PixelS, ScrambleS, PixelsS, 25, 0},
+};
+
+static unsigned Row(const Config *c, uint8_t data) {
+  return c->h-1-(((c->h-1)*data)/100);
+}
+
+/* compares the data area with the last n samples, returns the number of wrong pixels */
+static unsigned CompareSamples(const Config *c, unsigned n) {
+  unsigned x, y, y0, y1, wrong = 0;
+  int i;
+
+  for(x=0;x<c->w;x++) {
+    i = (int)n-(int)c->w+(int)x;               /* sample of this column */
+    y0 = c->h;
+    y1 = 0;
+    if (i>=0) {
+      y0 = y1 = Row(c, samples[i]);
+      if (x>0 && i>0) {                        /* line from the previous sample */
+        y0 = Row(c, samples[i-1])<y0 ? Row(c, samples[i-1]) : y0;
+        y1 = Row(c, samples[i-1])>y1 ? Row(c, samples[i-1]) : y1;
+      }
+    }
+    for(y=0;y<c->h;y++) {
+      if (c->pixel(c->x0+x, c->y0+y)!=(y>=y0 && y<=y1 ? c->dataPixel : c->bgPixel)) {
+        wrong++;
+      }
+    }
+  }
+  return wrong;
+}
+
+/* repaints the graph on a scrambled display, returns if it is the same as before */
+static bool Repaint(const Config *c) {
+  unsigned x, y;
+
+  for(y=0;y<c->h;y++) {
+    for(x=0;x<c->w;x++) {
+      shown[y][x] = c->pixel(c->x0+x, c->y0+y);
+    }
+  }
+  c->scramble();
+  (void)c->element->painter(c->window, c->element);
+  for(y=0;y<c->h;y++) {
+    for(x=0;x<c->w;x++) {
+      if (shown[y][x]!=c->pixel(c->x0+x, c->y0+y)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static void Check(const Config *c) {
+  unsigned i, wrong = 0, nofRepaintErrors = 0, nofTooMany = 0;
+  unsigned long nofPixels = 0, n;
+
+  UIX_SetDisplay(c->display);
+  CHECK(c->setStripChart(c->element, ring, (UIX_PixelDim)(c->w+1), c->dataColor)==ERR_FAILED);
+  CHECK(c->setStripChart(c->element, ring, (UIX_PixelDim)(c->w+2), c->dataColor)==ERR_OK);
+  MockLcdW_ResetCounters();
+  MockSsd1289_ResetCounters();
+  (void)c->element->painter(c->window, c->element);                   /* empty graph */
+  if (c->pixelsWritten!=NULL) {
+    CHECK(c->pixelsWritten()==c->w*c->h);
+  }
+  CHECK(CompareSamples(c, 0)==0);
+
+  for(i=0;i<NOF_SAMPLES;i++) {
+    n = c->pixelsWritten!=NULL ? c->pixelsWritten() : 0;
+    CHECK(c->addStripChartData(c->element, samples[i])==ERR_OK);
+    if (c->pixelsWritten!=NULL) {
+      n = c->pixelsWritten()-n;
+      nofPixels += n;
+      nofTooMany += c->maxPixels!=0 && n>c->maxPixels;
+    }
+    wrong += CompareSamples(c, i+1);
+    if (i%c->repaintEvery==0 && !Repaint(c)) {
+      nofRepaintErrors++;
+    }
+  }
+  CHECK(wrong==0);
+  CHECK(nofRepaintErrors==0);
+  CHECK(nofTooMany==0);
+  CHECK(mockLcdW.nofErrors==0);
+  CHECK(mockSsd1289.nofErrors==0);
+  if (c->pixelsWritten!=NULL) {
+    (void)printf("%s: %u samples, %u wrong pixels, %.1f pixels written per sample\n",
+      c->name, NOF_SAMPLES, wrong, (double)nofPixels/NOF_SAMPLES);
+  } else {
+    (void)printf("%s: %u samples, %u wrong pixels\n", c->name, NOF_SAMPLES, wrong);
+  }
+}
+
+int main(void) {
+  size_t i;
+
+  srand(1);
+  for(i=0;i<NOF_SAMPLES;i++) { /* ramps, jumps and noise, with 0 and 100 */
+    switch ((i/250)%4) {
+      case 0:  samples[i] = (uint8_t)(i%101); break;
+      case 1:  samples[i] = (uint8_t)(rand()%2 ? 0 : 100); break;
+      case 2:  samples[i] = (uint8_t)(50+rand()%11-5); break;
+      default: samples[i] = (uint8_t)(rand()%101); break;
+    }
+  }
+  LCDS_Init();
+
+  windows[0].prop.x = 10; windows[0].prop.y = 8;
+  CHECK(GRAPH1_CreateGraph(&windows[0], &graph1, 5, 7, 300+2, 200+2)==ERR_OK);
+  CHECK(GRAPH1_AddStripChartData(&graph1.element, 50)==ERR_FAILED);   /* no strip chart yet */
+  windows[1].prop.x = 3; windows[1].prop.y = 2;
+  CHECK(GRAPH2_CreateGraph(&windows[1], &graph2[0], 4, 5, 100, 50)==ERR_OK);
+  CHECK(GRAPH2_CreateGraph(&windows[2], &graph2[1], 0, 0, 320, 240)==ERR_OK);
+  windows[3].prop.x = 10; windows[3].prop.y = 8;
+  CHECK(GRAPH2_CreateGraph(&windows[3], &graph2[2], 5, 7, 300, 200)==ERR_OK);
+
+  for(i=0;i<sizeof(configs)/sizeof(configs[0]);i++) {
+    Check(&configs[i]);
+  }
+  return TestResult();
+}
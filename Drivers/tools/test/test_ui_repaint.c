@@ -0,0 +1,178 @@
+/*
+ * Selective repaint of the UI component UI1 on the 320x240 window display
+ * stand-in LCDW, which counts the pixels written. A window covering the
+ * screen holds 64 texts, a dialog window on top of it 4 texts. The texts fit
+ * into their elements, as the UI does not clip what a widget draws. Checked:
+ * - after changing a text outside of the dialog, under the dialog or in the
+ *   dialog, UpdateScreen() gives the same display content as a full repaint
+ *   on a scrambled display, and writes far fewer pixels.
+ * - a text under the dialog repaints the dialog on top of it.
+ * - UpdateScreen() without a change writes no pixels and updates nothing.
+ * - the region passed to UpdateRegion() covers the pixels written.
+ * - the same for random text changes.
+ * - a text without 'Deferred repaint' (TXTI) draws a change immediately,
+ *   with the same display content as a full repaint, and the next
+ *   UpdateScreen() writes no pixels.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ui_components.h"
+#include "testutil.h"
+
+#define NOF_COLS       8
+#define NOF_ROWS       8
+#define NOF_TEXTS      (NOF_COLS*NOF_ROWS)
+#define NOF_DIALOG     4
+#define TEXT_SIZE      12
+#define NOF_RANDOM     500
+
+static UI1_Screen screen;
+static WIN1_WindowWidget window, dialog;
+static TXT1_TextWidget texts[NOF_TEXTS], dialogTexts[NOF_DIALOG];
+static TXTI_TextWidget immediate;
+static unsigned char textBuf[NOF_TEXTS][TEXT_SIZE], dialogBuf[NOF_DIALOG][TEXT_SIZE], immediateBuf[TEXT_SIZE];
+
+static uint16_t shown[MOCK_LCD_W_HEIGHT][MOCK_LCD_W_WIDTH];
+
+/* shortens the text until it fits into the element, and changes the text of the element to it */
+static void ChangeText(TXT1_TextWidget *txtw, const char *text) {
+  unsigned char buf[TEXT_SIZE];
+  size_t n;
+
+  n = strlen(text);
+  if (n>=TEXT_SIZE) {
+    n = TEXT_SIZE-1;
+  }
+  do {
+    memcpy(buf, text, n);
+    buf[n] = '\0';
+  } while (   n-->0
+           && (   FDISP1_GetStringWidth(buf, txtw->textInfo.font, NULL)>txtw->element.prop.width
+               || FDISP1_GetStringHeight(buf, txtw->textInfo.font, NULL)>txtw->element.prop.height
+              )
+          );
+  (void)TXT1_ChangeText(txtw, TEXT_SIZE, buf);
+}
+
+static void CreateScreen(void) {
+  unsigned i;
+  char text[TEXT_SIZE];
+
+  UI1_Init();
+  UI1_CreateScreen(&screen, UI1_COLOR_WHITE);
+  (void)WIN1_Create(&screen.element, &window, 0, 0, MOCK_LCD_W_WIDTH-1, MOCK_LCD_W_HEIGHT-1);
+  for(i=0;i<NOF_TEXTS;i++) {
+    (void)TXT1_Create(&window.element, &texts[i], (UI1_PixelDim)(2+(i%NOF_COLS)*39), (UI1_PixelDim)(2+(i/NOF_COLS)*29), 37, 14);
+    (void)TXT1_SetText(&texts[i], textBuf[i]);
+    (void)snprintf(text, sizeof(text), "T%u", i);
+    ChangeText(&texts[i], text);
+  }
+  (void)TXTI_Create(&window.element, &immediate, 2, 17, 37, 14); /* between the first two rows */
+  (void)TXTI_SetText(&immediate, immediateBuf);
+  (void)WIN1_Create(&screen.element, &dialog, 100, 70, 120, 100);
+  for(i=0;i<NOF_DIALOG;i++) {
+    (void)TXT1_Create(&dialog.element, &dialogTexts[i], 4, (UI1_PixelDim)(4+i*22), 110, 14);
+    (void)TXT1_SetText(&dialogTexts[i], dialogBuf[i]);
+    (void)snprintf(text, sizeof(text), "Dialog %u", i);
+    ChangeText(&dialogTexts[i], text);
+  }
+}
+
+static bool Overlaps(UI1_Element *a, UI1_Element *b) {
+  UI1_PixelDim ax, ay, bx, by;
+
+  (void)UI1_GetElementAbsolutePos(a, &ax, &ay);
+  (void)UI1_GetElementAbsolutePos(b, &bx, &by);
+  return bx < ax+a->prop.width && ax < bx+b->prop.width && by < ay+a->prop.height && ay < by+b->prop.height;
+}
+
+/* updates the screen, returns the number of pixels written and checks the result against a full repaint */
+static unsigned long Update(void) {
+  unsigned long nofPixels;
+  bool ok;
+
+  MockLcdW_ResetCounters();
+  UI1_UpdateScreen(&screen, FALSE);
+  nofPixels = mockLcdW.nofPixels;
+  CHECK(mockLcdW.nofErrors==0);
+  if (nofPixels>0) {
+    CHECK(mockLcdW.nofUpdates==1);
+    CHECK(   mockLcdW.ux0<=mockLcdW.wx0 && mockLcdW.wx1<=mockLcdW.ux1
+          && mockLcdW.uy0<=mockLcdW.wy0 && mockLcdW.wy1<=mockLcdW.uy1);
+  } else {
+    CHECK(mockLcdW.nofUpdates==0);
+  }
+  memcpy(shown, mockLcdW.pixels, sizeof(shown));
+  memset(mockLcdW.pixels, 0x5a, sizeof(mockLcdW.pixels));  /* the full repaint has to write every pixel */
+  UI1_UpdateScreen(&screen, TRUE);
+  ok = memcmp(shown, mockLcdW.pixels, sizeof(shown))==0;
+  CHECK(ok);
+  return nofPixels;
+}
+
+static unsigned long ChangeAndUpdate(TXT1_TextWidget *txtw, const char *text) {
+  ChangeText(txtw, text);
+  return Update();
+}
+
+int main(void) {
+  unsigned long full, outside, under, inDialog, nothing;
+  unsigned i, t, nofWrong = 0;
+  int u = -1, o = -1;
+  char text[TEXT_SIZE];
+
+  CreateScreen();
+  MockLcdW_ResetCounters();
+  UI1_UpdateScreen(&screen, TRUE);
+  full = mockLcdW.nofPixels;
+  CHECK(mockLcdW.nofErrors==0);
+  CHECK(full>=MOCK_LCD_W_WIDTH*MOCK_LCD_W_HEIGHT);
+
+  for(i=0;i<NOF_TEXTS;i++) { /* a text under the dialog and one far away */
+    if (u<0 && Overlaps(&texts[i].element, &dialog.element)) {
+      u = (int)i;
+    } else if (o<0 && !Overlaps(&texts[i].element, &dialog.element)) {
+      o = (int)i;
+    }
+  }
+  CHECK(u>=0 && o>=0);
+
+  outside = ChangeAndUpdate(&texts[o], "Changed");
+  under = ChangeAndUpdate(&texts[u], "Changed");
+  inDialog = ChangeAndUpdate(&dialogTexts[1], "Changed");
+  nothing = Update();
+  CHECK(outside>0 && outside<full/50);
+  CHECK(under>(unsigned long)dialog.element.prop.width*dialog.element.prop.height); /* dialog repainted */
+  CHECK(inDialog>0 && inDialog<under);
+  CHECK(nothing==0);
+
+  (void)printf("%-28s %8lu pixels\n", "full update", full);
+  (void)printf("%-28s %8lu pixels\n", "text outside the dialog", outside);
+  (void)printf("%-28s %8lu pixels\n", "text under the dialog", under);
+  (void)printf("%-28s %8lu pixels\n", "text in the dialog", inDialog);
+  (void)printf("%-28s %8lu pixels\n", "nothing changed", nothing);
+
+  CHECK(FDISP1_GetStringHeight((unsigned char*)"Imm", immediate.textInfo.font, NULL)<=immediate.element.prop.height);
+  MockLcdW_ResetCounters();
+  (void)TXTI_ChangeText(&immediate, TEXT_SIZE, (unsigned char*)"Imm");
+  CHECK(mockLcdW.nofPixels>0 && mockLcdW.nofErrors==0);
+  CHECK(Update()==0);
+
+  srand(1);
+  for(i=0;i<NOF_RANDOM;i++) {
+    (void)snprintf(text, sizeof(text), "%.*s", rand()%(TEXT_SIZE-1), "WiWiWiWiWiWi");
+    t = (unsigned)rand()%(NOF_TEXTS+NOF_DIALOG);
+    ChangeText(t<NOF_TEXTS ? &texts[t] : &dialogTexts[t-NOF_TEXTS], text);
+    if (rand()%2) { /* sometimes two changes in one update */
+      t = (unsigned)rand()%NOF_TEXTS;
+      ChangeText(&texts[t], "x");
+    }
+    if (Update()>=full) {
+      nofWrong++;
+    }
+  }
+  CHECK(nofWrong==0);
+  (void)printf("%u random changes compared with a full repaint\n", NOF_RANDOM);
+  return TestResult();
+}
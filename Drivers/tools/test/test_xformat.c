@@ -0,0 +1,269 @@
+/*
+ * XFormat XF1 on the host, compared with the C library snprintf(). Checked:
+ * - xformatFast() for each item kind with edge values (0, +/-1, +/-5, the
+ *   int and long limits) and random values, with and without field width,
+ *   zero padding and left alignment, in int and long.
+ * - fixed point numbers with 0..9 fraction digits, including values below
+ *   one and LONG_MIN, against an integer reference.
+ * - the output blocks: each block fits into the buffer unless it is a long
+ *   literal passed directly, the blocks make up the whole output and the
+ *   return value is its length. A 42 character log line is passed in two
+ *   blocks of the 32 byte buffer.
+ * - xsnprintf() for every buffer size from 0 to beyond the output gives the
+ *   same buffer content and return value as snprintf(), and does not write
+ *   behind the buffer. xsprintf() and xformat() give the same output.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "XF1.h"
+#include "testutil.h"
+
+#define NOF_RANDOM   20000
+#define OUT_SIZE     512
+
+static char out[OUT_SIZE];
+static unsigned outLen, nofBlocks, nofLongBlocks, nofBlockErrors;
+
+static void OutBlock(void *arg, const char *p, unsigned n) {
+  (void)arg;
+  nofBlocks++;
+  if (n>XF1_FAST_BUF_SIZE) {
+    nofLongBlocks++;
+  }
+  if (n==0 || outLen+n>=OUT_SIZE) {
+    nofBlockErrors++;
+    return;
+  }
+  memcpy(out+outLen, p, n);
+  outLen += n;
+  out[outLen] = '\0';
+}
+
+/* formats with the format items, returns if the output, the block count and the return value are consistent */
+static bool Fast(const XF1_FormatItem *fmt, ...) {
+  va_list args;
+  unsigned count;
+
+  outLen = 0;
+  out[0] = '\0';
+  nofBlocks = 0;
+  nofLongBlocks = 0;
+  va_start(args, fmt);
+  count = XF1_xvformatFast(OutBlock, NULL, fmt, args);
+  va_end(args);
+  return count==outLen && count==strlen(out);
+}
+
+/* the snprintf() printf format for a number item */
+static void PrintfFormat(char *f, unsigned flags, const char *conv) {
+  (void)sprintf(f, "%%%s%s*%s%s", (flags&XF1_FMT_FLAG_LEFT) ? "-" : "", (flags&XF1_FMT_FLAG_ZERO) ? "0" : "",
+    (flags&XF1_FMT_FLAG_LONG) ? "l" : "", conv);
+}
+
+static unsigned TestNumbers(long value, unsigned width, unsigned flags) {
+  char f[16], ref[64];
+  unsigned wrong = 0;
+  const XF1_FormatItem d[] = {XF1_FMT_D(width, flags), XF1_FMT_END()};
+  const XF1_FormatItem u[] = {XF1_FMT_U(width, flags), XF1_FMT_END()};
+  const XF1_FormatItem x[] = {XF1_FMT_X(width, flags), XF1_FMT_END()};
+  const XF1_FormatItem X[] = {XF1_FMT_X(width, flags|XF1_FMT_FLAG_UPPER), XF1_FMT_END()};
+
+  if (flags&XF1_FMT_FLAG_LONG) {
+    PrintfFormat(f, flags, "d");
+    (void)snprintf(ref, sizeof(ref), f, (int)width, value);
+    wrong += !Fast(d, value) || strcmp(out, ref)!=0;
+    PrintfFormat(f, flags, "u");
+    (void)snprintf(ref, sizeof(ref), f, (int)width, (unsigned long)value);
+    wrong += !Fast(u, (unsigned long)value) || strcmp(out, ref)!=0;
+    PrintfFormat(f, flags, "x");
+    (void)snprintf(ref, sizeof(ref), f, (int)width, (unsigned long)value);
+    wrong += !Fast(x, (unsigned long)value) || strcmp(out, ref)!=0;
+    PrintfFormat(f, flags, "X");
+    (void)snprintf(ref, sizeof(ref), f, (int)width, (unsigned long)value);
+    wrong += !Fast(X, (unsigned long)value) || strcmp(out, ref)!=0;
+  } else {
+    PrintfFormat(f, flags, "d");
+    (void)snprintf(ref, sizeof(ref), f, (int)width, (int)value);
+    wrong += !Fast(d, (int)value) || strcmp(out, ref)!=0;
+    PrintfFormat(f, flags, "u");
+    (void)snprintf(ref, sizeof(ref), f, (int)width, (unsigned)value);
+    wrong += !Fast(u, (unsigned)value) || strcmp(out, ref)!=0;
+    PrintfFormat(f, flags, "x");
+    (void)snprintf(ref, sizeof(ref), f, (int)width, (unsigned)value);
+    wrong += !Fast(x, (unsigned)value) || strcmp(out, ref)!=0;
+    PrintfFormat(f, flags, "X");
+    (void)snprintf(ref, sizeof(ref), f, (int)width, (unsigned)value);
+    wrong += !Fast(X, (unsigned)value) || strcmp(out, ref)!=0;
+  }
+  return wrong;
+}
+
+/* fixed point reference with integer arithmetic: value/10^prec with prec fraction digits */
+static void RefFix(char *ref, size_t size, long value, unsigned prec, unsigned width, unsigned flags) {
+  char num[48], sNum[56];
+  unsigned long v, scale = 1;
+  unsigned i;
+  const char *sign = value<0 ? "-" : "";
+
+  v = value<0 ? 0UL-(unsigned long)value : (unsigned long)value;
+  for(i=0;i<prec;i++) {
+    scale *= 10;
+  }
+  if (prec==0) {
+    (void)snprintf(num, sizeof(num), "%lu", v);
+  } else {
+    (void)snprintf(num, sizeof(num), "%lu.%0*lu", v/scale, (int)prec, v%scale);
+  }
+  if (flags&XF1_FMT_FLAG_LEFT) {
+    (void)snprintf(ref, size, "%s%-*s", sign, (int)(width>strlen(sign) ? width-strlen(sign) : 0), num);
+  } else if (flags&XF1_FMT_FLAG_ZERO) {
+    (void)snprintf(ref, size, "%s%s", sign, num);
+    while (strlen(ref)<width) { /* zeros after the sign */
+      memmove(ref+strlen(sign)+1, ref+strlen(sign), strlen(ref)-strlen(sign)+1);
+      ref[strlen(sign)] = '0';
+    }
+  } else {
+    (void)snprintf(sNum, sizeof(sNum), "%s%s", sign, num);
+    (void)snprintf(ref, size, "%*s", (int)width, sNum);
+  }
+}
+
+static unsigned TestFix(long value, unsigned prec, unsigned width, unsigned flags) {
+  char ref[64];
+  const XF1_FormatItem fix[] = {XF1_FMT_FIX(width, prec, flags), XF1_FMT_END()};
+
+  RefFix(ref, sizeof(ref), value, prec, width, flags);
+  return !Fast(fix, value) || strcmp(out, ref)!=0;
+}
+
+static long RandomLong(void) {
+  long v = 0;
+  unsigned i;
+
+  for(i=0;i<sizeof(long);i++) {
+    v = (long)(((unsigned long)v<<8)|(unsigned long)(rand()&0xff));
+  }
+  return v>>(rand()%(8*sizeof(long))); /* all magnitudes */
+}
+
+/* xsnprintf() into a buffer with guard bytes for all sizes, returns the number of differences to snprintf() */
+static unsigned TestSnprintf(const char *fmt, ...) {
+  char buf[OUT_SIZE], ref[OUT_SIZE];
+  va_list args;
+  int len, res, refRes;
+  size_t size;
+  unsigned wrong = 0;
+
+  va_start(args, fmt);
+  len = vsnprintf(ref, sizeof(ref), fmt, args);
+  va_end(args);
+  for(size=0;size<=(size_t)len+2;size++) {
+    memset(buf, '#', sizeof(buf));
+    va_start(args, fmt);
+    res = XF1_xvsnprintf(buf, size, fmt, args);
+    va_end(args);
+    memset(ref, '#', sizeof(ref));
+    va_start(args, fmt);
+    refRes = vsnprintf(ref, size, fmt, args);
+    va_end(args);
+    if (res!=refRes || memcmp(buf, ref, size+8)!=0) {
+      wrong++;
+    }
+  }
+  memset(buf, '#', sizeof(buf));
+  va_start(args, fmt);
+  res = XF1_xvsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  wrong += res!=len || strcmp(buf, ref)!=0;
+  return wrong;
+}
+
+static void OutChar(void *arg, char c) {
+  (void)arg;
+  if (outLen+1<OUT_SIZE) {
+    out[outLen++] = c;
+    out[outLen] = '\0';
+  }
+}
+
+int main(void) {
+  static const long edges[] = {0, 1, -1, 5, -5, 9, 10, -10, 255, 0xABCD, INT_MAX, INT_MIN, LONG_MAX, LONG_MIN};
+  static const unsigned widths[] = {0, 1, 5, 12, 24};
+  static const unsigned flagSets[] = {0, XF1_FMT_FLAG_ZERO, XF1_FMT_FLAG_LEFT, XF1_FMT_FLAG_ZERO|XF1_FMT_FLAG_LEFT};
+  static const XF1_FormatItem strFmt[] = {
+    XF1_FMT_LIT("<"), XF1_FMT_S(0, 0), XF1_FMT_LIT("|"), XF1_FMT_S(8, 0), XF1_FMT_LIT("|"),
+    XF1_FMT_S(8, XF1_FMT_FLAG_LEFT), XF1_FMT_LIT("|"), XF1_FMT_C(), XF1_FMT_LIT(">"), XF1_FMT_END()
+  };
+  static const XF1_FormatItem longFmt[] = {
+    XF1_FMT_LIT("a literal longer than the output buffer of the fast formatter, "), XF1_FMT_U(40, 0),
+    XF1_FMT_LIT(" and a short one"), XF1_FMT_S(50, XF1_FMT_FLAG_LEFT), XF1_FMT_LIT("|"), XF1_FMT_END()
+  };
+  static const XF1_FormatItem lineFmt[] = {
+    XF1_FMT_LIT("T: "), XF1_FMT_FIX(0, 2, 0), XF1_FMT_LIT(" C, rpm="), XF1_FMT_U(5, 0), XF1_FMT_LIT(", st="),
+    XF1_FMT_S(0, 0), XF1_FMT_LIT(", id=0x"), XF1_FMT_X(4, XF1_FMT_FLAG_ZERO|XF1_FMT_FLAG_UPPER), XF1_FMT_LIT("\r\n"),
+    XF1_FMT_END()
+  };
+  char ref[OUT_SIZE];
+  unsigned i, w, f, p, wrongNum = 0, wrongFix = 0, nofChecks = 0;
+  long v;
+
+  for(i=0;i<sizeof(edges)/sizeof(edges[0]);i++) {
+    for(w=0;w<sizeof(widths)/sizeof(widths[0]);w++) {
+      for(f=0;f<sizeof(flagSets)/sizeof(flagSets[0]);f++) {
+        wrongNum += TestNumbers(edges[i], widths[w], flagSets[f]);
+        wrongNum += TestNumbers(edges[i], widths[w], flagSets[f]|XF1_FMT_FLAG_LONG);
+        for(p=0;p<=9;p++) {
+          wrongFix += TestFix(edges[i], p, widths[w], flagSets[f]);
+        }
+        nofChecks += 8+10;
+      }
+    }
+  }
+  srand(1);
+  for(i=0;i<NOF_RANDOM;i++) {
+    v = RandomLong();
+    w = widths[rand()%(sizeof(widths)/sizeof(widths[0]))];
+    f = flagSets[rand()%(sizeof(flagSets)/sizeof(flagSets[0]))];
+    wrongNum += TestNumbers(v, w, f);
+    wrongNum += TestNumbers(v, w, f|XF1_FMT_FLAG_LONG);
+    wrongFix += TestFix(v, (unsigned)rand()%10, w, f);
+    nofChecks += 8+1;
+  }
+  CHECK(wrongNum==0);
+  CHECK(wrongFix==0);
+
+  CHECK(Fast(strFmt, "abc", "abc", "abc", 'z'));
+  CHECK(strcmp(out, "<abc|     abc|abc     |z>")==0);
+  CHECK(Fast(strFmt, "", NULL, "123456789", '%'));
+  CHECK(strcmp(out, "<|  (null)|123456789|%>")==0);
+
+  CHECK(Fast(longFmt, 42UL, "x"));
+  (void)snprintf(ref, sizeof(ref), "a literal longer than the output buffer of the fast formatter, %40u and a short one%-50s|", 42U, "x");
+  CHECK(strcmp(out, ref)==0);
+  CHECK(nofLongBlocks==1);   /* only the long literal */
+  CHECK(nofBlockErrors==0);
+
+  CHECK(Fast(lineFmt, 2345L, 1200U, "run", 0x2aU));
+  CHECK(strcmp(out, "T: 23.45 C, rpm= 1200, st=run, id=0x002A\r\n")==0);
+  CHECK(nofBlocks==2);   /* the line is longer than the output buffer */
+  CHECK(Fast(lineFmt, -5L, 0U, "", 0U));
+  CHECK(strcmp(out, "T: -0.05 C, rpm=    0, st=, id=0x0000\r\n")==0);
+
+  (void)printf("%u xformatFast() outputs compared, %u wrong numbers, %u wrong fixed point numbers\n",
+    nofChecks, wrongNum, wrongFix);
+
+  CHECK(TestSnprintf("")==0);
+  CHECK(TestSnprintf("abc")==0);
+  CHECK(TestSnprintf("T: %d.%02d C, rpm=%5u, st=%s, id=0x%04X\r\n", 23, 45, 1200U, "run", 0x2aU)==0);
+  CHECK(TestSnprintf("%-8s|%8s|%c|%ld|%lu|%lx|%08lX", "left", "right", 'c', LONG_MIN, ULONG_MAX, 0xdeadUL, 0xbeefUL)==0);
+  CHECK(TestSnprintf("%d %d %u %x %.3f", INT_MIN, INT_MAX, UINT_MAX, 0U, -1.5)==0);
+  CHECK(XF1_xsprintf(ref, "%s=%5d", "value", -42)==11);
+  CHECK(strcmp(ref, "value=  -42")==0);
+  outLen = 0;
+  CHECK(XF1_xformat(OutChar, NULL, "%s=%5d", "value", -42)==11);
+  CHECK(strcmp(out, ref)==0);
+  (void)printf("xsnprintf() compared for all buffer sizes\n");
+  return TestResult();
+}
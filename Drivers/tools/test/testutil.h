@@ -0,0 +1,38 @@
+/*
+ * Minimal checks for the host tests: a failed CHECK() is reported with its
+ * location, and TestResult() returns the exit code of the test.
+ */
+#ifndef TESTUTIL_H
+#define TESTUTIL_H
+
+#include <stdio.h>
+#include <time.h>
+
+static int testNofFailed = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      testNofFailed++; \
+      (void)fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    } \
+  } while(0)
+
+static inline int TestResult(void) {
+  if (testNofFailed!=0) {
+    (void)printf("FAILED: %d checks\n", testNofFailed);
+    return 1;
+  }
+  (void)printf("OK\n");
+  return 0;
+}
+
+/* monotonic time in nanoseconds, for the benchmarks */
+static inline unsigned long long TestTimeNs(void) {
+  struct timespec t;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &t);
+  return (unsigned long long)t.tv_sec*1000000000ULL+(unsigned long long)t.tv_nsec;
+}
+
+#endif /* TESTUTIL_H */